@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace strgraph::alloc_tracking {
+
+/**
+ * @brief Heap activity of one thread since it started.
+ */
+struct AllocCounters {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t allocated_bytes = 0;    ///< Usable size of all allocations
+};
+
+/**
+ * @brief Whether the counting operator new/delete are linked in.
+ *
+ * They live in the opt-in strgraph_alloc_hooks object library; without
+ * it every counter stays at zero and no allocation is slowed down.
+ */
+[[nodiscard]] bool installed() noexcept;
+
+/**
+ * @brief Counters of the calling thread.
+ *
+ * Take two snapshots and subtract them to measure a region of code.
+ */
+[[nodiscard]] AllocCounters thread_counters() noexcept;
+
+/**
+ * @brief Bytes currently allocated through operator new, over all threads.
+ */
+[[nodiscard]] int64_t live_bytes() noexcept;
+
+/**
+ * @brief Highest live_bytes() since the last reset_peak().
+ */
+[[nodiscard]] int64_t peak_live_bytes() noexcept;
+
+/**
+ * @brief Restart peak tracking from the current live_bytes().
+ */
+void reset_peak() noexcept;
+
+namespace detail {
+
+/**
+ * @brief Called by the hooks for every allocation and deallocation.
+ */
+void on_allocate(size_t bytes) noexcept;
+void on_deallocate(size_t bytes) noexcept;
+void mark_installed() noexcept;
+
+} // namespace detail
+
+} // namespace strgraph::alloc_tracking
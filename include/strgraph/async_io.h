@@ -0,0 +1,193 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <streambuf>
+#include <cstddef>
+
+namespace strgraph {
+
+/**
+ * @brief Asynchronous I/O backends for streaming file input and output.
+ */
+enum class IoBackend {
+    AUTO,        ///< io_uring when the kernel allows it, THREAD otherwise
+    IO_URING,    ///< Linux io_uring with registered buffers
+    THREAD       ///< Blocking pread/pwrite on a background thread
+};
+
+/**
+ * @brief Get the lowercase name of an I/O backend (e.g. "io_uring").
+ */
+[[nodiscard]] std::string_view io_backend_name(IoBackend backend);
+
+/**
+ * @brief Parse an I/O backend name as returned by io_backend_name().
+ *
+ * @throws std::runtime_error if the name is unknown
+ */
+[[nodiscard]] IoBackend parse_io_backend(std::string_view name);
+
+/**
+ * @brief Check whether io_uring can be set up in this process.
+ *
+ * io_uring may be missing (old kernels) or disabled by seccomp or the
+ * kernel.io_uring_disabled sysctl, e.g. inside containers.
+ */
+[[nodiscard]] bool io_uring_available();
+
+/**
+ * @brief Buffering options shared by AsyncFileReader and AsyncFileWriter.
+ */
+struct AsyncIoOptions {
+    IoBackend backend = IoBackend::AUTO;
+
+    /**
+     * @brief Size of each I/O request and buffer.
+     */
+    size_t block_size = size_t{1} << 20;
+
+    /**
+     * @brief Number of buffers, i.e. the maximum number of requests in flight.
+     */
+    size_t queue_depth = 4;
+
+    /**
+     * @brief Free space reserved in front of each read buffer.
+     *
+     * Lets a consumer prepend the incomplete tail of the previous block
+     * without copying the new block.
+     */
+    size_t headroom = size_t{64} << 10;
+};
+
+/**
+ * @brief I/O counters of an AsyncFileReader or AsyncFileWriter.
+ */
+struct IoStats {
+    IoBackend backend = IoBackend::AUTO;
+    size_t bytes = 0;
+    size_t requests = 0;
+
+    /**
+     * @brief Time the consumer (or producer) was blocked waiting for I/O.
+     */
+    double wait_seconds = 0.0;
+};
+
+/**
+ * @brief A block of file data returned by AsyncFileReader::next().
+ *
+ * The memory stays valid until the block is released. The headroom bytes
+ * directly in front of data are writable scratch space.
+ */
+struct ReadBlock {
+    char* data = nullptr;
+    size_t size = 0;
+    size_t headroom = 0;
+
+    /**
+     * @brief Whether this is the final block of the file.
+     */
+    bool last = false;
+
+    /**
+     * @brief Buffer index, used by AsyncFileReader::release().
+     */
+    size_t slot = 0;
+};
+
+/**
+ * @brief Sequential file reader that keeps several block reads in flight.
+ *
+ * Up to queue_depth blocks are read ahead of the consumer, so the next
+ * blocks are loaded while the current one is being processed. Blocks are
+ * returned in file order.
+ */
+class AsyncFileReader {
+public:
+    /**
+     * @brief Open a file and start reading ahead.
+     *
+     * @param path File to read
+     * @param options Backend and buffering options
+     * @throws std::runtime_error if the file cannot be opened, or if
+     *         IO_URING is requested but unavailable
+     */
+    explicit AsyncFileReader(const std::string& path, const AsyncIoOptions& options = {});
+    ~AsyncFileReader();
+
+    AsyncFileReader(const AsyncFileReader&) = delete;
+    AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+
+    /**
+     * @brief Wait for the next block of the file.
+     *
+     * @return The block, or nullopt once the whole file has been returned
+     * @throws std::runtime_error if a read fails
+     */
+    std::optional<ReadBlock> next();
+
+    /**
+     * @brief Hand a block's buffer back so the next read can be issued into it.
+     */
+    void release(const ReadBlock& block);
+
+    [[nodiscard]] size_t file_size() const noexcept;
+    [[nodiscard]] const IoStats& stats() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Output stream buffer whose full blocks are written asynchronously.
+ *
+ * Use it through a std::ostream. Data is written into one buffer while
+ * previously filled buffers are being written to the file. Regular files
+ * keep up to queue_depth writes in flight; pipes and terminals one.
+ *
+ * Write errors make the stream fail and are rethrown by close().
+ */
+class AsyncFileWriter : public std::streambuf {
+public:
+    /**
+     * @brief Create (or truncate) a file for writing.
+     *
+     * @throws std::runtime_error if the file cannot be created
+     */
+    explicit AsyncFileWriter(const std::string& path, const AsyncIoOptions& options = {});
+
+    /**
+     * @brief Write to an already open file descriptor (e.g. STDOUT_FILENO).
+     *
+     * The descriptor is not closed by the writer.
+     */
+    explicit AsyncFileWriter(int fd, const AsyncIoOptions& options = {});
+
+    ~AsyncFileWriter() override;
+
+    AsyncFileWriter(const AsyncFileWriter&) = delete;
+    AsyncFileWriter& operator=(const AsyncFileWriter&) = delete;
+
+    /**
+     * @brief Write all buffered data, wait for it and close the file.
+     *
+     * @throws std::runtime_error if any write failed
+     */
+    void close();
+
+    [[nodiscard]] const IoStats& stats() const noexcept;
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace strgraph
@@ -0,0 +1,217 @@
+#pragma once
+#include "graph.h"
+#include "executor.h"
+#include "record_reader.h"
+#include "async_io.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <ostream>
+#include <memory>
+
+namespace strgraph {
+
+/**
+ * @brief Binds one column of a record (or the whole record) to a PLACEHOLDER node.
+ * 
+ * Columns are selected by index, or by name through the CSV/TSV header
+ * row or the JSONL field name.
+ */
+struct ColumnBinding {
+    /**
+     * @brief Sentinel column index meaning "the whole record".
+     */
+    static constexpr size_t WHOLE_RECORD = static_cast<size_t>(-1);
+
+    size_t column = WHOLE_RECORD;
+    std::string placeholder_id;
+
+    /**
+     * @brief Column or field name; takes precedence over the index when set.
+     */
+    std::string column_name = {};
+};
+
+/**
+ * @brief Options controlling how a BatchRunner splits and executes records.
+ */
+struct BatchOptions {
+    /**
+     * @brief Node to compute for every record (supports "node:index").
+     */
+    std::string target_node_id;
+
+    /**
+     * @brief Input record format.
+     */
+    RecordFormat format = RecordFormat::LINES;
+
+    /**
+     * @brief Whether the first CSV/TSV record holds the column names.
+     */
+    bool has_header = true;
+
+    /**
+     * @brief Separator between records. Also used between output records.
+     */
+    char record_delimiter = '\n';
+
+    /**
+     * @brief Separator between columns.
+     * 
+     * For LINES, nullopt binds whole records only; CSV and TSV default
+     * to ',' and '\t'.
+     */
+    std::optional<char> column_delimiter;
+
+    /**
+     * @brief Placeholder bindings applied to every record.
+     */
+    std::vector<ColumnBinding> bindings;
+
+    /**
+     * @brief Strategy used to compute each record.
+     */
+    ExecutionStrategy strategy = ExecutionStrategy::RECURSIVE;
+
+    /**
+     * @brief Number of records scheduled together before results are written.
+     */
+    size_t chunk_records = 16384;
+
+    /**
+     * @brief Worker thread count (0 = one per core).
+     */
+    size_t num_threads = 0;
+
+    /**
+     * @brief Emit an empty output record instead of failing on errors.
+     */
+    bool skip_errors = false;
+};
+
+/**
+ * @brief Throughput statistics of a batch run.
+ */
+struct BatchStats {
+    size_t records = 0;
+    size_t errors = 0;
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    double elapsed_seconds = 0.0;
+
+    /**
+     * @brief Time spent executing records; the rest of elapsed_seconds is
+     *        spent splitting records, writing results or waiting for input.
+     */
+    double compute_seconds = 0.0;
+
+    [[nodiscard]] double records_per_second() const;
+    [[nodiscard]] double megabytes_per_second() const;
+};
+
+/**
+ * @brief Runs one graph over every record of an input buffer.
+ * 
+ * Records are processed in parallel chunks, each worker thread owning a
+ * private copy of the graph, and results are written in input order.
+ * Bound columns are passed to the executor as views into the input
+ * buffer; only fields containing escape sequences are decoded.
+ */
+class BatchRunner {
+public:
+    /**
+     * @brief Create a runner for the given graph.
+     * 
+     * @param graph Graph to execute (copied once per worker thread)
+     * @param options Record splitting and execution options
+     * @throws std::runtime_error if a binding refers to a non-PLACEHOLDER node
+     *         or selects a column the format cannot address
+     */
+    BatchRunner(const Graph& graph, BatchOptions options);
+    ~BatchRunner();
+
+    /**
+     * @brief Process every record of the input and write the results.
+     * 
+     * @param input Input buffer (e.g. a MappedFile view)
+     * @param output Stream receiving one result per record
+     * @return Throughput statistics
+     * @throws std::runtime_error on the first failing record unless skip_errors is set
+     */
+    BatchStats run(std::string_view input, std::ostream& output);
+
+    /**
+     * @brief Process a file while it is being read.
+     * 
+     * Each block is processed as soon as it arrives while the reader keeps
+     * the following reads in flight. A record crossing a block boundary is
+     * joined in the headroom in front of the next block.
+     * 
+     * @param input Reader positioned at the start of the file
+     * @param output Stream receiving one result per record
+     * @return Throughput statistics
+     * @throws std::runtime_error on read errors, and on the first failing
+     *         record unless skip_errors is set
+     */
+    BatchStats run(AsyncFileReader& input, std::ostream& output);
+
+private:
+    struct Worker;
+
+    /**
+     * @brief Process the complete records of a segment of the input.
+     * 
+     * @param segment Input starting at a record boundary
+     * @param final_segment Whether segment ends the input
+     * @param header_pending Set while the CSV/TSV header is still to be read
+     * @return Number of bytes consumed; the rest starts an incomplete record
+     */
+    size_t process_segment(std::string_view segment, bool final_segment, bool& header_pending,
+                           std::ostream& output, BatchStats& stats);
+
+    /**
+     * @brief Compute one record on the given worker.
+     */
+    void process_record(Worker& worker, std::string_view record, std::string& result);
+
+    /**
+     * @brief Resolve named CSV/TSV bindings against a header row.
+     */
+    void resolve_header(std::string_view header);
+
+    /**
+     * @brief Whether the input starts with a CSV/TSV header row.
+     */
+    [[nodiscard]] bool has_header_row() const;
+
+    BatchOptions options_;
+    RecordReader reader_;
+
+    /**
+     * @brief Column index of each binding (CSV, TSV and LINES).
+     */
+    std::vector<size_t> binding_columns_;
+
+    /**
+     * @brief Field name of each binding (JSONL; empty for whole records).
+     */
+    std::vector<std::string_view> binding_names_;
+
+    /**
+     * @brief Whether any binding needs the record split into fields.
+     */
+    bool split_fields_ = false;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    /**
+     * @brief Per-chunk buffers, reused across chunks and segments.
+     */
+    std::vector<std::string_view> records_;
+    std::vector<std::string> results_;
+    std::vector<char> failed_;
+};
+
+} // namespace strgraph
@@ -1,6 +1,8 @@
 #pragma once
 #include "graph.h"
 #include "executor.h"
+#include "batch_runner.h"
+#include "traffic_recorder.h"
 #include <string>
 #include <unordered_map>
 #include <memory>
@@ -49,6 +51,130 @@ public:
     std::string run_auto(const std::string& target_node_id,
                         const std::unordered_map<std::string, std::string>& feed_dict = {});
     
+    /**
+     * @brief Execute with PLACEHOLDER values memory-mapped from files.
+     * 
+     * @param target_node_id ID of the node to compute
+     * @param file_feeds File ranges for PLACEHOLDER nodes (read in place)
+     * @param feed_dict In-memory values for the remaining PLACEHOLDER nodes
+     * @param strategy Execution strategy
+     * @return The computed result string
+     */
+    std::string run_with_files(const std::string& target_node_id,
+                               const FileFeedDict& file_feeds,
+                               const std::unordered_map<std::string, std::string>& feed_dict = {},
+                               ExecutionStrategy strategy = ExecutionStrategy::RECURSIVE);
+    
+    /**
+     * @brief Execute and write the target's value to a sink without building it.
+     * 
+     * @param target_node_id ID of the node to write (see Executor::compute_to_sink)
+     * @param sink Destination of the value
+     * @param feed_dict Runtime values for PLACEHOLDER nodes
+     * @param file_feeds File-backed values for PLACEHOLDER nodes
+     * @param strategy Execution strategy
+     * @return Number of bytes written
+     */
+    size_t run_to_sink(const std::string& target_node_id,
+                       OutputSink& sink,
+                       const std::unordered_map<std::string, std::string>& feed_dict = {},
+                       const FileFeedDict& file_feeds = {},
+                       ExecutionStrategy strategy = ExecutionStrategy::RECURSIVE);
+    
+    /**
+     * @brief Execute the graph once per record of an input buffer.
+     * 
+     * Columns or JSON fields are mapped onto PLACEHOLDER nodes as views
+     * into the input (see BatchRunner).
+     * 
+     * @param input Record data (e.g. a MappedFile view)
+     * @param options Record format, bindings and execution options
+     * @param output Stream receiving one result per record
+     * @return Throughput statistics
+     */
+    BatchStats run_batch(std::string_view input, const BatchOptions& options, std::ostream& output);
+
+    /**
+     * @brief Execute the graph once per record of a file streamed by an AsyncFileReader.
+     * 
+     * Blocks are processed while the following ones are being read.
+     */
+    BatchStats run_batch(AsyncFileReader& input, const BatchOptions& options, std::ostream& output);
+
+    /**
+     * @brief Start recording per-node timings of subsequent runs.
+     * 
+     * Events accumulate across runs until the profiler is cleared.
+     * Batch runs are not recorded.
+     *
+     * @param counters Where to sample hardware counters as well
+     * @return False if hardware counters were requested but are not
+     *         permitted; timings are recorded regardless
+     */
+    bool enable_profiling(CounterLevel counters = CounterLevel::OFF);
+
+    /**
+     * @brief Stop recording; the events recorded so far are kept.
+     */
+    void disable_profiling();
+
+    /**
+     * @brief The profiler, or nullptr if profiling was never enabled.
+     */
+    [[nodiscard]] Profiler* profiler() const noexcept;
+
+    /**
+     * @brief Record sampled calls of run() and run_auto() to a traffic log.
+     *
+     * Each sampled call is written with its target, feeds, strategy,
+     * latency and a hash of its result (or its error), so strgraph-replay
+     * can re-execute and verify it against another build. Calls that are
+     * not sampled cost one extra branch.
+     *
+     * @param recorder Log to write to; may be shared by several graphs
+     * @param graph_id Id of this graph in the log (default: the graph's name)
+     */
+    void enable_recording(std::shared_ptr<TrafficRecorder> recorder, std::string graph_id = {});
+
+    /**
+     * @brief Stop recording; the recorder is released.
+     */
+    void disable_recording();
+
+    /**
+     * @brief Keep the latest operations of every run in a flight recorder
+     *        and write a Chrome trace of each run slower than the threshold.
+     *
+     * Enabling again replaces the recorder; its traces are not forgotten
+     * on disk but dumps() starts empty.
+     */
+    void enable_flight_recorder(FlightRecorderOptions options = {});
+
+    /**
+     * @brief Stop recording; the recorder and its dumps() list are kept.
+     */
+    void disable_flight_recorder();
+
+    /**
+     * @brief The flight recorder, or nullptr if it was never enabled.
+     */
+    [[nodiscard]] FlightRecorder* flight_recorder() const noexcept;
+
+    /**
+     * @brief Describe the plan of a target (see Executor::explain).
+     */
+    [[nodiscard]] Explanation explain(const std::string& target_node_id,
+                                      ExecutionStrategy strategy = ExecutionStrategy::AUTO,
+                                      const std::unordered_map<std::string, std::string>& feed_dict = {});
+
+    /**
+     * @brief Run the plan of a target and annotate it with actual
+     *        timings (see Executor::explain_analyze).
+     */
+    [[nodiscard]] Explanation explain_analyze(const std::string& target_node_id,
+                                              const std::unordered_map<std::string, std::string>& feed_dict = {},
+                                              ExecutionStrategy strategy = ExecutionStrategy::AUTO);
+
     /**
      * @brief Get the underlying graph (for inspection).
      * 
@@ -63,10 +189,35 @@ public:
      */
     bool is_valid() const;
 
+    /**
+     * @brief Whether the graph passed Executor::verify() when it was
+     *        compiled, so its runs take the unchecked fast path.
+     *
+     * A graph that fails verification is still valid: its runs take the
+     * checked path, which reports the problem if a run reaches it.
+     */
+    [[nodiscard]] bool is_verified() const noexcept;
+
+    /**
+     * @brief Why verification failed, or empty if the graph is verified.
+     */
+    [[nodiscard]] const std::string& verification_error() const noexcept;
+
 private:
     std::unique_ptr<Graph> graph_;
     std::unique_ptr<Executor> executor_;
+    std::unique_ptr<Profiler> profiler_;
+    std::shared_ptr<TrafficRecorder> recorder_;
+    std::string recording_id_;
+    std::unique_ptr<FlightRecorder> flight_recorder_;
     bool valid_;
+    std::string verification_error_;
+
+    void verify();
+
+    std::string run_recorded(const std::string& target_node_id,
+                             const std::unordered_map<std::string, std::string>& feed_dict,
+                             ExecutionStrategy strategy);
 };
 
 } // namespace strgraph
@@ -1,8 +1,43 @@
 #pragma once
+#include "operation_registry.h"
+#include <span>
+#include <string_view>
 
 namespace strgraph {
 namespace core_ops {
 
+/**
+ * @brief How a built-in operation assembles its output from its arguments.
+ */
+enum class AssemblyKind {
+    NONE,      ///< Output is computed, not assembled
+    CONCAT,    ///< Inputs followed by constants
+    REPEAT     ///< The input repeated constants[0] times
+};
+
+/**
+ * @brief Signature of the built-in operations.
+ */
+using Kernel = OpResult (*)(std::span<const std::string_view> inputs,
+                            std::span<const std::string_view> constants);
+
+/**
+ * @brief A built-in operation and the name it is registered under.
+ */
+struct KernelEntry {
+    std::string_view name;
+    Kernel kernel;
+    OpSignature signature;
+};
+
+/**
+ * @brief All built-in operations, in registration order.
+ * 
+ * Calling a kernel directly skips the OperationRegistry lookup and the
+ * std::function wrapper, which is what the kernel benchmark compares.
+ */
+[[nodiscard]] std::span<const KernelEntry> kernels();
+
 /**
  * @brief Register all built-in core operations to the OperationRegistry.
  * 
@@ -15,6 +50,18 @@ namespace core_ops {
  */
 void register_all();
 
+/**
+ * @brief Identify the built-in assembly operations.
+ * 
+ * Used to stream results piece by piece instead of building them. Only
+ * the built-in implementations are recognized, so an operation registered
+ * under the same name by the user is reported as NONE.
+ * 
+ * @param op Operation as returned by the OperationRegistry
+ * @return The assembly performed by op
+ */
+[[nodiscard]] AssemblyKind assembly_kind(const StringOperation& op);
+
 } // namespace core_ops
 } // namespace strgraph
 
@@ -1,6 +1,16 @@
 #pragma once
 #include "graph.h"
+#include "mapped_file.h"
+#include "output_sink.h"
+#include "flight_recorder.h"
+#include "profiler.h"
+#include "metrics.h"
+#include "explain.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
+#include <span>
 #include <unordered_set>
 #include <unordered_map>
 #include <vector>
@@ -14,6 +24,54 @@ namespace strgraph {
  */
 using FeedDict = std::unordered_map<std::string, std::string>;
 
+/**
+ * @brief Non-owning runtime input dictionary.
+ * 
+ * Maps node IDs to views of their runtime values. Keys and values must
+ * outlive the computation (and the returned result reference).
+ */
+using FeedViewDict = std::unordered_map<std::string_view, std::string_view>;
+
+/**
+ * @brief A PLACEHOLDER value read from a file (or a byte range of it).
+ * 
+ * The range is memory-mapped read-only for the duration of the
+ * computation and fed as a view, so operations read it straight from
+ * the page cache without copying.
+ */
+struct FileFeed {
+    std::string path;
+    size_t offset = 0;
+    size_t length = MappedFile::TO_END;
+};
+
+/**
+ * @brief Maps PLACEHOLDER node IDs to the files holding their values.
+ */
+using FileFeedDict = std::unordered_map<std::string, FileFeed>;
+
+/**
+ * @brief Enumeration of the available execution strategies.
+ */
+enum class ExecutionStrategy {
+    RECURSIVE,   ///< compute()
+    ITERATIVE,   ///< compute_iterative()
+    PARALLEL,    ///< compute_parallel()
+    AUTO         ///< compute_auto()
+};
+
+/**
+ * @brief Get the lowercase name of an execution strategy (e.g. "parallel").
+ */
+[[nodiscard]] std::string_view strategy_name(ExecutionStrategy strategy);
+
+/**
+ * @brief Parse a strategy name as returned by strategy_name().
+ * 
+ * @throws std::runtime_error if the name is unknown
+ */
+[[nodiscard]] ExecutionStrategy parse_strategy(std::string_view name);
+
 /**
  * @brief Executor for computing nodes in a string computation graph.
  */
@@ -25,6 +83,35 @@ public:
      * @param graph The computation graph
      */
     explicit Executor(Graph& graph);
+    ~Executor();
+
+    /**
+     * @brief Verify the whole graph once and run it without per-node checks.
+     * 
+     * Proves that every input ID parses and names a node, that the graph
+     * has no cycle, that every operation exists, was registered with an
+     * OpSignature and accepts its node's input and constant counts, and
+     * that output indices are used exactly on multi-output operations.
+     * Every strategy then runs on a plan with inputs and operations
+     * resolved to pointers and levels precomputed: no input ID is parsed,
+     * no node or operation is looked up by name and no cycle is tracked.
+     * 
+     * What depends on the data is still checked on every run: fed
+     * placeholders, output indices against the outputs a node actually
+     * produced, and that an operation returned the kind of output its
+     * signature declares.
+     * 
+     * The verification holds until clear_verification(); call verify()
+     * again after modifying the graph or re-registering its operations.
+     * 
+     * @throws std::runtime_error with the first problem found; the
+     *         executor is then unverified and checks everything as before
+     */
+    void verify();
+
+    void clear_verification() noexcept;
+
+    [[nodiscard]] bool is_verified() const noexcept { return verified_ != nullptr; }
 
     /**
      * @brief Automatically select and execute the best strategy.
@@ -34,6 +121,8 @@ public:
      * - Parallel: OpenMP available && width >= 100 && nodes >= 500
      * - Iterative: default for large/deep graphs
      * 
+     * explain() shows the choice and the facts it is based on.
+     * 
      * @param target_node_id ID of the node to compute
      * @param feed_dict Runtime values for PLACEHOLDER nodes
      * @return Const reference to the computed result string
@@ -80,6 +169,86 @@ public:
         std::string_view target_node_id,
         const FeedDict& feed_dict = {});
 
+    /**
+     * @brief Compute the target node with an explicitly chosen strategy.
+     * 
+     * @param strategy Strategy to dispatch to
+     * @param target_node_id ID of the node to compute
+     * @param feed_dict Runtime values for PLACEHOLDER nodes
+     * @return Const reference to the computed result string
+     */
+    [[nodiscard]] const std::string& compute_with_strategy(
+        ExecutionStrategy strategy,
+        std::string_view target_node_id,
+        const FeedDict& feed_dict = {});
+
+    /**
+     * @brief Compute the target node with values read in place from views.
+     * 
+     * PLACEHOLDER values are not copied; operations read them directly
+     * from the memory the views refer to (e.g. a memory-mapped file).
+     * 
+     * @param strategy Strategy to dispatch to
+     * @param target_node_id ID of the node to compute
+     * @param feed_views Runtime values for PLACEHOLDER nodes
+     * @return Const reference to the computed result string
+     */
+    [[nodiscard]] const std::string& compute_with_strategy(
+        ExecutionStrategy strategy,
+        std::string_view target_node_id,
+        const FeedViewDict& feed_views);
+
+    /**
+     * @brief Compute the target node with PLACEHOLDER values mapped from files.
+     * 
+     * Each file range is mapped read-only with a sequential access hint
+     * and bound as a view; the mappings are released before returning.
+     * 
+     * @param strategy Strategy to dispatch to
+     * @param target_node_id ID of the node to compute
+     * @param file_feeds File-backed values for PLACEHOLDER nodes
+     * @param feed_dict In-memory values for the remaining PLACEHOLDER nodes
+     * @return Const reference to the computed result string
+     * @throws std::runtime_error if a file cannot be mapped or a placeholder
+     *         is fed both from a file and from feed_dict
+     */
+    [[nodiscard]] const std::string& compute_with_files(
+        ExecutionStrategy strategy,
+        std::string_view target_node_id,
+        const FileFeedDict& file_feeds,
+        const FeedDict& feed_dict = {});
+
+    /**
+     * @brief Compute the target node and write its value to a sink.
+     * 
+     * A target that is a concat or repeat is never materialized: the
+     * tree of nested concat/repeat nodes below it is flattened into a
+     * list of pieces (the values of the other nodes it reaches, and
+     * constants), only those nodes are computed, and the pieces are handed
+     * to the sink in one call, e.g. a single writev() for an FdSink.
+     * 
+     * @param strategy Strategy used to compute the pieces
+     * @param target_node_id ID of the node to write
+     * @param sink Destination of the value
+     * @param feed_dict Runtime values for PLACEHOLDER nodes
+     * @param file_feeds File-backed values for PLACEHOLDER nodes
+     * @return Number of bytes handed to the sink
+     */
+    size_t compute_to_sink(
+        ExecutionStrategy strategy,
+        std::string_view target_node_id,
+        OutputSink& sink,
+        const FeedDict& feed_dict = {},
+        const FileFeedDict& file_feeds = {});
+
+    /**
+     * @brief Upper bound on the pieces a target is flattened into.
+     * 
+     * Nodes that would exceed it (e.g. a repeat with a huge count) are
+     * computed and written as one piece.
+     */
+    static constexpr size_t MAX_SINK_PIECES = 65536;
+
     /**
      * @brief Perform topological sort on the graph.
      * 
@@ -88,11 +257,96 @@ public:
     [[nodiscard]] std::vector<Node*> topological_sort();
 
     /**
-     * @brief Minimum size of a layer to be executed in parallel.
+     * @brief Dependency levels of the subgraph reachable from a target.
+     * 
+     * The first level holds the nodes without inputs and every other node
+     * sits one level above its deepest input: the layers the parallel
+     * strategy runs one after another. Within a level, nodes are in the
+     * order they are reached from the target, breadth first.
+     * 
+     * Nodes get dense integer ids as they are discovered, so nothing is
+     * recursive and no string is hashed after discovery. Subgraphs with
+     * frontiers of at least MIN_PARALLEL_PLAN_NODES nodes resolve inputs,
+     * count in-degrees and peel levels on the thread team.
+     * 
+     * @throws std::runtime_error on a cycle or an input that is not in the graph
+     */
+    [[nodiscard]] std::vector<std::vector<Node*>> topological_layers(std::string_view target_node_id);
+
+    /**
+     * @brief Nodes a step of topological_layers() must cover to use threads.
+     */
+    static constexpr size_t MIN_PARALLEL_PLAN_NODES = 4096;
+
+    /**
+     * @brief Default minimum size of a layer to be executed in parallel.
      * 
      */
     static constexpr size_t MIN_PARALLEL_LAYER_SIZE = 200;
 
+    /**
+     * @brief Set the minimum size of a layer the parallel strategy runs on
+     *        OpenMP threads; smaller layers run serially.
+     * 
+     * The crossover depends on the operation costs, string sizes and
+     * machine; strgraph_scaling measures it.
+     */
+    void set_min_parallel_layer_size(size_t size) noexcept { min_parallel_layer_size_ = size; }
+
+    [[nodiscard]] size_t min_parallel_layer_size() const noexcept { return min_parallel_layer_size_; }
+
+    /**
+     * @brief Thresholds of compute_auto().
+     */
+    static constexpr size_t AUTO_MAX_RECURSION_DEPTH = 100;
+    static constexpr size_t AUTO_MAX_RECURSION_NODES = 500;
+    static constexpr size_t AUTO_MIN_PARALLEL_NODES = 500;
+    static constexpr size_t AUTO_MIN_PARALLEL_WIDTH = 100;
+
+    /**
+     * @brief Describe how a target would be computed, without running it.
+     * 
+     * @param target_node_id ID of the node to compute
+     * @param strategy Strategy to explain; AUTO explains compute_auto()'s choice
+     * @param feed_dict Runtime values, only used to estimate sizes
+     * @return The chosen strategy and why, the layers in topological
+     *         order with estimated costs, and the optimizations that apply
+     */
+    [[nodiscard]] Explanation explain(
+        std::string_view target_node_id,
+        ExecutionStrategy strategy = ExecutionStrategy::AUTO,
+        const FeedDict& feed_dict = {});
+
+    /**
+     * @brief explain() and run the plan, annotating every operation with
+     *        its actual time and bytes.
+     * 
+     * The run is recorded by a temporary profiler; an attached profiler
+     * does not record it.
+     */
+    [[nodiscard]] Explanation explain_analyze(
+        std::string_view target_node_id,
+        const FeedDict& feed_dict = {},
+        ExecutionStrategy strategy = ExecutionStrategy::AUTO);
+
+    /**
+     * @brief Record every executed operation in a profiler.
+     * 
+     * @param profiler Profiler to record into (not owned), or nullptr to stop
+     */
+    void set_profiler(Profiler* profiler) noexcept { profiler_ = profiler; }
+
+    [[nodiscard]] Profiler* profiler() const noexcept { return profiler_; }
+
+    /**
+     * @brief Keep recent operations in a flight recorder and dump slow runs.
+     * 
+     * @param recorder Flight recorder (not owned), or nullptr to stop
+     */
+    void set_flight_recorder(FlightRecorder* recorder) noexcept { flight_recorder_ = recorder; }
+
+    [[nodiscard]] FlightRecorder* flight_recorder() const noexcept { return flight_recorder_; }
+
 private:
     /**
      * @brief Reference to the graph being executed.
@@ -110,23 +364,139 @@ private:
     /**
      * @brief Feed dictionary for PLACEHOLDER nodes.
      * 
-     * Stores runtime values for PLACEHOLDER nodes during execution.
+     * Views of the caller's runtime values for PLACEHOLDER nodes, valid
+     * during one execution.
      */
-    FeedDict feed_dict_;
-    
+    FeedViewDict feed_dict_;
+
     /**
-     * @brief Recursively compute a node and all its dependencies.
+     * @brief Profiler recording operations, or nullptr.
+     */
+    Profiler* profiler_ = nullptr;
+
+    /**
+     * @brief Flight recorder of recent operations, or nullptr.
+     */
+    FlightRecorder* flight_recorder_ = nullptr;
+    size_t min_parallel_layer_size_ = MIN_PARALLEL_LAYER_SIZE;
+
+    /**
+     * @brief Process metrics of this graph (see MetricsRegistry).
+     */
+    EngineMetrics metrics_;
+
+    /**
+     * @brief The resolved plan of a verified graph (see verify()), or nullptr.
+     */
+    struct VerifiedPlan;
+    std::unique_ptr<VerifiedPlan> verified_;
+
+    /**
+     * @brief Bind a PLACEHOLDER node to its fed value (without copying it).
+     */
+    void bind_placeholder(Node& node);
+
+    /**
+     * @brief Resolve the result of the target after execution.
      * 
-     * @param node The node to compute
+     * @param target_node_id Target ID, optionally with an output index
+     * @return Const reference to the selected output
      */
-    void compute_node_recursive(Node& node);
+    [[nodiscard]] const std::string& target_result(std::string_view target_node_id);
 
     /**
-     * @brief Compute in-degree for all nodes.
+     * @brief The feeds of one computation.
      * 
-     * @return Map of node_id -> in_degree
+     * Fills feed_dict_ with views of the fed values and of mapped file
+     * feeds. When the binding goes out of scope, or binding a feed throws,
+     * feed_dict_ is cleared and the values bound from it are dropped, so
+     * no view into the caller's memory or a released mapping outlives the
+     * computation.
      */
-    [[nodiscard]] std::unordered_map<std::string, int> compute_in_degrees() const;
+    class FeedBinding {
+    public:
+        FeedBinding(Executor& executor, const FeedDict& feed_dict, const FileFeedDict& file_feeds = {});
+        FeedBinding(Executor& executor, const FeedViewDict& feed_views);
+        ~FeedBinding();
+
+        FeedBinding(const FeedBinding&) = delete;
+        FeedBinding& operator=(const FeedBinding&) = delete;
+
+    private:
+        void release() noexcept;
+
+        Executor& executor_;
+        std::vector<MappedFile> mappings_;
+    };
+
+    /**
+     * @brief One piece of a flattened sink target.
+     */
+    struct SinkPiece {
+        std::string_view text;    ///< Node input ID, or the constant itself
+        bool is_node;
+    };
+
+    /**
+     * @brief Flatten nested concat/repeat nodes below input_id into pieces.
+     * 
+     * @param input_id Node ID, optionally with an output index
+     * @param depth Current nesting depth
+     * @param pieces Receives the pieces in output order
+     * @param leaves Receives the IDs of the nodes that must be computed
+     */
+    void plan_sink_pieces(std::string_view input_id, size_t depth,
+                          std::vector<SinkPiece>& pieces,
+                          std::vector<std::string_view>& leaves);
+
+    /**
+     * @brief Fill the facts of a decision that compute_auto() bases its choice on.
+     * 
+     * Depth, node count and widest layer are those of the target's layers,
+     * so verified and unverified executors decide alike.
+     */
+    void auto_inputs(std::string_view target_node_id, StrategyDecision& decision);
+
+    /**
+     * @brief Choose the strategy compute_auto() uses for a target.
+     */
+    [[nodiscard]] ExecutionStrategy select_strategy(std::string_view target_node_id);
+
+    /**
+     * @brief The rule of compute_auto(); node_count and max_layer_width
+     *        are only consulted when they can change the outcome.
+     */
+    [[nodiscard]] static ExecutionStrategy auto_strategy(size_t depth, size_t node_count,
+                                                         size_t max_layer_width);
+
+    /**
+     * @brief Compute several targets in one pass with the given strategy.
+     * 
+     * AUTO must be resolved with select_strategy() first.
+     */
+    void run_targets(ExecutionStrategy strategy, std::span<const std::string_view> target_node_ids);
+
+    /**
+     * @brief run_targets() without recording run metrics.
+     */
+    void execute_targets(ExecutionStrategy strategy, std::span<const std::string_view> target_node_ids);
+
+    /**
+     * @brief Strategy implementations operating on the already bound feed_dict_.
+     */
+    [[nodiscard]] const std::string& run_strategy(ExecutionStrategy strategy,
+                                                  std::string_view target_node_id);
+    [[nodiscard]] const std::string& run_auto(std::string_view target_node_id);
+    [[nodiscard]] const std::string& run_recursive(std::string_view target_node_id);
+    [[nodiscard]] const std::string& run_iterative(std::string_view target_node_id);
+    [[nodiscard]] const std::string& run_parallel(std::string_view target_node_id);
+    
+    /**
+     * @brief Recursively compute a node and all its dependencies.
+     * 
+     * @param node The node to compute
+     */
+    void compute_node_recursive(Node& node);
 
     /**
      * @brief Execute a single node (non-recursive).
@@ -137,6 +507,18 @@ private:
      */
     void execute_node(Node& node);
 
+    /**
+     * @brief Invoke the operation of a node and store its result.
+     * 
+     * @param multi_output Output kind the operation's signature declares,
+     *        checked before the node is marked computed; unchecked if empty
+     */
+    void run_operation(Node& node,
+                       const StringOperation& op,
+                       std::span<const std::string_view> input_values,
+                       std::span<const std::string_view> constant_values,
+                       std::optional<bool> multi_output = std::nullopt);
+
     /**
      * @brief Topological sort for subgraph reachable from target.
      * 
@@ -148,66 +530,58 @@ private:
     [[nodiscard]] std::vector<Node*> topological_sort_subgraph(std::string_view target_node_id);
 
     /**
-     * @brief Partition the sorted nodes into layers.
-     * 
-     * @param sorted_nodes Vector of nodes in topological order
-     * @return Vector of vectors of nodes, each representing a layer
+     * @brief Topological sort for the subgraph reachable from several targets.
+     */
+    [[nodiscard]] std::vector<Node*> topological_sort_subgraph(
+        std::span<const std::string_view> target_node_ids);
+
+    /**
+     * @brief Dependency levels of the subgraph reachable from several
+     *        targets (see topological_layers()).
      */
-    [[nodiscard]] std::vector<std::vector<Node*>> partition_by_layers(
-        const std::vector<Node*>& sorted_nodes) const;
+    [[nodiscard]] std::vector<std::vector<Node*>> subgraph_layers(
+        std::span<const std::string_view> target_node_ids);
     
     /**
      * @brief Execute a layer of nodes.
      * 
-     * @param layer Vector of nodes to execute
+     * @param layer Nodes to execute, or their ids in the verified plan
+     * @param execute Executes one element of the layer
      */
-    void execute_layer(const std::vector<Node*>& layer);
+    template <typename Item, typename Execute>
+    void execute_layer(const std::vector<Item>& layer, Execute&& execute);
 
     /**
-     * @brief Prepare graph for execution.
-     * 
-     * - Resets all non-VARIABLE nodes to PENDING state
-     * - Initializes CONSTANT and VARIABLE nodes with their initial values
-     * - PLACEHOLDER nodes are validated lazily during execution
+     * @brief execute_targets() on the verified plan.
      */
-    void prepare_graph();
-    
+    void execute_verified_targets(ExecutionStrategy strategy,
+                                  std::span<const std::string_view> target_node_ids);
+
     /**
-     * @brief Core Kahn's algorithm for topological sorting.
-     * 
-     * Performs BFS-based topological sort on a given set of nodes.
-     * 
-     * @param nodes Set of node IDs to sort
-     * @param in_degree Map of node ID to in-degree count
-     * @param dependents Map of node ID to list of dependent node IDs
-     * @return Vector of nodes in topological order
+     * @brief Dependency levels of the subgraph reachable from the targets,
+     *        as ids of the verified plan.
      */
-    [[nodiscard]] std::vector<Node*> kahn_algorithm(
-        const std::unordered_set<std::string>& nodes,
-        const std::unordered_map<std::string, int>& in_degree,
-        const std::unordered_map<std::string, std::vector<std::string>>& dependents
-    );
-    
+    [[nodiscard]] std::vector<std::vector<uint32_t>> verified_layers(
+        std::span<const std::string_view> target_node_ids);
+
     /**
-     * @brief Fast depth estimation with early termination.
-     * 
-     * @param node_id Starting node ID
-     * @param max_depth Maximum depth to check (stops early if exceeded)
-     * @return Estimated depth (may be capped at max_depth + 1)
+     * @brief Compute a node of the verified plan after its inputs.
      */
-    [[nodiscard]] size_t estimate_depth_fast(
-        std::string_view node_id,
-        size_t max_depth
-    ) const;
-    
+    void compute_verified_recursive(uint32_t id);
+
+    /**
+     * @brief Execute a node of the verified plan whose inputs are computed.
+     */
+    void execute_verified(uint32_t id);
+
     /**
-     * @brief Recursive helper for depth estimation.
+     * @brief Prepare graph for execution.
+     * 
+     * - Resets all non-VARIABLE nodes to PENDING state
+     * - Initializes CONSTANT and VARIABLE nodes with their initial values
+     * - PLACEHOLDER nodes are validated lazily during execution
      */
-    [[nodiscard]] size_t estimate_depth_dfs(
-        std::string_view node_id,
-        size_t max_depth,
-        std::unordered_map<std::string, size_t>& memo
-    ) const;
+    void prepare_graph();
 };
 
 }
\ No newline at end of file
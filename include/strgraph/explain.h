@@ -0,0 +1,84 @@
+#pragma once
+#include "node.h"
+#include <cstdint>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace strgraph {
+
+enum class ExecutionStrategy;
+
+/**
+ * @brief Why a strategy was chosen for a target.
+ *
+ * The facts are those compute_auto() bases its choice on; reasons
+ * compares them against the thresholds in plain words.
+ */
+struct StrategyDecision {
+    ExecutionStrategy requested;      ///< AUTO unless a strategy was forced
+    ExecutionStrategy strategy;       ///< Strategy that runs
+    size_t estimated_depth = 0;       ///< Layers from the inputs to the target
+    size_t node_count = 0;            ///< Nodes reachable from the target
+    size_t max_layer_width = 0;
+    bool openmp = false;              ///< Whether the parallel strategy is available
+    std::vector<std::string> reasons;
+};
+
+/**
+ * @brief One node of an explained plan.
+ */
+struct ExplainNode {
+    std::string id;
+    NodeType type = NodeType::OPERATION;
+    std::string op_name;
+    std::vector<std::string> input_ids;
+    std::vector<std::string> constants;
+    size_t layer = 0;                 ///< Layer of the parallel strategy
+    size_t estimated_bytes = 0;       ///< Estimated output size
+    size_t estimated_cost = 0;        ///< Estimated bytes read and written
+
+    // Filled in by ANALYZE for executed operations
+    std::optional<uint64_t> actual_ns;
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    size_t thread = 0;
+};
+
+/**
+ * @brief Execution plan of a target, as returned by Executor::explain().
+ *
+ * Costs are estimates from the sizes known before execution: constants,
+ * variables, the fed placeholder values (ESTIMATED_PLACEHOLDER_BYTES
+ * for unfed ones), propagated through the operations. Concat and repeat
+ * are sized exactly, every other operation as its largest input.
+ */
+struct Explanation {
+    static constexpr size_t ESTIMATED_PLACEHOLDER_BYTES = 64;
+
+    std::string target;
+    StrategyDecision decision;
+    std::vector<ExplainNode> nodes;                ///< Topological order
+    std::vector<std::vector<size_t>> layers;       ///< Indices into nodes
+    std::vector<std::string> optimizations;
+    size_t graph_nodes = 0;                        ///< Nodes of the whole graph
+
+    bool analyzed = false;                         ///< Whether the plan was run
+    uint64_t total_ns = 0;                         ///< Wall time of the run (ANALYZE)
+
+    /**
+     * @brief Human-readable rendering, one line per node.
+     */
+    [[nodiscard]] std::string to_text() const;
+
+    /**
+     * @brief JSON rendering.
+     *
+     * @param indent Spaces per level, or -1 for a single line
+     */
+    [[nodiscard]] std::string to_json(int indent = 2) const;
+};
+
+} // namespace strgraph
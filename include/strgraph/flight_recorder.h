@@ -0,0 +1,154 @@
+#pragma once
+#include "node.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace strgraph {
+
+/**
+ * @brief Options of a FlightRecorder.
+ */
+struct FlightRecorderOptions {
+    uint64_t threshold_ns = 100'000'000;  ///< Runs taking at least this long are dumped
+    size_t events_per_thread = 4096;      ///< Ring capacity per worker, rounded up to a power of two
+    std::string trace_dir = ".";          ///< Directory the traces are written to
+    size_t max_dumps = 100;               ///< Traces written at most; 0 for no limit
+};
+
+/**
+ * @brief Always-on recorder that writes a trace of every slow run.
+ *
+ * Attach it with Executor::set_flight_recorder(). Every operation
+ * appends one fixed-size event (node, start, end, run) to a ring buffer
+ * of its worker thread: no allocation, no lock and no shared cache line,
+ * with the time-stamp counter as clock where the CPU has one. The rings
+ * always hold the latest events; when a run takes at least threshold_ns,
+ * its events and the sizes of its feeds are written to a Chrome trace
+ * (strgraph-slow-<graph>-<pid>-<run>.json in trace_dir) by the thread
+ * that ran it, before the run returns.
+ *
+ * A run with more operations per worker than the ring holds keeps its
+ * latest ones; the trace reports how many were dropped. Like a Profiler,
+ * a recorder serves one executor at a time.
+ */
+class FlightRecorder {
+public:
+    explicit FlightRecorder(FlightRecorderOptions options = {});
+
+    [[nodiscard]] const FlightRecorderOptions& options() const noexcept { return options_; }
+
+    void set_threshold_ns(uint64_t threshold_ns) noexcept { options_.threshold_ns = threshold_ns; }
+
+    /**
+     * @brief Paths of the traces written so far.
+     */
+    [[nodiscard]] std::vector<std::string> dumps() const;
+
+    /**
+     * @brief Runs recorded so far.
+     */
+    [[nodiscard]] uint64_t runs() const noexcept { return run_; }
+
+    /**
+     * @brief Clock of the events: time-stamp counter ticks on x86,
+     *        steady_clock nanoseconds elsewhere.
+     */
+    [[nodiscard]] static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    /**
+     * @brief State of the run being recorded.
+     */
+    struct RunScope {
+        uint64_t run = 0;
+        uint64_t start_ticks = 0;
+        std::chrono::steady_clock::time_point start;
+        uint64_t duration_ns = 0;         ///< Set by end_run()
+    };
+
+    /**
+     * @brief Start a run; called by the executing thread.
+     */
+    [[nodiscard]] RunScope begin_run();
+
+    /**
+     * @brief Record an operation that started at `start_ticks` (now()).
+     */
+    void record(const Node& node, uint64_t start_ticks) noexcept {
+        const size_t thread = worker_index();
+        if (thread >= rings_.size()) [[unlikely]] {
+            return; // Nested parallelism beyond the prepared workers
+        }
+        Ring& ring = *rings_[thread];
+        const uint64_t head = ring.head.load(std::memory_order_relaxed);
+        ring.events[head & mask_] = {&node, start_ticks, now(), run_};
+        ring.head.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Finish a run.
+     *
+     * @return Whether the run was slow enough to be dumped
+     */
+    [[nodiscard]] bool end_run(RunScope& scope) noexcept;
+
+    /**
+     * @brief Write the trace of a slow run.
+     *
+     * Errors writing the file are not thrown (a slow run must not turn
+     * into a failed one); the run is then just not dumped.
+     *
+     * @param feed_bytes Size of every placeholder value of the run
+     * @return Path of the trace, or empty if it could not be written
+     */
+    std::string dump(const RunScope& scope, std::string_view strategy, std::string_view graph_name,
+                     std::span<const std::pair<std::string, size_t>> feed_bytes);
+
+private:
+    struct Event {
+        const Node* node;
+        uint64_t start;
+        uint64_t end;
+        uint64_t run;
+    };
+
+    struct alignas(64) Ring {
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t> head{0};
+        uint64_t run_start = 0;           ///< head when the current run began
+    };
+
+    static size_t worker_index() noexcept;
+
+    [[nodiscard]] double ns_per_tick() const noexcept;
+
+    FlightRecorderOptions options_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+    uint64_t mask_ = 0;
+    uint64_t run_ = 0;
+    uint64_t epoch_ticks_;
+    std::chrono::steady_clock::time_point epoch_;
+
+    mutable std::mutex dumps_mutex_;
+    std::vector<std::string> dumps_;
+};
+
+} // namespace strgraph
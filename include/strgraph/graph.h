@@ -4,6 +4,9 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <cstdint>
+#include <span>
+#include <string_view>
 #include <json.hpp>
 
 namespace strgraph {
@@ -20,9 +23,122 @@ public:
      * 
      * @param json JSON object containing graph definition
      * @return Unique pointer to the constructed Graph
+     * @throws std::runtime_error for invalid nodes or a duplicate node id
      */
     static std::unique_ptr<Graph> from_json(const nlohmann::json& json);
 
+    /**
+     * @brief Construct a Graph from the text of a JSON graph document.
+     * 
+     * Builds the same graph as from_json(nlohmann::json::parse(text)),
+     * without holding the whole document as a JSON tree: a structural
+     * scan finds the elements of the "nodes" array, chunks of them are
+     * parsed into nodes on the thread team, and the chunks are merged in
+     * document order. Documents the scan does not recognize are parsed
+     * whole, so errors are reported as by nlohmann::json::parse().
+     * 
+     * @param text JSON graph document
+     * @param fields If not null, receives the other top-level fields (e.g. "target_node")
+     * @return Unique pointer to the constructed Graph
+     * @throws std::runtime_error for invalid nodes or a duplicate node id
+     */
+    static std::unique_ptr<Graph> from_json_text(std::string_view text, nlohmann::json* fields = nullptr);
+
+    /**
+     * @brief Construct only the part of a JSON graph document reachable
+     *        from some targets.
+     * 
+     * One structural scan indexes every element of the "nodes" array by
+     * its "id"; then only the targets and, transitively, their inputs are
+     * parsed (each frontier on the thread team) and constructed. Memory
+     * and load time beyond the scan scale with the nodes reached, not
+     * with the document. Unreached nodes are not validated, except that
+     * their ids must be unique. Documents the scan cannot index (e.g. an
+     * element without a plain "id") are loaded whole and then pruned.
+     * 
+     * Inputs naming no node are kept as they are and reported when a run
+     * reaches them, as for a whole graph.
+     * 
+     * @param text JSON graph document
+     * @param targets Nodes to keep with their inputs; output indices ("split:1") are accepted
+     * @param fields If not null, receives the other top-level fields (e.g. "target_node")
+     * @return Unique pointer to the constructed Graph
+     * @throws std::runtime_error if a target is missing, for an invalid
+     *         reached node or for a duplicate node id
+     */
+    static std::unique_ptr<Graph> from_json_text(std::string_view text, std::span<const std::string> targets,
+                                                 nlohmann::json* fields = nullptr);
+
+    /**
+     * @brief Nodes from_json_text() parses per task at least.
+     */
+    static constexpr size_t MIN_LOAD_CHUNK_NODES = 256;
+
+    /**
+     * @brief Construct a Graph from its compact binary representation.
+     * 
+     * @param data Bytes produced by to_binary()
+     * @return Unique pointer to the constructed Graph
+     */
+    static std::unique_ptr<Graph> from_binary(std::string_view data);
+
+    /**
+     * @brief Construct only the part of a binary graph reachable from
+     *        some targets (see from_json_text()).
+     * 
+     * Records are indexed by id without decoding the rest of them, and
+     * only the reached ones are decoded.
+     */
+    static std::unique_ptr<Graph> from_binary(std::string_view data, std::span<const std::string> targets);
+
+    /**
+     * @brief Load a Graph from a file containing either JSON or binary data.
+     * 
+     * The format is detected from the BINARY_MAGIC header.
+     * 
+     * @param path Path to the graph file
+     * @param fields If not null, receives the other top-level fields of a
+     *               JSON graph (e.g. "target_node"); left empty for binary
+     * @return Unique pointer to the constructed Graph
+     */
+    static std::unique_ptr<Graph> from_file(const std::string& path, nlohmann::json* fields = nullptr);
+
+    /**
+     * @brief Load only the part of a graph file reachable from some
+     *        targets, in either format.
+     */
+    static std::unique_ptr<Graph> from_file(const std::string& path, std::span<const std::string> targets,
+                                            nlohmann::json* fields = nullptr);
+
+    /**
+     * @brief Serialize the graph into the compact binary format.
+     * 
+     * Layout (host byte order): BINARY_MAGIC, u32 version, u64 node count,
+     * then one length-prefixed record per node. Records can be skipped
+     * without decoding them.
+     * 
+     * @return Binary representation of the graph
+     */
+    [[nodiscard]] std::string to_binary() const;
+
+    /**
+     * @brief Append the header of a binary graph with node_count records.
+     * 
+     * Together with append_binary_record() this writes the format of
+     * to_binary() node by node, without building a Graph first.
+     */
+    static void append_binary_header(std::string& out, uint64_t node_count);
+
+    /**
+     * @brief Append the length-prefixed binary record of one node.
+     */
+    static void append_binary_record(std::string& out, const Node& node);
+
+    /**
+     * @brief Magic bytes at the start of a binary graph file.
+     */
+    static constexpr std::string_view BINARY_MAGIC = "SGB1";
+
     /**
      * @brief Get a node by ID.
      * 
@@ -45,8 +161,19 @@ public:
      */
     NodeMap& get_nodes();
 
+    /**
+     * @brief Name identifying the graph in metrics (JSON field "name").
+     */
+    [[nodiscard]] const std::string& name() const noexcept { return name_; }
+
+    /**
+     * @brief Set the name; affects executors created afterwards.
+     */
+    void set_name(std::string name) { name_ = std::move(name); }
+
 private:
     NodeMap nodes_;
+    std::string name_ = "unnamed";
 };
 
 } // namespace strgraph
\ No newline at end of file
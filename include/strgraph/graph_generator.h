@@ -0,0 +1,129 @@
+#pragma once
+#include "graph.h"
+#include "node.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace strgraph::generator {
+
+/**
+ * @brief How the operation nodes are spread over the layers.
+ */
+enum class WidthProfile {
+    UNIFORM,    ///< Every layer equally wide
+    DIAMOND,    ///< Widening towards the middle layer, then narrowing
+    FUNNEL,     ///< Widest first, narrowing towards the target
+    RANDOM      ///< Random widths (log-uniform within a factor of 16)
+};
+
+/**
+ * @brief Operations used by the unary nodes (as in the benchmark workloads).
+ */
+enum class OpMix {
+    CASE,       ///< to_upper, to_lower, capitalize, title
+    COPY,       ///< identity, reverse
+    EDIT,       ///< replace, trim, substring
+    MIXED       ///< All of the above
+};
+
+std::string_view width_profile_name(WidthProfile profile);
+std::string_view op_mix_name(OpMix mix);
+
+/**
+ * @throws std::runtime_error for unknown names
+ */
+WidthProfile parse_width_profile(std::string_view name);
+OpMix parse_op_mix(std::string_view name);
+
+/**
+ * @brief Parameters of a synthetic graph.
+ *
+ * Every operation preserves the length of its input and nodes with
+ * several inputs concat them and cut the result back to value_size, so
+ * any generated graph runs in about (nodes x value_size) memory when
+ * its placeholders are fed values of value_size bytes.
+ */
+struct Options {
+    size_t nodes = 1000;              ///< Operation nodes of the layers (before the final reduction)
+    size_t depth = 0;                 ///< Layers; 0 for about sqrt(nodes)
+    WidthProfile width = WidthProfile::UNIFORM;
+    size_t placeholders = 1;
+    size_t min_fan_in = 1;
+    size_t max_fan_in = 3;
+    size_t lookback = 1;              ///< Layers inputs are drawn from
+    double hub_ratio = 0.0;           ///< Probability that an input is a placeholder (fan-out hubs)
+    OpMix mix = OpMix::MIXED;
+    size_t value_size = 64;           ///< Length merges cut their result to
+    double multi_output_ratio = 0.0;  ///< Share of positions that are split nodes
+    size_t split_outputs = 4;         ///< Outputs of a split node
+    uint64_t seed = 42;
+    std::string name = "generated";   ///< Graph name (JSON field "name")
+};
+
+/**
+ * @brief What a generation produced.
+ */
+struct Summary {
+    static constexpr std::string_view TARGET = "out";
+
+    std::vector<std::string> placeholder_ids;
+    size_t total_nodes = 0;           ///< Including placeholders and constants
+    size_t operation_nodes = 0;
+    size_t layers = 0;                ///< Generator layers including the final reduction
+    size_t max_layer_nodes = 0;       ///< Operation nodes of the widest layer
+    size_t split_nodes = 0;
+    size_t edges = 0;                 ///< Inputs over all operation nodes
+};
+
+/**
+ * @brief Receives the generated nodes in topological order.
+ */
+using NodeSink = std::function<void(const Node&)>;
+
+/**
+ * @brief Generate a graph node by node.
+ *
+ * Nodes are streamed, so graphs far larger than what a Graph can hold
+ * comfortably (tens of millions of nodes) can be written to disk; the
+ * generator itself only keeps the last `lookback` layers. Every node
+ * reaches Summary::TARGET, and the same options always produce the same
+ * nodes in the same order.
+ *
+ * @throws std::runtime_error for inconsistent options
+ */
+Summary generate(const Options& options, const NodeSink& sink);
+
+/**
+ * @brief Generate a graph in memory.
+ */
+std::unique_ptr<Graph> generate_graph(const Options& options, Summary* summary = nullptr);
+
+/**
+ * @brief Stream a generated graph as JSON ({"name", "target_node", "nodes"}).
+ */
+Summary write_json(const Options& options, std::ostream& out);
+
+/**
+ * @brief Stream a generated graph in the binary format of Graph::to_binary().
+ *
+ * The node count precedes the records, so the graph is generated twice:
+ * once to count it and once to write it.
+ */
+Summary write_binary(const Options& options, std::ostream& out);
+
+/**
+ * @brief Deterministic text of the given length: lowercase words separated
+ *        by single spaces, never starting or ending with a space.
+ *
+ * Values like this keep every operation of a generated graph length
+ * preserving, so they are what placeholders should be fed.
+ */
+std::string make_value(size_t size, uint64_t seed);
+
+} // namespace strgraph::generator
@@ -0,0 +1,160 @@
+#pragma once
+#include "graph.h"
+#include "executor.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace strgraph {
+
+class GraphTemplate;
+
+/**
+ * @brief Values of the parameters of a GraphTemplate, e.g. one tenant's.
+ *
+ * All values are stored in one buffer, in the template's parameter
+ * order. Create it with GraphTemplate::bind(); it can only be run with
+ * the template that created it.
+ */
+class ParameterSet {
+public:
+    ParameterSet() = default;
+
+    /**
+     * @brief Value of the parameter in slot `slot` (see GraphTemplate::parameters()).
+     */
+    [[nodiscard]] std::string_view value(size_t slot) const noexcept {
+        const size_t begin = slot == 0 ? 0 : ends_[slot - 1];
+        return std::string_view(values_).substr(begin, ends_[slot] - begin);
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return ends_.size(); }
+
+    /**
+     * @brief Heap bytes held by the set.
+     */
+    [[nodiscard]] size_t bytes() const noexcept {
+        return values_.capacity() + ends_.capacity() * sizeof(uint32_t);
+    }
+
+private:
+    friend class GraphTemplate;
+
+    uint64_t template_id_ = 0;
+    std::string values_;
+    std::vector<uint32_t> ends_;          ///< End offset of every value in values_
+};
+
+/**
+ * @brief A graph whose designated CONSTANT nodes are parameters, run
+ *        with one ParameterSet per tenant.
+ *
+ * Tenants that share a graph structure and differ only in some constant
+ * values (separators, prefixes, replacement strings) share one template
+ * instead of a CompiledGraph each. The template holds the graph once;
+ * a tenant holds only its ParameterSet, so binding a new tenant copies
+ * its values and nothing else.
+ *
+ * Runs execute on pooled contexts, each a copy of the graph in which the
+ * parameters are placeholders, verified once when it is created (see
+ * Executor::verify()). Parameter values are bound as views of the
+ * ParameterSet, like fed placeholders, without being copied. A run
+ * takes an idle context or creates one, so the number of copies follows
+ * the number of concurrent runs, not the number of tenants. run() may
+ * be called from several threads at once.
+ */
+class GraphTemplate {
+public:
+    /**
+     * @brief Make the given CONSTANT nodes parameters of a graph.
+     *
+     * @param graph The graph; the parameters' values are their defaults
+     * @param parameter_ids IDs of CONSTANT nodes, in slot order
+     * @throws std::runtime_error if an ID is not a CONSTANT node or is repeated
+     */
+    GraphTemplate(std::unique_ptr<Graph> graph, std::vector<std::string> parameter_ids);
+    ~GraphTemplate();
+
+    GraphTemplate(const GraphTemplate&) = delete;
+    GraphTemplate& operator=(const GraphTemplate&) = delete;
+
+    /**
+     * @brief IDs of the parameters, in slot order.
+     */
+    [[nodiscard]] const std::vector<std::string>& parameters() const noexcept { return parameter_ids_; }
+
+    /**
+     * @brief Create the parameter set of a tenant.
+     *
+     * @param values Values by parameter ID; other parameters keep the
+     *               value of their node in the graph
+     * @throws std::runtime_error if a key is not a parameter
+     */
+    [[nodiscard]] ParameterSet bind(const std::unordered_map<std::string, std::string>& values) const;
+
+    /**
+     * @brief The parameter set with every default value.
+     */
+    [[nodiscard]] const ParameterSet& defaults() const noexcept { return defaults_; }
+
+    /**
+     * @brief Compute a target with a tenant's parameters.
+     *
+     * @param parameters Parameter set created by this template's bind()
+     * @param target_node_id ID of the node to compute
+     * @param feed_dict Runtime values for PLACEHOLDER nodes (not parameters)
+     * @param strategy Execution strategy
+     * @return The computed result string
+     * @throws std::runtime_error if the parameter set belongs to another
+     *         template, a parameter is fed, or the computation fails
+     */
+    std::string run(const ParameterSet& parameters,
+                    std::string_view target_node_id,
+                    const FeedDict& feed_dict = {},
+                    ExecutionStrategy strategy = ExecutionStrategy::RECURSIVE);
+
+    /**
+     * @brief The graph, with the parameters' default values.
+     */
+    [[nodiscard]] const Graph& graph() const noexcept { return *graph_; }
+
+    /**
+     * @brief Whether runs take the verified fast path (see CompiledGraph::is_verified()).
+     */
+    [[nodiscard]] bool is_verified() const noexcept { return verification_error_.empty(); }
+
+    /**
+     * @brief Why verification failed, or empty if the template is verified.
+     */
+    [[nodiscard]] const std::string& verification_error() const noexcept { return verification_error_; }
+
+    /**
+     * @brief Execution contexts created so far (the highest concurrency seen).
+     */
+    [[nodiscard]] size_t contexts() const;
+
+private:
+    struct Context;
+
+    std::unique_ptr<Context> acquire();
+    void release(std::unique_ptr<Context> context);
+    [[nodiscard]] std::unique_ptr<Context> make_context() const;
+
+    std::unique_ptr<const Graph> graph_;
+    std::vector<std::string> parameter_ids_;
+    std::unordered_map<std::string, size_t> parameter_slots_;
+    ParameterSet defaults_;
+    uint64_t id_;
+    std::string verification_error_;
+
+    mutable std::mutex pool_mutex_;
+    std::vector<std::unique_ptr<Context>> idle_;
+    size_t contexts_ = 0;
+};
+
+} // namespace strgraph
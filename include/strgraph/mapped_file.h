@@ -0,0 +1,69 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace strgraph {
+
+/**
+ * @brief Read-only memory mapping of a file (or a byte range of it).
+ * 
+ * The mapping is released when the object is destroyed. Move-only.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Sentinel length meaning "until the end of the file".
+     */
+    static constexpr size_t TO_END = static_cast<size_t>(-1);
+
+    /**
+     * @brief Map a byte range of a file read-only.
+     * 
+     * @param path Path of the file to map
+     * @param offset Byte offset of the range (need not be page-aligned)
+     * @param length Length of the range, or TO_END
+     * @throws std::runtime_error if the file cannot be opened or mapped,
+     *         or if the range lies outside the file
+     */
+    explicit MappedFile(const std::string& path, size_t offset = 0, size_t length = TO_END);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief View over the mapped range.
+     */
+    [[nodiscard]] std::string_view view() const noexcept {
+        return {data_, size_};
+    }
+
+    [[nodiscard]] const char* data() const noexcept { return data_; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+
+    /**
+     * @brief Hint the kernel that the range will be read sequentially.
+     */
+    void advise_sequential() const noexcept;
+
+private:
+    void release() noexcept;
+
+    /**
+     * @brief Start of the page-aligned mapping.
+     */
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+
+    /**
+     * @brief Start and size of the requested range inside the mapping.
+     */
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace strgraph
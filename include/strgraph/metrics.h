@@ -0,0 +1,196 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace strgraph {
+
+/**
+ * @brief Label set of a metric, e.g. {{"strategy", "parallel"}}.
+ */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+namespace detail {
+
+/**
+ * @brief Number of shards of every metric; threads are spread over them
+ *        round-robin so concurrent updates rarely share a cache line.
+ */
+inline constexpr size_t METRIC_SHARDS = 16;
+
+/**
+ * @brief Shard of the calling thread, assigned on first use.
+ */
+[[nodiscard]] inline size_t metric_shard() noexcept {
+    static std::atomic<size_t> next_shard{0};
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+    return shard;
+}
+
+} // namespace detail
+
+/**
+ * @brief Monotonic counter sharded per thread.
+ *
+ * add() is one relaxed atomic increment on a cache line mostly owned by
+ * the calling thread.
+ */
+class Counter {
+public:
+    void add(uint64_t amount = 1) noexcept {
+        shards_[detail::metric_shard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t value() const noexcept;
+    void reset() noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Shard, detail::METRIC_SHARDS> shards_;
+};
+
+/**
+ * @brief Histogram with power-of-two buckets, sharded per thread.
+ *
+ * Bucket i counts the values v with bit_width(v) == i, i.e. 0 in bucket
+ * 0 and [2^(i-1), 2^i) in bucket i; values beyond the last bucket are
+ * counted in it.
+ */
+class Histogram {
+public:
+    static constexpr size_t BUCKETS = 48;
+
+    void observe(uint64_t value) noexcept {
+        size_t bucket = static_cast<size_t>(std::bit_width(value));
+        Shard& shard = shards_[detail::metric_shard()];
+        shard.counts[bucket < BUCKETS ? bucket : BUCKETS - 1].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    struct Snapshot {
+        std::array<uint64_t, BUCKETS> counts{};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+    };
+
+    [[nodiscard]] Snapshot snapshot() const noexcept;
+    void reset() noexcept;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+        std::atomic<uint64_t> sum{0};
+    };
+    std::array<Shard, detail::METRIC_SHARDS> shards_;
+};
+
+/**
+ * @brief Named metrics of the process, exported in the Prometheus text
+ *        exposition format.
+ *
+ * Looking a metric up takes a lock; callers on hot paths look their
+ * metrics up once and keep the reference, which stays valid for the
+ * lifetime of the process.
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief The process-wide registry the engine records into.
+     */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Get or create a counter.
+     *
+     * @param name Metric name (conventionally ending in _total)
+     * @param help Description exported as # HELP
+     * @param labels Label set identifying the series
+     * @throws std::runtime_error if name is registered as a histogram
+     */
+    Counter& counter(std::string_view name, std::string_view help, const MetricLabels& labels = {});
+
+    /**
+     * @brief Get or create a histogram.
+     *
+     * @param scale Factor converting recorded values to exported ones
+     *        (e.g. 1e-9 to record nanoseconds and export seconds)
+     * @throws std::runtime_error if name is registered as a counter
+     */
+    Histogram& histogram(std::string_view name, std::string_view help,
+                         const MetricLabels& labels = {}, double scale = 1.0);
+
+    /**
+     * @brief All metrics in the Prometheus text exposition format.
+     */
+    [[nodiscard]] std::string to_prometheus() const;
+
+    /**
+     * @brief Pass the exposition to a callback (e.g. an HTTP handler).
+     */
+    void export_prometheus(const std::function<void(std::string_view)>& callback) const;
+
+    /**
+     * @brief Write the exposition to a file, atomically replacing it
+     *        (suitable for the node_exporter textfile collector).
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void write_prometheus(const std::string& path) const;
+
+    /**
+     * @brief Zero every metric (registrations are kept).
+     */
+    void reset();
+
+private:
+    enum class Type { COUNTER, HISTOGRAM };
+
+    struct Family {
+        Type type;
+        std::string help;
+        double scale = 1.0;
+        std::map<std::string, std::unique_ptr<Counter>> counters;      ///< By rendered labels
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(std::string_view name, std::string_view help, Type type, double scale);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family, std::less<>> families_;
+};
+
+/**
+ * @brief Metrics the Executor records into, resolved once per graph name.
+ */
+struct EngineMetrics {
+    std::array<Counter*, 3> runs{};           ///< By resolved strategy (recursive, iterative, parallel)
+    std::array<Histogram*, 3> run_latency{};  ///< Nanoseconds, by resolved strategy
+    Counter* run_failures = nullptr;
+    Counter* nodes_executed = nullptr;
+    Counter* bytes_produced = nullptr;
+    Histogram* layer_width = nullptr;
+
+    /**
+     * @brief Look up the metrics of the graph with the given name.
+     */
+    [[nodiscard]] static EngineMetrics for_graph(std::string_view graph_name);
+
+    /**
+     * @brief Count an exception thrown by an operation (cold path).
+     */
+    static void record_op_exception(std::string_view op_name);
+};
+
+} // namespace strgraph
@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include "operation_registry.h"
@@ -104,6 +105,14 @@ struct Node {
      * For other nodes, it's reset at the start of each execution.
      */
     std::optional<OpResult> computed_result;
+
+    /**
+     * @brief Externally owned value bound to a PLACEHOLDER node.
+     * 
+     * Fed values are read in place through this view instead of being
+     * copied into computed_result. Valid only during one execution.
+     */
+    std::optional<std::string_view> bound_value;
 };
 
 }
\ No newline at end of file
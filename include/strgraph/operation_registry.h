@@ -2,7 +2,9 @@
 #include <string>
 #include <string_view>
 #include <span>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -58,6 +60,25 @@ using StringOperation = std::function<OpResult(
     std::span<const std::string_view> constants
 )>;
 
+/**
+ * @brief What an operation accepts and returns, checked when a graph is verified.
+ * 
+ * Executor::verify() proves every node against the signature of its
+ * operation once, so verified graphs run without per-node checks.
+ */
+struct OpSignature {
+    size_t min_inputs = 0;
+    size_t max_inputs = SIZE_MAX;
+    size_t min_constants = 0;
+    size_t max_constants = SIZE_MAX;
+    bool multi_output = false;                ///< Returns std::vector<std::string>
+
+    [[nodiscard]] bool accepts(size_t inputs, size_t constants) const noexcept {
+        return inputs >= min_inputs && inputs <= max_inputs &&
+               constants >= min_constants && constants <= max_constants;
+    }
+};
+
 /**
  * @brief Registry for managing string operations in the computation graph.
  * 
@@ -82,6 +103,14 @@ public:
      * @param op The operation function to register
      */
     void register_op(const std::string& name, StringOperation op);
+
+    /**
+     * @brief Register an operation together with its signature.
+     * 
+     * Graphs using operations registered without a signature still run,
+     * but cannot be verified (see Executor::verify()).
+     */
+    void register_op(const std::string& name, StringOperation op, OpSignature signature);
     
     /**
      * @brief Retrieve an operation by name.
@@ -99,6 +128,13 @@ public:
      */
     [[nodiscard]] bool has_operation(std::string_view name) const;
 
+    /**
+     * @brief Signature of an operation, if it was registered with one.
+     * 
+     * @throws std::runtime_error if the operation does not exist
+     */
+    [[nodiscard]] std::optional<OpSignature> get_signature(std::string_view name) const;
+
     // Delete copy and move operations to enforce singleton
     OperationRegistry(const OperationRegistry&) = delete;
     OperationRegistry& operator=(const OperationRegistry&) = delete;
@@ -115,12 +151,20 @@ private:
      * @brief Storage for registered operations.
      */
     std::unordered_map<std::string, StringOperation, StringHash, StringEqual> operations_;
+
+    /**
+     * @brief Signatures of the operations registered with one.
+     */
+    std::unordered_map<std::string, OpSignature, StringHash, StringEqual> signatures_;
 };
 
 /**
  * @brief Register user operation macro
  * 
  * Users can use this macro to register their custom operations.
+ * The operation is registered with a signature that accepts any number
+ * of inputs and constants and declares one output, so graphs using it
+ * can be verified (see Executor::verify()).
  * 
  * @param op_name Operation name (string literal)
  * @param func_name Function name (identifier)
@@ -141,7 +185,7 @@ private:
                     } \
                     std::string result = func_name(input_vec, const_vec); \
                     return OpResult(result); \
-                }); \
+                }, OpSignature{}); \
             } \
         }; \
         static func_name##_Registrar func_name##_instance; \
@@ -0,0 +1,102 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <span>
+#include <functional>
+#include <ostream>
+#include <cstddef>
+
+namespace strgraph {
+
+/**
+ * @brief Destination for results written without materializing them.
+ *
+ * Executor::compute_to_sink() hands a result over as a sequence of pieces
+ * (e.g. the inputs and constants of a concat) which the sink writes in order.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Write the pieces in order.
+     *
+     * The views are only valid during the call.
+     */
+    virtual void write(std::span<const std::string_view> pieces) = 0;
+};
+
+/**
+ * @brief Sink writing to a file descriptor with scatter-gather writev() calls.
+ */
+class FdSink final : public OutputSink {
+public:
+    /**
+     * @brief Write to an open descriptor (e.g. STDOUT_FILENO); it is not closed.
+     */
+    explicit FdSink(int fd);
+
+    /**
+     * @brief Create (or truncate) a file and write to it.
+     *
+     * @throws std::runtime_error if the file cannot be created
+     */
+    explicit FdSink(const std::string& path);
+
+    ~FdSink() override;
+
+    FdSink(const FdSink&) = delete;
+    FdSink& operator=(const FdSink&) = delete;
+
+    /**
+     * @throws std::runtime_error if a write fails
+     */
+    void write(std::span<const std::string_view> pieces) override;
+
+    [[nodiscard]] size_t bytes_written() const noexcept { return bytes_written_; }
+
+    /**
+     * @brief Number of writev() system calls issued.
+     */
+    [[nodiscard]] size_t write_calls() const noexcept { return write_calls_; }
+
+private:
+    int fd_;
+    bool owns_fd_ = false;
+    std::string name_;
+    size_t bytes_written_ = 0;
+    size_t write_calls_ = 0;
+};
+
+/**
+ * @brief Sink writing to a std::ostream (e.g. one backed by an AsyncFileWriter).
+ */
+class StreamSink final : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& stream) : stream_(stream) {}
+
+    /**
+     * @throws std::runtime_error if the stream fails
+     */
+    void write(std::span<const std::string_view> pieces) override;
+
+private:
+    std::ostream& stream_;
+};
+
+/**
+ * @brief Sink passing every piece to a callback.
+ */
+class CallbackSink final : public OutputSink {
+public:
+    using Callback = std::function<void(std::string_view)>;
+
+    explicit CallbackSink(Callback callback) : callback_(std::move(callback)) {}
+
+    void write(std::span<const std::string_view> pieces) override;
+
+private:
+    Callback callback_;
+};
+
+} // namespace strgraph
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace strgraph {
+
+/**
+ * @brief Hardware counter values; -1 marks a counter that is not available.
+ */
+struct PerfSample {
+    int64_t cycles = -1;
+    int64_t instructions = -1;
+    int64_t cache_misses = -1;
+    int64_t branch_misses = -1;
+
+    [[nodiscard]] bool valid() const noexcept { return cycles >= 0; }
+
+    /**
+     * @brief Instructions per cycle, or 0 if unknown.
+     */
+    [[nodiscard]] double ipc() const noexcept {
+        return cycles > 0 && instructions >= 0
+            ? static_cast<double>(instructions) / static_cast<double>(cycles) : 0.0;
+    }
+
+    /**
+     * @brief Per-counter difference (end - start); unavailable stays -1.
+     */
+    friend PerfSample operator-(const PerfSample& end, const PerfSample& start) noexcept;
+
+    /**
+     * @brief Per-counter sum; unavailable stays -1.
+     */
+    PerfSample& operator+=(const PerfSample& other) noexcept;
+};
+
+/**
+ * @brief perf_event_open() counters of one thread (user space only).
+ *
+ * Cycles, instructions, cache misses and branch misses are opened as one
+ * group, so they are scheduled together and their ratios are meaningful.
+ * Counting starts at construction; read() returns running totals, and a
+ * region is measured by subtracting two reads. When the kernel refuses
+ * the counters (containers, perf_event_paranoid, no PMU in a VM) the
+ * object is unavailable and every read is an invalid sample.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    [[nodiscard]] bool available() const noexcept { return fds_[0] >= 0; }
+
+    /**
+     * @brief Why the counters could not be opened (empty if available).
+     */
+    [[nodiscard]] const std::string& unavailable_reason() const noexcept { return reason_; }
+
+    /**
+     * @brief Running totals (scaled if the kernel multiplexed the group).
+     */
+    [[nodiscard]] PerfSample read() const noexcept;
+
+    /**
+     * @brief Counters of the calling thread, opened on first use.
+     */
+    static PerfCounters& for_this_thread();
+
+    /**
+     * @brief Sum of for_this_thread() over the calling thread and the
+     *        OpenMP worker threads.
+     */
+    static PerfSample read_team();
+
+    /**
+     * @brief Whether hardware counters can be opened in this process.
+     */
+    static bool supported();
+
+private:
+    static constexpr int EVENTS = 4;
+    int fds_[EVENTS] = {-1, -1, -1, -1};
+    std::string reason_;
+};
+
+} // namespace strgraph
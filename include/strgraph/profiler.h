@@ -0,0 +1,174 @@
+#pragma once
+#include "node.h"
+#include "perf_counters.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace strgraph {
+
+/**
+ * @brief Execution record of one OPERATION node.
+ */
+struct NodeEvent {
+    std::string node_id;
+    std::string op_name;
+    uint64_t start_ns = 0;        ///< Since the profiler was created or cleared
+    uint64_t end_ns = 0;
+    size_t thread = 0;            ///< Worker index (OpenMP thread number)
+    size_t input_bytes = 0;       ///< Total size of the input values
+    size_t output_bytes = 0;      ///< Total size of the output values
+    int64_t allocations = -1;     ///< operator new calls, -1 if not tracked
+    PerfSample counters;          ///< Hardware counters (CounterLevel::NODES only)
+
+    [[nodiscard]] uint64_t duration_ns() const noexcept { return end_ns - start_ns; }
+};
+
+/**
+ * @brief Record of one execution (one strategy run over its targets).
+ */
+struct RunEvent {
+    std::string strategy;         ///< Resolved strategy name
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;
+    PerfSample counters;          ///< Summed over the worker threads
+
+    [[nodiscard]] uint64_t duration_ns() const noexcept { return end_ns - start_ns; }
+};
+
+/**
+ * @brief Record of one layer of the parallel strategy.
+ */
+struct LayerEvent {
+    size_t width = 0;             ///< Nodes of the layer
+    size_t threads = 1;           ///< OpenMP team size, 1 if the layer ran serially
+    uint64_t start_ns = 0;
+    uint64_t end_ns = 0;          ///< After the barrier closing the layer
+
+    [[nodiscard]] uint64_t duration_ns() const noexcept { return end_ns - start_ns; }
+};
+
+/**
+ * @brief Where a Profiler samples hardware counters.
+ */
+enum class CounterLevel {
+    OFF,        ///< Timing only
+    RUNS,       ///< Around each strategy run
+    NODES       ///< Around each strategy run and each operation
+};
+
+/**
+ * @brief Collects per-node timings of an Executor.
+ *
+ * Attach it with Executor::set_profiler(); a detached executor checks a
+ * single null pointer per node and records nothing. Events are buffered
+ * per worker thread, so parallel layers record without locking. A
+ * profiler records one executor at a time.
+ *
+ * Allocation counts are only available when the strgraph_alloc_hooks
+ * library is linked in (see alloc_tracking.h), hardware counters only
+ * when requested with set_counter_level() and permitted by the kernel.
+ */
+class Profiler {
+public:
+    Profiler();
+
+    /**
+     * @brief Drop all events and restart the clock.
+     */
+    void clear();
+
+    /**
+     * @brief Sample hardware counters (see PerfCounters).
+     *
+     * @return False if the kernel refuses the counters; profiling then
+     *         continues with timing only
+     */
+    bool set_counter_level(CounterLevel level);
+
+    [[nodiscard]] CounterLevel counter_level() const noexcept { return counter_level_; }
+
+    /**
+     * @brief All events ordered by start time.
+     */
+    [[nodiscard]] std::vector<NodeEvent> events() const;
+
+    /**
+     * @brief All executions in order.
+     */
+    [[nodiscard]] const std::vector<RunEvent>& runs() const noexcept { return runs_; }
+
+    /**
+     * @brief Layers of parallel-strategy runs in order.
+     *
+     * Thread time of a layer not covered by its node events is spent in
+     * scheduling, at the closing barrier or idle.
+     */
+    [[nodiscard]] const std::vector<LayerEvent>& layers() const noexcept { return layers_; }
+
+    /**
+     * @brief Events in the Chrome trace-event JSON format.
+     *
+     * Load the result in chrome://tracing or https://ui.perfetto.dev;
+     * each node is a complete ("X") event on its worker's track, each
+     * run and each layer run on several threads an enclosing one on
+     * track 0.
+     */
+    [[nodiscard]] std::string to_chrome_trace() const;
+
+    /**
+     * @brief Write to_chrome_trace() to a file.
+     *
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void write_chrome_trace(const std::string& path) const;
+
+    /**
+     * @brief State captured before an operation runs.
+     */
+    struct Scope {
+        uint64_t start_ns;
+        uint64_t allocations;
+        PerfSample counters;
+    };
+
+    /**
+     * @brief Size the per-thread buffers; called before each execution.
+     */
+    void prepare();
+
+    [[nodiscard]] Scope begin() const noexcept;
+
+    /**
+     * @brief Record a node whose operation ran since begin().
+     */
+    void record(const Node& node, const Scope& scope, size_t input_bytes, size_t output_bytes);
+
+    /**
+     * @brief Start and record an execution; called by the executing thread.
+     */
+    [[nodiscard]] Scope begin_run() const;
+    void record_run(std::string_view strategy, const Scope& scope);
+
+    /**
+     * @brief Start and record a layer of the parallel strategy.
+     *
+     * @param threads Size of the team that ran the layer, 1 if it ran serially
+     */
+    [[nodiscard]] uint64_t begin_layer() const noexcept { return now_ns(); }
+    void record_layer(size_t width, size_t threads, uint64_t start_ns);
+
+private:
+    [[nodiscard]] uint64_t now_ns() const noexcept;
+
+    std::chrono::steady_clock::time_point epoch_;
+    std::vector<std::vector<NodeEvent>> buffers_;
+    std::vector<RunEvent> runs_;
+    std::vector<LayerEvent> layers_;
+    CounterLevel counter_level_ = CounterLevel::OFF;
+};
+
+} // namespace strgraph
@@ -0,0 +1,135 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <optional>
+#include <cstdint>
+
+namespace strgraph {
+
+/**
+ * @brief Supported record file formats.
+ */
+enum class RecordFormat {
+    LINES,   ///< One record per line, optionally split on a plain delimiter
+    CSV,     ///< RFC 4180 comma-separated values (quoted fields, "" escapes)
+    TSV,     ///< Tab-separated values (no quoting)
+    JSONL    ///< One flat JSON object per line
+};
+
+/**
+ * @brief Get the lowercase name of a record format (e.g. "csv").
+ */
+[[nodiscard]] std::string_view record_format_name(RecordFormat format);
+
+/**
+ * @brief Parse a record format name as returned by record_format_name().
+ * 
+ * @throws std::runtime_error if the name is unknown
+ */
+[[nodiscard]] RecordFormat parse_record_format(std::string_view name);
+
+/**
+ * @brief A field of a record, viewed in place in the input buffer.
+ * 
+ * Fields without escape sequences are used directly; escaped fields are
+ * decoded into a caller-provided scratch buffer on demand.
+ */
+struct FieldView {
+    enum class Escape : uint8_t {
+        NONE,          ///< raw is the value
+        CSV_QUOTES,    ///< raw contains doubled quotes ("")
+        JSON           ///< raw contains JSON backslash escapes
+    };
+
+    std::string_view raw;
+    Escape escape = Escape::NONE;
+
+    /**
+     * @brief Get the field value, decoding escapes into scratch if needed.
+     * 
+     * @param scratch Buffer that holds decoded values
+     * @return View of the value (into the input buffer or into scratch)
+     */
+    [[nodiscard]] std::string_view value(std::string& scratch) const;
+};
+
+/**
+ * @brief Splits record files into records and fields without copying.
+ * 
+ * Record and field boundaries are found with a vectorized structural
+ * character scan (AVX2 or SSE2 when available, scalar otherwise) that
+ * classifies 64 bytes at a time and masks out delimiters inside quotes.
+ */
+class RecordReader {
+public:
+    /**
+     * @brief Create a reader for the given format.
+     * 
+     * @param format Record format
+     * @param delimiter Column delimiter; defaults to ',' for CSV and '\t' for TSV.
+     *                  LINES records are only split into columns when set.
+     * @param record_delimiter Separator between records (LINES only)
+     */
+    explicit RecordReader(RecordFormat format,
+                          std::optional<char> delimiter = std::nullopt,
+                          char record_delimiter = '\n');
+
+    /**
+     * @brief Collect up to max_records records starting at pos.
+     * 
+     * Records are views into input with the record delimiter (and a CRLF
+     * '\r') removed. Newlines inside quoted CSV fields do not end a record.
+     * 
+     * @param input Input buffer
+     * @param pos Start position (must be at a record boundary)
+     * @param max_records Maximum number of records to collect
+     * @param records Receives the records
+     * @param final_segment Whether input ends the stream. When false, a
+     *                      trailing record without a delimiter is left
+     *                      unconsumed so it can be completed by the next block.
+     * @return Position just past the last collected record
+     */
+    size_t scan_records(std::string_view input, size_t pos, size_t max_records,
+                        std::vector<std::string_view>& records,
+                        bool final_segment = true) const;
+
+    /**
+     * @brief Split a delimited record into its fields.
+     * 
+     * For LINES without a delimiter the whole record is a single field.
+     * Not applicable to JSONL records.
+     */
+    void split_fields(std::string_view record, std::vector<FieldView>& fields) const;
+
+    /**
+     * @brief Look up top-level fields of a flat JSONL object by name.
+     * 
+     * String values are returned without their quotes, other values
+     * (numbers, booleans, nested objects) as raw JSON text and null as
+     * an empty value.
+     * 
+     * @param record One JSON object
+     * @param names Field names to look up
+     * @param fields Receives one entry per name; nullopt for missing fields
+     * @throws std::runtime_error if the record is not a JSON object
+     */
+    void find_json_fields(std::string_view record, std::span<const std::string_view> names,
+                          std::vector<std::optional<FieldView>>& fields) const;
+
+    /**
+     * @brief Parse a header record into column names (CSV, TSV and LINES).
+     */
+    [[nodiscard]] std::vector<std::string> parse_header(std::string_view record) const;
+
+    [[nodiscard]] RecordFormat format() const noexcept { return format_; }
+
+private:
+    RecordFormat format_;
+    std::optional<char> delimiter_;
+    char record_delimiter_;
+    bool quoted_;
+};
+
+} // namespace strgraph
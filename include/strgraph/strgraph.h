@@ -1,10 +1,20 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 
 namespace strgraph {
 
+/**
+ * @brief Time spent in each phase of one execute() / execute_auto() call.
+ */
+struct ExecuteTimings {
+    uint64_t parse_ns = 0;        ///< Parsing the JSON text
+    uint64_t build_ns = 0;        ///< Building the Graph and its Executor
+    uint64_t execute_ns = 0;      ///< Computing the target and copying the result
+};
+
 /**
  * @brief Main entry point for executing a string computation graph from JSON.
  * 
@@ -22,11 +32,13 @@ namespace strgraph {
  * 
  * @param json_data JSON string containing the graph definition and target node
  * @param feed_dict Runtime values for PLACEHOLDER nodes (node_id -> value)
+ * @param timings If not null, receives the time spent in each phase
  * @return The computed result string of the target node
  */
 [[nodiscard]] std::string execute(
     std::string_view json_data,
-    const std::unordered_map<std::string, std::string>& feed_dict);
+    const std::unordered_map<std::string, std::string>& feed_dict,
+    ExecuteTimings* timings = nullptr);
 
 /**
  * @brief Auto-select best execution strategy based on graph characteristics.
@@ -38,10 +50,12 @@ namespace strgraph {
  * 
  * @param json_data JSON string containing the graph definition and target node
  * @param feed_dict Runtime values for PLACEHOLDER nodes (node_id -> value)
+ * @param timings If not null, receives the time spent in each phase
  * @return The computed result string of the target node
  */
 [[nodiscard]] std::string execute_auto(
     std::string_view json_data,
-    const std::unordered_map<std::string, std::string>& feed_dict = {});
+    const std::unordered_map<std::string, std::string>& feed_dict = {},
+    ExecuteTimings* timings = nullptr);
 
 } // namespace strgraph
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace strgraph {
+
+/**
+ * @brief One recorded call of CompiledGraph::run() or run_auto().
+ */
+struct TrafficRecord {
+    uint64_t timestamp_ns = 0;        ///< Start of the call, since the recorder was created
+    std::string graph_id;
+    std::string target;
+    std::string strategy;             ///< strategy_name() of the call
+    std::vector<std::pair<std::string, std::string>> feeds;   ///< Sorted by placeholder id
+    uint64_t result_size = 0;
+    uint64_t result_hash = 0;         ///< TrafficRecorder::hash() of the result
+    uint64_t latency_ns = 0;          ///< Duration of the recorded call
+    std::string error;                ///< what() of the exception if the call failed, else empty
+};
+
+/**
+ * @brief Options of a TrafficRecorder.
+ */
+struct RecorderOptions {
+    double sample_rate = 1.0;         ///< Probability that a call is recorded
+    uint64_t max_records = 0;         ///< Stop recording after this many records; 0 for no limit
+    uint64_t seed = 0;                ///< Seed of the sampling; 0 for a random seed
+};
+
+/**
+ * @brief Writes sampled calls of one or more CompiledGraphs to a binary
+ *        traffic log, for offline replay with strgraph-replay.
+ *
+ * Layout (host byte order): LOG_MAGIC, u32 version, then one record per
+ * call: u32 record size, u64 timestamp, u64 latency, u64 result size,
+ * u64 result hash, and the strings graph id, target, strategy, error
+ * (u32 length + bytes), u32 feed count and a name and value string per
+ * feed. The size prefix lets readers skip records.
+ *
+ * Thread-safe: several graphs, possibly on different threads, may share
+ * one recorder. Records are buffered and written in blocks of about
+ * 1 MiB, by flush() and when the recorder is destroyed.
+ */
+class TrafficRecorder {
+public:
+    static constexpr std::string_view LOG_MAGIC = "SGT1";
+    static constexpr uint32_t LOG_VERSION = 1;
+
+    /**
+     * @throws std::runtime_error if the log cannot be created
+     */
+    explicit TrafficRecorder(const std::string& path, RecorderOptions options = {});
+    ~TrafficRecorder();
+
+    TrafficRecorder(const TrafficRecorder&) = delete;
+    TrafficRecorder& operator=(const TrafficRecorder&) = delete;
+
+    /**
+     * @brief Decide whether the next call is recorded.
+     */
+    [[nodiscard]] bool sample();
+
+    /**
+     * @brief Append a record to the log.
+     */
+    void record(const TrafficRecord& record);
+
+    /**
+     * @brief Write the buffered records to the file.
+     *
+     * @throws std::runtime_error if writing fails
+     */
+    void flush();
+
+    /**
+     * @brief Nanoseconds since the recorder was created.
+     */
+    [[nodiscard]] uint64_t now_ns() const noexcept;
+
+    [[nodiscard]] uint64_t records() const;
+
+    /**
+     * @brief 64-bit FNV-1a hash used for result verification.
+     */
+    [[nodiscard]] static uint64_t hash(std::string_view data) noexcept;
+
+    /**
+     * @brief Read every record of a traffic log.
+     *
+     * @throws std::runtime_error if the file is missing, not a traffic
+     *         log or truncated
+     */
+    [[nodiscard]] static std::vector<TrafficRecord> read(const std::string& path);
+
+private:
+    mutable std::mutex mutex_;
+    std::ofstream file_;
+    std::string buffer_;
+    RecorderOptions options_;
+    std::mt19937_64 rng_;
+    uint64_t records_ = 0;
+    std::chrono::steady_clock::time_point epoch_;
+};
+
+} // namespace strgraph
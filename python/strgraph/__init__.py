@@ -9,10 +9,11 @@ The library is organized into several modules:
 - graph: Core Graph and Node classes
 - ops: String operation functions
 - backend: Low-level C++ backend interface
+- timing: Opt-in latency breakdown of calls into the engine
 """
 
 # Core classes
-from .graph import Graph, Node, MultiOutputNode, CompiledGraph
+from .graph import Graph, Node, MultiOutputNode, CompiledGraph, GraphTemplate
 
 # Operations
 from .ops import (
@@ -57,8 +58,14 @@ from .hybrid_ops import (
     cpp_op,
 )
 
+# Call latency breakdown (strgraph.timing)
+from . import timing
+
 # Backend utilities
-from .backend import is_backend_available
+from .backend import (
+    is_backend_available, metrics_text, write_metrics, export_metrics, reset_metrics,
+    traffic_recorder,
+)
 
 # C++ operation registration
 def register_cpp_operation(name):
@@ -95,6 +102,7 @@ __all__ = [
     "Node",
     "MultiOutputNode",
     "CompiledGraph",
+    "GraphTemplate",
     
     # Basic operations
     "reverse",
@@ -137,6 +145,16 @@ __all__ = [
     "is_backend_available",
     "register_cpp_operation",
     
+    # Metrics
+    "timing",
+    "metrics_text",
+    "write_metrics",
+    "export_metrics",
+    "reset_metrics",
+    
+    # Traffic capture
+    "traffic_recorder",
+    
     # Version
     "__version__",
 ]
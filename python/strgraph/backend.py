@@ -10,8 +10,9 @@ This module provides a Python interface to the C++ backend, handling:
 
 import sys
 import json
+import time
 from pathlib import Path
-from typing import Dict, Optional
+from typing import Callable, Dict, Optional, Tuple
 
 # Attempt to locate and import the C++ backend module
 _build_dir = Path(__file__).parent.parent.parent / "build"
@@ -70,6 +71,87 @@ def execute(graph_json: dict, feed_dict: Optional[Dict[str, str]] = None) -> str
         return strgraph_cpp.execute(json_str, feed_dict)
 
 
+def execute_timed(graph_json: dict, feed_dict: Optional[Dict[str, str]] = None) -> Tuple[str, Dict[str, int], int]:
+    """
+    execute() with its phases timed (see the timing module).
+    
+    Returns:
+        The result, nanoseconds per phase, and the wall time of the
+        native call
+    """
+    _require_backend()
+    start = time.perf_counter_ns()
+    json_str = json.dumps(graph_json)
+    dumps_ns = time.perf_counter_ns() - start
+    
+    native_start = time.perf_counter_ns()
+    result, phases = strgraph_cpp.execute_timed(json_str, feed_dict or {})
+    native_ns = time.perf_counter_ns() - native_start
+    phases["json_dumps"] = dumps_ns
+    return result, phases, native_ns
+
+
+def _require_backend() -> None:
+    if not _backend_available:
+        raise RuntimeError(
+            f"C++ backend not available. Please build the project first.\n"
+            f"Import error: {_import_error}"
+        )
+
+
+def metrics_text() -> str:
+    """
+    Engine metrics in the Prometheus text exposition format.
+    
+    Covers runs per graph (named by the graph JSON "name" field) and
+    strategy, run latency histograms per strategy, nodes executed, bytes
+    produced, exceptions per operation and parallel layer widths, for all
+    graphs executed by this process.
+    """
+    _require_backend()
+    return strgraph_cpp.metrics_text()
+
+
+def write_metrics(path: str) -> None:
+    """
+    Atomically replace a file with metrics_text(), e.g. for the
+    node_exporter textfile collector.
+    """
+    _require_backend()
+    strgraph_cpp.write_metrics(str(path))
+
+
+def export_metrics(callback: Callable[[str], None]) -> None:
+    """Pass metrics_text() to callback (e.g. an HTTP handler's write)."""
+    _require_backend()
+    strgraph_cpp.export_metrics(callback)
+
+
+def reset_metrics() -> None:
+    """Zero all engine metrics."""
+    _require_backend()
+    strgraph_cpp.reset_metrics()
+
+
+def traffic_recorder(path: str, sample_rate: float = 1.0, max_records: int = 0, seed: int = 0):
+    """
+    Create a traffic log for CompiledGraph.enable_recording().
+    
+    Recorded calls (target, feeds, strategy, latency and a hash of the
+    result) are re-executed and verified by the strgraph-replay tool.
+    One recorder may be shared by several graphs and threads; records
+    are written when it is flushed or garbage collected.
+    
+    Args:
+        path: Log file to create (truncated if it exists)
+        sample_rate: Probability that a call is recorded
+        max_records: Stop after this many records (0 for no limit)
+        seed: Seed of the sampling (0 for a random seed)
+    """
+    _require_backend()
+    return strgraph_cpp.TrafficRecorder(path, sample_rate, max_records, seed)
+
+
 # Module initialization: warn if backend is not available
 if not _backend_available:
     import warnings
@@ -58,7 +58,7 @@ def register_operation(
     if backend.is_backend_available():
         try:
             import strgraph_cpp
-            strgraph_cpp.register_python_operation(name, func)
+            strgraph_cpp.register_python_operation(name, func, multi_output)
         except Exception as e:
             import warnings
             warnings.warn(
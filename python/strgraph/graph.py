@@ -2,8 +2,10 @@
 Core graph and node classes for StrGraphCPP.
 """
 
-from typing import Dict, List, Optional, Union
-from . import backend
+import json
+import os
+from typing import Callable, Dict, List, Optional, Union
+from . import backend, timing
 
 
 # Global variable to track the active graph for context manager
@@ -30,10 +32,14 @@ class Graph:
     Represents a string computation graph.
     """
     
-    def __init__(self):
+    def __init__(self, name: Optional[str] = None):
         """
         Initialize an empty graph.
+        
+        Args:
+            name: Optional name labelling the graph's runs in the engine metrics
         """
+        self.name = name
         self._nodes: List[dict] = []
         self._node_counter: int = 0
         self._node_objects: Dict[str, 'Node'] = {}
@@ -203,6 +209,8 @@ class Graph:
             RuntimeError: If execution fails in the C++ backend
             RuntimeError: If a placeholder is missing from feed_dict
         """
+        start = timing.now() if timing.is_enabled() else 0
+        
         # Convert target to node ID string
         if isinstance(target, Node):
             target_id = target.id
@@ -214,11 +222,16 @@ class Graph:
             return self._compiled_graph.run(target_id, feed_dict or {})
         
         # Fallback to JSON-based execution
-        graph_json = {
-            "nodes": self._nodes,
-            "target_node": target_id
-        }
-        
+        built = timing.now() if start else 0
+        graph_json = self.to_json()
+        graph_json["target_node"] = target_id
+        
+        if start:
+            to_json_ns = timing.now() - built
+            result, phases, native_ns = backend.execute_timed(graph_json, feed_dict)
+            phases["graph_to_json"] = to_json_ns
+            timing.record("Graph.run", phases, native_ns, timing.now() - start)
+            return result
         return backend.execute(graph_json, feed_dict)
     
     def run_optimized(
@@ -270,11 +283,29 @@ class Graph:
         """
         return CompiledGraph(self.to_json())
     
+    def compile_template(self, parameters: List[Union['Node', str]]) -> 'GraphTemplate':
+        """
+        Compile the graph as a template whose given constants are parameters.
+        
+        Tenants that differ only in those constants share the template,
+        each with a small parameter set from GraphTemplate.bind().
+        
+        Args:
+            parameters: Constant nodes (or their IDs) to make parameters
+        
+        Returns:
+            A GraphTemplate instance
+        """
+        return GraphTemplate(self.to_json(), parameters)
+    
     def to_json(self) -> dict:
         """
         Export the graph as a JSON dictionary.
         """
-        return {"nodes": self._nodes}
+        graph_json = {"nodes": self._nodes}
+        if self.name is not None:
+            graph_json["name"] = self.name
+        return graph_json
     
     def __repr__(self) -> str:
         """String representation of the graph."""
@@ -398,6 +429,97 @@ class MultiOutputNode(Node):
         return f"MultiOutputNode(id='{self.id}')"
 
 
+def _normalize_file_feeds(file_feeds: Dict[Union[Node, str], Union[str, tuple]]) -> Dict[str, tuple]:
+    """
+    Convert file feeds to {placeholder_id: (path, offset, length_or_None)}.
+    """
+    normalized = {}
+    for node, feed in file_feeds.items():
+        node_id = node.id if isinstance(node, Node) else node
+        if isinstance(feed, (str, os.PathLike)):
+            normalized[node_id] = (os.fspath(feed), 0, None)
+        else:
+            path, offset, *rest = feed
+            length = rest[0] if rest else None
+            normalized[node_id] = (os.fspath(path), offset, length)
+    return normalized
+
+
+class GraphTemplate:
+    """
+    A compiled graph shared by tenants that differ only in some constants.
+    
+    Use Graph.compile_template() to create instances, bind() once per
+    tenant, and run() with the tenant's parameter set. run() can be
+    called from several threads at once.
+    """
+    
+    def __init__(self, graph_json: dict, parameters: List[Union['Node', str]]):
+        """
+        Create a template from a graph JSON dictionary.
+        
+        Args:
+            graph_json: Graph definition dictionary
+            parameters: Constant nodes (or their IDs) to make parameters
+        """
+        import json
+        ids = [p.id if isinstance(p, Node) else p for p in parameters]
+        self._template = backend.strgraph_cpp.GraphTemplate(json.dumps(graph_json), ids)
+    
+    @property
+    def parameters(self) -> List[str]:
+        """IDs of the parameters, in slot order."""
+        return self._template.parameters
+    
+    def bind(self, values: Optional[Dict[Union['Node', str], str]] = None):
+        """
+        Create the parameter set of a tenant.
+        
+        Args:
+            values: Values by parameter; others keep their graph value
+        
+        Returns:
+            An opaque parameter set for run()
+        """
+        values = values or {}
+        return self._template.bind({
+            (k.id if isinstance(k, Node) else k): v for k, v in values.items()
+        })
+    
+    def defaults(self):
+        """The parameter set with every default value."""
+        return self._template.defaults()
+    
+    def run(
+        self,
+        parameters,
+        target: Union['Node', str],
+        feed_dict: Optional[Dict[str, str]] = None,
+        strategy: str = "recursive"
+    ) -> str:
+        """
+        Compute a target with a tenant's parameters.
+        
+        Args:
+            parameters: Parameter set from bind()
+            target: Node to compute (Node object or node ID string)
+            feed_dict: Runtime values for placeholder nodes
+            strategy: "recursive", "iterative", "parallel" or "auto"
+        
+        Returns:
+            The computed result string
+        """
+        target_id = target.id if isinstance(target, Node) else target
+        return self._template.run(parameters, target_id, feed_dict or {}, strategy)
+    
+    def is_verified(self) -> bool:
+        """Check if runs take the verified fast path."""
+        return self._template.is_verified()
+    
+    def __repr__(self) -> str:
+        return f"GraphTemplate(parameters={self.parameters})"
+
+
 class CompiledGraph:
     """
     A compiled graph that can be executed efficiently without JSON overhead.
@@ -417,7 +539,12 @@ class CompiledGraph:
         json_str = json.dumps(graph_json)
         self._compiled = backend.strgraph_cpp.CompiledGraph(json_str)
     
-    def run(self, target: Union[Node, str], feed_dict: Optional[Dict[str, str]] = None) -> str:
+    def run(
+        self,
+        target: Union[Node, str],
+        feed_dict: Optional[Dict[str, str]] = None,
+        file_feeds: Optional[Dict[Union[Node, str], Union[str, tuple]]] = None
+    ) -> str:
         """
         Execute the compiled graph and return the result.
         
@@ -427,10 +554,16 @@ class CompiledGraph:
             feed_dict: Dictionary mapping placeholder node IDs to their
                       runtime string values. Required if the graph contains
                       placeholder nodes.
+            file_feeds: Placeholders whose values are read from files, as
+                       a path or a (path, offset[, length]) tuple. The file
+                       range is memory-mapped and read in place, so large
+                       documents never become Python strings.
         
         Returns:
             The computed result string from the target node
         """
+        start = timing.now() if timing.is_enabled() else 0
+        
         # Convert target to node ID string
         if isinstance(target, Node):
             target_id = target.id
@@ -440,19 +573,33 @@ class CompiledGraph:
         if feed_dict is None:
             feed_dict = {}
         
+        if file_feeds:
+            return self._compiled.run_with_files(
+                target_id, _normalize_file_feeds(file_feeds), feed_dict, "recursive"
+            )
+        if start:
+            return self._run_timed("CompiledGraph.run", start, target_id, feed_dict, False)
         return self._compiled.run(target_id, feed_dict)
     
-    def run_auto(self, target: Union[Node, str], feed_dict: Optional[Dict[str, str]] = None) -> str:
+    def run_auto(
+        self,
+        target: Union[Node, str],
+        feed_dict: Optional[Dict[str, str]] = None,
+        file_feeds: Optional[Dict[Union[Node, str], Union[str, tuple]]] = None
+    ) -> str:
         """
         Execute with auto strategy selection.
         
         Args:
             target: The node to compute
             feed_dict: Runtime values for PLACEHOLDER nodes
+            file_feeds: File-backed placeholder values (see run())
         
         Returns:
             The computed result string
         """
+        start = timing.now() if timing.is_enabled() else 0
+        
         # Convert target to node ID string
         if isinstance(target, Node):
             target_id = target.id
@@ -462,8 +609,276 @@ class CompiledGraph:
         if feed_dict is None:
             feed_dict = {}
         
+        if file_feeds:
+            return self._compiled.run_with_files(
+                target_id, _normalize_file_feeds(file_feeds), feed_dict, "auto"
+            )
+        if start:
+            return self._run_timed("CompiledGraph.run_auto", start, target_id, feed_dict, True)
         return self._compiled.run_auto(target_id, feed_dict)
     
+    def _run_timed(self, call: str, start: int, target_id: str,
+                   feed_dict: Dict[str, str], auto_strategy: bool) -> str:
+        """Run through the timed binding and record the phases (see timing)."""
+        native_start = timing.now()
+        result, phases = self._compiled.run_timed(target_id, feed_dict, auto_strategy)
+        native_ns = timing.now() - native_start
+        timing.record(call, phases, native_ns, timing.now() - start)
+        return result
+    
+    def run_to_file(
+        self,
+        target: Union[Node, str],
+        output_path: str,
+        feed_dict: Optional[Dict[str, str]] = None,
+        file_feeds: Optional[Dict[Union[Node, str], Union[str, tuple]]] = None,
+        strategy: str = "recursive"
+    ) -> int:
+        """
+        Execute the graph and write the target's value to a file.
+        
+        When the target is a concat or repeat, the result is never built:
+        the nested concat/repeat nodes are flattened into pieces that are
+        written with scatter-gather writev() calls. Nothing is returned to
+        Python except the byte count.
+        
+        Args:
+            target: The node to write
+            output_path: File to create (or truncate)
+            feed_dict: Runtime values for PLACEHOLDER nodes
+            file_feeds: File-backed placeholder values (see run())
+            strategy: "recursive", "iterative", "parallel" or "auto"
+        
+        Returns:
+            Number of bytes written
+        """
+        target_id = target.id if isinstance(target, Node) else target
+        return self._compiled.run_to_file(
+            target_id, os.fspath(output_path), feed_dict or {},
+            _normalize_file_feeds(file_feeds or {}), strategy
+        )
+    
+    def run_to_callback(
+        self,
+        target: Union[Node, str],
+        callback: Callable[[bytes], None],
+        feed_dict: Optional[Dict[str, str]] = None,
+        file_feeds: Optional[Dict[Union[Node, str], Union[str, tuple]]] = None,
+        strategy: str = "recursive"
+    ) -> int:
+        """
+        Execute the graph and pass the target's value to callback in pieces.
+        
+        Pieces are produced like in run_to_file(); callback receives each
+        one as bytes, in order (e.g. a socket's sendall).
+        
+        Returns:
+            Number of bytes passed to callback
+        """
+        target_id = target.id if isinstance(target, Node) else target
+        return self._compiled.run_to_callback(
+            target_id, callback, feed_dict or {},
+            _normalize_file_feeds(file_feeds or {}), strategy
+        )
+    
+    def run_file(
+        self,
+        target: Union[Node, str],
+        input_path: str,
+        output_path: str,
+        bindings: Dict[str, Union[Node, str]],
+        format: str = "lines",
+        strategy: str = "recursive",
+        num_threads: int = 0,
+        skip_errors: bool = False,
+        io: str = "mmap"
+    ) -> Dict[str, float]:
+        """
+        Execute the graph once per record of a file, entirely in C++.
+        
+        The input file is memory-mapped and split into records; each
+        bound column is fed to its placeholder without copying. Results
+        are written to output_path, one line per record, in input order.
+        
+        Args:
+            target: The node to compute for every record
+            input_path: Path of the record file
+            output_path: Path of the result file
+            bindings: Maps a column to a placeholder. Keys are a column
+                     index ("0"), a CSV/TSV header name or JSONL field
+                     name, or "" for the whole record.
+            format: "lines", "csv", "tsv" or "jsonl"
+            strategy: "recursive", "iterative", "parallel" or "auto"
+            num_threads: Worker threads (0 = one per core)
+            skip_errors: Write an empty line for failing records instead of raising
+            io: "mmap" maps the whole input; "auto", "io_uring" or "thread"
+                stream it in blocks, reading ahead and writing results
+                asynchronously while records are computed
+        
+        Returns:
+            Statistics: records, errors, bytes, records_per_second,
+            megabytes_per_second, compute_seconds and, when streaming,
+            io_backend, read/write requests and wait times
+        """
+        target_id = target.id if isinstance(target, Node) else target
+        placeholder_ids = {
+            column: (node.id if isinstance(node, Node) else node)
+            for column, node in bindings.items()
+        }
+        return self._compiled.run_file(
+            target_id, input_path, output_path, placeholder_ids,
+            format, strategy, num_threads, skip_errors, io
+        )
+    
+    def enable_profiling(self, hardware_counters: str = "off") -> bool:
+        """
+        Record the timing of every operation node in subsequent runs.
+        
+        Events accumulate across runs until clear_profile(). Runs of
+        run_file() are not recorded. Profiling adds no overhead while it
+        is disabled.
+        
+        Args:
+            hardware_counters: Also sample cycles, instructions, cache
+                misses and branch misses around each run ("runs") or
+                around each run and each operation ("nodes")
+        
+        Returns:
+            False if hardware counters were requested but the kernel does
+            not permit them; timings are recorded regardless
+        """
+        return self._compiled.enable_profiling(hardware_counters)
+    
+    def disable_profiling(self) -> None:
+        """Stop recording; the events recorded so far are kept."""
+        self._compiled.disable_profiling()
+    
+    def clear_profile(self) -> None:
+        """Drop the recorded events."""
+        self._compiled.clear_profile()
+    
+    def profile_events(self) -> List[dict]:
+        """
+        Recorded node events, ordered by start time.
+        
+        Returns:
+            Dictionaries with node_id, op, start_ns, end_ns, thread,
+            input_bytes, output_bytes, allocations (None unless the
+            process counts allocations) and cycles, instructions,
+            cache_misses, branch_misses (None unless sampled per node)
+        """
+        return self._compiled.profile_events()
+    
+    def profile_runs(self) -> List[dict]:
+        """
+        Recorded executions, in order.
+        
+        Returns:
+            Dictionaries with strategy, start_ns, end_ns and the hardware
+            counters summed over the worker threads (None unless sampled)
+        """
+        return self._compiled.profile_runs()
+    
+    def profile_trace(self, path: Optional[str] = None) -> str:
+        """
+        Recorded events in the Chrome trace-event format.
+        
+        Open the file in chrome://tracing or https://ui.perfetto.dev.
+        
+        Args:
+            path: If given, also write the trace to this file
+        
+        Returns:
+            The trace as a JSON string
+        """
+        trace = self._compiled.profile_trace()
+        if path is not None:
+            with open(path, "w") as f:
+                f.write(trace)
+        return trace
+    
+    def enable_recording(self, recorder, graph_id: str = "") -> None:
+        """
+        Record sampled run() and run_auto() calls to a traffic log.
+        
+        Calls with file_feeds are not recorded. Unsampled calls cost a
+        single branch.
+        
+        Args:
+            recorder: Log from strgraph.traffic_recorder(), may be shared
+            graph_id: Id of this graph in the log (default: the graph name)
+        """
+        self._compiled.enable_recording(recorder, graph_id)
+    
+    def disable_recording(self) -> None:
+        """Stop recording calls."""
+        self._compiled.disable_recording()
+    
+    def enable_flight_recorder(
+        self,
+        threshold_ms: float = 100.0,
+        trace_dir: str = ".",
+        events_per_thread: int = 4096,
+        max_dumps: int = 100,
+    ) -> None:
+        """
+        Keep the latest operations of every run in per-thread ring buffers
+        and write a Chrome trace of each run slower than threshold_ms.
+        
+        The trace (strgraph-slow-<graph>-<pid>-<run>.json) holds the
+        operations of the run, its strategy, latency and feed sizes, and
+        opens in chrome://tracing or Perfetto. Meant to stay enabled in
+        production: fast runs cost one ring write per operation.
+        
+        Args:
+            threshold_ms: Runs taking at least this long are dumped
+            trace_dir: Directory the traces are written to
+            events_per_thread: Ring capacity per worker thread; longer
+                runs keep their latest operations
+            max_dumps: Traces written at most (0 for no limit)
+        """
+        self._compiled.enable_flight_recorder(threshold_ms, trace_dir, events_per_thread, max_dumps)
+    
+    def disable_flight_recorder(self) -> None:
+        """Stop the flight recorder; traces written so far are kept."""
+        self._compiled.disable_flight_recorder()
+    
+    def flight_recorder_dumps(self) -> List[str]:
+        """Paths of the traces written by the flight recorder."""
+        return list(self._compiled.flight_recorder_dumps())
+    
+    def explain(
+        self,
+        target_id: str,
+        inputs: Optional[Dict[str, str]] = None,
+        strategy: str = "auto",
+        analyze: bool = False,
+        format: str = "text",
+    ) -> Union[str, dict]:
+        """
+        Show how a target is computed: the chosen strategy and why, the
+        layers in topological order with estimated costs, and the
+        optimizations that apply.
+        
+        Args:
+            target_id: Node to explain
+            inputs: Placeholder values; sizes the estimates, and are fed
+                to the run when analyze is True
+            strategy: "auto" explains the automatic choice
+            analyze: Also run the plan and annotate every operation with
+                its actual time and bytes (EXPLAIN ANALYZE)
+            format: "text" for a readable report, "json" for a dict
+        
+        Returns:
+            The report as a string, or a dict for format="json"
+        """
+        if format not in ("text", "json"):
+            raise ValueError(f"format must be 'text' or 'json', got {format!r}")
+        report = self._compiled.explain(
+            target_id, inputs or {}, strategy, analyze, format == "json"
+        )
+        return json.loads(report) if format == "json" else report
+    
     def is_valid(self) -> bool:
         """
         Check if the compiled graph is valid and ready for execution.
@@ -473,6 +888,28 @@ class CompiledGraph:
         """
         return self._compiled.is_valid()
     
+    def is_verified(self) -> bool:
+        """
+        Check if the graph passed verification when it was compiled.
+        
+        Verified graphs run on an unchecked fast path. Graphs using custom
+        operations registered without a declared result kind are not
+        verified and run on the checked path.
+        
+        Returns:
+            True if the graph is verified, False otherwise
+        """
+        return self._compiled.is_verified()
+    
+    def verification_error(self) -> str:
+        """
+        Why verification failed.
+        
+        Returns:
+            The first problem found, or an empty string if the graph is verified
+        """
+        return self._compiled.verification_error()
+    
     def __repr__(self) -> str:
         """String representation of the compiled graph."""
         status = "valid" if self.is_valid() else "invalid"
@@ -0,0 +1,164 @@
+"""
+Opt-in latency breakdown of Python calls into the engine.
+
+For small graphs most of the time of a call is spent outside the engine.
+While timing is enabled, every Graph.run() and CompiledGraph.run() call
+is split into phases and aggregated per entry point:
+
+- graph_to_json: building the graph dictionary (Graph.run only)
+- json_dumps: serializing it to JSON text (Graph.run only)
+- argument_conversion: converting the Python arguments to C++
+- gil_handoff: releasing and reacquiring the GIL around the engine
+- json_parse: parsing the JSON text in C++ (Graph.run only)
+- graph_build: building the C++ graph and executor (Graph.run only)
+- execute: computing the target
+- result_conversion: converting the result to a Python string
+- binding_other: the rest of the native call (pybind11 dispatch)
+- python_other: the rest of the Python wrapper
+
+Graph.run() of a graph that was already run with run_optimized() goes
+through its compiled graph and is recorded as CompiledGraph.run.
+
+Example:
+    >>> from strgraph import timing
+    >>> with timing.collect():
+    ...     for _ in range(1000):
+    ...         compiled.run("out", {"x": "hello"})
+    >>> print(timing.summary())
+"""
+
+import time
+from contextlib import contextmanager
+from typing import Dict, Iterator
+
+PHASES = (
+    "graph_to_json",
+    "json_dumps",
+    "argument_conversion",
+    "gil_handoff",
+    "json_parse",
+    "graph_build",
+    "execute",
+    "result_conversion",
+    "binding_other",
+    "python_other",
+)
+
+_enabled = False
+_calls: Dict[str, dict] = {}
+
+
+def enable() -> None:
+    """Start timing calls (adds a few microseconds per call)."""
+    global _enabled
+    _enabled = True
+
+
+def disable() -> None:
+    """Stop timing calls; the collected timings are kept."""
+    global _enabled
+    _enabled = False
+
+
+def is_enabled() -> bool:
+    return _enabled
+
+
+def reset() -> None:
+    """Drop the collected timings."""
+    _calls.clear()
+
+
+@contextmanager
+def collect(reset_first: bool = True) -> Iterator[None]:
+    """Enable timing for the duration of a with block."""
+    if reset_first:
+        reset()
+    was_enabled = _enabled
+    enable()
+    try:
+        yield
+    finally:
+        if not was_enabled:
+            disable()
+
+
+def now() -> int:
+    return time.perf_counter_ns()
+
+
+def record(call: str, phases: Dict[str, int], native_ns: int, total_ns: int) -> None:
+    """
+    Add one call to the aggregate.
+
+    Args:
+        call: Entry point, e.g. "CompiledGraph.run"
+        phases: Nanoseconds per measured phase
+        native_ns: Wall time of the native call, whose unmeasured rest
+            is attributed to binding_other
+        total_ns: Wall time of the whole call, whose unmeasured rest is
+            attributed to python_other
+    """
+    phases = dict(phases)
+    native_phases = sum(
+        ns for name, ns in phases.items() if name not in ("graph_to_json", "json_dumps")
+    )
+    phases["binding_other"] = max(0, native_ns - native_phases)
+    phases["python_other"] = max(0, total_ns - sum(phases.values()))
+
+    entry = _calls.setdefault(call, {"calls": 0, "total_ns": 0, "phases": {}})
+    entry["calls"] += 1
+    entry["total_ns"] += total_ns
+    for name, ns in phases.items():
+        stats = entry["phases"].setdefault(name, {"total_ns": 0, "max_ns": 0})
+        stats["total_ns"] += ns
+        stats["max_ns"] = max(stats["max_ns"], ns)
+
+
+def report() -> Dict[str, dict]:
+    """
+    Aggregated timings per entry point.
+
+    Returns:
+        {call: {"calls", "total_ns", "mean_ns", "engine_share", "phases":
+        {phase: {"total_ns", "mean_ns", "max_ns", "share"}}}}, where
+        share is the fraction of the total time of the entry point and
+        engine_share the share of the execute phase
+    """
+    result = {}
+    for call, entry in _calls.items():
+        calls = entry["calls"]
+        total = entry["total_ns"] or 1
+        phases = {}
+        for name in PHASES:
+            if name in entry["phases"]:
+                stats = entry["phases"][name]
+                phases[name] = {
+                    "total_ns": stats["total_ns"],
+                    "mean_ns": stats["total_ns"] / calls,
+                    "max_ns": stats["max_ns"],
+                    "share": stats["total_ns"] / total,
+                }
+        result[call] = {
+            "calls": calls,
+            "total_ns": entry["total_ns"],
+            "mean_ns": entry["total_ns"] / calls,
+            "engine_share": phases.get("execute", {}).get("share", 0.0),
+            "phases": phases,
+        }
+    return result
+
+
+def summary() -> str:
+    """report() as a table of mean microseconds and shares per phase."""
+    lines = []
+    for call, entry in report().items():
+        lines.append(
+            f"{call}: {entry['calls']} calls, {entry['mean_ns'] / 1000:.2f} us/call, "
+            f"{entry['engine_share']:.0%} in the engine"
+        )
+        for name, stats in entry["phases"].items():
+            lines.append(
+                f"  {name:<20} {stats['mean_ns'] / 1000:>10.2f} us {stats['share']:>7.1%}"
+            )
+    return "\n".join(lines)
@@ -0,0 +1,100 @@
+/**
+ * @file alloc_hooks.cpp
+ * @brief Counting replacements of the global operator new/delete.
+ *
+ * Built as the strgraph_alloc_hooks object library and linked only into
+ * executables that want allocation statistics (tests, benchmarks); the
+ * library itself never replaces the global allocator. Sizes are the
+ * usable sizes reported by malloc, so frees need no size header.
+ */
+#include "strgraph/alloc_tracking.h"
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+
+namespace {
+
+namespace tracking = strgraph::alloc_tracking::detail;
+
+void* allocate(std::size_t size) noexcept {
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr != nullptr) {
+        tracking::on_allocate(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* allocate_aligned(std::size_t size, std::align_val_t alignment) noexcept {
+    auto align = static_cast<std::size_t>(alignment);
+    // aligned_alloc() requires a multiple of the alignment
+    size = (size == 0 ? align : (size + align - 1) / align * align);
+    void* ptr = std::aligned_alloc(align, size);
+    if (ptr != nullptr) {
+        tracking::on_allocate(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void deallocate(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        tracking::on_deallocate(malloc_usable_size(ptr));
+        std::free(ptr);
+    }
+}
+
+[[maybe_unused]] const bool installed = (tracking::mark_installed(), true);
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    void* ptr = allocate(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* ptr = allocate_aligned(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { deallocate(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { deallocate(ptr); }
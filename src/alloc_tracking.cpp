@@ -0,0 +1,60 @@
+#include "strgraph/alloc_tracking.h"
+#include <atomic>
+
+namespace strgraph::alloc_tracking {
+
+namespace {
+
+// Constant-initialized, so usable by allocations made before main()
+thread_local AllocCounters thread_state;
+std::atomic<int64_t> live{0};
+std::atomic<int64_t> peak{0};
+std::atomic<bool> hooks_installed{false};
+
+} // anonymous namespace
+
+bool installed() noexcept {
+    return hooks_installed.load(std::memory_order_relaxed);
+}
+
+AllocCounters thread_counters() noexcept {
+    return thread_state;
+}
+
+int64_t live_bytes() noexcept {
+    return live.load(std::memory_order_relaxed);
+}
+
+int64_t peak_live_bytes() noexcept {
+    return peak.load(std::memory_order_relaxed);
+}
+
+void reset_peak() noexcept {
+    peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+namespace detail {
+
+void on_allocate(size_t bytes) noexcept {
+    ++thread_state.allocations;
+    thread_state.allocated_bytes += bytes;
+
+    int64_t now = live.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed)
+                  + static_cast<int64_t>(bytes);
+    int64_t highest = peak.load(std::memory_order_relaxed);
+    while (now > highest && !peak.compare_exchange_weak(highest, now, std::memory_order_relaxed)) {
+    }
+}
+
+void on_deallocate(size_t bytes) noexcept {
+    ++thread_state.deallocations;
+    live.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+void mark_installed() noexcept {
+    hooks_installed.store(true, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+} // namespace strgraph::alloc_tracking
@@ -0,0 +1,798 @@
+#include "strgraph/async_io.h"
+#include <stdexcept>
+#include <format>
+#include <cstring>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define STRGRAPH_HAVE_IO_URING 1
+#endif
+
+namespace {
+
+using strgraph::IoBackend;
+
+/**
+ * @brief Largest request size (io_uring lengths are 32-bit).
+ */
+constexpr size_t MAX_BLOCK_SIZE = size_t{1} << 30;
+
+constexpr size_t BUFFER_ALIGNMENT = 4096;
+
+/**
+ * @brief One read or write of a buffer slot.
+ */
+struct IoRequest {
+    size_t slot;
+    char* data;
+    size_t length;
+    int64_t offset;    ///< -1 = current file position (pipes)
+    bool write;
+};
+
+struct IoCompletion {
+    size_t slot;
+    int64_t result;    ///< Bytes transferred, or -errno
+};
+
+/**
+ * @brief Submits requests and waits for their completions.
+ */
+class IoEngine {
+public:
+    virtual ~IoEngine() = default;
+    virtual void submit(const IoRequest& request) = 0;
+    virtual IoCompletion wait() = 0;
+};
+
+/**
+ * @brief Fallback engine: blocking pread/pwrite on a background thread.
+ *
+ * Requests are served in submission order.
+ */
+class ThreadEngine final : public IoEngine {
+public:
+    explicit ThreadEngine(int fd) : fd_(fd), thread_([this] { loop(); }) {}
+
+    ~ThreadEngine() override {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        request_cv_.notify_all();
+        thread_.join();
+    }
+
+    void submit(const IoRequest& request) override {
+        {
+            std::lock_guard lock(mutex_);
+            pending_.push_back(request);
+        }
+        request_cv_.notify_all();
+    }
+
+    IoCompletion wait() override {
+        std::unique_lock lock(mutex_);
+        completion_cv_.wait(lock, [this] { return !completed_.empty(); });
+        IoCompletion completion = completed_.front();
+        completed_.pop_front();
+        return completion;
+    }
+
+private:
+    void loop() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            request_cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+            if (pending_.empty()) {
+                return;
+            }
+            IoRequest request = pending_.front();
+            pending_.pop_front();
+            lock.unlock();
+
+            ssize_t n;
+            if (request.write) {
+                n = request.offset < 0
+                    ? ::write(fd_, request.data, request.length)
+                    : ::pwrite(fd_, request.data, request.length, static_cast<off_t>(request.offset));
+            } else {
+                n = request.offset < 0
+                    ? ::read(fd_, request.data, request.length)
+                    : ::pread(fd_, request.data, request.length, static_cast<off_t>(request.offset));
+            }
+            int64_t result = n < 0 ? -static_cast<int64_t>(errno) : static_cast<int64_t>(n);
+
+            lock.lock();
+            completed_.push_back({request.slot, result});
+            completion_cv_.notify_all();
+        }
+    }
+
+    int fd_;
+    std::mutex mutex_;
+    std::condition_variable request_cv_;
+    std::condition_variable completion_cv_;
+    std::deque<IoRequest> pending_;
+    std::deque<IoCompletion> completed_;
+    bool stop_ = false;
+
+    // Started last, once the members it uses are initialized
+    std::thread thread_;
+};
+
+#ifdef STRGRAPH_HAVE_IO_URING
+
+int uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                                      flags, nullptr, 0));
+}
+
+int uring_register(int ring_fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, ring_fd, opcode, arg, count));
+}
+
+/**
+ * @brief io_uring engine driven through the raw system calls.
+ *
+ * The slot buffers are registered with the ring so requests use the
+ * READ_FIXED/WRITE_FIXED opcodes and skip per-request page pinning. If
+ * registration is refused (e.g. RLIMIT_MEMLOCK), plain READ/WRITE is used.
+ */
+class UringEngine final : public IoEngine {
+public:
+    UringEngine(int fd, unsigned entries, std::span<const iovec> buffers) : fd_(fd) {
+        io_uring_params params{};
+        ring_fd_ = uring_setup(entries, &params);
+        if (ring_fd_ < 0) {
+            throw std::runtime_error(std::format("io_uring_setup failed: {}", std::strerror(errno)));
+        }
+        try {
+            map_rings(params);
+        } catch (...) {
+            release();
+            throw;
+        }
+
+        fixed_ = uring_register(ring_fd_, IORING_REGISTER_BUFFERS, buffers.data(),
+                                static_cast<unsigned>(buffers.size())) == 0;
+    }
+
+    ~UringEngine() override {
+        release();
+    }
+
+    UringEngine(const UringEngine&) = delete;
+    UringEngine& operator=(const UringEngine&) = delete;
+
+    void submit(const IoRequest& request) override {
+        // Only this thread produces submissions, so the tail needs no atomic read
+        unsigned tail = *sq_tail_;
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        if (fixed_) {
+            sqe.opcode = request.write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe.buf_index = static_cast<uint16_t>(request.slot);
+        } else {
+            sqe.opcode = request.write ? IORING_OP_WRITE : IORING_OP_READ;
+        }
+        sqe.fd = fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(request.data);
+        sqe.len = static_cast<uint32_t>(request.length);
+        sqe.off = static_cast<uint64_t>(request.offset);
+        sqe.user_data = request.slot;
+        sq_array_[index] = index;
+        __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+
+        int ret;
+        do {
+            ret = uring_enter(ring_fd_, 1, 0, 0);
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 0) {
+            throw std::runtime_error(std::format("io_uring_enter failed: {}", std::strerror(errno)));
+        }
+    }
+
+    IoCompletion wait() override {
+        while (true) {
+            unsigned head = *cq_head_;
+            if (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                IoCompletion completion{static_cast<size_t>(cqe.user_data), cqe.res};
+                __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+                return completion;
+            }
+            if (uring_enter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                throw std::runtime_error(std::format("io_uring_enter failed: {}", std::strerror(errno)));
+            }
+        }
+    }
+
+private:
+    void release() noexcept {
+        if (sqes_) ::munmap(sqes_, sqes_size_);
+        if (cq_ring_ && cq_ring_ != sq_ring_) ::munmap(cq_ring_, cq_size_);
+        if (sq_ring_) ::munmap(sq_ring_, sq_size_);
+        if (ring_fd_ >= 0) ::close(ring_fd_);
+    }
+
+    void* map(size_t size, off_t offset) {
+        void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ring_fd_, offset);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error(std::format("Cannot map io_uring ring: {}", std::strerror(errno)));
+        }
+        return ptr;
+    }
+
+    void map_rings(const io_uring_params& params) {
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+        }
+
+        sq_ring_ = map(sq_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap ? sq_ring_ : map(cq_size_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+
+        auto* sq = static_cast<char*>(sq_ring_);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* cq = static_cast<char*>(cq_ring_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    int fd_;
+    int ring_fd_ = -1;
+    bool fixed_ = false;
+
+    void* sq_ring_ = nullptr;
+    void* cq_ring_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned* sq_array_ = nullptr;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+#endif // STRGRAPH_HAVE_IO_URING
+
+/**
+ * @brief Create the engine for a backend, falling back from AUTO to THREAD.
+ *
+ * @param chosen Receives the backend actually used
+ */
+std::unique_ptr<IoEngine> make_engine(IoBackend backend, int fd, std::span<const iovec> buffers,
+                                      IoBackend& chosen) {
+    if (backend != IoBackend::THREAD) {
+#ifdef STRGRAPH_HAVE_IO_URING
+        try {
+            auto engine = std::make_unique<UringEngine>(fd, static_cast<unsigned>(buffers.size()), buffers);
+            chosen = IoBackend::IO_URING;
+            return engine;
+        } catch (const std::runtime_error&) {
+            if (backend == IoBackend::IO_URING) {
+                throw;
+            }
+        }
+#else
+        if (backend == IoBackend::IO_URING) {
+            throw std::runtime_error("io_uring is not supported on this platform");
+        }
+#endif
+    }
+    chosen = IoBackend::THREAD;
+    return std::make_unique<ThreadEngine>(fd);
+}
+
+struct FreeDeleter {
+    void operator()(char* ptr) const noexcept { std::free(ptr); }
+};
+
+using AlignedBuffer = std::unique_ptr<char, FreeDeleter>;
+
+AlignedBuffer allocate_buffer(size_t size) {
+    size_t rounded = (size + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+    auto* ptr = static_cast<char*>(std::aligned_alloc(BUFFER_ALIGNMENT, rounded));
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return AlignedBuffer(ptr);
+}
+
+void check_options(const strgraph::AsyncIoOptions& options) {
+    if (options.block_size == 0 || options.block_size > MAX_BLOCK_SIZE) {
+        throw std::runtime_error(std::format(
+            "AsyncIoOptions::block_size must be between 1 and {} bytes", MAX_BLOCK_SIZE));
+    }
+    if (options.queue_depth == 0 || options.queue_depth > 1024) {
+        throw std::runtime_error("AsyncIoOptions::queue_depth must be between 1 and 1024");
+    }
+}
+
+bool is_retryable(int64_t result) {
+    return result == -EINTR || result == -EAGAIN;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // anonymous namespace
+
+namespace strgraph {
+
+std::string_view io_backend_name(IoBackend backend) {
+    switch (backend) {
+        case IoBackend::AUTO: return "auto";
+        case IoBackend::IO_URING: return "io_uring";
+        case IoBackend::THREAD: return "thread";
+    }
+    return "unknown";
+}
+
+IoBackend parse_io_backend(std::string_view name) {
+    if (name == "auto") return IoBackend::AUTO;
+    if (name == "io_uring" || name == "uring") return IoBackend::IO_URING;
+    if (name == "thread") return IoBackend::THREAD;
+    throw std::runtime_error(std::format(
+        "Unknown I/O backend '{}' (expected auto, io_uring or thread)", name));
+}
+
+bool io_uring_available() {
+#ifdef STRGRAPH_HAVE_IO_URING
+    static const bool available = [] {
+        io_uring_params params{};
+        int ring_fd = uring_setup(1, &params);
+        if (ring_fd < 0) {
+            return false;
+        }
+        ::close(ring_fd);
+        return true;
+    }();
+    return available;
+#else
+    return false;
+#endif
+}
+
+// ============================================================================
+// AsyncFileReader
+// ============================================================================
+
+struct AsyncFileReader::Impl {
+    struct Slot {
+        char* buffer = nullptr;
+        size_t seq = 0;          ///< Block number being read into the slot
+        size_t requested = 0;
+        size_t filled = 0;
+        bool ready = false;
+    };
+
+    std::string path;
+    int fd = -1;
+    size_t file_size = 0;
+    size_t block_size = 0;
+    size_t headroom = 0;
+    size_t total_blocks = 0;
+    size_t next_seq = 0;
+    size_t in_flight = 0;
+
+    std::vector<AlignedBuffer> buffers;
+    std::vector<Slot> slots;
+    std::unique_ptr<IoEngine> engine;
+    IoStats stats;
+
+    ~Impl() {
+        // The kernel may still write into the buffers until the reads complete
+        while (engine && in_flight > 0) {
+            try {
+                engine->wait();
+            } catch (...) {
+                break;
+            }
+            --in_flight;
+        }
+        engine.reset();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    void issue(size_t slot, size_t seq) {
+        Slot& s = slots[slot];
+        s.seq = seq;
+        s.requested = std::min(block_size, file_size - seq * block_size);
+        s.filled = 0;
+        s.ready = false;
+        submit_remaining(slot);
+    }
+
+    void submit_remaining(size_t slot) {
+        Slot& s = slots[slot];
+        engine->submit({slot, s.buffer + headroom + s.filled, s.requested - s.filled,
+                        static_cast<int64_t>(s.seq * block_size + s.filled), false});
+        ++in_flight;
+        ++stats.requests;
+    }
+
+    void complete(const IoCompletion& completion) {
+        --in_flight;
+        Slot& s = slots[completion.slot];
+        if (is_retryable(completion.result)) {
+            submit_remaining(completion.slot);
+            return;
+        }
+        if (completion.result < 0) {
+            throw std::runtime_error(std::format(
+                "Cannot read '{}': {}", path, std::strerror(static_cast<int>(-completion.result))));
+        }
+        s.filled += static_cast<size_t>(completion.result);
+        stats.bytes += static_cast<size_t>(completion.result);
+
+        // Short reads are continued; a zero-byte read means the file shrank
+        if (completion.result > 0 && s.filled < s.requested) {
+            submit_remaining(completion.slot);
+            return;
+        }
+        s.ready = true;
+    }
+};
+
+AsyncFileReader::AsyncFileReader(const std::string& path, const AsyncIoOptions& options)
+    : impl_(std::make_unique<Impl>()) {
+    check_options(options);
+    Impl& impl = *impl_;
+    impl.path = path;
+    impl.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (impl.fd < 0) {
+        throw std::runtime_error(std::format("Cannot open '{}': {}", path, std::strerror(errno)));
+    }
+    struct stat st{};
+    if (::fstat(impl.fd, &st) != 0) {
+        throw std::runtime_error(std::format("Cannot stat '{}': {}", path, std::strerror(errno)));
+    }
+    ::posix_fadvise(impl.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    impl.file_size = static_cast<size_t>(st.st_size);
+    impl.block_size = options.block_size;
+    impl.headroom = (options.headroom + BUFFER_ALIGNMENT - 1) / BUFFER_ALIGNMENT * BUFFER_ALIGNMENT;
+    impl.total_blocks = (impl.file_size + impl.block_size - 1) / impl.block_size;
+
+    std::vector<iovec> iovecs;
+    for (size_t i = 0; i < options.queue_depth; ++i) {
+        impl.buffers.push_back(allocate_buffer(impl.headroom + impl.block_size));
+        impl.slots.push_back({impl.buffers.back().get()});
+        iovecs.push_back({impl.buffers.back().get(), impl.headroom + impl.block_size});
+    }
+    impl.engine = make_engine(options.backend, impl.fd, iovecs, impl.stats.backend);
+
+    for (size_t i = 0; i < std::min(impl.slots.size(), impl.total_blocks); ++i) {
+        impl.issue(i, i);
+    }
+}
+
+AsyncFileReader::~AsyncFileReader() = default;
+
+std::optional<ReadBlock> AsyncFileReader::next() {
+    Impl& impl = *impl_;
+    if (impl.next_seq >= impl.total_blocks) {
+        return std::nullopt;
+    }
+
+    size_t slot = impl.next_seq % impl.slots.size();
+    if (!impl.slots[slot].ready) {
+        auto start = std::chrono::steady_clock::now();
+        while (!impl.slots[slot].ready) {
+            impl.complete(impl.engine->wait());
+        }
+        impl.stats.wait_seconds += seconds_since(start);
+    }
+
+    const Impl::Slot& s = impl.slots[slot];
+    ReadBlock block{s.buffer + impl.headroom, s.filled, impl.headroom, false, slot};
+    if (s.filled < s.requested) {
+        impl.total_blocks = impl.next_seq + 1;
+    }
+    block.last = impl.next_seq + 1 >= impl.total_blocks;
+    ++impl.next_seq;
+    return block;
+}
+
+void AsyncFileReader::release(const ReadBlock& block) {
+    Impl& impl = *impl_;
+    Impl::Slot& s = impl.slots.at(block.slot);
+    s.ready = false;
+    size_t seq = s.seq + impl.slots.size();
+    if (seq < impl.total_blocks) {
+        impl.issue(block.slot, seq);
+    }
+}
+
+size_t AsyncFileReader::file_size() const noexcept {
+    return impl_->file_size;
+}
+
+const IoStats& AsyncFileReader::stats() const noexcept {
+    return impl_->stats;
+}
+
+// ============================================================================
+// AsyncFileWriter
+// ============================================================================
+
+struct AsyncFileWriter::Impl {
+    struct Slot {
+        char* buffer = nullptr;
+        size_t length = 0;
+        size_t written = 0;
+        int64_t offset = -1;
+        bool busy = false;
+    };
+
+    std::string name;
+    int fd = -1;
+    bool owns_fd = false;
+
+    /**
+     * @brief Whether writes go to explicit offsets (regular files without O_APPEND).
+     */
+    bool positioned = false;
+    int64_t offset = 0;
+    size_t block_size = 0;
+    size_t max_in_flight = 1;
+    size_t in_flight = 0;
+    size_t current = 0;
+    bool closed = false;
+    std::string error;
+
+    std::vector<AlignedBuffer> buffers;
+    std::vector<Slot> slots;
+    std::unique_ptr<IoEngine> engine;
+    IoStats stats;
+
+    ~Impl() {
+        while (engine && in_flight > 0) {
+            try {
+                engine->wait();
+            } catch (...) {
+                break;
+            }
+            --in_flight;
+        }
+        engine.reset();
+        if (owns_fd && fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    void init(const AsyncIoOptions& options) {
+        struct stat st{};
+        int flags = ::fcntl(fd, F_GETFL);
+        positioned = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            flags >= 0 && !(flags & O_APPEND);
+        if (positioned) {
+            offset = ::lseek(fd, 0, SEEK_CUR);
+        }
+        // Pipes only keep their order with one write at a time
+        max_in_flight = positioned ? options.queue_depth : 1;
+        block_size = options.block_size;
+
+        // One buffer is always being filled
+        std::vector<iovec> iovecs;
+        for (size_t i = 0; i < options.queue_depth + 1; ++i) {
+            buffers.push_back(allocate_buffer(block_size));
+            slots.push_back({buffers.back().get()});
+            iovecs.push_back({buffers.back().get(), block_size});
+        }
+        engine = make_engine(options.backend, fd, iovecs, stats.backend);
+    }
+
+    void submit(size_t slot, size_t length) {
+        Slot& s = slots[slot];
+        s.length = length;
+        s.written = 0;
+        s.offset = positioned ? offset : -1;
+        s.busy = true;
+        offset += static_cast<int64_t>(length);
+        submit_remaining(slot);
+    }
+
+    void submit_remaining(size_t slot) {
+        Slot& s = slots[slot];
+        int64_t at = s.offset < 0 ? -1 : s.offset + static_cast<int64_t>(s.written);
+        engine->submit({slot, s.buffer + s.written, s.length - s.written, at, true});
+        ++in_flight;
+        ++stats.requests;
+    }
+
+    void complete(const IoCompletion& completion) {
+        --in_flight;
+        Slot& s = slots[completion.slot];
+        if (is_retryable(completion.result)) {
+            submit_remaining(completion.slot);
+            return;
+        }
+        if (completion.result <= 0) {
+            if (error.empty()) {
+                error = std::format("Cannot write '{}': {}", name, completion.result < 0
+                    ? std::strerror(static_cast<int>(-completion.result)) : "no progress");
+            }
+            s.busy = false;
+            return;
+        }
+        s.written += static_cast<size_t>(completion.result);
+        stats.bytes += static_cast<size_t>(completion.result);
+        if (s.written < s.length) {
+            submit_remaining(completion.slot);
+            return;
+        }
+        s.busy = false;
+    }
+
+    void wait_one() {
+        auto start = std::chrono::steady_clock::now();
+        complete(engine->wait());
+        stats.wait_seconds += seconds_since(start);
+    }
+
+    /**
+     * @brief Pick a free buffer to fill next, waiting for writes if necessary.
+     */
+    size_t acquire() {
+        while (true) {
+            if (in_flight < max_in_flight) {
+                for (size_t i = 0; i < slots.size(); ++i) {
+                    if (!slots[i].busy) {
+                        return i;
+                    }
+                }
+            }
+            wait_one();
+        }
+    }
+
+    void wait_all() {
+        while (in_flight > 0) {
+            wait_one();
+        }
+    }
+};
+
+AsyncFileWriter::AsyncFileWriter(const std::string& path, const AsyncIoOptions& options)
+    : impl_(std::make_unique<Impl>()) {
+    check_options(options);
+    impl_->name = path;
+    impl_->fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (impl_->fd < 0) {
+        throw std::runtime_error(std::format("Cannot create '{}': {}", path, std::strerror(errno)));
+    }
+    impl_->owns_fd = true;
+    impl_->init(options);
+    setp(impl_->slots[0].buffer, impl_->slots[0].buffer + impl_->block_size);
+}
+
+AsyncFileWriter::AsyncFileWriter(int fd, const AsyncIoOptions& options)
+    : impl_(std::make_unique<Impl>()) {
+    check_options(options);
+    impl_->name = std::format("fd {}", fd);
+    impl_->fd = fd;
+    impl_->init(options);
+    setp(impl_->slots[0].buffer, impl_->slots[0].buffer + impl_->block_size);
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Errors are only reported by an explicit close()
+    }
+}
+
+AsyncFileWriter::int_type AsyncFileWriter::overflow(int_type ch) {
+    Impl& impl = *impl_;
+    if (impl.closed || !impl.error.empty()) {
+        return traits_type::eof();
+    }
+    try {
+        size_t used = static_cast<size_t>(pptr() - pbase());
+        if (used > 0) {
+            impl.submit(impl.current, used);
+            impl.current = impl.acquire();
+            char* buffer = impl.slots[impl.current].buffer;
+            setp(buffer, buffer + impl.block_size);
+        }
+    } catch (const std::exception& e) {
+        impl.error = e.what();
+    }
+    if (!impl.error.empty()) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int AsyncFileWriter::sync() {
+    Impl& impl = *impl_;
+    if (impl.closed) {
+        return impl.error.empty() ? 0 : -1;
+    }
+    if (traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+        return -1;
+    }
+    try {
+        impl.wait_all();
+    } catch (const std::exception& e) {
+        impl.error = e.what();
+    }
+    return impl.error.empty() ? 0 : -1;
+}
+
+void AsyncFileWriter::close() {
+    Impl& impl = *impl_;
+    if (impl.closed) {
+        return;
+    }
+    sync();
+    impl.closed = true;
+    setp(nullptr, nullptr);
+
+    if (impl.owns_fd) {
+        if (::close(impl.fd) != 0 && impl.error.empty()) {
+            impl.error = std::format("Cannot close '{}': {}", impl.name, std::strerror(errno));
+        }
+        impl.fd = -1;
+    } else if (impl.positioned) {
+        // Positioned writes do not move the file offset of a borrowed descriptor
+        ::lseek(impl.fd, static_cast<off_t>(impl.offset), SEEK_SET);
+    }
+    if (!impl.error.empty()) {
+        throw std::runtime_error(impl.error);
+    }
+}
+
+const IoStats& AsyncFileWriter::stats() const noexcept {
+    return impl_->stats;
+}
+
+} // namespace strgraph
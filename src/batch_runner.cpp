@@ -0,0 +1,295 @@
+#include "strgraph/batch_runner.h"
+#include <stdexcept>
+#include <format>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+size_t default_thread_count() {
+#ifdef USE_OPENMP
+    return static_cast<size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+
+} // anonymous namespace
+
+namespace strgraph {
+
+/**
+ * @brief Per-thread execution state.
+ */
+struct BatchRunner::Worker {
+    explicit Worker(const Graph& graph, size_t binding_count)
+        : graph(std::make_unique<Graph>(graph)), executor(*this->graph), scratch(binding_count) {}
+
+    std::unique_ptr<Graph> graph;
+    Executor executor;
+    FeedViewDict feed_views;
+    std::vector<FieldView> fields;
+    std::vector<std::optional<FieldView>> json_fields;
+
+    /**
+     * @brief Decode buffers for escaped fields, one per binding.
+     */
+    std::vector<std::string> scratch;
+};
+
+double BatchStats::records_per_second() const {
+    return elapsed_seconds > 0.0 ? static_cast<double>(records) / elapsed_seconds : 0.0;
+}
+
+double BatchStats::megabytes_per_second() const {
+    return elapsed_seconds > 0.0
+        ? static_cast<double>(input_bytes) / (1024.0 * 1024.0) / elapsed_seconds
+        : 0.0;
+}
+
+BatchRunner::BatchRunner(const Graph& graph, BatchOptions options)
+    : options_(std::move(options)),
+      reader_(options_.format, options_.column_delimiter, options_.record_delimiter) {
+    const bool jsonl = options_.format == RecordFormat::JSONL;
+    const bool header = has_header_row();
+
+    for (const auto& binding : options_.bindings) {
+        auto it = graph.get_nodes().find(binding.placeholder_id);
+        if (it == graph.get_nodes().end() || it->second.type != NodeType::PLACEHOLDER) {
+            throw std::runtime_error(std::format(
+                "Binding target '{}' is not a PLACEHOLDER node", binding.placeholder_id));
+        }
+
+        if (jsonl) {
+            if (binding.column_name.empty() && binding.column != ColumnBinding::WHOLE_RECORD) {
+                throw std::runtime_error(std::format(
+                    "Binding '{}': JSONL fields must be selected by name", binding.placeholder_id));
+            }
+        } else if (!binding.column_name.empty()) {
+            if (!header) {
+                throw std::runtime_error(std::format(
+                    "Binding '{}' selects column '{}' by name, but the input has no header",
+                    binding.placeholder_id, binding.column_name));
+            }
+            split_fields_ = true;
+        } else if (binding.column != ColumnBinding::WHOLE_RECORD) {
+            if (options_.format == RecordFormat::LINES && !options_.column_delimiter) {
+                throw std::runtime_error(std::format(
+                    "Binding '{}' uses column {} but no column delimiter is set",
+                    binding.placeholder_id, binding.column));
+            }
+            split_fields_ = true;
+        }
+
+        binding_columns_.push_back(binding.column);
+        binding_names_.push_back(binding.column_name);
+    }
+    if (options_.chunk_records == 0) {
+        throw std::runtime_error("BatchOptions::chunk_records must be positive");
+    }
+
+    size_t threads = options_.num_threads ? options_.num_threads : default_thread_count();
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.push_back(std::make_unique<Worker>(graph, options_.bindings.size()));
+    }
+    // Every record runs the same plan: verify it once per copy so records
+    // take the unchecked path. A graph that fails runs checked.
+    try {
+        for (auto& worker : workers_) {
+            worker->executor.verify();
+        }
+    } catch (const std::exception&) {
+        for (auto& worker : workers_) {
+            worker->executor.clear_verification();
+        }
+    }
+}
+
+BatchRunner::~BatchRunner() = default;
+
+void BatchRunner::resolve_header(std::string_view header) {
+    auto columns = reader_.parse_header(header);
+    for (size_t i = 0; i < options_.bindings.size(); ++i) {
+        const auto& name = options_.bindings[i].column_name;
+        if (name.empty()) {
+            continue;
+        }
+        auto it = std::find(columns.begin(), columns.end(), name);
+        if (it == columns.end()) {
+            throw std::runtime_error(std::format(
+                "Column '{}' (bound to '{}') not found in header", name,
+                options_.bindings[i].placeholder_id));
+        }
+        binding_columns_[i] = static_cast<size_t>(it - columns.begin());
+    }
+}
+
+bool BatchRunner::has_header_row() const {
+    return options_.has_header &&
+        (options_.format == RecordFormat::CSV || options_.format == RecordFormat::TSV);
+}
+
+void BatchRunner::process_record(Worker& worker, std::string_view record, std::string& result) {
+    const size_t binding_count = options_.bindings.size();
+
+    if (options_.format == RecordFormat::JSONL) {
+        reader_.find_json_fields(record, binding_names_, worker.json_fields);
+    } else if (split_fields_) {
+        reader_.split_fields(record, worker.fields);
+    }
+
+    for (size_t i = 0; i < binding_count; ++i) {
+        std::string_view value;
+        if (options_.format == RecordFormat::JSONL) {
+            if (binding_names_[i].empty()) {
+                value = record;
+            } else if (worker.json_fields[i]) {
+                value = worker.json_fields[i]->value(worker.scratch[i]);
+            } else {
+                throw std::runtime_error(std::format(
+                    "Record has no field '{}' to bind to '{}'",
+                    binding_names_[i], options_.bindings[i].placeholder_id));
+            }
+        } else if (binding_columns_[i] == ColumnBinding::WHOLE_RECORD) {
+            value = record;
+        } else if (binding_columns_[i] < worker.fields.size()) {
+            value = worker.fields[binding_columns_[i]].value(worker.scratch[i]);
+        } else {
+            throw std::runtime_error(std::format(
+                "Record has {} columns, cannot bind column {} to '{}'",
+                worker.fields.size(), binding_columns_[i], options_.bindings[i].placeholder_id));
+        }
+        worker.feed_views[options_.bindings[i].placeholder_id] = value;
+    }
+
+    result = worker.executor.compute_with_strategy(
+        options_.strategy, options_.target_node_id, worker.feed_views);
+}
+
+size_t BatchRunner::process_segment(std::string_view segment, bool final_segment,
+                                    bool& header_pending, std::ostream& output,
+                                    BatchStats& stats) {
+    auto& records = records_;
+    auto& results = results_;
+    auto& failed = failed_;
+    std::atomic<size_t> errors{0};
+
+    size_t pos = 0;
+    if (header_pending) {
+        pos = reader_.scan_records(segment, 0, 1, records, final_segment);
+        if (records.empty()) {
+            return 0;
+        }
+        resolve_header(records[0]);
+        header_pending = false;
+    }
+
+    while (pos < segment.size()) {
+        pos = reader_.scan_records(segment, pos, options_.chunk_records, records, final_segment);
+        if (records.empty()) {
+            break;
+        }
+        results.resize(records.size());
+        failed.assign(records.size(), 0);
+
+        auto compute_start = std::chrono::steady_clock::now();
+        const long long count = static_cast<long long>(records.size());
+#ifdef USE_OPENMP
+        #pragma omp parallel for num_threads(static_cast<int>(workers_.size())) schedule(dynamic, 64)
+#endif
+        for (long long i = 0; i < count; ++i) {
+#ifdef USE_OPENMP
+            Worker& worker = *workers_[static_cast<size_t>(omp_get_thread_num())];
+#else
+            Worker& worker = *workers_[0];
+#endif
+            try {
+                process_record(worker, records[i], results[i]);
+            } catch (const std::exception& e) {
+                // Exceptions must not escape the parallel region
+                results[i] = e.what();
+                failed[i] = 1;
+                errors.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        stats.compute_seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - compute_start).count();
+        // Counted before a failing record is rethrown below
+        stats.errors += errors.exchange(0, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < records.size(); ++i) {
+            if (failed[i]) {
+                if (!options_.skip_errors) {
+                    throw std::runtime_error(std::format(
+                        "Record {} failed: {}", stats.records + i, results[i]));
+                }
+                results[i].clear();
+            }
+            output.write(results[i].data(), static_cast<std::streamsize>(results[i].size()));
+            output.put(options_.record_delimiter);
+            stats.output_bytes += results[i].size() + 1;
+        }
+        stats.records += records.size();
+    }
+    return pos;
+}
+
+BatchStats BatchRunner::run(std::string_view input, std::ostream& output) {
+    BatchStats stats;
+    stats.input_bytes = input.size();
+    auto start = std::chrono::steady_clock::now();
+
+    bool header_pending = has_header_row();
+    process_segment(input, true, header_pending, output, stats);
+
+    output.flush();
+    stats.elapsed_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+BatchStats BatchRunner::run(AsyncFileReader& input, std::ostream& output) {
+    BatchStats stats;
+    stats.input_bytes = input.file_size();
+    auto start = std::chrono::steady_clock::now();
+
+    bool header_pending = has_header_row();
+    std::string carry;     // incomplete record at the end of the previous block
+    std::string joined;    // carry and block, when carry exceeds the headroom
+
+    while (auto block = input.next()) {
+        std::string_view segment(block->data, block->size);
+        if (carry.size() > block->headroom) {
+            joined.assign(carry);
+            joined.append(segment);
+            segment = joined;
+        } else if (!carry.empty()) {
+            char* begin = block->data - carry.size();
+            std::memcpy(begin, carry.data(), carry.size());
+            segment = std::string_view(begin, carry.size() + block->size);
+        }
+
+        try {
+            size_t consumed = process_segment(segment, block->last, header_pending, output, stats);
+            carry.assign(segment.substr(consumed));
+        } catch (...) {
+            input.release(*block);
+            throw;
+        }
+        input.release(*block);
+    }
+
+    output.flush();
+    stats.elapsed_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+} // namespace strgraph
@@ -2,6 +2,7 @@
 #include "strgraph/graph.h"
 #include "strgraph/executor.h"
 #include <json.hpp>
+#include <algorithm>
 
 namespace strgraph {
 
@@ -15,18 +16,32 @@ CompiledGraph::CompiledGraph(std::unique_ptr<Graph> graph)
             valid_ = false;
         }
     }
+    verify();
 }
 
 CompiledGraph::CompiledGraph(std::string_view json_data) 
     : valid_(false) {
     try {
-        auto json = nlohmann::json::parse(json_data);
-        graph_ = Graph::from_json(json);
+        graph_ = Graph::from_json_text(json_data);
         executor_ = std::make_unique<Executor>(*graph_);
         valid_ = true;
     } catch (const std::exception&) {
         valid_ = false;
     }
+    verify();
+}
+
+void CompiledGraph::verify() {
+    if (!valid_ || !executor_) {
+        return;
+    }
+    try {
+        executor_->verify();
+        verification_error_.clear();
+    } catch (const std::exception& e) {
+        // Still runnable: the checked path reports the problem when a run reaches it
+        verification_error_ = e.what();
+    }
 }
 
 std::string CompiledGraph::run(const std::string& target_node_id,
@@ -34,6 +49,9 @@ std::string CompiledGraph::run(const std::string& target_node_id,
     if (!valid_ || !executor_) {
         throw std::runtime_error("CompiledGraph is not valid");
     }
+    if (recorder_ && recorder_->sample()) {
+        return run_recorded(target_node_id, feed_dict, ExecutionStrategy::RECURSIVE);
+    }
     return executor_->compute(target_node_id, feed_dict);
 }
 
@@ -42,9 +60,146 @@ std::string CompiledGraph::run_auto(const std::string& target_node_id,
     if (!valid_ || !executor_) {
         throw std::runtime_error("CompiledGraph is not valid");
     }
+    if (recorder_ && recorder_->sample()) {
+        return run_recorded(target_node_id, feed_dict, ExecutionStrategy::AUTO);
+    }
     return executor_->compute_auto(target_node_id, feed_dict);
 }
 
+std::string CompiledGraph::run_recorded(const std::string& target_node_id,
+                                        const std::unordered_map<std::string, std::string>& feed_dict,
+                                        ExecutionStrategy strategy) {
+    TrafficRecord record;
+    record.graph_id = recording_id_;
+    record.target = target_node_id;
+    record.strategy = strategy_name(strategy);
+    record.feeds.assign(feed_dict.begin(), feed_dict.end());
+    std::ranges::sort(record.feeds);
+
+    record.timestamp_ns = recorder_->now_ns();
+    try {
+        std::string result = executor_->compute_with_strategy(strategy, target_node_id, feed_dict);
+        record.latency_ns = recorder_->now_ns() - record.timestamp_ns;
+        record.result_size = result.size();
+        record.result_hash = TrafficRecorder::hash(result);
+        recorder_->record(record);
+        return result;
+    } catch (const std::exception& e) {
+        record.latency_ns = recorder_->now_ns() - record.timestamp_ns;
+        record.error = e.what();
+        recorder_->record(record);
+        throw;
+    }
+}
+
+std::string CompiledGraph::run_with_files(const std::string& target_node_id,
+                                         const FileFeedDict& file_feeds,
+                                         const std::unordered_map<std::string, std::string>& feed_dict,
+                                         ExecutionStrategy strategy) {
+    if (!valid_ || !executor_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    return executor_->compute_with_files(strategy, target_node_id, file_feeds, feed_dict);
+}
+
+size_t CompiledGraph::run_to_sink(const std::string& target_node_id,
+                                  OutputSink& sink,
+                                  const std::unordered_map<std::string, std::string>& feed_dict,
+                                  const FileFeedDict& file_feeds,
+                                  ExecutionStrategy strategy) {
+    if (!valid_ || !executor_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    return executor_->compute_to_sink(strategy, target_node_id, sink, feed_dict, file_feeds);
+}
+
+BatchStats CompiledGraph::run_batch(std::string_view input, const BatchOptions& options,
+                                    std::ostream& output) {
+    if (!valid_ || !graph_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    BatchRunner runner(*graph_, options);
+    return runner.run(input, output);
+}
+
+BatchStats CompiledGraph::run_batch(AsyncFileReader& input, const BatchOptions& options,
+                                    std::ostream& output) {
+    if (!valid_ || !graph_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    BatchRunner runner(*graph_, options);
+    return runner.run(input, output);
+}
+
+bool CompiledGraph::enable_profiling(CounterLevel counters) {
+    if (!valid_ || !executor_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    if (!profiler_) {
+        profiler_ = std::make_unique<Profiler>();
+    }
+    bool counting = profiler_->set_counter_level(counters);
+    executor_->set_profiler(profiler_.get());
+    return counting;
+}
+
+void CompiledGraph::disable_profiling() {
+    if (executor_) {
+        executor_->set_profiler(nullptr);
+    }
+}
+
+void CompiledGraph::enable_recording(std::shared_ptr<TrafficRecorder> recorder, std::string graph_id) {
+    if (!valid_ || !graph_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    recording_id_ = graph_id.empty() ? graph_->name() : std::move(graph_id);
+    recorder_ = std::move(recorder);
+}
+
+void CompiledGraph::disable_recording() {
+    recorder_.reset();
+}
+
+void CompiledGraph::enable_flight_recorder(FlightRecorderOptions options) {
+    if (!valid_ || !executor_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    flight_recorder_ = std::make_unique<FlightRecorder>(std::move(options));
+    executor_->set_flight_recorder(flight_recorder_.get());
+}
+
+void CompiledGraph::disable_flight_recorder() {
+    if (executor_) {
+        executor_->set_flight_recorder(nullptr);
+    }
+}
+
+FlightRecorder* CompiledGraph::flight_recorder() const noexcept {
+    return flight_recorder_.get();
+}
+
+Profiler* CompiledGraph::profiler() const noexcept {
+    return profiler_.get();
+}
+
+Explanation CompiledGraph::explain(const std::string& target_node_id, ExecutionStrategy strategy,
+                                   const std::unordered_map<std::string, std::string>& feed_dict) {
+    if (!valid_ || !executor_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    return executor_->explain(target_node_id, strategy, feed_dict);
+}
+
+Explanation CompiledGraph::explain_analyze(const std::string& target_node_id,
+                                           const std::unordered_map<std::string, std::string>& feed_dict,
+                                           ExecutionStrategy strategy) {
+    if (!valid_ || !executor_) {
+        throw std::runtime_error("CompiledGraph is not valid");
+    }
+    return executor_->explain_analyze(target_node_id, feed_dict, strategy);
+}
+
 const Graph& CompiledGraph::get_graph() const {
     if (!graph_) {
         throw std::runtime_error("CompiledGraph has no graph");
@@ -56,4 +211,12 @@ bool CompiledGraph::is_valid() const {
     return valid_;
 }
 
+bool CompiledGraph::is_verified() const noexcept {
+    return executor_ && executor_->is_verified();
+}
+
+const std::string& CompiledGraph::verification_error() const noexcept {
+    return verification_error_;
+}
+
 } // namespace strgraph
@@ -346,26 +346,49 @@ OpResult title_op(std::span<const std::string_view> inputs, std::span<const std:
 namespace strgraph {
 namespace core_ops {
 
+std::span<const KernelEntry> kernels() {
+    // Signatures: inputs min/max, constants min/max, multi-output
+    static constexpr KernelEntry KERNELS[] = {
+        // Basic operations
+        {"identity", identity_op, {1, 1, 0, 0}},
+        {"concat", concat_op, {}},
+        {"reverse", reverse_op, {1, 1, 0, 0}},
+        {"to_upper", to_upper_op, {1, 1, 0, 0}},
+        {"to_lower", to_lower_op, {1, 1, 0, 0}},
+        {"split", split_op, {1, 1, 1, 1, true}},
+
+        // String manipulation operations
+        {"trim", trim_op, {1, 1, 0, 0}},
+        {"replace", replace_op, {1, 1, 2, 2}},
+        {"substring", substring_op, {1, 1, 2, 2}},
+        {"repeat", repeat_op, {1, 1, 1, 1}},
+        {"pad_left", pad_left_op, {1, 1, 2, 2}},
+        {"pad_right", pad_right_op, {1, 1, 2, 2}},
+        {"capitalize", capitalize_op, {1, 1, 0, 0}},
+        {"title", title_op, {1, 1, 0, 0}},
+    };
+    return KERNELS;
+}
+
 void register_all() {
     OperationRegistry& registry = OperationRegistry::get_instance();
-    
-    // Basic operations
-    registry.register_op("identity", identity_op);
-    registry.register_op("concat", concat_op);
-    registry.register_op("reverse", reverse_op);
-    registry.register_op("to_upper", to_upper_op);
-    registry.register_op("to_lower", to_lower_op);
-    registry.register_op("split", split_op);
-    
-    // String manipulation operations
-    registry.register_op("trim", trim_op);
-    registry.register_op("replace", replace_op);
-    registry.register_op("substring", substring_op);
-    registry.register_op("repeat", repeat_op);
-    registry.register_op("pad_left", pad_left_op);
-    registry.register_op("pad_right", pad_right_op);
-    registry.register_op("capitalize", capitalize_op);
-    registry.register_op("title", title_op);
+    for (const auto& [name, kernel, signature] : kernels()) {
+        registry.register_op(std::string(name), kernel, signature);
+    }
+}
+
+AssemblyKind assembly_kind(const StringOperation& op) {
+    const Kernel* target = op.target<Kernel>();
+    if (target == nullptr) {
+        return AssemblyKind::NONE;
+    }
+    if (*target == &concat_op) {
+        return AssemblyKind::CONCAT;
+    }
+    if (*target == &repeat_op) {
+        return AssemblyKind::REPEAT;
+    }
+    return AssemblyKind::NONE;
 }
 
 } // namespace core_ops
@@ -1,11 +1,23 @@
 #include "strgraph/executor.h"
 #include "strgraph/operation_registry.h"
+#include "strgraph/core_ops.h"
 #include <format>
 #include <stdexcept>
-#include <functional>
-#include <queue>
+#include <atomic>
+#include <cstdint>
+#include <limits>
 #include <cctype>
 #include <optional>
+#include <charconv>
+#include <chrono>
+#include <algorithm>
+#include <exception>
+#include <variant>
+#include <array>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
 
 namespace {
 
@@ -62,167 +74,970 @@ ParsedInputId parse_input_id(std::string_view input_id) {
     return {node_id, index};
 }
 
+/**
+ * @brief Read the value referenced by an input ID from a computed node.
+ * 
+ * @param input_node The computed node referenced by the input
+ * @param parsed The parsed input ID
+ * @param input_id The original input ID string (for error messages)
+ * @return View of the referenced value
+ */
+std::string_view input_value(const strgraph::Node& input_node, const ParsedInputId& parsed,
+                             std::string_view input_id) {
+    // PLACEHOLDER values are bound in place and never multi-output
+    if (input_node.bound_value.has_value()) {
+        if (parsed.output_index.has_value()) {
+            throw std::runtime_error(
+                std::format("Node '{}' is not a multi-output node, cannot access index {}",
+                            parsed.node_id, *parsed.output_index));
+        }
+        return *input_node.bound_value;
+    }
+
+    if (!input_node.computed_result.has_value()) {
+        throw std::runtime_error(std::format("Input node '{}' has no computed result", input_id));
+    }
+
+    return std::visit([&](auto&& result) -> std::string_view {
+        using T = std::decay_t<decltype(result)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            if (parsed.output_index.has_value()) {
+                throw std::runtime_error(
+                    std::format("Node '{}' is not a multi-output node, cannot access index {}",
+                                parsed.node_id, *parsed.output_index));
+            }
+            return result;
+        } else {
+            if (!parsed.output_index.has_value()) {
+                throw std::runtime_error(
+                    std::format("Node '{}' is a multi-output node, must specify index (e.g., '{}:0')",
+                                parsed.node_id, parsed.node_id));
+            }
+            size_t index = *parsed.output_index;
+            if (index >= result.size()) {
+                throw std::runtime_error(
+                    std::format("Index {} out of bounds for node '{}' (size: {})",
+                                index, parsed.node_id, result.size()));
+            }
+            return result[index];
+        }
+    }, *input_node.computed_result);
+}
+
+/**
+ * @brief Total size of the output(s) of an operation.
+ */
+size_t result_size(const strgraph::OpResult& result) {
+    if (const auto* single = std::get_if<std::string>(&result)) {
+        return single->size();
+    }
+    size_t total = 0;
+    for (const auto& output : std::get<std::vector<std::string>>(result)) {
+        total += output.size();
+    }
+    return total;
+}
+
+#ifdef USE_OPENMP
+constexpr bool OPENMP_AVAILABLE = true;
+#else
+constexpr bool OPENMP_AVAILABLE = false;
+#endif
+
+/**
+ * @brief A cycle found while planning; callers name the graph or subgraph.
+ */
+struct CycleError : std::runtime_error {
+    CycleError() : std::runtime_error("Cycle detected") {}
+};
+
+std::vector<strgraph::Node*> flatten_layers(const std::vector<std::vector<strgraph::Node*>>& layers) {
+    size_t total = 0;
+    for (const auto& layer : layers) {
+        total += layer.size();
+    }
+    std::vector<strgraph::Node*> sorted;
+    sorted.reserve(total);
+    for (const auto& layer : layers) {
+        sorted.insert(sorted.end(), layer.begin(), layer.end());
+    }
+    return sorted;
+}
+
+/**
+ * @brief The subgraph reachable from a set of targets, over dense ids.
+ * 
+ * Nodes are numbered breadth first from the targets, and only the
+ * discovery hashes strings; inputs and dependents are then kept as
+ * offsets into flat id arrays. Each step uses the thread team when it
+ * covers at least MIN_PARALLEL_PLAN_NODES nodes, and the result does not
+ * depend on the thread count.
+ */
+class SubgraphPlan {
+public:
+    SubgraphPlan(strgraph::Graph& graph, std::span<const std::string_view> target_node_ids) {
+        discover(graph, target_node_ids);
+        link_dependents();
+    }
+
+    /**
+     * @brief Nodes grouped by level (1 + the deepest input's level), in id order.
+     * 
+     * @throws CycleError if some nodes never become ready
+     */
+    [[nodiscard]] std::vector<std::vector<strgraph::Node*>> layers() const;
+
+private:
+    static constexpr size_t MIN_PARALLEL = strgraph::Executor::MIN_PARALLEL_PLAN_NODES;
+
+    void discover(strgraph::Graph& graph, std::span<const std::string_view> target_node_ids);
+    void link_dependents();
+
+    [[nodiscard]] uint32_t input_count(uint32_t id) const {
+        return input_offsets_[id + 1] - input_offsets_[id];
+    }
+
+    std::vector<strgraph::Node*> nodes_;
+    std::vector<uint32_t> input_offsets_{0};      ///< Inputs of i: inputs_[input_offsets_[i], input_offsets_[i + 1])
+    std::vector<uint32_t> inputs_;
+    std::vector<uint32_t> dependent_offsets_;     ///< Same layout for the reverse edges
+    std::vector<uint32_t> dependents_;
+};
+
+void SubgraphPlan::discover(strgraph::Graph& graph, std::span<const std::string_view> target_node_ids) {
+    std::unordered_map<const strgraph::Node*, uint32_t> ids;
+    auto id_of = [&](strgraph::Node* node) {
+        auto [it, inserted] = ids.try_emplace(node, static_cast<uint32_t>(nodes_.size()));
+        if (inserted) {
+            if (nodes_.size() == std::numeric_limits<uint32_t>::max()) {
+                throw std::runtime_error("Subgraph has too many nodes to plan");
+            }
+            nodes_.push_back(node);
+        }
+        return it->second;
+    };
+    for (std::string_view target_node_id : target_node_ids) {
+        (void)id_of(&graph.get_node(parse_input_id(target_node_id).node_id));
+    }
+
+    // One frontier (the nodes found by the previous one) at a time
+    std::vector<size_t> offsets;
+    std::vector<strgraph::Node*> resolved;
+    for (size_t begin = 0; begin < nodes_.size();) {
+        const size_t end = nodes_.size();
+        offsets.assign(end - begin + 1, 0);
+        for (size_t i = begin; i < end; ++i) {
+            offsets[i - begin + 1] = offsets[i - begin] + nodes_[i]->input_ids.size();
+        }
+        resolved.resize(offsets.back());
+
+        // Parsing and hashing the input ids is the expensive part
+        std::exception_ptr error;
+        size_t error_at = std::numeric_limits<size_t>::max();
+#ifdef USE_OPENMP
+        #pragma omp parallel for schedule(dynamic, 256) if(end - begin >= MIN_PARALLEL)
+#endif
+        for (size_t k = 0; k < end - begin; ++k) {
+            try {
+                const auto& input_ids = nodes_[begin + k]->input_ids;
+                for (size_t j = 0; j < input_ids.size(); ++j) {
+                    resolved[offsets[k] + j] = &graph.get_node(parse_input_id(input_ids[j]).node_id);
+                }
+            } catch (...) {
+                // Exceptions must not escape the parallel region
+#ifdef USE_OPENMP
+                #pragma omp critical(strgraph_plan_error)
+#endif
+                if (k < error_at) {
+                    error_at = k;
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        // Numbered in order, so ids do not depend on the thread count
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t k = offsets[i - begin]; k < offsets[i - begin + 1]; ++k) {
+                inputs_.push_back(id_of(resolved[k]));
+            }
+            input_offsets_.push_back(static_cast<uint32_t>(inputs_.size()));
+        }
+        begin = end;
+    }
+}
+
+void SubgraphPlan::link_dependents() {
+    const size_t count = nodes_.size();
+    [[maybe_unused]] const bool parallel = count >= MIN_PARALLEL;
+
+    dependent_offsets_.assign(count + 1, 0);
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(static) if(parallel)
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        for (uint32_t e = input_offsets_[i]; e < input_offsets_[i + 1]; ++e) {
+            std::atomic_ref(dependent_offsets_[inputs_[e] + 1]).fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        dependent_offsets_[i + 1] += dependent_offsets_[i];
+    }
+
+    dependents_.resize(inputs_.size());
+    std::vector<uint32_t> cursor(dependent_offsets_.begin(), dependent_offsets_.end() - 1);
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(static) if(parallel)
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        for (uint32_t e = input_offsets_[i]; e < input_offsets_[i + 1]; ++e) {
+            uint32_t slot = std::atomic_ref(cursor[inputs_[e]]).fetch_add(1, std::memory_order_relaxed);
+            dependents_[slot] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+std::vector<std::vector<strgraph::Node*>> SubgraphPlan::layers() const {
+    const size_t count = nodes_.size();
+    std::vector<uint32_t> remaining(count);
+    std::vector<uint32_t> level(count, 0);
+    std::vector<uint32_t> frontier;
+    for (uint32_t id = 0; id < count; ++id) {
+        remaining[id] = input_count(id);
+        if (remaining[id] == 0) {
+            frontier.push_back(id);
+        }
+    }
+
+    // Kahn's algorithm a whole frontier at a time: the nodes a frontier
+    // makes ready form the next level
+    size_t placed = 0;
+    uint32_t levels = 0;
+    std::vector<uint32_t> next;
+    while (!frontier.empty()) {
+        placed += frontier.size();
+        ++levels;
+        next.clear();
+#ifdef USE_OPENMP
+        #pragma omp parallel if(frontier.size() >= MIN_PARALLEL)
+#endif
+        {
+            std::vector<uint32_t> ready;
+#ifdef USE_OPENMP
+            #pragma omp for schedule(static) nowait
+#endif
+            for (size_t k = 0; k < frontier.size(); ++k) {
+                const uint32_t id = frontier[k];
+                for (uint32_t e = dependent_offsets_[id]; e < dependent_offsets_[id + 1]; ++e) {
+                    const uint32_t dependent = dependents_[e];
+                    if (std::atomic_ref(remaining[dependent]).fetch_sub(1, std::memory_order_relaxed) == 1) {
+                        level[dependent] = levels;
+                        ready.push_back(dependent);
+                    }
+                }
+            }
+#ifdef USE_OPENMP
+            #pragma omp critical(strgraph_plan_frontier)
+#endif
+            next.insert(next.end(), ready.begin(), ready.end());
+        }
+        frontier.swap(next);
+    }
+    if (placed != count) {
+        throw CycleError();
+    }
+
+    // Counting sort by level keeps every level in id order
+    std::vector<std::vector<strgraph::Node*>> layers(levels);
+    std::vector<size_t> sizes(levels, 0);
+    for (uint32_t id = 0; id < count; ++id) {
+        ++sizes[level[id]];
+    }
+    for (uint32_t l = 0; l < levels; ++l) {
+        layers[l].reserve(sizes[l]);
+    }
+    for (uint32_t id = 0; id < count; ++id) {
+        layers[level[id]].push_back(nodes_[id]);
+    }
+    return layers;
+}
+
+/**
+ * @brief Set the depth, node count and widest layer of a decision from layers.
+ */
+template <typename Layers>
+void describe_layers(const Layers& layers, strgraph::StrategyDecision& decision) {
+    decision.estimated_depth = layers.size();
+    decision.node_count = 0;
+    decision.max_layer_width = 0;
+    for (const auto& layer : layers) {
+        decision.node_count += layer.size();
+        decision.max_layer_width = std::max(decision.max_layer_width, layer.size());
+    }
+}
+
 }
 
 namespace strgraph {
 
-Executor::Executor(Graph& graph) : graph_(graph) {}
+std::string_view strategy_name(ExecutionStrategy strategy) {
+    switch (strategy) {
+        case ExecutionStrategy::RECURSIVE: return "recursive";
+        case ExecutionStrategy::ITERATIVE: return "iterative";
+        case ExecutionStrategy::PARALLEL:  return "parallel";
+        case ExecutionStrategy::AUTO:      return "auto";
+    }
+    return "unknown";
+}
 
-size_t Executor::estimate_depth_dfs(
-    std::string_view node_id,
-    size_t max_depth,
-    std::unordered_map<std::string, size_t>& memo
-) const {
-    // Extract actual node ID (remove index if present)
-    auto parsed = parse_input_id(node_id);
-    std::string id(parsed.node_id);
-    
-    // Check memo
-    auto it = memo.find(id);
-    if (it != memo.end()) {
+ExecutionStrategy parse_strategy(std::string_view name) {
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        if (strategy_name(strategy) == name) {
+            return strategy;
+        }
+    }
+    throw std::runtime_error(std::format("Unknown execution strategy '{}'", name));
+}
+
+/**
+ * @brief Nodes of a verified graph in topological order, with their
+ *        inputs, operations and constants resolved.
+ */
+struct Executor::VerifiedPlan {
+    static constexpr size_t NO_INDEX = std::numeric_limits<size_t>::max();
+
+    struct Input {
+        const Node* node;
+        uint32_t id;
+        size_t index;                     ///< Output index, or NO_INDEX
+    };
+
+    struct Entry {
+        Node* node;
+        StringOperation op;               ///< Empty unless node is an OPERATION
+        bool multi_output = false;
+        uint32_t level = 0;
+        uint32_t inputs_begin = 0;        ///< Range in inputs
+        uint32_t inputs_end = 0;
+        uint32_t constants_begin = 0;     ///< Range in constants
+        uint32_t constants_end = 0;
+    };
+
+    std::vector<Entry> entries;           ///< Indexed by id, in topological order
+    std::vector<Input> inputs;
+    std::vector<std::string_view> constants;
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+    /**
+     * @brief Reachability marks: marks[id] == epoch when reached in this walk.
+     */
+    std::vector<uint32_t> marks;
+    uint32_t epoch = 0;
+
+    [[nodiscard]] uint32_t id_of(std::string_view target_node_id) const {
+        auto parsed = parse_input_id(target_node_id);
+        auto it = ids.find(parsed.node_id);
+        if (it == ids.end()) {
+            throw std::runtime_error(std::format("Node '{}' not found in graph", parsed.node_id));
+        }
         return it->second;
     }
-    
-    // Early termination: if we've already exceeded max_depth
-    if (memo.size() > max_depth) {
-        return max_depth + 1;
+};
+
+Executor::Executor(Graph& graph)
+    : graph_(graph), metrics_(EngineMetrics::for_graph(graph.name())) {}
+
+Executor::~Executor() = default;
+
+void Executor::clear_verification() noexcept {
+    verified_.reset();
+}
+
+void Executor::verify() {
+    verified_.reset();
+    const OperationRegistry& registry = OperationRegistry::get_instance();
+    auto is_multi_output = [&](const Node& node) {
+        if (node.type != NodeType::OPERATION) {
+            return false;
+        }
+        auto signature = registry.get_signature(node.op_name);
+        return signature.has_value() && signature->multi_output;
+    };
+
+    // Step 1: every node against its operation, every reference against its node
+    for (const auto& [id, node] : graph_.get_nodes()) {
+        if (node.type == NodeType::OPERATION) {
+            auto signature = registry.get_signature(node.op_name);
+            if (!signature) {
+                throw std::runtime_error(std::format(
+                    "Operation '{}' of node '{}' has no signature to verify against", node.op_name, id));
+            }
+            if (!signature->accepts(node.input_ids.size(), node.constants.size())) {
+                throw std::runtime_error(std::format(
+                    "Node '{}' passes {} inputs and {} constants, which operation '{}' does not accept",
+                    id, node.input_ids.size(), node.constants.size(), node.op_name));
+            }
+        }
+        for (const auto& input_id : node.input_ids) {
+            auto parsed = parse_input_id(input_id);
+            const bool multi_output = is_multi_output(graph_.get_node(parsed.node_id));
+            if (parsed.output_index && !multi_output) {
+                throw std::runtime_error(
+                    std::format("Node '{}' is not a multi-output node, cannot access index {}",
+                                parsed.node_id, *parsed.output_index));
+            }
+            if (!parsed.output_index && multi_output) {
+                throw std::runtime_error(
+                    std::format("Node '{}' is a multi-output node, must specify index (e.g., '{}:0')",
+                                parsed.node_id, parsed.node_id));
+            }
+        }
     }
-    
-    const Node& node = graph_.get_node(id);
-    
-    // Base case: no inputs
-    if (node.input_ids.empty()) {
-        memo[id] = 1;
-        return 1;
+
+    // Step 2: no cycles; the levels order the plan
+    auto layers = [&] {
+        std::vector<std::string_view> all_nodes;
+        all_nodes.reserve(graph_.get_nodes().size());
+        for (const auto& [id, _] : graph_.get_nodes()) {
+            all_nodes.push_back(id);
+        }
+        try {
+            return subgraph_layers(all_nodes);
+        } catch (const CycleError&) {
+            throw std::runtime_error("Cycle detected in graph");
+        }
+    }();
+
+    // Step 3: resolve everything a run would look up
+    auto plan = std::make_unique<VerifiedPlan>();
+    plan->entries.reserve(graph_.get_nodes().size());
+    plan->ids.reserve(graph_.get_nodes().size());
+    for (uint32_t level = 0; level < layers.size(); ++level) {
+        for (Node* node : layers[level]) {
+            plan->ids.emplace(node->id, static_cast<uint32_t>(plan->entries.size()));
+            plan->entries.push_back({.node = node, .op = {}, .level = level});
+        }
     }
-    
-    // Recursive case: 1 + max(input depths)
-    size_t max_input_depth = 0;
-    for (const auto& input_id : node.input_ids) {
-        size_t depth = estimate_depth_dfs(input_id, max_depth, memo);
-        if (depth > max_depth) {
-            // Early termination
-            return max_depth + 1;
+    for (auto& entry : plan->entries) {
+        const Node& node = *entry.node;
+        if (node.type == NodeType::OPERATION) {
+            entry.op = registry.get_op(node.op_name);
+            entry.multi_output = is_multi_output(node);
         }
-        max_input_depth = std::max(max_input_depth, depth);
+        entry.inputs_begin = static_cast<uint32_t>(plan->inputs.size());
+        for (const auto& input_id : node.input_ids) {
+            auto parsed = parse_input_id(input_id);
+            const uint32_t input = plan->ids.at(parsed.node_id);
+            plan->inputs.push_back({plan->entries[input].node, input,
+                                    parsed.output_index.value_or(VerifiedPlan::NO_INDEX)});
+        }
+        entry.inputs_end = static_cast<uint32_t>(plan->inputs.size());
+        entry.constants_begin = static_cast<uint32_t>(plan->constants.size());
+        plan->constants.insert(plan->constants.end(), node.constants.begin(), node.constants.end());
+        entry.constants_end = static_cast<uint32_t>(plan->constants.size());
     }
-    
-    size_t result = max_input_depth + 1;
-    memo[id] = result;
-    return result;
+    plan->marks.assign(plan->entries.size(), 0);
+    verified_ = std::move(plan);
 }
 
-size_t Executor::estimate_depth_fast(std::string_view node_id, size_t max_depth) const {
-    std::unordered_map<std::string, size_t> memo;
-    return estimate_depth_dfs(node_id, max_depth, memo);
+const std::string& Executor::compute_with_strategy(
+    ExecutionStrategy strategy,
+    std::string_view target_node_id,
+    const FeedDict& feed_dict
+) {
+    FeedBinding feeds(*this, feed_dict);
+    return run_strategy(strategy, target_node_id);
 }
 
-const std::string& Executor::compute_auto(std::string_view target_node_id, const FeedDict& feed_dict) {
-    // Strategy selection thresholds
-    constexpr size_t MAX_RECURSION_DEPTH = 100;
-    constexpr size_t MAX_RECURSION_NODES = 500;
-    constexpr size_t MIN_PARALLEL_NODES = 500;
-    constexpr size_t MIN_PARALLEL_WIDTH = 100;
-    
-    // Step 1: Fast depth check (with early termination)
-    size_t estimated_depth = estimate_depth_fast(target_node_id, MAX_RECURSION_DEPTH + 1);
-    
-    // Step 2: Decide recursive vs iterative/parallel
-    if (estimated_depth <= MAX_RECURSION_DEPTH) {
-        // Shallow graph: check node count
-        auto sorted = topological_sort_subgraph(target_node_id);
-        
-        if (sorted.size() <= MAX_RECURSION_NODES) {
-            // Small graph: use recursive (fastest)
-            return compute(target_node_id, feed_dict);
+const std::string& Executor::compute_with_strategy(
+    ExecutionStrategy strategy,
+    std::string_view target_node_id,
+    const FeedViewDict& feed_views
+) {
+    FeedBinding feeds(*this, feed_views);
+    return run_strategy(strategy, target_node_id);
+}
+
+const std::string& Executor::compute_with_files(
+    ExecutionStrategy strategy,
+    std::string_view target_node_id,
+    const FileFeedDict& file_feeds,
+    const FeedDict& feed_dict
+) {
+    // Results never refer to placeholder memory, so the mappings can be
+    // released once the views bound to the placeholders are dropped
+    FeedBinding feeds(*this, feed_dict, file_feeds);
+    return run_strategy(strategy, target_node_id);
+}
+
+size_t Executor::compute_to_sink(
+    ExecutionStrategy strategy,
+    std::string_view target_node_id,
+    OutputSink& sink,
+    const FeedDict& feed_dict,
+    const FileFeedDict& file_feeds
+) {
+    FeedBinding feeds(*this, feed_dict, file_feeds);
+
+    std::vector<SinkPiece> pieces;
+    std::vector<std::string_view> leaves;
+    plan_sink_pieces(target_node_id, 0, pieces, leaves);
+
+    if (strategy == ExecutionStrategy::AUTO) {
+        strategy = select_strategy(target_node_id);
+    }
+    run_targets(strategy, leaves);
+    // Resolve the leaves of dropped pieces (repeat count 0) as well, so a
+    // bad output index fails as it does when the target is computed
+    for (std::string_view leaf : leaves) {
+        auto parsed = parse_input_id(leaf);
+        (void)input_value(graph_.get_node(parsed.node_id), parsed, leaf);
+    }
+
+    std::vector<std::string_view> views;
+    views.reserve(pieces.size());
+    size_t total = 0;
+    for (const auto& piece : pieces) {
+        std::string_view view = piece.text;
+        if (piece.is_node) {
+            auto parsed = parse_input_id(piece.text);
+            view = input_value(graph_.get_node(parsed.node_id), parsed, piece.text);
         }
-        
-        // Large but shallow: check if parallel is worth it
-        #ifdef USE_OPENMP
-            if (sorted.size() >= MIN_PARALLEL_NODES) {
-                auto layers = partition_by_layers(sorted);
-                size_t max_width = 0;
-                for (const auto& layer : layers) {
-                    max_width = std::max(max_width, layer.size());
+        views.push_back(view);
+        total += view.size();
+    }
+    sink.write(views);
+    return total;
+}
+
+void Executor::plan_sink_pieces(std::string_view input_id, size_t depth,
+                                std::vector<SinkPiece>& pieces,
+                                std::vector<std::string_view>& leaves) {
+    // Deeply nested assemblies are computed rather than flattened
+    constexpr size_t MAX_SINK_DEPTH = 256;
+
+    auto parsed = parse_input_id(input_id);
+    Node& node = graph_.get_node(parsed.node_id);
+
+    auto kind = core_ops::AssemblyKind::NONE;
+    if (node.type == NodeType::OPERATION && !parsed.output_index && depth < MAX_SINK_DEPTH &&
+        pieces.size() < MAX_SINK_PIECES) {
+        kind = core_ops::assembly_kind(OperationRegistry::get_instance().get_op(node.op_name));
+    }
+
+    const size_t start = pieces.size();
+    const size_t leaf_start = leaves.size();
+    bool flattened = false;
+
+    if (kind == core_ops::AssemblyKind::CONCAT) {
+        for (const auto& id : node.input_ids) {
+            plan_sink_pieces(id, depth + 1, pieces, leaves);
+        }
+        for (const auto& constant : node.constants) {
+            pieces.push_back({constant, false});
+        }
+        flattened = true;
+    } else if (kind == core_ops::AssemblyKind::REPEAT &&
+               node.input_ids.size() == 1 && node.constants.size() == 1) {
+        size_t count = 0;
+        const std::string& text = node.constants[0];
+        auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), count);
+        if (ec == std::errc{} && ptr == text.data() + text.size()) {
+            plan_sink_pieces(node.input_ids[0], depth + 1, pieces, leaves);
+            const size_t width = pieces.size() - start;
+            if (count == 0 || width == 0) {
+                pieces.resize(start);
+                flattened = true;
+            } else if (count <= MAX_SINK_PIECES / width) {
+                // Divided, not multiplied: count can be any size_t
+                pieces.reserve(start + width * count);
+                for (size_t i = 1; i < count; ++i) {
+                    for (size_t j = 0; j < width; ++j) {
+                        pieces.push_back(pieces[start + j]);
+                    }
+                }
+                flattened = true;
+            }
+        }
+    }
+
+    if (flattened && pieces.size() <= MAX_SINK_PIECES) {
+        return;
+    }
+
+    // Not an assembly (or too large to flatten): the node is one piece
+    pieces.resize(start);
+    leaves.resize(leaf_start);
+    pieces.push_back({input_id, true});
+    leaves.push_back(input_id);
+}
+
+const std::string& Executor::run_strategy(ExecutionStrategy strategy, std::string_view target_node_id) {
+    switch (strategy) {
+        case ExecutionStrategy::RECURSIVE:
+            return run_recursive(target_node_id);
+        case ExecutionStrategy::ITERATIVE:
+            return run_iterative(target_node_id);
+        case ExecutionStrategy::PARALLEL:
+            return run_parallel(target_node_id);
+        case ExecutionStrategy::AUTO:
+            break;
+    }
+    return run_auto(target_node_id);
+}
+
+const std::string& Executor::compute_auto(std::string_view target_node_id, const FeedDict& feed_dict) {
+    FeedBinding feeds(*this, feed_dict);
+    return run_auto(target_node_id);
+}
+
+const std::string& Executor::run_auto(std::string_view target_node_id) {
+    return run_strategy(select_strategy(target_node_id), target_node_id);
+}
+
+ExecutionStrategy Executor::auto_strategy(size_t depth, size_t node_count,
+                                          size_t max_layer_width) {
+    if (depth <= AUTO_MAX_RECURSION_DEPTH && node_count <= AUTO_MAX_RECURSION_NODES) {
+        // Small shallow graph: recursion is fastest
+        return ExecutionStrategy::RECURSIVE;
+    }
+    if (OPENMP_AVAILABLE && node_count >= AUTO_MIN_PARALLEL_NODES &&
+        max_layer_width >= AUTO_MIN_PARALLEL_WIDTH) {
+        // Large and wide
+        return ExecutionStrategy::PARALLEL;
+    }
+    // Default: iterative (most reliable for large or deep graphs)
+    return ExecutionStrategy::ITERATIVE;
+}
+
+void Executor::auto_inputs(std::string_view target_node_id, StrategyDecision& decision) {
+    // The same exact measure on both paths: the layers of the reachable
+    // subgraph, taken from the precomputed levels when verified
+    if (verified_ != nullptr) {
+        describe_layers(verified_layers(std::span(&target_node_id, 1)), decision);
+    } else {
+        describe_layers(topological_layers(target_node_id), decision);
+    }
+}
+
+ExecutionStrategy Executor::select_strategy(std::string_view target_node_id) {
+    StrategyDecision decision;
+    auto_inputs(target_node_id, decision);
+    return auto_strategy(decision.estimated_depth, decision.node_count, decision.max_layer_width);
+}
+
+Explanation Executor::explain(std::string_view target_node_id, ExecutionStrategy strategy,
+                              const FeedDict& feed_dict) {
+    Explanation plan;
+    plan.target = std::string(target_node_id);
+    plan.graph_nodes = graph_.get_nodes().size();
+
+    auto layers = topological_layers(target_node_id);
+    auto sorted = flatten_layers(layers);
+
+    StrategyDecision& decision = plan.decision;
+    decision.requested = strategy;
+    auto_inputs(target_node_id, decision);
+    decision.openmp = OPENMP_AVAILABLE;
+    decision.strategy = strategy != ExecutionStrategy::AUTO
+        ? strategy
+        : auto_strategy(decision.estimated_depth, decision.node_count, decision.max_layer_width);
+
+    // Reasons, in the order compute_auto() checks them
+    auto& reasons = decision.reasons;
+    if (strategy != ExecutionStrategy::AUTO) {
+        reasons.push_back(std::format("requested explicitly (compute_auto would choose {})",
+                                      strategy_name(auto_strategy(decision.estimated_depth,
+                                                                  decision.node_count,
+                                                                  decision.max_layer_width))));
+    }
+    if (decision.estimated_depth <= AUTO_MAX_RECURSION_DEPTH) {
+        reasons.push_back(std::format("depth {} <= {}: shallow enough to recurse",
+                                      decision.estimated_depth, AUTO_MAX_RECURSION_DEPTH));
+        reasons.push_back(std::format("{} nodes {} {}: {} to recurse", decision.node_count,
+                                      decision.node_count <= AUTO_MAX_RECURSION_NODES ? "<=" : ">",
+                                      AUTO_MAX_RECURSION_NODES,
+                                      decision.node_count <= AUTO_MAX_RECURSION_NODES ? "few enough" : "too many"));
+    } else {
+        reasons.push_back(std::format("depth {} > {}: too deep to recurse",
+                                      decision.estimated_depth, AUTO_MAX_RECURSION_DEPTH));
+    }
+    if (!OPENMP_AVAILABLE) {
+        reasons.push_back("built without OpenMP: parallel strategy unavailable");
+    } else {
+        reasons.push_back(std::format("{} nodes {} {} for parallel", decision.node_count,
+                                      decision.node_count >= AUTO_MIN_PARALLEL_NODES ? ">=" : "<",
+                                      AUTO_MIN_PARALLEL_NODES));
+        reasons.push_back(std::format("widest layer {} {} {} for parallel", decision.max_layer_width,
+                                      decision.max_layer_width >= AUTO_MIN_PARALLEL_WIDTH ? ">=" : "<",
+                                      AUTO_MIN_PARALLEL_WIDTH));
+    }
+
+    // Nodes in topological order with estimated sizes
+    std::unordered_map<std::string_view, size_t> index_of;
+    index_of.reserve(sorted.size());
+    plan.nodes.reserve(sorted.size());
+    for (Node* node : sorted) {
+        index_of.emplace(node->id, plan.nodes.size());
+        ExplainNode& item = plan.nodes.emplace_back();
+        item.id = node->id;
+        item.type = node->type;
+        item.op_name = node->op_name;
+        item.input_ids = node->input_ids;
+        item.constants = node->constants;
+
+        switch (node->type) {
+            case NodeType::CONSTANT:
+            case NodeType::VARIABLE:
+                item.estimated_bytes = node->initial_value ? node->initial_value->size() : 0;
+                break;
+            case NodeType::PLACEHOLDER: {
+                auto fed = feed_dict.find(node->id);
+                item.estimated_bytes = fed != feed_dict.end()
+                    ? fed->second.size() : Explanation::ESTIMATED_PLACEHOLDER_BYTES;
+                break;
+            }
+            case NodeType::OPERATION: {
+                size_t input_bytes = 0;
+                size_t largest = 0;
+                for (const auto& input_id : node->input_ids) {
+                    auto it = index_of.find(parse_input_id(input_id).node_id);
+                    size_t bytes = it != index_of.end() ? plan.nodes[it->second].estimated_bytes : 0;
+                    input_bytes += bytes;
+                    largest = std::max(largest, bytes);
                 }
-                
-                if (max_width >= MIN_PARALLEL_WIDTH) {
-                    // Wide graph: use parallel
-                    return compute_parallel(target_node_id, feed_dict);
+                size_t constant_bytes = 0;
+                for (const auto& constant : node->constants) {
+                    constant_bytes += constant.size();
                 }
+
+                size_t output_bytes = largest;
+                auto kind = core_ops::assembly_kind(OperationRegistry::get_instance().get_op(node->op_name));
+                if (kind == core_ops::AssemblyKind::CONCAT) {
+                    output_bytes = input_bytes + constant_bytes;
+                } else if (kind == core_ops::AssemblyKind::REPEAT && !node->constants.empty()) {
+                    size_t count = 0;
+                    std::from_chars(node->constants[0].data(),
+                                    node->constants[0].data() + node->constants[0].size(), count);
+                    output_bytes = largest * count;
+                }
+                item.estimated_bytes = output_bytes;
+                item.estimated_cost = input_bytes + output_bytes;
+                break;
             }
-        #endif
-        
-        // Default: iterative
-        return compute_iterative(target_node_id, feed_dict);
+        }
     }
-    
-    // Step 3: Deep graph - check parallel viability
-    #ifdef USE_OPENMP
-        auto sorted = topological_sort_subgraph(target_node_id);
-        
-        if (sorted.size() >= MIN_PARALLEL_NODES) {
-            auto layers = partition_by_layers(sorted);
-            size_t max_width = 0;
-            for (const auto& layer : layers) {
-                max_width = std::max(max_width, layer.size());
+
+    for (const auto& layer : layers) {
+        auto& indices = plan.layers.emplace_back();
+        for (Node* node : layer) {
+            size_t index = index_of.at(node->id);
+            plan.nodes[index].layer = plan.layers.size() - 1;
+            indices.push_back(index);
+        }
+    }
+
+    // Optimizations the chosen strategy applies to this plan
+    auto& optimizations = plan.optimizations;
+    if (plan.graph_nodes > sorted.size()) {
+        optimizations.push_back(std::format("pruning: {} of {} graph nodes are not reachable from the target and are skipped",
+                                            plan.graph_nodes - sorted.size(), plan.graph_nodes));
+    }
+    size_t placeholders = 0;
+    size_t initialized = 0;
+    for (const Node* node : sorted) {
+        placeholders += node->type == NodeType::PLACEHOLDER;
+        initialized += node->type == NodeType::CONSTANT || node->type == NodeType::VARIABLE;
+    }
+    if (placeholders > 0) {
+        optimizations.push_back(std::format("zero-copy feeds: placeholder values are read in place, not copied ({} nodes)",
+                                            placeholders));
+    }
+    if (initialized > 0) {
+        optimizations.push_back(std::format("preinitialized: constant and variable values are set before execution ({} nodes)",
+                                            initialized));
+    }
+    if (decision.strategy == ExecutionStrategy::PARALLEL) {
+        size_t parallel_layers = 0;
+        for (const auto& layer : plan.layers) {
+            parallel_layers += OPENMP_AVAILABLE && layer.size() >= min_parallel_layer_size_;
+        }
+        optimizations.push_back(std::format("parallel layers: {} of {} layers run on OpenMP threads, "
+                                            "layers below {} nodes run serially",
+                                            parallel_layers, plan.layers.size(), min_parallel_layer_size_));
+    }
+    return plan;
+}
+
+Explanation Executor::explain_analyze(std::string_view target_node_id, const FeedDict& feed_dict,
+                                      ExecutionStrategy strategy) {
+    Explanation plan = explain(target_node_id, strategy, feed_dict);
+
+    Profiler profiler;
+    Profiler* attached = profiler_;
+    profiler_ = &profiler;
+    try {
+        (void)compute_with_strategy(plan.decision.strategy, target_node_id, feed_dict);
+    } catch (...) {
+        profiler_ = attached;
+        throw;
+    }
+    profiler_ = attached;
+
+    std::unordered_map<std::string_view, ExplainNode*> by_id;
+    for (auto& node : plan.nodes) {
+        by_id.emplace(node.id, &node);
+    }
+    for (const auto& event : profiler.events()) {
+        auto it = by_id.find(event.node_id);
+        if (it != by_id.end()) {
+            it->second->actual_ns = event.duration_ns();
+            it->second->input_bytes = event.input_bytes;
+            it->second->output_bytes = event.output_bytes;
+            it->second->thread = event.thread;
+        }
+    }
+    plan.analyzed = true;
+    plan.total_ns = profiler.runs().empty() ? 0 : profiler.runs().back().duration_ns();
+    return plan;
+}
+
+const std::string& Executor::compute(std::string_view target_node_id, const FeedDict& feed_dict) {
+    FeedBinding feeds(*this, feed_dict);
+    return run_recursive(target_node_id);
+}
+
+const std::string& Executor::run_recursive(std::string_view target_node_id) {
+    run_targets(ExecutionStrategy::RECURSIVE, std::span(&target_node_id, 1));
+    return target_result(target_node_id);
+}
+
+template <typename Item, typename Execute>
+void Executor::execute_layer(const std::vector<Item>& layer, Execute&& execute) {
+    if (layer.empty()) {
+        return;
+    }
+    const bool parallel = OPENMP_AVAILABLE && layer.size() >= min_parallel_layer_size_;
+    const uint64_t start_ns = profiler_ != nullptr ? profiler_->begin_layer() : 0;
+    size_t threads = 1;
+
+    if (parallel) {
+#ifdef USE_OPENMP
+        // OpenMP available: parallel execution
+        std::vector<std::exception_ptr> errors(layer.size());
+        #pragma omp parallel
+        {
+            // The team may be smaller than omp_get_max_threads(), e.g. when nested
+            #pragma omp single nowait
+            threads = static_cast<size_t>(omp_get_num_threads());
+
+            #pragma omp for schedule(dynamic)
+            for (size_t i = 0; i < layer.size(); ++i) {
+                try {
+                    execute(layer[i]);
+                } catch (...) {
+                    // Exceptions must not escape the parallel region
+                    errors[i] = std::current_exception();
+                }
             }
-            
-            if (max_width >= MIN_PARALLEL_WIDTH) {
-                // Deep + wide: use parallel
-                return compute_parallel(target_node_id, feed_dict);
+        }
+        // Rethrow the failure a sequential layer would have hit first
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
             }
         }
-    #endif
-    
-    // Default: iterative (most reliable for deep graphs)
-    return compute_iterative(target_node_id, feed_dict);
+#endif
+    } else {
+        // Layer too small or OpenMP not available: sequential execution
+        for (const Item& item : layer) {
+            execute(item);
+        }
+    }
+
+    if (profiler_ != nullptr) {
+        profiler_->record_layer(layer.size(), threads, start_ns);
+    }
 }
 
-const std::string& Executor::compute(std::string_view target_node_id, const FeedDict& feed_dict) {
-    // Save feed_dict for use during execution
-    feed_dict_ = feed_dict;
-    
+void Executor::run_targets(ExecutionStrategy strategy,
+                           std::span<const std::string_view> target_node_ids) {
+    if (strategy == ExecutionStrategy::AUTO) {
+        throw std::logic_error("run_targets requires a resolved strategy");
+    }
+    const auto index = static_cast<size_t>(strategy);
+    const auto start = std::chrono::steady_clock::now();
+    Profiler::Scope run_scope{};
+    if (profiler_ != nullptr) {
+        run_scope = profiler_->begin_run();
+    }
+    FlightRecorder::RunScope flight_scope{};
+    if (flight_recorder_ != nullptr) {
+        flight_scope = flight_recorder_->begin_run();
+    }
+    try {
+        execute_targets(strategy, target_node_ids);
+    } catch (...) {
+        metrics_.run_failures->add();
+        throw;
+    }
+    if (profiler_ != nullptr) {
+        profiler_->record_run(strategy_name(strategy), run_scope);
+    }
+    if (flight_recorder_ != nullptr && flight_recorder_->end_run(flight_scope)) [[unlikely]] {
+        std::vector<std::pair<std::string, size_t>> feed_bytes;
+        feed_bytes.reserve(feed_dict_.size());
+        for (const auto& [id, value] : feed_dict_) {
+            feed_bytes.emplace_back(std::string(id), value.size());
+        }
+        std::ranges::sort(feed_bytes);
+        flight_recorder_->dump(flight_scope, strategy_name(strategy), graph_.name(), feed_bytes);
+    }
+    metrics_.runs[index]->add();
+    metrics_.run_latency[index]->observe(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+}
+
+void Executor::execute_targets(ExecutionStrategy strategy,
+                               std::span<const std::string_view> target_node_ids) {
     prepare_graph();
-    
-    visiting_.clear(); // Reset for new computation
-    
-    // Support "node:index" syntax for accessing multi-output nodes
-    auto parsed = parse_input_id(target_node_id);
-    Node& target_node = graph_.get_node(parsed.node_id);
-    compute_node_recursive(target_node);
-    
-    if (!target_node.computed_result.has_value()) {
-        throw std::runtime_error(
-            std::format("Node '{}' computation failed", target_node.id));
+    if (profiler_ != nullptr) {
+        profiler_->prepare();
     }
-    
-    return std::visit([&](auto&& result) -> const std::string& {
-        using T = std::decay_t<decltype(result)>;
-        if constexpr (std::is_same_v<T, std::string>) {
-            // Single-output node
-            if (parsed.output_index.has_value()) {
-                throw std::runtime_error(
-                    std::format("Node '{}' is a single-output node, cannot use index",
-                                parsed.node_id));
+    if (verified_ != nullptr) {
+        execute_verified_targets(strategy, target_node_ids);
+        return;
+    }
+
+    switch (strategy) {
+        case ExecutionStrategy::RECURSIVE:
+            visiting_.clear(); // Reset for new computation
+            for (std::string_view target_node_id : target_node_ids) {
+                // Support "node:index" syntax for accessing multi-output nodes
+                auto parsed = parse_input_id(target_node_id);
+                compute_node_recursive(graph_.get_node(parsed.node_id));
             }
-            return result;
-        } else {  
-            // Multi-output node
-            if (!parsed.output_index.has_value()) {
-                throw std::runtime_error(
-                    std::format("Node '{}' is a multi-output node, must specify index (e.g., '{}:0')",
-                                parsed.node_id, parsed.node_id));
+            break;
+
+        case ExecutionStrategy::ITERATIVE:
+            for (Node* node : topological_sort_subgraph(target_node_ids)) {
+                execute_node(*node);
             }
-            size_t index = *parsed.output_index;
-            if (index >= result.size()) {
-                throw std::runtime_error(
-                    std::format("Index {} out of bounds for node '{}' (size: {})",
-                                index, parsed.node_id, result.size()));
+            break;
+
+        case ExecutionStrategy::PARALLEL:
+            for (const auto& layer : subgraph_layers(target_node_ids)) {
+                metrics_.layer_width->observe(layer.size());
+                execute_layer(layer, [this](Node* node) { execute_node(*node); });
             }
-            return result[index];
-        }
-    }, *target_node.computed_result);
+            break;
+
+        case ExecutionStrategy::AUTO:
+            throw std::logic_error("execute_targets requires a resolved strategy");
+    }
 }   
 
 void Executor::compute_node_recursive(Node& node) {
@@ -248,18 +1063,9 @@ void Executor::compute_node_recursive(Node& node) {
             return;
             
         case NodeType::PLACEHOLDER:
-            // Get value from feed_dict
-            {
-                auto it = feed_dict_.find(node.id);
-                if (it == feed_dict_.end()) {
-                    throw std::runtime_error(
-                        std::format("PLACEHOLDER node '{}' missing from feed_dict", node.id));
-                }
-                node.computed_result = it->second;
-                node.state = NodeState::COMPUTED;
-                visiting_.erase(node.id);
-                return;
-            }
+            bind_placeholder(node);
+            visiting_.erase(node.id);
+            return;
             
         case NodeType::OPERATION:
             // Continue to operation execution below
@@ -276,44 +1082,7 @@ void Executor::compute_node_recursive(Node& node) {
         Node& input_node = graph_.get_node(parsed.node_id);
         compute_node_recursive(input_node);
 
-        if (parsed.output_index.has_value()) {
-            size_t index = *parsed.output_index;
-            
-            if (!input_node.computed_result.has_value()) {
-                throw std::runtime_error(std::format("Input node '{}' has no computed result", input_id_str));
-            }
-
-            std::visit([&](auto&& result) {
-                using T = std::decay_t<decltype(result)>;
-                if constexpr (std::is_same_v<T, std::string>) {
-                    throw std::runtime_error(
-                        std::format("Node '{}' is not a multi-output node, cannot access index {}",
-                                    parsed.node_id, index));
-                } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
-                    if (index >= result.size()) {
-                        throw std::runtime_error(
-                            std::format("Index {} out of bounds for node '{}' (size: {})",
-                                        index, parsed.node_id, result.size()));
-                    }
-                    input_values.emplace_back(result[index]);
-                }
-            }, *input_node.computed_result);
-        } else {
-            if (!input_node.computed_result.has_value()) {
-                throw std::runtime_error(std::format("Input node '{}' has no computed result", input_id_str));
-            }
-
-            std::visit([&](auto&& result) {
-                using T = std::decay_t<decltype(result)>;
-                if constexpr (std::is_same_v<T, std::string>) {
-                    input_values.emplace_back(result);
-                } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
-                    throw std::runtime_error(
-                        std::format("Node '{}' is a multi-output node, must specify index (e.g., '{}:0')",
-                                    parsed.node_id, parsed.node_id));
-                }
-            }, *input_node.computed_result);
-        }
+        input_values.emplace_back(input_value(input_node, parsed, input_id_str));
     }
 
     // Prepare constants
@@ -323,142 +1092,45 @@ void Executor::compute_node_recursive(Node& node) {
         constant_values.emplace_back(constant);
     }
 
-    StringOperation op = OperationRegistry::get_instance().get_op(node.op_name);
-    node.computed_result.emplace(op(input_values, constant_values));
-    node.state = NodeState::COMPUTED;
+    run_operation(node, OperationRegistry::get_instance().get_op(node.op_name), input_values, constant_values);
     
     visiting_.erase(node.id);
 }
 
-std::unordered_map<std::string, int> Executor::compute_in_degrees() const {
-    std::unordered_map<std::string, int> in_degree;
-    
-    for (const auto& [id, node] : graph_.get_nodes()) {
-        in_degree[id] = static_cast<int>(node.input_ids.size());
-    }
-    
-    return in_degree;
-}
-
-std::vector<Node*> Executor::kahn_algorithm(
-    const std::unordered_set<std::string>& nodes,
-    const std::unordered_map<std::string, int>& in_degree,
-    const std::unordered_map<std::string, std::vector<std::string>>& dependents
-) {
-    // Initialize queue with zero in-degree nodes
-    std::queue<Node*> zero_degree_queue;
-    for (const auto& id : nodes) {
-        if (in_degree.at(id) == 0) {
-            zero_degree_queue.push(&graph_.get_node(id));
-        }
-    }
-    
-    // Local copy for modification during BFS
-    auto in_degree_copy = in_degree;
-    
-    // BFS topological sort
-    std::vector<Node*> sorted;
-    sorted.reserve(nodes.size());
-    
-    while (!zero_degree_queue.empty()) {
-        Node* current = zero_degree_queue.front();
-        zero_degree_queue.pop();
-        sorted.push_back(current);
-        
-        // Update dependent nodes
-        auto it = dependents.find(current->id);
-        if (it != dependents.end()) {
-            for (const auto& dependent_id : it->second) {
-                in_degree_copy[dependent_id]--;
-                if (in_degree_copy[dependent_id] == 0) {
-                    zero_degree_queue.push(&graph_.get_node(dependent_id));
-                }
-            }
-        }
-    }
-    
-    // Cycle detection
-    if (sorted.size() != nodes.size()) {
-        throw std::runtime_error("Cycle detected in graph");
-    }
-    
-    return sorted;
-}
-
 std::vector<Node*> Executor::topological_sort() {
-    // Prepare node set
-    std::unordered_set<std::string> all_nodes;
+    std::vector<std::string_view> all_nodes;
+    all_nodes.reserve(graph_.get_nodes().size());
     for (const auto& [id, _] : graph_.get_nodes()) {
-        all_nodes.insert(id);
+        all_nodes.push_back(id);
     }
-    
-    // Compute in-degrees
-    auto in_degree = compute_in_degrees();
-    
-    // Build dependents map (reverse adjacency list)
-    std::unordered_map<std::string, std::vector<std::string>> dependents;
-    for (auto& [id, node] : graph_.get_nodes()) {
-        for (const auto& input_id_str : node.input_ids) {
-            // Extract actual node ID (remove index if present)
-            auto parsed = parse_input_id(input_id_str);
-            std::string actual_input_id(parsed.node_id);
-            dependents[actual_input_id].push_back(id);
-        }
+    try {
+        return flatten_layers(subgraph_layers(all_nodes));
+    } catch (const CycleError&) {
+        throw std::runtime_error("Cycle detected in graph");
     }
-    
-    // Run Kahn's algorithm
-    return kahn_algorithm(all_nodes, in_degree, dependents);
 }
 
 std::vector<Node*> Executor::topological_sort_subgraph(std::string_view target_node_id) {
-    // Step 1: Mark all reachable nodes from target via DFS
-    std::unordered_set<std::string> reachable;
-    std::function<void(const std::string&)> mark_reachable;
-    
-    mark_reachable = [&](const std::string& id) {
-        // Extract actual node ID (remove index if present)
-        auto parsed = parse_input_id(id);
-        std::string actual_node_id(parsed.node_id);
-        
-        if (reachable.contains(actual_node_id)) {
-            return;
-        }
-        reachable.insert(actual_node_id);
-        
-        Node& node = graph_.get_node(actual_node_id);
-        for (const auto& input_id : node.input_ids) {
-            mark_reachable(input_id);
-        }
-    };
-    
-    mark_reachable(std::string(target_node_id));
-    
-    // Step 2: Compute in-degrees and dependents for subgraph
-    std::unordered_map<std::string, int> in_degree;
-    std::unordered_map<std::string, std::vector<std::string>> dependents;
-    
-    for (const auto& id : reachable) {
-        Node& node = graph_.get_node(id);
-        in_degree[id] = 0;
-        
-        for (const auto& input_id_str : node.input_ids) {
-            // Extract actual node ID (remove index if present)
-            auto parsed = parse_input_id(input_id_str);
-            std::string actual_input_id(parsed.node_id);
-            
-            if (reachable.contains(actual_input_id)) {
-                in_degree[id]++;
-                dependents[actual_input_id].push_back(id);
-            }
-        }
-    }
-    
-    // Step 3: Run Kahn's algorithm on the subgraph
+    return topological_sort_subgraph(std::span(&target_node_id, 1));
+}
+
+std::vector<Node*> Executor::topological_sort_subgraph(
+    std::span<const std::string_view> target_node_ids) {
+    return flatten_layers(subgraph_layers(target_node_ids));
+}
+
+std::vector<std::vector<Node*>> Executor::topological_layers(std::string_view target_node_id) {
+    return subgraph_layers(std::span(&target_node_id, 1));
+}
+
+std::vector<std::vector<Node*>> Executor::subgraph_layers(
+    std::span<const std::string_view> target_node_ids) {
     try {
-        return kahn_algorithm(reachable, in_degree, dependents);
-    } catch (const std::runtime_error& e) {
-        // Add context about which subgraph failed
-        throw std::runtime_error(std::format("Cycle detected in subgraph of '{}'", target_node_id));
+        SubgraphPlan plan(graph_, target_node_ids);
+        return plan.layers();
+    } catch (const CycleError&) {
+        throw std::runtime_error(std::format("Cycle detected in subgraph of '{}'",
+                                             target_node_ids.empty() ? "" : target_node_ids.front()));
     }
 }
 
@@ -478,17 +1150,8 @@ void Executor::execute_node(Node& node) {
             return;
             
         case NodeType::PLACEHOLDER:
-            // Get value from feed_dict
-            {
-                auto it = feed_dict_.find(node.id);
-                if (it == feed_dict_.end()) {
-                    throw std::runtime_error(
-                        std::format("PLACEHOLDER node '{}' missing from feed_dict", node.id));
-                }
-                node.computed_result = it->second;
-                node.state = NodeState::COMPUTED;
-                return;
-            }
+            bind_placeholder(node);
+            return;
             
         case NodeType::OPERATION:
             // Continue to operation execution below
@@ -503,42 +1166,12 @@ void Executor::execute_node(Node& node) {
         auto parsed = parse_input_id(input_id_str);
         Node& input_node = graph_.get_node(parsed.node_id);
         
-        if (!input_node.computed_result.has_value()) {
+        if (input_node.state != NodeState::COMPUTED) {
             throw std::runtime_error(
                 std::format("Input node '{}' not computed (topological order error)", parsed.node_id));
         }
         
-        // Access the appropriate output based on whether index is specified
-        if (parsed.output_index.has_value()) {
-            size_t index = *parsed.output_index;
-            
-            std::visit([&](auto&& result) {
-                using T = std::decay_t<decltype(result)>;
-                if constexpr (std::is_same_v<T, std::string>) {
-                    throw std::runtime_error(
-                        std::format("Node '{}' is not a multi-output node, cannot access index {}",
-                                    parsed.node_id, index));
-                } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
-                    if (index >= result.size()) {
-                        throw std::runtime_error(
-                            std::format("Index {} out of bounds for node '{}' (size: {})",
-                                        index, parsed.node_id, result.size()));
-                    }
-                    input_values.emplace_back(result[index]);
-                }
-            }, *input_node.computed_result);
-        } else {
-            std::visit([&](auto&& result) {
-                using T = std::decay_t<decltype(result)>;
-                if constexpr (std::is_same_v<T, std::string>) {
-                    input_values.emplace_back(result);
-                } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
-                    throw std::runtime_error(
-                        std::format("Node '{}' is a multi-output node, must specify index (e.g., '{}:0')",
-                                    parsed.node_id, parsed.node_id));
-                }
-            }, *input_node.computed_result);
-        }
+        input_values.emplace_back(input_value(input_node, parsed, input_id_str));
     }
     
     std::vector<std::string_view> constant_values;
@@ -547,129 +1180,280 @@ void Executor::execute_node(Node& node) {
         constant_values.emplace_back(constant);
     }
     
-    StringOperation op = OperationRegistry::get_instance().get_op(node.op_name);
-    node.computed_result.emplace(op(input_values, constant_values));
-    node.state = NodeState::COMPUTED;
+    run_operation(node, OperationRegistry::get_instance().get_op(node.op_name), input_values, constant_values);
 }
 
-const std::string& Executor::compute_iterative(std::string_view target_node_id, const FeedDict& feed_dict) {
-    // Save feed_dict for use during execution
-    feed_dict_ = feed_dict;
-    
-    // Prepare graph for execution (reset state)
-    prepare_graph();
-    
-    auto sorted = topological_sort_subgraph(target_node_id);
-    
-    for (Node* node : sorted) {
-        execute_node(*node);
+void Executor::run_operation(Node& node,
+                             const StringOperation& op,
+                             std::span<const std::string_view> input_values,
+                             std::span<const std::string_view> constant_values,
+                             std::optional<bool> multi_output) {
+    try {
+        if (profiler_ == nullptr) [[likely]] {
+            if (flight_recorder_ == nullptr) [[likely]] {
+                node.computed_result.emplace(op(input_values, constant_values));
+            } else {
+                const uint64_t start = FlightRecorder::now();
+                node.computed_result.emplace(op(input_values, constant_values));
+                flight_recorder_->record(node, start);
+            }
+        } else {
+            // Profiling and flight recording are independent of each other
+            size_t input_bytes = 0;
+            for (std::string_view value : input_values) {
+                input_bytes += value.size();
+            }
+            const uint64_t start = flight_recorder_ != nullptr ? FlightRecorder::now() : 0;
+            Profiler::Scope scope = profiler_->begin();
+            node.computed_result.emplace(op(input_values, constant_values));
+            profiler_->record(node, scope, input_bytes, result_size(*node.computed_result));
+            if (flight_recorder_ != nullptr) {
+                flight_recorder_->record(node, start);
+            }
+        }
+    } catch (...) {
+        EngineMetrics::record_op_exception(node.op_name);
+        throw;
     }
-    
-    // Support "node:index" syntax
-    auto parsed = parse_input_id(target_node_id);
-    Node& target = graph_.get_node(parsed.node_id);
-    if (!target.computed_result.has_value()) {
-        throw std::runtime_error(
-            std::format("Target node '{}' has no computed result", parsed.node_id));
+    if (multi_output.has_value() &&
+        std::holds_alternative<std::vector<std::string>>(*node.computed_result) != *multi_output) {
+        node.computed_result.reset();
+        throw std::runtime_error(std::format(
+            "Operation '{}' of node '{}' returned {} output, but its signature declares {} output",
+            node.op_name, node.id, *multi_output ? "single" : "multi", *multi_output ? "multi" : "single"));
     }
-    
-    return std::visit([&](auto&& result) -> const std::string& {
-        using T = std::decay_t<decltype(result)>;
-        if constexpr (std::is_same_v<T, std::string>) {
-            if (parsed.output_index.has_value()) {
-                throw std::runtime_error(
-                    std::format("Node '{}' is a single-output node, cannot use index",
-                                parsed.node_id));
+    metrics_.nodes_executed->add();
+    metrics_.bytes_produced->add(result_size(*node.computed_result));
+    node.state = NodeState::COMPUTED;
+}
+
+void Executor::execute_verified_targets(ExecutionStrategy strategy,
+                                        std::span<const std::string_view> target_node_ids) {
+    switch (strategy) {
+        case ExecutionStrategy::RECURSIVE:
+            for (std::string_view target_node_id : target_node_ids) {
+                compute_verified_recursive(verified_->id_of(target_node_id));
             }
-            return result;
-        } else {  
-            if (!parsed.output_index.has_value()) {
-                throw std::runtime_error(
-                    std::format("Node '{}' is a multi-output node, must specify index (e.g., '{}:0')",
-                                parsed.node_id, parsed.node_id));
+            break;
+
+        case ExecutionStrategy::ITERATIVE:
+            for (const auto& layer : verified_layers(target_node_ids)) {
+                for (uint32_t id : layer) {
+                    execute_verified(id);
+                }
             }
-            size_t index = *parsed.output_index;
-            if (index >= result.size()) {
-                throw std::runtime_error(
-                    std::format("Index {} out of bounds for node '{}' (size: {})",
-                                index, parsed.node_id, result.size()));
+            break;
+
+        case ExecutionStrategy::PARALLEL:
+            for (const auto& layer : verified_layers(target_node_ids)) {
+                metrics_.layer_width->observe(layer.size());
+                execute_layer(layer, [this](uint32_t id) { execute_verified(id); });
             }
-            return result[index];
+            break;
+
+        case ExecutionStrategy::AUTO:
+            throw std::logic_error("execute_targets requires a resolved strategy");
+    }
+}
+
+std::vector<std::vector<uint32_t>> Executor::verified_layers(
+    std::span<const std::string_view> target_node_ids) {
+    VerifiedPlan& plan = *verified_;
+    if (++plan.epoch == 0) {
+        std::ranges::fill(plan.marks, 0);
+        plan.epoch = 1;
+    }
+
+    // Everything reachable from the targets, without recursion
+    std::vector<uint32_t> reached;
+    for (std::string_view target_node_id : target_node_ids) {
+        const uint32_t id = plan.id_of(target_node_id);
+        if (plan.marks[id] != plan.epoch) {
+            plan.marks[id] = plan.epoch;
+            reached.push_back(id);
         }
-    }, *target.computed_result);
+    }
+    for (size_t next = 0; next < reached.size(); ++next) {
+        const auto& entry = plan.entries[reached[next]];
+        for (uint32_t e = entry.inputs_begin; e < entry.inputs_end; ++e) {
+            const uint32_t input = plan.inputs[e].id;
+            if (plan.marks[input] != plan.epoch) {
+                plan.marks[input] = plan.epoch;
+                reached.push_back(input);
+            }
+        }
+    }
+
+    // A node's level only depends on its inputs, so the graph's levels
+    // are the subgraph's; ids are ordered by level already
+    std::ranges::sort(reached);
+    std::vector<std::vector<uint32_t>> layers;
+    for (uint32_t id : reached) {
+        const uint32_t level = plan.entries[id].level;
+        while (layers.size() <= level) {
+            layers.emplace_back();
+        }
+        layers[level].push_back(id);
+    }
+    std::erase_if(layers, [](const auto& layer) { return layer.empty(); });
+    return layers;
 }
 
-std::vector<std::vector<Node*>> Executor::partition_by_layers(
-    const std::vector<Node*>& sorted_nodes) const {
+void Executor::compute_verified_recursive(uint32_t id) {
+    const auto& entry = verified_->entries[id];
+    if (entry.node->state == NodeState::COMPUTED) {
+        return;
+    }
+    for (uint32_t e = entry.inputs_begin; e < entry.inputs_end; ++e) {
+        compute_verified_recursive(verified_->inputs[e].id);
+    }
+    execute_verified(id);
+}
 
-    std::unordered_map<std::string, int> node_level;
-    std::vector<std::vector<Node*>> layers;
+void Executor::execute_verified(uint32_t id) {
+    const auto& entry = verified_->entries[id];
+    Node& node = *entry.node;
+    if (node.state == NodeState::COMPUTED) {
+        return;
+    }
+    switch (node.type) {
+        case NodeType::CONSTANT:
+        case NodeType::VARIABLE:
+            // A variable without an initial value has never been computed
+            throw std::runtime_error(std::format("Node '{}' has no computed result", node.id));
 
-    for (Node* node : sorted_nodes) {
-        int max_input_level = 0;
+        case NodeType::PLACEHOLDER:
+            bind_placeholder(node);
+            return;
 
-        for (const auto& input_id_str : node->input_ids) {
-            // Extract actual node ID (remove index if present)
-            auto parsed = parse_input_id(input_id_str);
-            std::string actual_input_id(parsed.node_id);
-            
-            auto it = node_level.find(actual_input_id);
-            if (it != node_level.end()) {
-                max_input_level = std::max(max_input_level, it->second);
+        case NodeType::OPERATION:
+            break;
+    }
+
+    // Inputs are computed and of the verified kind; only indices depend on the
+    // data. The values live on this call's stack: an operation may run another
+    // graph on the same thread while they are in use.
+    constexpr size_t INLINE_INPUTS = 8;
+    const size_t input_count = entry.inputs_end - entry.inputs_begin;
+    std::array<std::string_view, INLINE_INPUTS> inline_values;
+    std::vector<std::string_view> heap_values;
+    std::span<std::string_view> input_values(inline_values.data(), input_count);
+    if (input_count > INLINE_INPUTS) {
+        heap_values.resize(input_count);
+        input_values = heap_values;
+    }
+    for (size_t i = 0; i < input_count; ++i) {
+        const auto& input = verified_->inputs[entry.inputs_begin + i];
+        const Node& input_node = *input.node;
+        if (input_node.bound_value.has_value()) {
+            input_values[i] = *input_node.bound_value;
+        } else if (input.index == VerifiedPlan::NO_INDEX) {
+            input_values[i] = *std::get_if<std::string>(&*input_node.computed_result);
+        } else {
+            const auto& outputs = *std::get_if<std::vector<std::string>>(&*input_node.computed_result);
+            if (input.index >= outputs.size()) {
+                throw std::runtime_error(
+                    std::format("Index {} out of bounds for node '{}' (size: {})",
+                                input.index, input_node.id, outputs.size()));
             }
+            input_values[i] = outputs[input.index];
         }
+    }
 
-        int current_level = max_input_level + 1;
-        node_level[node->id] = current_level;
+    run_operation(node, entry.op, input_values,
+                  std::span(verified_->constants).subspan(entry.constants_begin,
+                                                          entry.constants_end - entry.constants_begin),
+                  entry.multi_output);
+}
 
-        if (layers.size() <= static_cast<size_t>(current_level)) {
-            layers.resize(current_level + 1);
-        }
+const std::string& Executor::compute_iterative(std::string_view target_node_id, const FeedDict& feed_dict) {
+    FeedBinding feeds(*this, feed_dict);
+    return run_iterative(target_node_id);
+}
 
-        layers[current_level].push_back(node);
-    }
+const std::string& Executor::run_iterative(std::string_view target_node_id) {
+    run_targets(ExecutionStrategy::ITERATIVE, std::span(&target_node_id, 1));
+    return target_result(target_node_id);
+}
 
-    return layers;
+const std::string& Executor::compute_parallel(std::string_view target_node_id, const FeedDict& feed_dict) {
+    FeedBinding feeds(*this, feed_dict);
+    return run_parallel(target_node_id);
 }
 
-void Executor::execute_layer(const std::vector<Node*>& layer) {
-    if (layer.size() >= MIN_PARALLEL_LAYER_SIZE) {
-#ifdef USE_OPENMP
-        // OpenMP available: parallel execution
-        #pragma omp parallel for schedule(dynamic)
-        for (size_t i = 0; i < layer.size(); ++i) {
-            execute_node(*layer[i]);
-        }
-#else
-        // OpenMP not available: fall back to sequential execution
-        for (Node* node : layer) {
-            execute_node(*node);
-        }
-#endif
-    } else {
-        // Layer too small: sequential execution to avoid overhead
-        for (Node* node : layer) {
-            execute_node(*node);
+const std::string& Executor::run_parallel(std::string_view target_node_id) {
+    run_targets(ExecutionStrategy::PARALLEL, std::span(&target_node_id, 1));
+    return target_result(target_node_id);
+}
+
+Executor::FeedBinding::FeedBinding(Executor& executor, const FeedDict& feed_dict,
+                                   const FileFeedDict& file_feeds)
+    : executor_(executor) {
+    FeedViewDict& bound = executor_.feed_dict_;
+    bound.clear();
+    for (const auto& [id, value] : feed_dict) {
+        bound.emplace(id, value);
+    }
+    mappings_.reserve(file_feeds.size());
+    try {
+        for (const auto& [id, feed] : file_feeds) {
+            if (bound.contains(id)) {
+                throw std::runtime_error(std::format(
+                    "Placeholder '{}' is fed both from a file and from the feed dictionary", id));
+            }
+            mappings_.emplace_back(feed.path, feed.offset, feed.length);
+            mappings_.back().advise_sequential();
+            bound[id] = mappings_.back().view();
         }
+    } catch (...) {
+        // The destructor does not run for a throwing constructor
+        release();
+        throw;
     }
 }
 
-const std::string& Executor::compute_parallel(std::string_view target_node_id, const FeedDict& feed_dict) {
-    // Save feed_dict for use during execution
-    feed_dict_ = feed_dict;
-    
-    prepare_graph();
-    
-    auto sorted_nodes = topological_sort_subgraph(target_node_id);
-    auto layers = partition_by_layers(sorted_nodes);
+Executor::FeedBinding::FeedBinding(Executor& executor, const FeedViewDict& feed_views)
+    : executor_(executor) {
+    executor_.feed_dict_ = feed_views;
+}
 
-    for (const auto& layer : layers) {
-        execute_layer(layer);
+Executor::FeedBinding::~FeedBinding() {
+    release();
+}
+
+void Executor::FeedBinding::release() noexcept {
+    // Values are only bound from feed_dict_, so its keys name every bound node
+    auto& nodes = executor_.graph_.get_nodes();
+    for (const auto& [id, value] : executor_.feed_dict_) {
+        auto node = nodes.find(id);
+        if (node != nodes.end()) {
+            node->second.bound_value.reset();
+        }
+    }
+    executor_.feed_dict_.clear();
+}
+
+void Executor::bind_placeholder(Node& node) {
+    // Get value from feed_dict; the value is read in place, not copied
+    auto it = feed_dict_.find(node.id);
+    if (it == feed_dict_.end()) {
+        throw std::runtime_error(
+            std::format("PLACEHOLDER node '{}' missing from feed_dict", node.id));
     }
+    node.bound_value = it->second;
+    node.state = NodeState::COMPUTED;
+}
 
+const std::string& Executor::target_result(std::string_view target_node_id) {
     // Support "node:index" syntax
     auto parsed = parse_input_id(target_node_id);
     Node& target = graph_.get_node(parsed.node_id);
+
+    // Placeholder targets are materialized so a string reference can be returned
+    if (target.bound_value.has_value() && !target.computed_result.has_value()) {
+        target.computed_result.emplace(std::string(*target.bound_value));
+    }
+
     if (!target.computed_result.has_value()) {
         throw std::runtime_error(
             std::format("Target node '{}' has no computed result", parsed.node_id));
@@ -707,6 +1491,7 @@ void Executor::prepare_graph() {
         if (node.type != NodeType::VARIABLE) {
             node.state = NodeState::PENDING;
             node.computed_result.reset();
+            node.bound_value.reset();
         }
 
         // Initialize nodes based on type
@@ -0,0 +1,133 @@
+#include "strgraph/explain.h"
+#include "strgraph/executor.h"
+#include <json.hpp>
+#include <format>
+
+namespace {
+
+std::string_view type_name(strgraph::NodeType type) {
+    switch (type) {
+        case strgraph::NodeType::CONSTANT:    return "constant";
+        case strgraph::NodeType::PLACEHOLDER: return "placeholder";
+        case strgraph::NodeType::VARIABLE:    return "variable";
+        case strgraph::NodeType::OPERATION:   return "operation";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief `op(a, b, "constant")` for operations, the node type otherwise.
+ */
+std::string describe(const strgraph::ExplainNode& node) {
+    if (node.type != strgraph::NodeType::OPERATION) {
+        return std::string(type_name(node.type));
+    }
+    std::string text = node.op_name + "(";
+    for (size_t i = 0; i < node.input_ids.size(); ++i) {
+        if (i > 0) text += ", ";
+        text += node.input_ids[i];
+    }
+    for (const auto& constant : node.constants) {
+        text += std::format("{}\"{}\"", text.back() == '(' ? "" : ", ", constant);
+    }
+    return text + ")";
+}
+
+} // anonymous namespace
+
+namespace strgraph {
+
+std::string Explanation::to_text() const {
+    std::string out = std::format("{} {}\n", analyzed ? "EXPLAIN ANALYZE" : "EXPLAIN", target);
+    out += std::format("Strategy: {} ({})\n", strategy_name(decision.strategy),
+                       decision.requested == ExecutionStrategy::AUTO ? "auto" : "requested");
+    for (const auto& reason : decision.reasons) {
+        out += std::format("  - {}\n", reason);
+    }
+    out += std::format("Nodes: {} of {} reachable, {} layers, widest {}\n",
+                       decision.node_count, graph_nodes, layers.size(), decision.max_layer_width);
+    if (!optimizations.empty()) {
+        out += "Optimizations:\n";
+        for (const auto& optimization : optimizations) {
+            out += std::format("  - {}\n", optimization);
+        }
+    }
+
+    for (size_t layer = 0; layer < layers.size(); ++layer) {
+        out += std::format("Layer {} (width {})\n", layer, layers[layer].size());
+        for (size_t index : layers[layer]) {
+            const ExplainNode& node = nodes[index];
+            out += std::format("  {} = {}  est_bytes={} est_cost={}",
+                               node.id, describe(node), node.estimated_bytes, node.estimated_cost);
+            if (node.actual_ns) {
+                out += std::format("  actual={:.3f}us in={} out={} worker={}",
+                                   static_cast<double>(*node.actual_ns) / 1000.0,
+                                   node.input_bytes, node.output_bytes, node.thread);
+            }
+            out += '\n';
+        }
+    }
+
+    if (analyzed) {
+        out += std::format("Execution time: {:.3f} ms\n", static_cast<double>(total_ns) / 1e6);
+    }
+    return out;
+}
+
+std::string Explanation::to_json(int indent) const {
+    nlohmann::json plan_nodes = nlohmann::json::array();
+    for (const auto& node : nodes) {
+        nlohmann::json item = {
+            {"id", node.id},
+            {"type", type_name(node.type)},
+            {"layer", node.layer},
+            {"estimated_bytes", node.estimated_bytes},
+            {"estimated_cost", node.estimated_cost}
+        };
+        if (node.type == NodeType::OPERATION) {
+            item["op"] = node.op_name;
+            item["inputs"] = node.input_ids;
+            item["constants"] = node.constants;
+        }
+        if (node.actual_ns) {
+            item["actual_ns"] = *node.actual_ns;
+            item["input_bytes"] = node.input_bytes;
+            item["output_bytes"] = node.output_bytes;
+            item["thread"] = node.thread;
+        }
+        plan_nodes.push_back(std::move(item));
+    }
+
+    nlohmann::json layer_ids = nlohmann::json::array();
+    for (const auto& layer : layers) {
+        nlohmann::json ids = nlohmann::json::array();
+        for (size_t index : layer) {
+            ids.push_back(nodes[index].id);
+        }
+        layer_ids.push_back(std::move(ids));
+    }
+
+    nlohmann::json result = {
+        {"target", target},
+        {"analyzed", analyzed},
+        {"strategy", {
+            {"requested", strategy_name(decision.requested)},
+            {"chosen", strategy_name(decision.strategy)},
+            {"estimated_depth", decision.estimated_depth},
+            {"node_count", decision.node_count},
+            {"max_layer_width", decision.max_layer_width},
+            {"openmp", decision.openmp},
+            {"reasons", decision.reasons}
+        }},
+        {"graph_nodes", graph_nodes},
+        {"layers", std::move(layer_ids)},
+        {"nodes", std::move(plan_nodes)},
+        {"optimizations", optimizations}
+    };
+    if (analyzed) {
+        result["total_ns"] = total_ns;
+    }
+    return result.dump(indent);
+}
+
+} // namespace strgraph
@@ -0,0 +1,182 @@
+#include "strgraph/flight_recorder.h"
+#include <json.hpp>
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <unistd.h>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace strgraph {
+
+namespace {
+
+size_t max_workers() noexcept {
+#ifdef USE_OPENMP
+    return static_cast<size_t>(std::max(omp_get_max_threads(), 1));
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Graph name usable in a file name.
+ */
+std::string file_name_part(std::string_view name) {
+    std::string result;
+    for (char c : name) {
+        bool safe = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                    c == '-' || c == '_' || c == '.';
+        result.push_back(safe ? c : '_');
+    }
+    return result.empty() ? "graph" : result;
+}
+
+} // anonymous namespace
+
+FlightRecorder::FlightRecorder(FlightRecorderOptions options)
+    : options_(std::move(options)),
+      mask_(std::bit_ceil(std::max<size_t>(options_.events_per_thread, 2)) - 1),
+      epoch_ticks_(now()),
+      epoch_(std::chrono::steady_clock::now()) {
+}
+
+size_t FlightRecorder::worker_index() noexcept {
+#ifdef USE_OPENMP
+    return static_cast<size_t>(omp_get_thread_num());
+#else
+    return 0;
+#endif
+}
+
+std::vector<std::string> FlightRecorder::dumps() const {
+    std::lock_guard lock(dumps_mutex_);
+    return dumps_;
+}
+
+FlightRecorder::RunScope FlightRecorder::begin_run() {
+    while (rings_.size() < max_workers()) {
+        auto ring = std::make_unique<Ring>();
+        ring->events = std::make_unique<Event[]>(mask_ + 1);
+        rings_.push_back(std::move(ring));
+    }
+    for (auto& ring : rings_) {
+        ring->run_start = ring->head.load(std::memory_order_relaxed);
+    }
+    RunScope scope;
+    scope.run = ++run_;
+    scope.start = std::chrono::steady_clock::now();
+    scope.start_ticks = now();
+    return scope;
+}
+
+bool FlightRecorder::end_run(RunScope& scope) noexcept {
+    scope.duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - scope.start).count());
+    if (scope.duration_ns < options_.threshold_ns) [[likely]] {
+        return false;
+    }
+    std::lock_guard lock(dumps_mutex_);
+    return options_.max_dumps == 0 || dumps_.size() < options_.max_dumps;
+}
+
+double FlightRecorder::ns_per_tick() const noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    // Calibrated over the recorder's lifetime, which covers at least the slow run
+    const uint64_t ticks = now() - epoch_ticks_;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count();
+    return ticks > 0 ? static_cast<double>(ns) / static_cast<double>(ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+std::string FlightRecorder::dump(const RunScope& scope, std::string_view strategy, std::string_view graph_name,
+                                 std::span<const std::pair<std::string, size_t>> feed_bytes) {
+    const double scale = ns_per_tick();
+    auto to_us = [&](uint64_t ticks) {
+        return static_cast<double>(ticks - std::min(ticks, scope.start_ticks)) * scale / 1000.0;
+    };
+
+    nlohmann::json trace_events = nlohmann::json::array();
+    uint64_t dropped = 0;
+    for (size_t thread = 0; thread < rings_.size(); ++thread) {
+        const Ring& ring = *rings_[thread];
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        const uint64_t recorded = head - ring.run_start;
+        const uint64_t kept = std::min(recorded, mask_ + 1);
+        dropped += recorded - kept;
+        if (kept == 0) {
+            continue;
+        }
+        trace_events.push_back({
+            {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", thread},
+            {"args", {{"name", std::format("worker {}", thread)}}}
+        });
+        for (uint64_t i = head - kept; i < head; ++i) {
+            const Event& event = ring.events[i & mask_];
+            if (event.run != scope.run) {
+                continue;
+            }
+            trace_events.push_back({
+                {"name", event.node->id},
+                {"cat", event.node->op_name},
+                {"ph", "X"},
+                {"ts", to_us(event.start)},
+                {"dur", static_cast<double>(event.end - event.start) * scale / 1000.0},
+                {"pid", 1},
+                {"tid", thread},
+                {"args", {{"op", event.node->op_name}}}
+            });
+        }
+    }
+
+    nlohmann::json feeds = nlohmann::json::object();
+    for (const auto& [id, bytes] : feed_bytes) {
+        feeds[id] = bytes;
+    }
+    trace_events.push_back({
+        {"name", std::format("run ({})", strategy)},
+        {"cat", "run"},
+        {"ph", "X"},
+        {"ts", 0.0},
+        {"dur", static_cast<double>(scope.duration_ns) / 1000.0},
+        {"pid", 1},
+        {"tid", 0},
+        {"args", {
+            {"strategy", strategy},
+            {"graph", graph_name},
+            {"run", scope.run},
+            {"duration_ns", scope.duration_ns},
+            {"threshold_ns", options_.threshold_ns},
+            {"feed_bytes", std::move(feeds)},
+            {"dropped_events", dropped}
+        }}
+    });
+    nlohmann::json trace = {
+        {"traceEvents", std::move(trace_events)},
+        {"displayTimeUnit", "ns"}
+    };
+
+    std::filesystem::path path = std::filesystem::path(options_.trace_dir) /
+        std::format("strgraph-slow-{}-{}-{}.json", file_name_part(graph_name), ::getpid(), scope.run);
+    try {
+        std::ofstream output(path, std::ios::binary | std::ios::trunc);
+        output << trace.dump();
+        if (!output) {
+            return {};
+        }
+    } catch (const std::exception&) {
+        return {};
+    }
+    std::lock_guard lock(dumps_mutex_);
+    dumps_.push_back(path.string());
+    return dumps_.back();
+}
+
+} // namespace strgraph
@@ -1,6 +1,571 @@
 #include "strgraph/graph.h"
 #include <stdexcept>
 #include <format>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+constexpr uint32_t BINARY_VERSION = 1;
+
+/// Smallest node record with its size prefix: type, flag, and empty id,
+/// op name, inputs and constants
+constexpr size_t MIN_BINARY_RECORD = sizeof(uint32_t) + 2 + 4 * sizeof(uint32_t);
+
+/**
+ * @brief Append-only writer for the binary graph format.
+ */
+class BinaryWriter {
+public:
+    explicit BinaryWriter(std::string& out) : out_(out) {}
+
+    template <typename T>
+    void write_pod(T value) {
+        out_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void write_string(std::string_view s) {
+        write_pod(static_cast<uint32_t>(s.size()));
+        out_.append(s);
+    }
+
+    void write_strings(const std::vector<std::string>& strings) {
+        write_pod(static_cast<uint32_t>(strings.size()));
+        for (const auto& s : strings) {
+            write_string(s);
+        }
+    }
+
+private:
+    std::string& out_;
+};
+
+/**
+ * @brief Bounds-checked reader for the binary graph format.
+ */
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view data) : data_(data) {}
+
+    template <typename T>
+    T read_pod() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string_view read_view(size_t size) {
+        require(size);
+        std::string_view view = data_.substr(pos_, size);
+        pos_ += size;
+        return view;
+    }
+
+    std::string read_string() {
+        return std::string(read_view(read_pod<uint32_t>()));
+    }
+
+    std::vector<std::string> read_strings() {
+        uint32_t count = read_pod<uint32_t>();
+        std::vector<std::string> strings;
+        // count is untrusted: reserve no more than the data can hold
+        strings.reserve(std::min<size_t>(count, remaining() / sizeof(uint32_t)));
+        for (uint32_t i = 0; i < count; ++i) {
+            strings.push_back(read_string());
+        }
+        return strings;
+    }
+
+    bool at_end() const { return pos_ == data_.size(); }
+
+    size_t remaining() const { return data_.size() - pos_; }
+
+private:
+    void require(size_t size) const {
+        if (data_.size() - pos_ < size) {
+            throw std::runtime_error("Binary graph data is truncated");
+        }
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+size_t max_threads() {
+#ifdef USE_OPENMP
+    return static_cast<size_t>(omp_get_max_threads());
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Build a node from its JSON object.
+ */
+strgraph::Node node_from_json(const nlohmann::json& node_json) {
+    strgraph::Node node;
+    node.id = node_json.at("id").get<std::string>();
+
+    // Parse node type (default to auto-detection for backward compatibility)
+    if (node_json.contains("type")) {
+        std::string type_str = node_json.at("type").get<std::string>();
+        if (type_str == "constant") {
+            node.type = strgraph::NodeType::CONSTANT;
+        } else if (type_str == "placeholder") {
+            node.type = strgraph::NodeType::PLACEHOLDER;
+        } else if (type_str == "variable") {
+            node.type = strgraph::NodeType::VARIABLE;
+        } else if (type_str == "operation") {
+            node.type = strgraph::NodeType::OPERATION;
+        } else {
+            throw std::runtime_error(std::format(
+                "Unknown node type '{}' for node '{}'", type_str, node.id));
+        }
+    }
+
+    // Backward compatibility: auto-detect type from structure
+    if (node_json.contains("value")) {
+        // Has value: CONSTANT (or VARIABLE if explicitly set)
+        if (!node_json.contains("type")) {
+            node.type = strgraph::NodeType::CONSTANT;
+        }
+        node.initial_value = node_json.at("value").get<std::string>();
+    } else if (node_json.contains("op")) {
+        // Has operation: OPERATION
+        if (!node_json.contains("type")) {
+            node.type = strgraph::NodeType::OPERATION;
+        }
+        node.op_name = node_json.at("op").get<std::string>();
+        if (node_json.contains("inputs")) {
+            node.input_ids = node_json.at("inputs").get<std::vector<std::string>>();
+        }
+        if (node_json.contains("constants")) {
+            node.constants = node_json.at("constants").get<std::vector<std::string>>();
+        }
+    } else {
+        // No value or op: must be PLACEHOLDER
+        if (!node_json.contains("type")) {
+            throw std::runtime_error(std::format(
+                "Node '{}' has neither 'value' nor 'op', and no 'type' specified", node.id));
+        }
+        if (node.type != strgraph::NodeType::PLACEHOLDER) {
+            throw std::runtime_error(std::format(
+                "Node '{}' of type '{}' requires 'value' or 'op'", 
+                node.id, node_json.at("type").get<std::string>()));
+        }
+    }
+
+    // Validation
+    if (node.type == strgraph::NodeType::CONSTANT && !node.initial_value.has_value()) {
+        throw std::runtime_error(std::format(
+            "CONSTANT node '{}' must have an initial 'value'", node.id));
+    }
+    if (node.type == strgraph::NodeType::PLACEHOLDER && node.initial_value.has_value()) {
+        throw std::runtime_error(std::format(
+            "PLACEHOLDER node '{}' should not have an initial 'value' (use feed_dict)", node.id));
+    }
+    return node;
+}
+
+/**
+ * @brief Add a node, rejecting a second node with the same id.
+ */
+void insert_node(strgraph::Graph::NodeMap& nodes, strgraph::Node&& node) {
+    std::string id = node.id;
+    auto [it, inserted] = nodes.try_emplace(std::move(id), std::move(node));
+    if (!inserted) {
+        throw std::runtime_error(std::format("Duplicate node id '{}'", it->first));
+    }
+}
+
+/**
+ * @brief Decode one node of the binary format.
+ */
+strgraph::Node node_from_record(std::string_view data) {
+    BinaryReader record(data);
+    strgraph::Node node;
+    auto type = record.read_pod<uint8_t>();
+    if (type > static_cast<uint8_t>(strgraph::NodeType::OPERATION)) {
+        throw std::runtime_error(std::format("Invalid node type {} in binary graph", type));
+    }
+    node.type = static_cast<strgraph::NodeType>(type);
+    bool has_initial_value = record.read_pod<uint8_t>() != 0;
+    node.id = record.read_string();
+    node.op_name = record.read_string();
+    if (has_initial_value) {
+        node.initial_value = record.read_string();
+    }
+    node.input_ids = record.read_strings();
+    node.constants = record.read_strings();
+    if (!record.at_end()) {
+        throw std::runtime_error(std::format(
+            "Binary record for node '{}' has trailing bytes", node.id));
+    }
+    return node;
+}
+
+/**
+ * @brief Check the header of a binary graph and read its node count.
+ */
+uint64_t read_binary_header(BinaryReader& reader) {
+    if (reader.read_view(strgraph::Graph::BINARY_MAGIC.size()) != strgraph::Graph::BINARY_MAGIC) {
+        throw std::runtime_error("Binary graph data has an invalid header");
+    }
+    uint32_t version = reader.read_pod<uint32_t>();
+    if (version != BINARY_VERSION) {
+        throw std::runtime_error(std::format("Unsupported binary graph version {}", version));
+    }
+    return reader.read_pod<uint64_t>();
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(std::format("Cannot open graph file '{}'", path));
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    return std::move(buffer).str();
+}
+
+/**
+ * @brief The node an input ID refers to ("split:1" -> "split").
+ */
+std::string_view input_node_id(std::string_view input_id) {
+    return input_id.substr(0, input_id.find(':'));
+}
+
+/**
+ * @brief Position of every node of a graph document, by id.
+ */
+using NodeIndex = std::unordered_map<std::string_view, uint32_t>;
+
+void index_node(NodeIndex& index, std::string_view id, uint32_t position) {
+    if (!index.try_emplace(id, position).second) {
+        throw std::runtime_error(std::format("Duplicate node id '{}'", id));
+    }
+}
+
+/**
+ * @brief Construct the nodes reachable from `targets`, one frontier at a time.
+ * 
+ * @param parse Builds the node at a position of the index; the nodes of
+ *              a frontier are built on the thread team
+ */
+template <typename Parse>
+void load_reachable(const NodeIndex& index, std::span<const std::string> targets, Parse&& parse,
+                    strgraph::Graph::NodeMap& nodes) {
+    std::vector<uint8_t> reached(index.size(), 0);
+    std::vector<uint32_t> frontier;
+    auto reach = [&](std::string_view input_id) {
+        auto it = index.find(input_node_id(input_id));
+        if (it == index.end()) {
+            return false;
+        }
+        if (!reached[it->second]) {
+            reached[it->second] = 1;
+            frontier.push_back(it->second);
+        }
+        return true;
+    };
+    for (const auto& target : targets) {
+        if (!reach(target)) {
+            throw std::runtime_error(std::format("Node '{}' not found in graph", input_node_id(target)));
+        }
+    }
+
+    std::vector<uint32_t> current;
+    std::vector<strgraph::Node> parsed;
+    while (!frontier.empty()) {
+        current.swap(frontier);
+        frontier.clear();
+        // Document order: sequential reads, and errors reported deterministically
+        std::ranges::sort(current);
+        parsed.clear();
+        parsed.resize(current.size());
+        std::exception_ptr error;
+        size_t error_at = std::numeric_limits<size_t>::max();
+
+#ifdef USE_OPENMP
+        #pragma omp parallel for schedule(dynamic, 64) if(current.size() >= strgraph::Graph::MIN_LOAD_CHUNK_NODES)
+#endif
+        for (size_t i = 0; i < current.size(); ++i) {
+            try {
+                parsed[i] = parse(current[i]);
+            } catch (...) {
+#ifdef USE_OPENMP
+                #pragma omp critical(strgraph_load_error)
+#endif
+                if (i < error_at) {
+                    error_at = i;
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        for (strgraph::Node& node : parsed) {
+            for (const auto& input_id : node.input_ids) {
+                (void)reach(input_id); // Unknown inputs fail when a run reaches them
+            }
+            insert_node(nodes, std::move(node));
+        }
+    }
+}
+
+/**
+ * @brief Drop the nodes not reachable from `targets`.
+ */
+void retain_reachable(strgraph::Graph::NodeMap& nodes, std::span<const std::string> targets) {
+    std::unordered_set<std::string_view> keep;
+    std::vector<std::string_view> stack;
+    for (const auto& target : targets) {
+        std::string_view id = input_node_id(target);
+        auto it = nodes.find(id);
+        if (it == nodes.end()) {
+            throw std::runtime_error(std::format("Node '{}' not found in graph", id));
+        }
+        if (keep.insert(it->first).second) {
+            stack.push_back(it->first);
+        }
+    }
+    while (!stack.empty()) {
+        const strgraph::Node& node = nodes.find(stack.back())->second;
+        stack.pop_back();
+        for (const auto& input_id : node.input_ids) {
+            auto it = nodes.find(input_node_id(input_id));
+            if (it != nodes.end() && keep.insert(it->first).second) {
+                stack.push_back(it->first);
+            }
+        }
+    }
+    std::erase_if(nodes, [&](const auto& entry) { return !keep.contains(entry.first); });
+}
+
+/**
+ * @brief Byte ranges of a JSON document's "nodes" array and its elements.
+ */
+struct NodesArray {
+    size_t begin = 0;                           ///< Offset of '['
+    size_t end = 0;                             ///< Offset past ']'
+    std::vector<std::pair<size_t, size_t>> elements;
+    std::vector<std::pair<size_t, size_t>> ids; ///< Quoted "id" of each element, if indexed (empty if none)
+};
+
+/**
+ * @brief Structural scanner that finds value boundaries without decoding.
+ * 
+ * It only tracks strings and bracket depth; the values themselves are
+ * validated by the parser that decodes them later. Anything it does not
+ * expect makes it give up (nullopt), never throw.
+ */
+class JsonScanner {
+public:
+    explicit JsonScanner(std::string_view text) : text_(text) {}
+
+    /**
+     * @param index_ids Also find the "id" member of every element; an
+     *                  element that is not an object gives up
+     */
+    std::optional<NodesArray> find_nodes_array(bool index_ids = false) {
+        std::optional<NodesArray> found;
+        skip_whitespace();
+        bool scanned = scan_object([&](std::string_view key) {
+            if (key == "nodes" && peek() == '[') {
+                found = scan_array(index_ids);
+                return found.has_value();
+            }
+            return skip_value();
+        });
+        return scanned ? found : std::nullopt;
+    }
+
+private:
+    char peek() const { return pos_ < text_.size() ? text_[pos_] : '\0'; }
+
+    bool consume(char c) {
+        if (peek() != c) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    void skip_whitespace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\n' || text_[pos_] == '\r' || text_[pos_] == '\t')) {
+            ++pos_;
+        }
+    }
+
+    bool skip_string() {
+        if (!consume('"')) {
+            return false;
+        }
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '\\') {
+                ++pos_;
+            } else if (c == '"') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Scan an object, leaving each member's value to on_member(key).
+     */
+    template <typename OnMember>
+    bool scan_object(OnMember&& on_member) {
+        if (!consume('{')) {
+            return false;
+        }
+        skip_whitespace();
+        if (consume('}')) {
+            return true;
+        }
+        while (true) {
+            const size_t key_begin = pos_;
+            if (!skip_string()) {
+                return false;
+            }
+            const std::string_view key = text_.substr(key_begin + 1, pos_ - key_begin - 2);
+            skip_whitespace();
+            if (!consume(':')) {
+                return false;
+            }
+            skip_whitespace();
+            if (!on_member(key)) {
+                return false;
+            }
+            skip_whitespace();
+            if (consume('}')) {
+                return true;
+            }
+            if (!consume(',')) {
+                return false;
+            }
+            skip_whitespace();
+        }
+    }
+
+    bool skip_value() {
+        char c = peek();
+        if (c == '"') {
+            return skip_string();
+        }
+        if (c != '{' && c != '[') {
+            // Number or literal: up to the next delimiter
+            const size_t begin = pos_;
+            while (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '}' && text_[pos_] != ']' &&
+                   text_[pos_] != ' ' && text_[pos_] != '\n' && text_[pos_] != '\r' && text_[pos_] != '\t') {
+                ++pos_;
+            }
+            return pos_ > begin;
+        }
+        size_t depth = 0;
+        while (pos_ < text_.size()) {
+            switch (text_[pos_]) {
+            case '"':
+                if (!skip_string()) {
+                    return false;
+                }
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) {
+                    ++pos_;
+                    return true;
+                }
+                break;
+            default:
+                break;
+            }
+            ++pos_;
+        }
+        return false;
+    }
+
+    std::optional<NodesArray> scan_array(bool index_ids) {
+        NodesArray array;
+        array.begin = pos_++;
+        skip_whitespace();
+        if (!consume(']')) {
+            while (true) {
+                const size_t element_begin = pos_;
+                if (index_ids) {
+                    std::pair<size_t, size_t> id{0, 0};
+                    bool scanned = scan_object([&](std::string_view key) {
+                        if (key == "id" && peek() == '"') {
+                            const size_t id_begin = pos_;
+                            if (!skip_string()) {
+                                return false;
+                            }
+                            id = {id_begin, pos_};
+                            return true;
+                        }
+                        return skip_value();
+                    });
+                    if (!scanned) {
+                        return std::nullopt;
+                    }
+                    array.ids.push_back(id);
+                } else if (!skip_value()) {
+                    return std::nullopt;
+                }
+                array.elements.emplace_back(element_begin, pos_);
+                skip_whitespace();
+                if (consume(']')) {
+                    break;
+                }
+                if (!consume(',')) {
+                    return std::nullopt;
+                }
+                skip_whitespace();
+            }
+        }
+        array.end = pos_;
+        return array;
+    }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+/**
+ * @brief Parse the rest of the document, with an empty nodes array.
+ */
+nlohmann::json parse_without_nodes(std::string_view text, const NodesArray& nodes) {
+    std::string header;
+    header.reserve(text.size() - (nodes.end - nodes.begin) + 2);
+    header.append(text.substr(0, nodes.begin)).append("[]").append(text.substr(nodes.end));
+    return nlohmann::json::parse(header);
+}
+
+} // anonymous namespace
 
 namespace strgraph {
 
@@ -9,75 +574,212 @@ std::unique_ptr<Graph> Graph::from_json(const nlohmann::json& json_data) {
     if (!json_data.contains("nodes")) {
         throw std::runtime_error("JSON missing 'nodes' field.");
     }
+    if (json_data.contains("name")) {
+        graph->set_name(json_data.at("name").get<std::string>());
+    }
 
     for (const auto& node_json : json_data["nodes"]) {
-        Node node;
-        node.id = node_json.at("id").get<std::string>();
-
-        // Parse node type (default to auto-detection for backward compatibility)
-        if (node_json.contains("type")) {
-            std::string type_str = node_json.at("type").get<std::string>();
-            if (type_str == "constant") {
-                node.type = NodeType::CONSTANT;
-            } else if (type_str == "placeholder") {
-                node.type = NodeType::PLACEHOLDER;
-            } else if (type_str == "variable") {
-                node.type = NodeType::VARIABLE;
-            } else if (type_str == "operation") {
-                node.type = NodeType::OPERATION;
-            } else {
-                throw std::runtime_error(std::format(
-                    "Unknown node type '{}' for node '{}'", type_str, node.id));
-            }
+        insert_node(graph->nodes_, node_from_json(node_json));
+    }
+    return graph;
+}
+
+std::unique_ptr<Graph> Graph::from_json_text(std::string_view text, nlohmann::json* fields) {
+    std::optional<NodesArray> nodes = JsonScanner(text).find_nodes_array();
+    if (!nodes) {
+        // Not a plain {"nodes": [...], ...} object: let the parser report it
+        auto json = nlohmann::json::parse(text);
+        auto graph = from_json(json);
+        if (fields != nullptr) {
+            json.erase("nodes");
+            *fields = std::move(json);
         }
+        return graph;
+    }
 
-        // Backward compatibility: auto-detect type from structure
-        if (node_json.contains("value")) {
-            // Has value: CONSTANT (or VARIABLE if explicitly set)
-            if (!node_json.contains("type")) {
-                node.type = NodeType::CONSTANT;
-            }
-            node.initial_value = node_json.at("value").get<std::string>();
-        } else if (node_json.contains("op")) {
-            // Has operation: OPERATION
-            if (!node_json.contains("type")) {
-                node.type = NodeType::OPERATION;
-            }
-            node.op_name = node_json.at("op").get<std::string>();
-            if (node_json.contains("inputs")) {
-                node.input_ids = node_json.at("inputs").get<std::vector<std::string>>();
-            }
-            if (node_json.contains("constants")) {
-                node.constants = node_json.at("constants").get<std::vector<std::string>>();
-            }
-        } else {
-            // No value or op: must be PLACEHOLDER
-            if (!node_json.contains("type")) {
-                throw std::runtime_error(std::format(
-                    "Node '{}' has neither 'value' nor 'op', and no 'type' specified", node.id));
+    auto json = parse_without_nodes(text, *nodes);
+    auto graph = from_json(json);
+
+    // Chunks of consecutive elements, several per thread for balance
+    const size_t count = nodes->elements.size();
+    const size_t chunk_size = std::max(MIN_LOAD_CHUNK_NODES, count / (8 * max_threads()) + 1);
+    const size_t chunks = (count + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<Node>> parsed(chunks);
+    std::exception_ptr error;
+    size_t error_chunk = std::numeric_limits<size_t>::max();
+
+#ifdef USE_OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) if(chunks > 1)
+#endif
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        try {
+            const size_t first = chunk * chunk_size;
+            const size_t last = std::min(first + chunk_size, count);
+            parsed[chunk].reserve(last - first);
+            for (size_t i = first; i < last; ++i) {
+                auto [begin, end] = nodes->elements[i];
+                parsed[chunk].push_back(node_from_json(nlohmann::json::parse(text.substr(begin, end - begin))));
             }
-            if (node.type != NodeType::PLACEHOLDER) {
-                throw std::runtime_error(std::format(
-                    "Node '{}' of type '{}' requires 'value' or 'op'", 
-                    node.id, node_json.at("type").get<std::string>()));
+        } catch (...) {
+            // The first error in document order, as from_json() reports it
+#ifdef USE_OPENMP
+            #pragma omp critical(strgraph_load_error)
+#endif
+            if (chunk < error_chunk) {
+                error_chunk = chunk;
+                error = std::current_exception();
             }
         }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 
-        // Validation
-        if (node.type == NodeType::CONSTANT && !node.initial_value.has_value()) {
-            throw std::runtime_error(std::format(
-                "CONSTANT node '{}' must have an initial 'value'", node.id));
+    graph->nodes_.reserve(count);
+    for (auto& chunk : parsed) {
+        for (Node& node : chunk) {
+            insert_node(graph->nodes_, std::move(node));
         }
-        if (node.type == NodeType::PLACEHOLDER && node.initial_value.has_value()) {
-            throw std::runtime_error(std::format(
-                "PLACEHOLDER node '{}' should not have an initial 'value' (use feed_dict)", node.id));
+        std::vector<Node>().swap(chunk);
+    }
+    if (fields != nullptr) {
+        json.erase("nodes");
+        *fields = std::move(json);
+    }
+    return graph;
+}
+
+std::unique_ptr<Graph> Graph::from_json_text(std::string_view text, std::span<const std::string> targets,
+                                             nlohmann::json* fields) {
+    std::optional<NodesArray> nodes = JsonScanner(text).find_nodes_array(true);
+    if (!nodes || std::ranges::any_of(nodes->ids, [](const auto& id) { return id.first == id.second; })) {
+        // Not indexable by id: load it whole (which reports what is wrong) and prune
+        auto graph = from_json_text(text, fields);
+        retain_reachable(graph->nodes_, targets);
+        return graph;
+    }
+
+    auto json = parse_without_nodes(text, *nodes);
+    auto graph = from_json(json);
+
+    NodeIndex index;
+    index.reserve(nodes->ids.size());
+    std::deque<std::string> escaped_ids;
+    for (size_t i = 0; i < nodes->ids.size(); ++i) {
+        auto [begin, end] = nodes->ids[i];
+        std::string_view id = text.substr(begin + 1, end - begin - 2);
+        if (id.find('\\') != std::string_view::npos) {
+            id = escaped_ids.emplace_back(nlohmann::json::parse(text.substr(begin, end - begin)).get<std::string>());
         }
+        index_node(index, id, static_cast<uint32_t>(i));
+    }
+    load_reachable(index, targets, [&](uint32_t i) {
+        auto [begin, end] = nodes->elements[i];
+        return node_from_json(nlohmann::json::parse(text.substr(begin, end - begin)));
+    }, graph->nodes_);
 
-        graph->nodes_[node.id] = std::move(node);
+    if (fields != nullptr) {
+        json.erase("nodes");
+        *fields = std::move(json);
     }
     return graph;
 }
 
+std::unique_ptr<Graph> Graph::from_binary(std::string_view data) {
+    BinaryReader reader(data);
+    uint64_t node_count = read_binary_header(reader);
+
+    auto graph = std::make_unique<Graph>();
+    graph->nodes_.reserve(std::min<uint64_t>(node_count, reader.remaining() / MIN_BINARY_RECORD));
+
+    for (uint64_t i = 0; i < node_count; ++i) {
+        uint32_t record_size = reader.read_pod<uint32_t>();
+        insert_node(graph->nodes_, node_from_record(reader.read_view(record_size)));
+    }
+
+    if (!reader.at_end()) {
+        throw std::runtime_error("Binary graph data has trailing bytes");
+    }
+    return graph;
+}
+
+std::unique_ptr<Graph> Graph::from_binary(std::string_view data, std::span<const std::string> targets) {
+    BinaryReader reader(data);
+    uint64_t node_count = read_binary_header(reader);
+
+    // Index the records by id, skipping the rest of each one
+    NodeIndex index;
+    std::vector<std::string_view> records;
+    for (uint64_t i = 0; i < node_count; ++i) {
+        uint32_t record_size = reader.read_pod<uint32_t>();
+        std::string_view record_data = reader.read_view(record_size);
+        BinaryReader record(record_data);
+        (void)record.read_pod<uint8_t>(); // type
+        (void)record.read_pod<uint8_t>(); // has_initial_value
+        index_node(index, record.read_view(record.read_pod<uint32_t>()), static_cast<uint32_t>(records.size()));
+        records.push_back(record_data);
+    }
+    if (!reader.at_end()) {
+        throw std::runtime_error("Binary graph data has trailing bytes");
+    }
+
+    auto graph = std::make_unique<Graph>();
+    load_reachable(index, targets, [&](uint32_t i) { return node_from_record(records[i]); }, graph->nodes_);
+    return graph;
+}
+
+std::unique_ptr<Graph> Graph::from_file(const std::string& path, nlohmann::json* fields) {
+    std::string data = read_file(path);
+    if (data.starts_with(BINARY_MAGIC)) {
+        return from_binary(data);
+    }
+    return from_json_text(data, fields);
+}
+
+std::unique_ptr<Graph> Graph::from_file(const std::string& path, std::span<const std::string> targets,
+                                        nlohmann::json* fields) {
+    std::string data = read_file(path);
+    if (data.starts_with(BINARY_MAGIC)) {
+        return from_binary(data, targets);
+    }
+    return from_json_text(data, targets, fields);
+}
+
+std::string Graph::to_binary() const {
+    std::string out;
+    append_binary_header(out, nodes_.size());
+    for (const auto& [id, node] : nodes_) {
+        append_binary_record(out, node);
+    }
+    return out;
+}
+
+void Graph::append_binary_header(std::string& out, uint64_t node_count) {
+    BinaryWriter writer(out);
+    out.append(BINARY_MAGIC);
+    writer.write_pod(BINARY_VERSION);
+    writer.write_pod(node_count);
+}
+
+void Graph::append_binary_record(std::string& out, const Node& node) {
+    // Reserve the size prefix and patch it once the record is written
+    size_t size_offset = out.size();
+    BinaryWriter writer(out);
+    writer.write_pod(uint32_t{0});
+    writer.write_pod(static_cast<uint8_t>(node.type));
+    writer.write_pod(static_cast<uint8_t>(node.initial_value.has_value()));
+    writer.write_string(node.id);
+    writer.write_string(node.op_name);
+    if (node.initial_value.has_value()) {
+        writer.write_string(*node.initial_value);
+    }
+    writer.write_strings(node.input_ids);
+    writer.write_strings(node.constants);
+
+    auto record_size = static_cast<uint32_t>(out.size() - size_offset - sizeof(uint32_t));
+    std::memcpy(out.data() + size_offset, &record_size, sizeof(record_size));
+}
+
 Node& Graph::get_node(std::string_view id) {
     auto it = nodes_.find(id);
     if (it == nodes_.end()) {
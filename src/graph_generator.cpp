@@ -0,0 +1,462 @@
+#include "strgraph/graph_generator.h"
+#include <json.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <format>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+using namespace strgraph;
+using namespace strgraph::generator;
+
+constexpr std::string_view SEPARATOR_ID = "sep";
+constexpr std::string_view SEPARATOR = "|";
+
+constexpr std::array<WidthProfile, 4> ALL_PROFILES = {
+    WidthProfile::UNIFORM, WidthProfile::DIAMOND, WidthProfile::FUNNEL, WidthProfile::RANDOM};
+constexpr std::array<OpMix, 4> ALL_MIXES = {OpMix::CASE, OpMix::COPY, OpMix::EDIT, OpMix::MIXED};
+
+constexpr std::array<std::string_view, 4> CASE_OPS = {"to_upper", "to_lower", "capitalize", "title"};
+constexpr std::array<std::string_view, 2> COPY_OPS = {"identity", "reverse"};
+constexpr std::array<std::string_view, 3> EDIT_OPS = {"replace", "trim", "substring"};
+
+/**
+ * @brief A value a later node can consume.
+ */
+struct Handle {
+    bool placeholder = false;
+    uint64_t index = 0;
+    uint32_t outputs = 0;             ///< Outputs of a split node, 0 for single-output nodes
+};
+
+/**
+ * @brief One generation run; the random stream is consumed in a fixed
+ *        order so that the output only depends on the options.
+ */
+class Generator {
+public:
+    Generator(const Options& options, const NodeSink& sink) : options_(options), sink_(sink), rng_(options.seed) {}
+
+    Summary run() {
+        std::vector<size_t> widths = layer_widths();
+
+        std::vector<Handle> placeholders;
+        for (size_t i = 0; i < options_.placeholders; ++i) {
+            node_.type = NodeType::PLACEHOLDER;
+            node_.id = std::format("p{}", i);
+            node_.op_name.clear();
+            node_.initial_value.reset();
+            node_.input_ids.clear();
+            node_.constants.clear();
+            emit_node();
+            summary_.placeholder_ids.push_back(node_.id);
+            placeholders.push_back({true, i, 0});
+        }
+        if (options_.multi_output_ratio > 0.0) {
+            node_.type = NodeType::CONSTANT;
+            node_.id = SEPARATOR_ID;
+            node_.initial_value = std::string(SEPARATOR);
+            emit_node();
+            node_.initial_value.reset();
+        }
+
+        window_.push_back(placeholders);
+        std::vector<Handle> pending = std::move(placeholders);
+        shuffle(pending);
+
+        for (size_t width : widths) {
+            pending = generate_layer(width, pending);
+        }
+
+        // Reduce the last layer to a single value
+        const size_t reduce_fan_in = std::max<size_t>(2, options_.max_fan_in);
+        while (pending.size() > 1) {
+            std::vector<Handle> next;
+            size_t layer_start = summary_.operation_nodes;
+            for (size_t i = 0; i < pending.size(); i += reduce_fan_in) {
+                size_t end = std::min(pending.size(), i + reduce_fan_in);
+                std::vector<Handle> inputs(pending.begin() + static_cast<ptrdiff_t>(i),
+                                           pending.begin() + static_cast<ptrdiff_t>(end));
+                next.push_back(inputs.size() == 1 ? inputs[0] : merge(inputs));
+            }
+            finish_layer(layer_start);
+            pending = std::move(next);
+        }
+
+        size_t layer_start = summary_.operation_nodes;
+        add_operation(IDENTITY_OP, {id_of(pending[0])}, {}, std::string(Summary::TARGET));
+        finish_layer(layer_start);
+        return summary_;
+    }
+
+private:
+    uint64_t next() { return rng_(); }
+
+    /**
+     * @brief Uniform in [0, 1), identical on every standard library.
+     */
+    double next_unit() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+    template <typename T>
+    void shuffle(std::vector<T>& items) {
+        for (size_t i = items.size(); i > 1; --i) {
+            std::swap(items[i - 1], items[next() % i]);
+        }
+    }
+
+    std::vector<size_t> layer_widths() {
+        size_t depth = options_.depth;
+        if (depth == 0) {
+            depth = static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(options_.nodes))));
+        }
+        depth = std::clamp<size_t>(depth, 1, options_.nodes);
+
+        std::vector<double> weights(depth);
+        for (size_t layer = 0; layer < depth; ++layer) {
+            switch (options_.width) {
+                case WidthProfile::UNIFORM: weights[layer] = 1.0; break;
+                case WidthProfile::DIAMOND: weights[layer] = 1.0 + static_cast<double>(std::min(layer, depth - 1 - layer)); break;
+                case WidthProfile::FUNNEL: weights[layer] = static_cast<double>(depth - layer); break;
+                case WidthProfile::RANDOM: weights[layer] = std::pow(16.0, next_unit()); break;
+            }
+        }
+        double total = 0.0;
+        for (double weight : weights) total += weight;
+
+        std::vector<size_t> widths(depth);
+        for (size_t layer = 0; layer < depth; ++layer) {
+            double share = static_cast<double>(options_.nodes) * weights[layer] / total;
+            widths[layer] = std::max<size_t>(1, static_cast<size_t>(std::lround(share)));
+        }
+        return widths;
+    }
+
+    /**
+     * @brief Emit a layer of about `budget` operation nodes that consumes
+     *        every value of the previous layer.
+     */
+    std::vector<Handle> generate_layer(size_t budget, const std::vector<Handle>& previous) {
+        std::vector<Handle> layer;
+        size_t layer_start = summary_.operation_nodes;
+        size_t taken = 0;
+
+        auto emitted = [&] { return summary_.operation_nodes - layer_start; };
+        while (emitted() < budget || taken < previous.size()) {
+            size_t left = previous.size() - taken;
+            size_t nodes_left = budget > emitted() ? budget - emitted() : 0;
+            bool split = false;
+            size_t fan_in;
+            size_t from_previous;
+
+            if (nodes_left == 0) {
+                // Over budget: absorb the rest of the previous layer
+                fan_in = std::min(left, std::max<size_t>(2, options_.max_fan_in));
+                from_previous = fan_in;
+            } else {
+                split = options_.multi_output_ratio > 0.0 && next_unit() < options_.multi_output_ratio;
+                fan_in = split ? options_.split_outputs
+                               : options_.min_fan_in + next() % (options_.max_fan_in - options_.min_fan_in + 1);
+                // Spread the previous layer over the nodes still to come
+                size_t quota = (left + nodes_left - 1) / nodes_left;
+                from_previous = std::min(quota, std::max<size_t>(2, options_.max_fan_in));
+                fan_in = std::max(fan_in, from_previous);
+            }
+
+            std::vector<Handle> inputs;
+            for (size_t k = 0; k < fan_in; ++k) {
+                inputs.push_back(k < from_previous && taken < previous.size() ? previous[taken++] : pick());
+            }
+
+            if (split) {
+                layer.push_back(split_node(inputs));
+            } else if (inputs.size() == 1) {
+                layer.push_back(unary(inputs[0]));
+            } else {
+                layer.push_back(merge(inputs));
+            }
+        }
+
+        finish_layer(layer_start);
+        window_.push_back(layer);
+        while (window_.size() > options_.lookback) {
+            window_.pop_front();
+        }
+        shuffle(layer);
+        return layer;
+    }
+
+    void finish_layer(size_t layer_start) {
+        ++summary_.layers;
+        summary_.max_layer_nodes = std::max(summary_.max_layer_nodes, summary_.operation_nodes - layer_start);
+    }
+
+    /**
+     * @brief A random value of the window, or a placeholder hub.
+     */
+    Handle pick() {
+        if (options_.hub_ratio > 0.0 && next_unit() < options_.hub_ratio) {
+            return {true, next() % options_.placeholders, 0};
+        }
+        const auto& layer = window_[next() % window_.size()];
+        return layer[next() % layer.size()];
+    }
+
+    std::string id_of(const Handle& handle) {
+        if (handle.placeholder) {
+            return std::format("p{}", handle.index);
+        }
+        if (handle.outputs > 0) {
+            return std::format("n{}:{}", handle.index, next() % handle.outputs);
+        }
+        return std::format("n{}", handle.index);
+    }
+
+    Handle unary(const Handle& input) {
+        std::string_view op;
+        switch (options_.mix) {
+            case OpMix::CASE: op = CASE_OPS[next() % CASE_OPS.size()]; break;
+            case OpMix::COPY: op = COPY_OPS[next() % COPY_OPS.size()]; break;
+            case OpMix::EDIT: op = EDIT_OPS[next() % EDIT_OPS.size()]; break;
+            case OpMix::MIXED: {
+                size_t pick = next() % (CASE_OPS.size() + COPY_OPS.size() + EDIT_OPS.size());
+                if (pick < CASE_OPS.size()) op = CASE_OPS[pick];
+                else if ((pick -= CASE_OPS.size()) < COPY_OPS.size()) op = COPY_OPS[pick];
+                else op = EDIT_OPS[pick - COPY_OPS.size()];
+                break;
+            }
+        }
+
+        std::vector<std::string_view> constants;
+        if (op == "replace") constants = {"a", "e"};
+        if (op == "substring") constants = {"0", "-1"};
+        return add_operation(op, {id_of(input)}, constants);
+    }
+
+    /**
+     * @brief Concat the inputs and cut the result back to the value size.
+     */
+    Handle merge(const std::vector<Handle>& inputs) {
+        std::vector<std::string> ids;
+        for (const auto& input : inputs) ids.push_back(id_of(input));
+        Handle joined = add_operation("concat", ids, {});
+        std::string size = std::to_string(options_.value_size);
+        return add_operation("substring", {id_of(joined)}, {"0", size});
+    }
+
+    /**
+     * @brief Join the inputs with the separator and split them apart again,
+     *        one output per input.
+     */
+    Handle split_node(const std::vector<Handle>& inputs) {
+        std::vector<std::string> ids;
+        for (const auto& input : inputs) {
+            if (!ids.empty()) ids.emplace_back(SEPARATOR_ID);
+            ids.push_back(id_of(input));
+        }
+        Handle joined = add_operation("concat", ids, {});
+        Handle parts = add_operation("split", {id_of(joined)}, {SEPARATOR});
+        parts.outputs = static_cast<uint32_t>(inputs.size());
+        ++summary_.split_nodes;
+        return parts;
+    }
+
+    Handle add_operation(std::string_view op, const std::vector<std::string>& inputs,
+                         const std::vector<std::string_view>& constants, std::string id = {}) {
+        uint64_t index = summary_.operation_nodes++;
+        node_.type = NodeType::OPERATION;
+        node_.id = id.empty() ? std::format("n{}", index) : std::move(id);
+        node_.op_name = op;
+        node_.input_ids = inputs;
+        node_.constants.assign(constants.begin(), constants.end());
+        summary_.edges += inputs.size();
+        emit_node();
+        return {false, index, 0};
+    }
+
+    void emit_node() {
+        ++summary_.total_nodes;
+        sink_(node_);
+    }
+
+    const Options& options_;
+    const NodeSink& sink_;
+    std::mt19937_64 rng_;
+    std::deque<std::vector<Handle>> window_;    ///< Last `lookback` layers
+    Node node_;                                 ///< Reused for every emitted node
+    Summary summary_;
+};
+
+void validate(const Options& options) {
+    if (options.nodes == 0) {
+        throw std::runtime_error("Generated graphs need at least one node");
+    }
+    if (options.placeholders == 0) {
+        throw std::runtime_error("Generated graphs need at least one placeholder");
+    }
+    if (options.min_fan_in == 0 || options.min_fan_in > options.max_fan_in) {
+        throw std::runtime_error(std::format("Invalid fan-in range {}-{}", options.min_fan_in, options.max_fan_in));
+    }
+    if (options.lookback == 0) {
+        throw std::runtime_error("Lookback must be at least one layer");
+    }
+    if (options.hub_ratio < 0.0 || options.hub_ratio > 1.0 ||
+        options.multi_output_ratio < 0.0 || options.multi_output_ratio > 1.0) {
+        throw std::runtime_error("Ratios must be between 0 and 1");
+    }
+    if (options.split_outputs < 2) {
+        throw std::runtime_error("Split nodes need at least two outputs");
+    }
+}
+
+/**
+ * @brief JSON string literal; generated ids, ops and constants need no escaping.
+ */
+void append_quoted(std::string& out, std::string_view text) {
+    out += '"';
+    out += text;
+    out += '"';
+}
+
+void append_quoted_list(std::string& out, const std::vector<std::string>& items) {
+    out += '[';
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i > 0) out += ',';
+        append_quoted(out, items[i]);
+    }
+    out += ']';
+}
+
+constexpr size_t FLUSH_BYTES = size_t{1} << 20;
+
+} // anonymous namespace
+
+namespace strgraph::generator {
+
+std::string_view width_profile_name(WidthProfile profile) {
+    switch (profile) {
+        case WidthProfile::UNIFORM: return "uniform";
+        case WidthProfile::DIAMOND: return "diamond";
+        case WidthProfile::FUNNEL: return "funnel";
+        case WidthProfile::RANDOM: return "random";
+    }
+    return "unknown";
+}
+
+std::string_view op_mix_name(OpMix mix) {
+    switch (mix) {
+        case OpMix::CASE: return "case";
+        case OpMix::COPY: return "copy";
+        case OpMix::EDIT: return "edit";
+        case OpMix::MIXED: return "mixed";
+    }
+    return "unknown";
+}
+
+WidthProfile parse_width_profile(std::string_view name) {
+    for (WidthProfile profile : ALL_PROFILES) {
+        if (width_profile_name(profile) == name) return profile;
+    }
+    throw std::runtime_error(std::format("Unknown width profile '{}'", name));
+}
+
+OpMix parse_op_mix(std::string_view name) {
+    for (OpMix mix : ALL_MIXES) {
+        if (op_mix_name(mix) == name) return mix;
+    }
+    throw std::runtime_error(std::format("Unknown op mix '{}'", name));
+}
+
+Summary generate(const Options& options, const NodeSink& sink) {
+    validate(options);
+    return Generator(options, sink).run();
+}
+
+std::unique_ptr<Graph> generate_graph(const Options& options, Summary* summary) {
+    auto graph = std::make_unique<Graph>();
+    graph->set_name(options.name);
+    auto& nodes = graph->get_nodes();
+    Summary result = generate(options, [&](const Node& node) {
+        nodes[node.id] = node;
+    });
+    if (summary) {
+        *summary = std::move(result);
+    }
+    return graph;
+}
+
+Summary write_json(const Options& options, std::ostream& out) {
+    std::string buffer = std::format("{{\"name\": {}, \"target_node\": \"{}\", \"nodes\": [\n",
+                                     nlohmann::json(options.name).dump(), Summary::TARGET);
+    bool first = true;
+    Summary summary = generate(options, [&](const Node& node) {
+        buffer += first ? "{\"id\":" : ",\n{\"id\":";
+        first = false;
+        append_quoted(buffer, node.id);
+        switch (node.type) {
+            case NodeType::PLACEHOLDER:
+                buffer += ",\"type\":\"placeholder\"";
+                break;
+            case NodeType::CONSTANT:
+                buffer += ",\"type\":\"constant\",\"value\":";
+                append_quoted(buffer, *node.initial_value);
+                break;
+            default:
+                buffer += ",\"op\":";
+                append_quoted(buffer, node.op_name);
+                buffer += ",\"inputs\":";
+                append_quoted_list(buffer, node.input_ids);
+                buffer += ",\"constants\":";
+                append_quoted_list(buffer, node.constants);
+                break;
+        }
+        buffer += '}';
+        if (buffer.size() >= FLUSH_BYTES) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    });
+    buffer += "\n]}\n";
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return summary;
+}
+
+Summary write_binary(const Options& options, std::ostream& out) {
+    Summary counted = generate(options, [](const Node&) {});
+
+    std::string buffer;
+    Graph::append_binary_header(buffer, counted.total_nodes);
+    Summary summary = generate(options, [&](const Node& node) {
+        Graph::append_binary_record(buffer, node);
+        if (buffer.size() >= FLUSH_BYTES) {
+            out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            buffer.clear();
+        }
+    });
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return summary;
+}
+
+std::string make_value(size_t size, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::string tile(std::min<size_t>(size, 4096), 'x');
+    for (size_t i = 0; i < tile.size(); ++i) {
+        tile[i] = (rng() % 7 == 0) ? ' ' : static_cast<char>('a' + rng() % 26);
+    }
+    std::string value;
+    value.reserve(size);
+    while (value.size() < size) {
+        value.append(tile, 0, std::min(tile.size(), size - value.size()));
+    }
+    if (!value.empty()) {
+        value.front() = 'a';
+        value.back() = 'z';
+    }
+    return value;
+}
+
+} // namespace strgraph::generator
@@ -0,0 +1,168 @@
+#include "strgraph/graph_template.h"
+#include <atomic>
+#include <format>
+#include <limits>
+#include <stdexcept>
+
+namespace strgraph {
+
+namespace {
+
+std::atomic<uint64_t> next_template_id{1};
+
+} // anonymous namespace
+
+/**
+ * @brief A copy of the graph with the parameters as placeholders, and
+ *        its executor.
+ */
+struct GraphTemplate::Context {
+    explicit Context(std::unique_ptr<Graph> graph) : graph(std::move(graph)), executor(*this->graph) {}
+
+    std::unique_ptr<Graph> graph;
+    Executor executor;
+    FeedViewDict feeds;                            ///< Parameters, plus the feeds of the current run
+    std::vector<std::string_view*> parameter_values; ///< Values in feeds, by slot
+};
+
+GraphTemplate::GraphTemplate(std::unique_ptr<Graph> graph, std::vector<std::string> parameter_ids)
+    : graph_(std::move(graph)), parameter_ids_(std::move(parameter_ids)),
+      id_(next_template_id.fetch_add(1, std::memory_order_relaxed)) {
+    if (!graph_) {
+        throw std::runtime_error("GraphTemplate needs a graph");
+    }
+    for (size_t slot = 0; slot < parameter_ids_.size(); ++slot) {
+        const std::string& id = parameter_ids_[slot];
+        auto it = graph_->get_nodes().find(id);
+        if (it == graph_->get_nodes().end() || it->second.type != NodeType::CONSTANT) {
+            throw std::runtime_error(std::format("Template parameter '{}' is not a CONSTANT node", id));
+        }
+        if (!parameter_slots_.try_emplace(id, slot).second) {
+            throw std::runtime_error(std::format("Template parameter '{}' is given twice", id));
+        }
+    }
+    defaults_ = bind({});
+
+    // The first context is created now, so a graph that fails verification
+    // is detected once; later contexts verify their own copy (the plan
+    // refers to its nodes) only if this one passed
+    auto context = make_context();
+    try {
+        context->executor.verify();
+    } catch (const std::exception& e) {
+        verification_error_ = e.what();
+    }
+    contexts_ = 1;
+    idle_.push_back(std::move(context));
+}
+
+GraphTemplate::~GraphTemplate() = default;
+
+ParameterSet GraphTemplate::bind(const std::unordered_map<std::string, std::string>& values) const {
+    for (const auto& [id, value] : values) {
+        if (!parameter_slots_.contains(id)) {
+            throw std::runtime_error(std::format("'{}' is not a parameter of the template", id));
+        }
+    }
+    ParameterSet set;
+    set.template_id_ = id_;
+    set.ends_.reserve(parameter_ids_.size());
+    for (const auto& id : parameter_ids_) {
+        auto it = values.find(id);
+        set.values_.append(it != values.end() ? it->second : *graph_->get_nodes().find(id)->second.initial_value);
+        if (set.values_.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("Template parameter values exceed 4 GiB");
+        }
+        set.ends_.push_back(static_cast<uint32_t>(set.values_.size()));
+    }
+    set.values_.shrink_to_fit();
+    return set;
+}
+
+std::unique_ptr<GraphTemplate::Context> GraphTemplate::make_context() const {
+    auto graph = std::make_unique<Graph>(*graph_);
+    for (const auto& id : parameter_ids_) {
+        Node& node = graph->get_node(id);
+        node.type = NodeType::PLACEHOLDER;
+        node.initial_value.reset();
+    }
+    auto context = std::make_unique<Context>(std::move(graph));
+    context->feeds.reserve(parameter_ids_.size());
+    for (const auto& id : parameter_ids_) {
+        context->parameter_values.push_back(&context->feeds[id]);
+    }
+    return context;
+}
+
+std::unique_ptr<GraphTemplate::Context> GraphTemplate::acquire() {
+    {
+        std::lock_guard lock(pool_mutex_);
+        if (!idle_.empty()) {
+            auto context = std::move(idle_.back());
+            idle_.pop_back();
+            return context;
+        }
+        ++contexts_;
+        idle_.reserve(contexts_);
+    }
+    try {
+        auto context = make_context();
+        if (is_verified()) {
+            context->executor.verify();
+        }
+        return context;
+    } catch (...) {
+        std::lock_guard lock(pool_mutex_);
+        --contexts_;
+        throw;
+    }
+}
+
+void GraphTemplate::release(std::unique_ptr<Context> context) {
+    // idle_ has room for every context, so this never allocates
+    std::lock_guard lock(pool_mutex_);
+    idle_.push_back(std::move(context));
+}
+
+size_t GraphTemplate::contexts() const {
+    std::lock_guard lock(pool_mutex_);
+    return contexts_;
+}
+
+std::string GraphTemplate::run(const ParameterSet& parameters, std::string_view target_node_id,
+                               const FeedDict& feed_dict, ExecutionStrategy strategy) {
+    if (parameters.template_id_ != id_) {
+        throw std::runtime_error("ParameterSet was not created by this GraphTemplate");
+    }
+    std::unique_ptr<Context> context = acquire();
+    for (size_t slot = 0; slot < parameters.size(); ++slot) {
+        *context->parameter_values[slot] = parameters.value(slot);
+    }
+
+    // The run's feeds are added next to the parameters and removed after it
+    size_t added = 0;
+    auto remove_feeds = [&] {
+        auto it = feed_dict.begin();
+        for (size_t i = 0; i < added; ++i, ++it) {
+            context->feeds.erase(it->first);
+        }
+    };
+    try {
+        for (const auto& [id, value] : feed_dict) {
+            if (!context->feeds.try_emplace(id, value).second) {
+                throw std::runtime_error(std::format("'{}' is a template parameter and cannot be fed", id));
+            }
+            ++added;
+        }
+        std::string result = context->executor.compute_with_strategy(strategy, target_node_id, context->feeds);
+        remove_feeds();
+        release(std::move(context));
+        return result;
+    } catch (...) {
+        remove_feeds();
+        release(std::move(context));
+        throw;
+    }
+}
+
+} // namespace strgraph
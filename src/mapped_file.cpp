@@ -0,0 +1,105 @@
+#include "strgraph/mapped_file.h"
+#include <stdexcept>
+#include <format>
+#include <cstring>
+#include <cerrno>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace strgraph {
+
+MappedFile::MappedFile(const std::string& path, size_t offset, size_t length) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(std::format(
+            "Cannot open '{}': {}", path, std::strerror(errno)));
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        throw std::runtime_error(std::format("Cannot stat '{}': {}", path, std::strerror(err)));
+    }
+
+    size_t file_size = static_cast<size_t>(st.st_size);
+    if (offset > file_size) {
+        ::close(fd);
+        throw std::runtime_error(std::format(
+            "Offset {} is beyond the end of '{}' (size: {})", offset, path, file_size));
+    }
+    if (length == TO_END) {
+        length = file_size - offset;
+    } else if (length > file_size - offset) {
+        ::close(fd);
+        throw std::runtime_error(std::format(
+            "Range [{}, {}) is beyond the end of '{}' (size: {})",
+            offset, offset + length, path, file_size));
+    }
+
+    // Empty ranges are valid but cannot be mapped
+    if (length == 0) {
+        ::close(fd);
+        return;
+    }
+
+    // mmap offsets must be page-aligned
+    size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t aligned_offset = offset - (offset % page_size);
+    size_t lead = offset - aligned_offset;
+
+    void* mapping = ::mmap(nullptr, length + lead, PROT_READ, MAP_PRIVATE, fd,
+                           static_cast<off_t>(aligned_offset));
+    int err = errno;
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error(std::format("Cannot map '{}': {}", path, std::strerror(err)));
+    }
+
+    mapping_ = mapping;
+    mapping_size_ = length + lead;
+    data_ = static_cast<const char*>(mapping) + lead;
+    size_ = length;
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapping_(std::exchange(other.mapping_, nullptr)),
+      mapping_size_(std::exchange(other.mapping_size_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        mapping_size_ = std::exchange(other.mapping_size_, 0);
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+void MappedFile::advise_sequential() const noexcept {
+    if (mapping_) {
+        ::madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+    }
+}
+
+void MappedFile::release() noexcept {
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+} // namespace strgraph
@@ -0,0 +1,221 @@
+#include "strgraph/metrics.h"
+#include <cstdio>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Escape a label value as required by the exposition format.
+ */
+std::string escape_label(std::string_view value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        switch (c) {
+            case '\\': escaped += "\\\\"; break;
+            case '"': escaped += "\\\""; break;
+            case '\n': escaped += "\\n"; break;
+            default: escaped += c;
+        }
+    }
+    return escaped;
+}
+
+/**
+ * @brief Render a label set as `a="x",b="y"` (without braces).
+ */
+std::string render_labels(const strgraph::MetricLabels& labels) {
+    std::string rendered;
+    for (const auto& [key, value] : labels) {
+        if (!rendered.empty()) rendered += ',';
+        rendered += std::format("{}=\"{}\"", key, escape_label(value));
+    }
+    return rendered;
+}
+
+/**
+ * @brief Series name with its labels plus an optional extra label.
+ */
+std::string series(std::string_view name, const std::string& labels, std::string_view extra = {}) {
+    if (labels.empty() && extra.empty()) {
+        return std::string(name);
+    }
+    if (labels.empty()) {
+        return std::format("{}{{{}}}", name, extra);
+    }
+    if (extra.empty()) {
+        return std::format("{}{{{}}}", name, labels);
+    }
+    return std::format("{}{{{},{}}}", name, labels, extra);
+}
+
+} // anonymous namespace
+
+namespace strgraph {
+
+uint64_t Counter::value() const noexcept {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void Counter::reset() noexcept {
+    for (auto& shard : shards_) {
+        shard.value.store(0, std::memory_order_relaxed);
+    }
+}
+
+Histogram::Snapshot Histogram::snapshot() const noexcept {
+    Snapshot result;
+    for (const auto& shard : shards_) {
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            uint64_t count = shard.counts[i].load(std::memory_order_relaxed);
+            result.counts[i] += count;
+            result.count += count;
+        }
+        result.sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void Histogram::reset() noexcept {
+    for (auto& shard : shards_) {
+        for (auto& count : shard.counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        shard.sum.store(0, std::memory_order_relaxed);
+    }
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(std::string_view name, std::string_view help,
+                                                 Type type, double scale) {
+    auto it = families_.find(name);
+    if (it == families_.end()) {
+        it = families_.emplace(std::string(name), Family{type, std::string(help), scale, {}, {}}).first;
+    } else if (it->second.type != type) {
+        throw std::runtime_error(std::format("Metric '{}' is registered with another type", name));
+    }
+    return it->second;
+}
+
+Counter& MetricsRegistry::counter(std::string_view name, std::string_view help, const MetricLabels& labels) {
+    std::lock_guard lock(mutex_);
+    auto& slot = family(name, help, Type::COUNTER, 1.0).counters[render_labels(labels)];
+    if (!slot) {
+        slot = std::make_unique<Counter>();
+    }
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(std::string_view name, std::string_view help,
+                                      const MetricLabels& labels, double scale) {
+    std::lock_guard lock(mutex_);
+    auto& slot = family(name, help, Type::HISTOGRAM, scale).histograms[render_labels(labels)];
+    if (!slot) {
+        slot = std::make_unique<Histogram>();
+    }
+    return *slot;
+}
+
+std::string MetricsRegistry::to_prometheus() const {
+    std::lock_guard lock(mutex_);
+    std::string out;
+    for (const auto& [name, family] : families_) {
+        out += std::format("# HELP {} {}\n", name, family.help);
+        if (family.type == Type::COUNTER) {
+            out += std::format("# TYPE {} counter\n", name);
+            for (const auto& [labels, counter] : family.counters) {
+                out += std::format("{} {}\n", series(name, labels), counter->value());
+            }
+            continue;
+        }
+
+        out += std::format("# TYPE {} histogram\n", name);
+        for (const auto& [labels, histogram] : family.histograms) {
+            auto snapshot = histogram->snapshot();
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i + 1 < Histogram::BUCKETS; ++i) {
+                cumulative += snapshot.counts[i];
+                // Bucket i holds integers below 2^i
+                double upper = static_cast<double>((uint64_t{1} << i) - 1) * family.scale;
+                out += std::format("{} {}\n",
+                                   series(name + "_bucket", labels, std::format("le=\"{}\"", upper)),
+                                   cumulative);
+            }
+            out += std::format("{} {}\n", series(name + "_bucket", labels, "le=\"+Inf\""), snapshot.count);
+            out += std::format("{} {}\n", series(name + "_sum", labels),
+                               static_cast<double>(snapshot.sum) * family.scale);
+            out += std::format("{} {}\n", series(name + "_count", labels), snapshot.count);
+        }
+    }
+    return out;
+}
+
+void MetricsRegistry::export_prometheus(const std::function<void(std::string_view)>& callback) const {
+    callback(to_prometheus());
+}
+
+void MetricsRegistry::write_prometheus(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file << to_prometheus();
+        if (!file) {
+            throw std::runtime_error(std::format("Cannot write metrics to '{}'", temporary));
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error(std::format("Cannot replace '{}'", path));
+    }
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard lock(mutex_);
+    for (auto& [name, family] : families_) {
+        for (auto& [labels, counter] : family.counters) counter->reset();
+        for (auto& [labels, histogram] : family.histograms) histogram->reset();
+    }
+}
+
+EngineMetrics EngineMetrics::for_graph(std::string_view graph_name) {
+    auto& registry = MetricsRegistry::instance();
+    const std::string graph(graph_name);
+    static constexpr std::array<std::string_view, 3> STRATEGIES = {"recursive", "iterative", "parallel"};
+
+    EngineMetrics metrics;
+    for (size_t i = 0; i < STRATEGIES.size(); ++i) {
+        MetricLabels labels = {{"graph", graph}, {"strategy", std::string(STRATEGIES[i])}};
+        metrics.runs[i] = &registry.counter(
+            "strgraph_runs_total", "Graph executions by graph and resolved strategy", labels);
+        metrics.run_latency[i] = &registry.histogram(
+            "strgraph_run_duration_seconds", "Execution latency by resolved strategy",
+            {{"strategy", std::string(STRATEGIES[i])}}, 1e-9);
+    }
+    metrics.run_failures = &registry.counter(
+        "strgraph_run_failures_total", "Graph executions that threw", {{"graph", graph}});
+    metrics.nodes_executed = &registry.counter(
+        "strgraph_nodes_executed_total", "Operation nodes executed");
+    metrics.bytes_produced = &registry.counter(
+        "strgraph_bytes_produced_total", "Bytes of operation results produced");
+    metrics.layer_width = &registry.histogram(
+        "strgraph_parallel_layer_width", "Nodes per layer of parallel executions");
+    return metrics;
+}
+
+void EngineMetrics::record_op_exception(std::string_view op_name) {
+    MetricsRegistry::instance().counter(
+        "strgraph_op_exceptions_total", "Exceptions thrown by operations",
+        {{"op", std::string(op_name)}}).add();
+}
+
+} // namespace strgraph
@@ -13,6 +13,12 @@ OperationRegistry::OperationRegistry() = default;
 
 void OperationRegistry::register_op(const std::string& name, StringOperation op) {
     operations_[name] = op;
+    signatures_.erase(name);
+}
+
+void OperationRegistry::register_op(const std::string& name, StringOperation op, OpSignature signature) {
+    operations_[name] = op;
+    signatures_[name] = signature;
 }
 
 StringOperation OperationRegistry::get_op(std::string_view name) const {
@@ -27,4 +33,15 @@ bool OperationRegistry::has_operation(std::string_view name) const {
     return operations_.find(name) != operations_.end();
 }
 
+std::optional<OpSignature> OperationRegistry::get_signature(std::string_view name) const {
+    if (!has_operation(name)) {
+        throw std::runtime_error(std::format("Operation '{}' not found", name));
+    }
+    auto it = signatures_.find(name);
+    if (it == signatures_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "strgraph/output_sink.h"
+#include <stdexcept>
+#include <format>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <vector>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief Maximum iovec count of one writev() call.
+ */
+#ifdef IOV_MAX
+constexpr size_t MAX_IOVECS = IOV_MAX;
+#else
+constexpr size_t MAX_IOVECS = 1024;
+#endif
+
+} // anonymous namespace
+
+namespace strgraph {
+
+FdSink::FdSink(int fd) : fd_(fd), name_(std::format("fd {}", fd)) {}
+
+FdSink::FdSink(const std::string& path) : name_(path) {
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error(std::format("Cannot create '{}': {}", path, std::strerror(errno)));
+    }
+    owns_fd_ = true;
+}
+
+FdSink::~FdSink() {
+    if (owns_fd_) {
+        ::close(fd_);
+    }
+}
+
+void FdSink::write(std::span<const std::string_view> pieces) {
+    std::vector<iovec> iovecs;
+    iovecs.reserve(std::min(pieces.size(), MAX_IOVECS));
+
+    size_t next = 0;
+    while (next < pieces.size()) {
+        iovecs.clear();
+        for (; next < pieces.size() && iovecs.size() < MAX_IOVECS; ++next) {
+            if (!pieces[next].empty()) {
+                iovecs.push_back({const_cast<char*>(pieces[next].data()), pieces[next].size()});
+            }
+        }
+
+        // writev() may write less than requested; resume at the first unwritten byte
+        size_t first = 0;
+        while (first < iovecs.size()) {
+            ssize_t n = ::writev(fd_, iovecs.data() + first,
+                                 static_cast<int>(iovecs.size() - first));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::format(
+                    "Cannot write to '{}': {}", name_, std::strerror(errno)));
+            }
+            if (n == 0) {
+                throw std::runtime_error(std::format("Cannot write to '{}': no progress", name_));
+            }
+            ++write_calls_;
+            bytes_written_ += static_cast<size_t>(n);
+
+            auto remaining = static_cast<size_t>(n);
+            while (first < iovecs.size() && remaining >= iovecs[first].iov_len) {
+                remaining -= iovecs[first].iov_len;
+                ++first;
+            }
+            if (remaining > 0) {
+                iovecs[first].iov_base = static_cast<char*>(iovecs[first].iov_base) + remaining;
+                iovecs[first].iov_len -= remaining;
+            }
+        }
+    }
+}
+
+void StreamSink::write(std::span<const std::string_view> pieces) {
+    for (std::string_view piece : pieces) {
+        stream_.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+    }
+    if (!stream_) {
+        throw std::runtime_error("Cannot write to output stream");
+    }
+}
+
+void CallbackSink::write(std::span<const std::string_view> pieces) {
+    for (std::string_view piece : pieces) {
+        callback_(piece);
+    }
+}
+
+} // namespace strgraph
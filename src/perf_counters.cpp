@@ -0,0 +1,140 @@
+#include "strgraph/perf_counters.h"
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+constexpr uint64_t EVENT_CONFIGS[] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+int open_event(uint64_t config, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd == -1 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING | PERF_FORMAT_ID;
+    return static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+int64_t add_counts(int64_t a, int64_t b) {
+    return a < 0 || b < 0 ? -1 : a + b;
+}
+
+} // anonymous namespace
+
+namespace strgraph {
+
+PerfSample operator-(const PerfSample& end, const PerfSample& start) noexcept {
+    auto diff = [](int64_t a, int64_t b) { return a < 0 || b < 0 ? int64_t{-1} : a - b; };
+    return {diff(end.cycles, start.cycles), diff(end.instructions, start.instructions),
+            diff(end.cache_misses, start.cache_misses), diff(end.branch_misses, start.branch_misses)};
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) noexcept {
+    cycles = add_counts(cycles, other.cycles);
+    instructions = add_counts(instructions, other.instructions);
+    cache_misses = add_counts(cache_misses, other.cache_misses);
+    branch_misses = add_counts(branch_misses, other.branch_misses);
+    return *this;
+}
+
+PerfCounters::PerfCounters() {
+    fds_[0] = open_event(EVENT_CONFIGS[0], -1);
+    if (fds_[0] < 0) {
+        reason_ = std::format("perf_event_open: {}", std::strerror(errno));
+        return;
+    }
+    // Members the PMU lacks (common in VMs) are left out of the group
+    for (int i = 1; i < EVENTS; ++i) {
+        fds_[i] = open_event(EVENT_CONFIGS[i], fds_[0]);
+    }
+    if (::ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0) {
+        reason_ = std::format("PERF_EVENT_IOC_ENABLE: {}", std::strerror(errno));
+        for (int& fd : fds_) {
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+}
+
+PerfSample PerfCounters::read() const noexcept {
+    PerfSample sample;
+    if (!available()) {
+        return sample;
+    }
+
+    // Layout of PERF_FORMAT_GROUP | TOTAL_TIME_* | ID reads
+    struct {
+        uint64_t nr;
+        uint64_t time_enabled;
+        uint64_t time_running;
+        struct { uint64_t value; uint64_t id; } values[EVENTS];
+    } data;
+    if (::read(fds_[0], &data, sizeof(data)) <= 0 || data.nr == 0 || data.time_running == 0) {
+        return sample;
+    }
+    double scale = static_cast<double>(data.time_enabled) / static_cast<double>(data.time_running);
+
+    // Values come in the order the events joined the group
+    int64_t* fields[EVENTS] = {&sample.cycles, &sample.instructions, &sample.cache_misses, &sample.branch_misses};
+    size_t next = 0;
+    for (int i = 0; i < EVENTS && next < data.nr; ++i) {
+        if (fds_[i] >= 0) {
+            *fields[i] = static_cast<int64_t>(static_cast<double>(data.values[next++].value) * scale);
+        }
+    }
+    return sample;
+}
+
+PerfCounters& PerfCounters::for_this_thread() {
+    thread_local PerfCounters counters;
+    return counters;
+}
+
+PerfSample PerfCounters::read_team() {
+#ifdef USE_OPENMP
+    PerfSample total{0, 0, 0, 0};
+    #pragma omp parallel
+    {
+        PerfSample sample = for_this_thread().read();
+        #pragma omp critical
+        total += sample;
+    }
+    return total;
+#else
+    return for_this_thread().read();
+#endif
+}
+
+bool PerfCounters::supported() {
+    static const bool result = PerfCounters().available();
+    return result;
+}
+
+} // namespace strgraph
@@ -0,0 +1,227 @@
+#include "strgraph/profiler.h"
+#include "strgraph/alloc_tracking.h"
+#include <json.hpp>
+#include <algorithm>
+#include <fstream>
+#include <format>
+#include <stdexcept>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+size_t worker_index() noexcept {
+#ifdef USE_OPENMP
+    return static_cast<size_t>(omp_get_thread_num());
+#else
+    return 0;
+#endif
+}
+
+size_t max_workers() noexcept {
+#ifdef USE_OPENMP
+    return static_cast<size_t>(std::max(omp_get_max_threads(), 1));
+#else
+    return 1;
+#endif
+}
+
+} // anonymous namespace
+
+namespace strgraph {
+
+Profiler::Profiler() : epoch_(std::chrono::steady_clock::now()) {
+    prepare();
+}
+
+void Profiler::clear() {
+    for (auto& buffer : buffers_) {
+        buffer.clear();
+    }
+    runs_.clear();
+    layers_.clear();
+    epoch_ = std::chrono::steady_clock::now();
+}
+
+void Profiler::prepare() {
+    if (buffers_.size() < max_workers()) {
+        buffers_.resize(max_workers());
+    }
+}
+
+bool Profiler::set_counter_level(CounterLevel level) {
+    if (level != CounterLevel::OFF && !PerfCounters::supported()) {
+        counter_level_ = CounterLevel::OFF;
+        return false;
+    }
+    counter_level_ = level;
+    return true;
+}
+
+uint64_t Profiler::now_ns() const noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count());
+}
+
+Profiler::Scope Profiler::begin() const noexcept {
+    Scope scope{0, alloc_tracking::thread_counters().allocations, {}};
+    if (counter_level_ == CounterLevel::NODES) {
+        scope.counters = PerfCounters::for_this_thread().read();
+    }
+    scope.start_ns = now_ns();
+    return scope;
+}
+
+void Profiler::record(const Node& node, const Scope& scope, size_t input_bytes, size_t output_bytes) {
+    uint64_t end = now_ns();
+    size_t thread = worker_index();
+    if (thread >= buffers_.size()) {
+        return; // Nested parallelism beyond the prepared workers
+    }
+
+    NodeEvent event;
+    event.node_id = node.id;
+    event.op_name = node.op_name;
+    event.start_ns = scope.start_ns;
+    event.end_ns = end;
+    event.thread = thread;
+    if (counter_level_ == CounterLevel::NODES) {
+        event.counters = PerfCounters::for_this_thread().read() - scope.counters;
+    }
+    event.input_bytes = input_bytes;
+    event.output_bytes = output_bytes;
+    if (alloc_tracking::installed()) {
+        event.allocations = static_cast<int64_t>(
+            alloc_tracking::thread_counters().allocations - scope.allocations);
+    }
+    buffers_[thread].push_back(std::move(event));
+}
+
+Profiler::Scope Profiler::begin_run() const {
+    Scope scope{0, 0, {}};
+    if (counter_level_ != CounterLevel::OFF) {
+        scope.counters = PerfCounters::read_team();
+    }
+    scope.start_ns = now_ns();
+    return scope;
+}
+
+void Profiler::record_run(std::string_view strategy, const Scope& scope) {
+    RunEvent run;
+    run.strategy = std::string(strategy);
+    run.start_ns = scope.start_ns;
+    run.end_ns = now_ns();
+    if (counter_level_ != CounterLevel::OFF) {
+        run.counters = PerfCounters::read_team() - scope.counters;
+    }
+    runs_.push_back(std::move(run));
+}
+
+void Profiler::record_layer(size_t width, size_t threads, uint64_t start_ns) {
+    layers_.push_back({width, threads, start_ns, now_ns()});
+}
+
+std::vector<NodeEvent> Profiler::events() const {
+    std::vector<NodeEvent> merged;
+    for (const auto& buffer : buffers_) {
+        merged.insert(merged.end(), buffer.begin(), buffer.end());
+    }
+    std::ranges::stable_sort(merged, {}, &NodeEvent::start_ns);
+    return merged;
+}
+
+std::string Profiler::to_chrome_trace() const {
+    nlohmann::json trace_events = nlohmann::json::array();
+
+    for (size_t thread = 0; thread < buffers_.size(); ++thread) {
+        if (buffers_[thread].empty()) {
+            continue;
+        }
+        trace_events.push_back({
+            {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", thread},
+            {"args", {{"name", std::format("worker {}", thread)}}}
+        });
+    }
+
+    auto add_counters = [](nlohmann::json& args, const PerfSample& counters) {
+        if (counters.valid()) {
+            args["cycles"] = counters.cycles;
+            args["instructions"] = counters.instructions;
+            args["cache_misses"] = counters.cache_misses;
+            args["branch_misses"] = counters.branch_misses;
+            args["ipc"] = counters.ipc();
+        }
+    };
+
+    // Timestamps are in microseconds; runs enclose their nodes on track 0
+    for (const auto& run : runs_) {
+        nlohmann::json args = {{"strategy", run.strategy}};
+        add_counters(args, run.counters);
+        trace_events.push_back({
+            {"name", std::format("run ({})", run.strategy)},
+            {"cat", "run"},
+            {"ph", "X"},
+            {"ts", static_cast<double>(run.start_ns) / 1000.0},
+            {"dur", static_cast<double>(run.duration_ns()) / 1000.0},
+            {"pid", 1},
+            {"tid", 0},
+            {"args", std::move(args)}
+        });
+    }
+
+    for (const auto& layer : layers_) {
+        if (layer.threads < 2) {
+            continue;
+        }
+        trace_events.push_back({
+            {"name", std::format("layer (width {})", layer.width)},
+            {"cat", "layer"},
+            {"ph", "X"},
+            {"ts", static_cast<double>(layer.start_ns) / 1000.0},
+            {"dur", static_cast<double>(layer.duration_ns()) / 1000.0},
+            {"pid", 1},
+            {"tid", 0},
+            {"args", {{"width", layer.width}, {"threads", layer.threads}}}
+        });
+    }
+
+    for (const auto& event : events()) {
+        nlohmann::json args = {
+            {"op", event.op_name},
+            {"input_bytes", event.input_bytes},
+            {"output_bytes", event.output_bytes}
+        };
+        if (event.allocations >= 0) {
+            args["allocations"] = event.allocations;
+        }
+        add_counters(args, event.counters);
+        trace_events.push_back({
+            {"name", event.node_id},
+            {"cat", event.op_name},
+            {"ph", "X"},
+            {"ts", static_cast<double>(event.start_ns) / 1000.0},
+            {"dur", static_cast<double>(event.duration_ns()) / 1000.0},
+            {"pid", 1},
+            {"tid", event.thread},
+            {"args", std::move(args)}
+        });
+    }
+
+    nlohmann::json trace = {
+        {"traceEvents", std::move(trace_events)},
+        {"displayTimeUnit", "ns"}
+    };
+    return trace.dump();
+}
+
+void Profiler::write_chrome_trace(const std::string& path) const {
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output << to_chrome_trace();
+    if (!output) {
+        throw std::runtime_error(std::format("Cannot write trace to '{}'", path));
+    }
+}
+
+} // namespace strgraph
@@ -6,9 +6,141 @@
 #include "strgraph/core_ops.h"
 #include "strgraph/operation_registry.h"
 #include "strgraph/compiled_graph.h"
+#include "strgraph/graph_template.h"
+#include "strgraph/mapped_file.h"
+#include "strgraph/async_io.h"
+#include "strgraph/output_sink.h"
+#include "strgraph/metrics.h"
+#include "strgraph/traffic_recorder.h"
+#include <format>
+#include <fstream>
+#include <chrono>
+#include <map>
+#include <optional>
+#include <tuple>
 
 namespace py = pybind11;
 
+namespace {
+
+/**
+ * @brief Build batch bindings from {column: placeholder_id}.
+ * 
+ * Numeric keys select columns by index, other keys by header or JSON
+ * field name, and an empty key binds the whole record.
+ */
+std::vector<strgraph::ColumnBinding> make_bindings(
+    const std::unordered_map<std::string, std::string>& bindings) {
+    std::vector<strgraph::ColumnBinding> result;
+    for (const auto& [column, placeholder_id] : bindings) {
+        strgraph::ColumnBinding binding;
+        binding.placeholder_id = placeholder_id;
+        if (!column.empty() && column.find_first_not_of("0123456789") == std::string::npos) {
+            binding.column = std::stoull(column);
+        } else if (!column.empty()) {
+            binding.column_name = column;
+        }
+        result.push_back(std::move(binding));
+    }
+    return result;
+}
+
+using PyFileFeeds = std::unordered_map<std::string, std::tuple<std::string, size_t, std::optional<size_t>>>;
+
+/**
+ * @brief Convert {id: (path, offset, length or None)} to a FileFeedDict.
+ */
+strgraph::FileFeedDict make_file_feeds(const PyFileFeeds& file_feeds) {
+    strgraph::FileFeedDict files;
+    for (const auto& [id, feed] : file_feeds) {
+        const auto& [path, offset, length] = feed;
+        files[id] = {path, offset, length.value_or(strgraph::MappedFile::TO_END)};
+    }
+    return files;
+}
+
+/**
+ * @brief Add the hardware counters of a profile record (None if not sampled).
+ */
+void add_perf_sample(py::dict& item, const strgraph::PerfSample& sample) {
+    auto value = [](int64_t count) -> py::object {
+        return count >= 0 ? py::object(py::int_(count)) : py::object(py::none());
+    };
+    item["cycles"] = value(sample.cycles);
+    item["instructions"] = value(sample.instructions);
+    item["cache_misses"] = value(sample.cache_misses);
+    item["branch_misses"] = value(sample.branch_misses);
+}
+
+/**
+ * @brief Phases of a call measured on the native side of the binding.
+ *
+ * Arguments are taken as Python objects and the result is returned as
+ * one, so their conversions can be timed; the GIL is released around
+ * the engine call and the release and reacquisition are timed too.
+ */
+class CallTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Time the conversion of the arguments.
+     */
+    template <typename Convert>
+    auto convert(Convert&& convert_arguments) {
+        auto start = Clock::now();
+        auto arguments = convert_arguments();
+        phases_["argument_conversion"] = elapsed_ns(start);
+        return arguments;
+    }
+
+    /**
+     * @brief Run the engine without the GIL and time the handoff.
+     */
+    template <typename Run>
+    std::string run(Run&& run_engine) {
+        std::string result;
+        auto released = Clock::now();
+        uint64_t handoff_ns = 0;
+        Clock::time_point done;
+        {
+            py::gil_scoped_release release;
+            handoff_ns = elapsed_ns(released);
+            result = run_engine(phases_);
+            done = Clock::now();
+        }
+        phases_["gil_handoff"] = handoff_ns + elapsed_ns(done);
+        return result;
+    }
+
+    /**
+     * @brief Convert the result and return it with the phases.
+     */
+    py::tuple finish(const std::string& result) {
+        auto start = Clock::now();
+        py::str value(result);
+        phases_["result_conversion"] = elapsed_ns(start);
+
+        py::dict phases;
+        for (const auto& [name, ns] : phases_) {
+            phases[py::str(name)] = ns;
+        }
+        return py::make_tuple(std::move(value), std::move(phases));
+    }
+
+    static uint64_t elapsed_ns(Clock::time_point since) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count());
+    }
+
+private:
+    std::map<std::string, uint64_t> phases_;
+};
+
+using FeedMap = std::unordered_map<std::string, std::string>;
+
+} // anonymous namespace
+
 PYBIND11_MODULE(strgraph_cpp, m) {
     m.doc() = "StrGraphCPP - High-performance string computation graph backend";
     
@@ -35,6 +167,29 @@ PYBIND11_MODULE(strgraph_cpp, m) {
         py::arg("feed_dict")
     );
     
+    m.def("execute_timed",
+        [](const py::str& json_data, const py::dict& feed_dict, bool auto_strategy) {
+            CallTimer timer;
+            auto [json, feeds] = timer.convert([&] {
+                return std::make_pair(json_data.cast<std::string>(), feed_dict.cast<FeedMap>());
+            });
+            std::string result = timer.run([&](auto& phases) {
+                strgraph::ExecuteTimings timings;
+                std::string value = auto_strategy ? strgraph::execute_auto(json, feeds, &timings)
+                                                  : strgraph::execute(json, feeds, &timings);
+                phases["json_parse"] = timings.parse_ns;
+                phases["graph_build"] = timings.build_ns;
+                phases["execute"] = timings.execute_ns;
+                return value;
+            });
+            return timer.finish(result);
+        },
+        py::arg("json_data"),
+        py::arg("feed_dict"),
+        py::arg("auto_strategy") = false,
+        "execute() returning (result, {phase: nanoseconds})"
+    );
+    
     m.def("execute_auto",
         [](const std::string& json_data, const std::unordered_map<std::string, std::string>& feed_dict) {
             return strgraph::execute_auto(json_data, feed_dict);
@@ -43,6 +198,22 @@ PYBIND11_MODULE(strgraph_cpp, m) {
         py::arg("feed_dict") = std::unordered_map<std::string, std::string>{}
     );
     
+    // Traffic log of sampled CompiledGraph calls, replayed by strgraph-replay
+    py::class_<strgraph::TrafficRecorder, std::shared_ptr<strgraph::TrafficRecorder>>(m, "TrafficRecorder")
+        .def(py::init([](const std::string& path, double sample_rate, uint64_t max_records, uint64_t seed) {
+                 return std::make_shared<strgraph::TrafficRecorder>(
+                     path, strgraph::RecorderOptions{sample_rate, max_records, seed});
+             }),
+             py::arg("path"),
+             py::arg("sample_rate") = 1.0,
+             py::arg("max_records") = 0,
+             py::arg("seed") = 0,
+             "Create a traffic log recording a share of the calls of the graphs it is attached to")
+        .def("flush", &strgraph::TrafficRecorder::flush,
+             "Write the buffered records to the file")
+        .def_property_readonly("records", &strgraph::TrafficRecorder::records,
+                               "Number of calls recorded so far");
+
     // CompiledGraph class - the optimized way to run graphs
     py::class_<strgraph::CompiledGraph>(m, "CompiledGraph")
         .def(py::init<const std::string&>(), py::arg("json_data"),
@@ -51,18 +222,367 @@ PYBIND11_MODULE(strgraph_cpp, m) {
              py::arg("target_node_id"),
              py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
              "Execute the graph and return the result")
+        .def("run_timed",
+             [](strgraph::CompiledGraph& self, const py::str& target_node_id, const py::dict& feed_dict,
+                bool auto_strategy) {
+                 CallTimer timer;
+                 auto [target, feeds] = timer.convert([&] {
+                     return std::make_pair(target_node_id.cast<std::string>(), feed_dict.cast<FeedMap>());
+                 });
+                 std::string result = timer.run([&](auto& phases) {
+                     auto start = CallTimer::Clock::now();
+                     std::string value = auto_strategy ? self.run_auto(target, feeds) : self.run(target, feeds);
+                     phases["execute"] = CallTimer::elapsed_ns(start);
+                     return value;
+                 });
+                 return timer.finish(result);
+             },
+             py::arg("target_node_id"),
+             py::arg("feed_dict"),
+             py::arg("auto_strategy") = false,
+             "run() returning (result, {phase: nanoseconds})")
         .def("run_auto", &strgraph::CompiledGraph::run_auto,
              py::arg("target_node_id"),
              py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
              "Execute with auto strategy selection")
+        .def("run_with_files",
+             [](strgraph::CompiledGraph& self, const std::string& target_node_id,
+                const PyFileFeeds& file_feeds,
+                const std::unordered_map<std::string, std::string>& feed_dict,
+                const std::string& strategy) {
+                 auto files = make_file_feeds(file_feeds);
+                 auto parsed = strgraph::parse_strategy(strategy);
+                 py::gil_scoped_release release;
+                 return self.run_with_files(target_node_id, files, feed_dict, parsed);
+             },
+             py::arg("target_node_id"),
+             py::arg("file_feeds"),
+             py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
+             py::arg("strategy") = "recursive",
+             "Execute with placeholder values memory-mapped from (path, offset, length) file ranges")
+        .def("run_to_file",
+             [](strgraph::CompiledGraph& self, const std::string& target_node_id,
+                const std::string& output_path,
+                const std::unordered_map<std::string, std::string>& feed_dict,
+                const PyFileFeeds& file_feeds,
+                const std::string& strategy) {
+                 auto files = make_file_feeds(file_feeds);
+                 auto parsed = strgraph::parse_strategy(strategy);
+                 py::gil_scoped_release release;
+                 strgraph::FdSink sink(output_path);
+                 return self.run_to_sink(target_node_id, sink, feed_dict, files, parsed);
+             },
+             py::arg("target_node_id"),
+             py::arg("output_path"),
+             py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
+             py::arg("file_feeds") = PyFileFeeds{},
+             py::arg("strategy") = "recursive",
+             "Write the target's value to a file with scatter-gather writes; returns the byte count")
+        .def("run_to_callback",
+             [](strgraph::CompiledGraph& self, const std::string& target_node_id,
+                const std::function<void(py::bytes)>& callback,
+                const std::unordered_map<std::string, std::string>& feed_dict,
+                const PyFileFeeds& file_feeds,
+                const std::string& strategy) {
+                 strgraph::CallbackSink sink([&callback](std::string_view piece) {
+                     callback(py::bytes(piece.data(), piece.size()));
+                 });
+                 return self.run_to_sink(target_node_id, sink, feed_dict,
+                                         make_file_feeds(file_feeds), strgraph::parse_strategy(strategy));
+             },
+             py::arg("target_node_id"),
+             py::arg("callback"),
+             py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
+             py::arg("file_feeds") = PyFileFeeds{},
+             py::arg("strategy") = "recursive",
+             "Pass the target's value to callback piece by piece (as bytes); returns the byte count")
+        .def("run_file",
+             [](strgraph::CompiledGraph& self, const std::string& target_node_id,
+                const std::string& input_path, const std::string& output_path,
+                const std::unordered_map<std::string, std::string>& bindings,
+                const std::string& format, const std::string& strategy,
+                size_t num_threads, bool skip_errors, const std::string& io) {
+                 strgraph::BatchOptions options;
+                 options.target_node_id = target_node_id;
+                 options.bindings = make_bindings(bindings);
+                 options.format = strgraph::parse_record_format(format);
+                 options.strategy = strgraph::parse_strategy(strategy);
+                 options.num_threads = num_threads;
+                 options.skip_errors = skip_errors;
+
+                 strgraph::BatchStats stats;
+                 std::optional<strgraph::IoStats> read_stats;
+                 std::optional<strgraph::IoStats> write_stats;
+                 {
+                     py::gil_scoped_release release;
+                     if (io == "mmap") {
+                         strgraph::MappedFile input(input_path);
+                         input.advise_sequential();
+                         std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+                         if (!output) {
+                             throw std::runtime_error("Cannot open output file '" + output_path + "'");
+                         }
+                         stats = self.run_batch(input.view(), options, output);
+                         output.close();
+                         if (!output) {
+                             throw std::runtime_error("Cannot write output file '" + output_path + "'");
+                         }
+                     } else {
+                         strgraph::AsyncIoOptions io_options;
+                         io_options.backend = strgraph::parse_io_backend(io);
+                         strgraph::AsyncFileReader input(input_path, io_options);
+                         strgraph::AsyncFileWriter writer(output_path, io_options);
+                         std::ostream output(&writer);
+                         stats = self.run_batch(input, options, output);
+                         writer.close();
+                         if (!output) {
+                             throw std::runtime_error("Cannot write output file '" + output_path + "'");
+                         }
+                         read_stats = input.stats();
+                         write_stats = writer.stats();
+                     }
+                 }
+
+                 py::dict result;
+                 result["records"] = stats.records;
+                 result["errors"] = stats.errors;
+                 result["input_bytes"] = stats.input_bytes;
+                 result["output_bytes"] = stats.output_bytes;
+                 result["elapsed_seconds"] = stats.elapsed_seconds;
+                 result["records_per_second"] = stats.records_per_second();
+                 result["megabytes_per_second"] = stats.megabytes_per_second();
+                 result["compute_seconds"] = stats.compute_seconds;
+                 if (read_stats && write_stats) {
+                     result["io_backend"] = std::string(strgraph::io_backend_name(read_stats->backend));
+                     result["read_requests"] = read_stats->requests;
+                     result["read_wait_seconds"] = read_stats->wait_seconds;
+                     result["write_requests"] = write_stats->requests;
+                     result["write_wait_seconds"] = write_stats->wait_seconds;
+                 }
+                 return result;
+             },
+             py::arg("target_node_id"),
+             py::arg("input_path"),
+             py::arg("output_path"),
+             py::arg("bindings"),
+             py::arg("format") = "lines",
+             py::arg("strategy") = "recursive",
+             py::arg("num_threads") = 0,
+             py::arg("skip_errors") = false,
+             py::arg("io") = "mmap",
+             "Run the graph once per record of a file and write the results to another file")
+        .def("enable_profiling",
+             [](strgraph::CompiledGraph& self, const std::string& counters) {
+                 strgraph::CounterLevel level;
+                 if (counters == "off") {
+                     level = strgraph::CounterLevel::OFF;
+                 } else if (counters == "runs") {
+                     level = strgraph::CounterLevel::RUNS;
+                 } else if (counters == "nodes") {
+                     level = strgraph::CounterLevel::NODES;
+                 } else {
+                     throw std::runtime_error(std::format(
+                         "Unknown hardware counter level '{}' (expected off, runs or nodes)", counters));
+                 }
+                 return self.enable_profiling(level);
+             },
+             py::arg("hardware_counters") = "off",
+             "Record per-node timings of subsequent runs; returns False if hardware counters are not permitted")
+        .def("disable_profiling", &strgraph::CompiledGraph::disable_profiling,
+             "Stop recording; recorded events are kept")
+        .def("clear_profile",
+             [](strgraph::CompiledGraph& self) {
+                 if (auto* profiler = self.profiler()) {
+                     profiler->clear();
+                 }
+             },
+             "Drop the recorded events")
+        .def("profile_events",
+             [](const strgraph::CompiledGraph& self) {
+                 py::list result;
+                 if (const auto* profiler = self.profiler()) {
+                     for (const auto& event : profiler->events()) {
+                         py::dict item;
+                         item["node_id"] = event.node_id;
+                         item["op"] = event.op_name;
+                         item["start_ns"] = event.start_ns;
+                         item["end_ns"] = event.end_ns;
+                         item["thread"] = event.thread;
+                         item["input_bytes"] = event.input_bytes;
+                         item["output_bytes"] = event.output_bytes;
+                         if (event.allocations >= 0) {
+                             item["allocations"] = event.allocations;
+                         } else {
+                             item["allocations"] = py::none();
+                         }
+                         add_perf_sample(item, event.counters);
+                         result.append(item);
+                     }
+                 }
+                 return result;
+             },
+             "Recorded node events ordered by start time")
+        .def("profile_runs",
+             [](const strgraph::CompiledGraph& self) {
+                 py::list result;
+                 if (const auto* profiler = self.profiler()) {
+                     for (const auto& run : profiler->runs()) {
+                         py::dict item;
+                         item["strategy"] = run.strategy;
+                         item["start_ns"] = run.start_ns;
+                         item["end_ns"] = run.end_ns;
+                         add_perf_sample(item, run.counters);
+                         result.append(item);
+                     }
+                 }
+                 return result;
+             },
+             "Recorded executions in order")
+        .def("profile_trace",
+             [](const strgraph::CompiledGraph& self) {
+                 const auto* profiler = self.profiler();
+                 return profiler ? profiler->to_chrome_trace() : strgraph::Profiler().to_chrome_trace();
+             },
+             "Recorded events as Chrome trace-event JSON")
+        .def("explain",
+             [](strgraph::CompiledGraph& self, const std::string& target_node_id,
+                const std::unordered_map<std::string, std::string>& feed_dict,
+                const std::string& strategy, bool analyze, bool as_json) {
+                 auto parsed = strgraph::parse_strategy(strategy);
+                 strgraph::Explanation plan;
+                 {
+                     py::gil_scoped_release release;
+                     plan = analyze ? self.explain_analyze(target_node_id, feed_dict, parsed)
+                                    : self.explain(target_node_id, parsed, feed_dict);
+                 }
+                 return as_json ? plan.to_json() : plan.to_text();
+             },
+             py::arg("target_node_id"),
+             py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
+             py::arg("strategy") = "auto",
+             py::arg("analyze") = false,
+             py::arg("as_json") = false,
+             "Describe (and with analyze=True run) the execution plan of a target")
+        .def("enable_recording", &strgraph::CompiledGraph::enable_recording,
+             py::arg("recorder"),
+             py::arg("graph_id") = "",
+             "Record sampled run() and run_auto() calls to a TrafficRecorder (graph_id defaults to the graph name)")
+        .def("disable_recording", &strgraph::CompiledGraph::disable_recording,
+             "Stop recording calls")
+        .def("enable_flight_recorder",
+             [](strgraph::CompiledGraph& self, double threshold_ms, const std::string& trace_dir,
+                size_t events_per_thread, size_t max_dumps) {
+                 if (threshold_ms < 0.0) {
+                     throw std::runtime_error("threshold_ms must not be negative");
+                 }
+                 self.enable_flight_recorder({
+                     .threshold_ns = static_cast<uint64_t>(threshold_ms * 1e6),
+                     .events_per_thread = events_per_thread,
+                     .trace_dir = trace_dir,
+                     .max_dumps = max_dumps
+                 });
+             },
+             py::arg("threshold_ms") = 100.0,
+             py::arg("trace_dir") = ".",
+             py::arg("events_per_thread") = 4096,
+             py::arg("max_dumps") = 100,
+             "Keep the latest operations of every run and write a Chrome trace of each run slower than threshold_ms")
+        .def("disable_flight_recorder", &strgraph::CompiledGraph::disable_flight_recorder,
+             "Stop the flight recorder; traces written so far are kept")
+        .def("flight_recorder_dumps",
+             [](const strgraph::CompiledGraph& self) {
+                 const auto* recorder = self.flight_recorder();
+                 return recorder != nullptr ? recorder->dumps() : std::vector<std::string>{};
+             },
+             "Paths of the traces written by the flight recorder")
         .def("is_valid", &strgraph::CompiledGraph::is_valid,
              "Check if the compiled graph is valid")
+        .def("is_verified", &strgraph::CompiledGraph::is_verified,
+             "Check if the graph passed verification and runs on the unchecked fast path")
+        .def("verification_error", &strgraph::CompiledGraph::verification_error,
+             "Why verification failed, or an empty string if the graph is verified")
         .def("get_graph", &strgraph::CompiledGraph::get_graph, 
              py::return_value_policy::reference,
              "Get the underlying graph object");
     
+    py::class_<strgraph::ParameterSet>(m, "ParameterSet")
+        .def("__len__", &strgraph::ParameterSet::size)
+        .def("value", [](const strgraph::ParameterSet& self, size_t slot) {
+                 if (slot >= self.size()) {
+                     throw py::index_error("parameter slot out of range");
+                 }
+                 return std::string(self.value(slot));
+             },
+             py::arg("slot"),
+             "Value of the parameter in a slot of GraphTemplate.parameters()")
+        .def_property_readonly("bytes", &strgraph::ParameterSet::bytes,
+             "Heap bytes held by the set");
+
+    py::class_<strgraph::GraphTemplate>(m, "GraphTemplate")
+        .def(py::init([](const std::string& json_data, std::vector<std::string> parameters) {
+                 return std::make_unique<strgraph::GraphTemplate>(
+                     strgraph::Graph::from_json_text(json_data), std::move(parameters));
+             }),
+             py::arg("json_data"),
+             py::arg("parameters"),
+             "Create a template from a JSON graph whose given CONSTANT nodes are parameters")
+        .def_property_readonly("parameters", &strgraph::GraphTemplate::parameters,
+             "IDs of the parameters, in slot order")
+        .def("bind", &strgraph::GraphTemplate::bind,
+             py::arg("values"),
+             "Create a tenant's parameter set; unbound parameters keep their graph value")
+        .def("defaults", &strgraph::GraphTemplate::defaults,
+             py::return_value_policy::reference_internal,
+             "The parameter set with every default value")
+        .def("run",
+             [](strgraph::GraphTemplate& self, const strgraph::ParameterSet& parameters,
+                const std::string& target_node_id,
+                const std::unordered_map<std::string, std::string>& feed_dict,
+                const std::string& strategy) {
+                 auto parsed = strgraph::parse_strategy(strategy);
+                 py::gil_scoped_release release;
+                 return self.run(parameters, target_node_id, feed_dict, parsed);
+             },
+             py::arg("parameters"),
+             py::arg("target_node_id"),
+             py::arg("feed_dict") = std::unordered_map<std::string, std::string>{},
+             py::arg("strategy") = "recursive",
+             "Compute a target with a tenant's parameters (thread-safe)")
+        .def("is_verified", &strgraph::GraphTemplate::is_verified,
+             "Check if runs take the verified fast path")
+        .def("verification_error", &strgraph::GraphTemplate::verification_error,
+             "Why verification failed, or an empty string if the template is verified")
+        .def("contexts", &strgraph::GraphTemplate::contexts,
+             "Execution contexts created so far (the highest concurrency seen)");
+    
+    // Process metrics (Prometheus text exposition format)
+    m.def("metrics_text",
+        []() { return strgraph::MetricsRegistry::instance().to_prometheus(); },
+        "All engine metrics in the Prometheus text format"
+    );
+    
+    m.def("write_metrics",
+        [](const std::string& path) { strgraph::MetricsRegistry::instance().write_prometheus(path); },
+        py::arg("path"),
+        "Atomically write the metrics to a file (e.g. for the node_exporter textfile collector)"
+    );
+    
+    m.def("export_metrics",
+        [](const std::function<void(const std::string&)>& callback) {
+            strgraph::MetricsRegistry::instance().export_prometheus(
+                [&callback](std::string_view text) { callback(std::string(text)); });
+        },
+        py::arg("callback"),
+        "Pass the metrics text to a callback"
+    );
+    
+    m.def("reset_metrics",
+        []() { strgraph::MetricsRegistry::instance().reset(); },
+        "Zero all engine metrics"
+    );
+    
     m.def("register_python_operation",
-        [](const std::string& name, py::object py_func) {
+        [](const std::string& name, py::object py_func, std::optional<bool> multi_output) {
             auto& registry = strgraph::OperationRegistry::get_instance();
             
             PyObject* func_ptr = py_func.ptr();
@@ -115,10 +635,16 @@ PYBIND11_MODULE(strgraph_cpp, m) {
                 }
             };
             
-            registry.register_op(name, cpp_wrapper);
+            if (multi_output) {
+                // A declared result kind lets graphs using the op be verified
+                registry.register_op(name, cpp_wrapper, strgraph::OpSignature{.multi_output = *multi_output});
+            } else {
+                registry.register_op(name, cpp_wrapper);
+            }
         },
         py::arg("name"),
-        py::arg("func")
+        py::arg("func"),
+        py::arg("multi_output") = py::none()
     );
     
     
@@ -0,0 +1,476 @@
+#include "strgraph/record_reader.h"
+#include <stdexcept>
+#include <format>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using strgraph::FieldView;
+
+/**
+ * @brief Bitmasks of the bytes of a 64-byte block equal to two characters.
+ */
+struct BlockMasks {
+    uint64_t first;
+    uint64_t second;
+};
+
+/**
+ * @brief Compare a 64-byte block against two characters at once.
+ */
+inline BlockMasks classify_block(const char* block, char first, char second) {
+#if defined(__AVX2__)
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    const __m256i a = _mm256_set1_epi8(first);
+    const __m256i b = _mm256_set1_epi8(second);
+    auto mask = [&](__m256i needle) {
+        uint64_t l = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)));
+        uint64_t h = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)));
+        return l | (h << 32);
+    };
+    return {mask(a), mask(b)};
+#elif defined(__SSE2__)
+    __m128i chunks[4];
+    for (int i = 0; i < 4; ++i) {
+        chunks[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    }
+    auto mask = [&](char c) {
+        const __m128i needle = _mm_set1_epi8(c);
+        uint64_t result = 0;
+        for (int i = 0; i < 4; ++i) {
+            uint64_t bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunks[i], needle)));
+            result |= bits << (16 * i);
+        }
+        return result;
+    };
+    return {mask(first), mask(second)};
+#else
+    BlockMasks masks{0, 0};
+    for (int i = 0; i < 64; ++i) {
+        masks.first |= static_cast<uint64_t>(block[i] == first) << i;
+        masks.second |= static_cast<uint64_t>(block[i] == second) << i;
+    }
+    return masks;
+#endif
+}
+
+/**
+ * @brief Inclusive prefix XOR: bit i is the parity of bits [0, i].
+ * 
+ * Applied to the quote mask it yields the bytes inside quoted regions.
+ */
+inline uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+/**
+ * @brief Call fn(position) for every occurrence of target outside quotes.
+ * 
+ * Scanning stops early when fn returns false. The data must start
+ * outside a quoted region.
+ */
+template <typename Fn>
+void for_each_structural(std::string_view data, char target, bool quoted, Fn&& fn) {
+    uint64_t quote_carry = 0;
+    alignas(64) char tail[64];
+
+    for (size_t base = 0; base < data.size(); base += 64) {
+        size_t remaining = data.size() - base;
+        const char* block = data.data() + base;
+        uint64_t valid = ~uint64_t{0};
+        if (remaining < 64) {
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, block, remaining);
+            block = tail;
+            valid = (uint64_t{1} << remaining) - 1;
+        }
+
+        BlockMasks masks = classify_block(block, target, '"');
+        uint64_t hits = masks.first & valid;
+        if (quoted) {
+            uint64_t inside = prefix_xor(masks.second & valid) ^ quote_carry;
+            quote_carry = static_cast<uint64_t>(static_cast<int64_t>(inside) >> 63);
+            hits &= ~inside;
+        }
+
+        while (hits) {
+            if (!fn(base + static_cast<size_t>(__builtin_ctzll(hits)))) {
+                return;
+            }
+            hits &= hits - 1;
+        }
+    }
+}
+
+/**
+ * @brief Append the UTF-8 encoding of a code point.
+ */
+void append_utf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+uint32_t parse_hex4(std::string_view s, size_t pos) {
+    if (pos + 4 > s.size()) {
+        throw std::runtime_error("Truncated \\u escape in JSON string");
+    }
+    uint32_t value = 0;
+    for (size_t i = pos; i < pos + 4; ++i) {
+        char c = s[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+        else throw std::runtime_error("Invalid \\u escape in JSON string");
+    }
+    return value;
+}
+
+void unescape_json(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] != '\\') {
+            out += raw[i];
+            continue;
+        }
+        if (++i >= raw.size()) {
+            throw std::runtime_error("Truncated escape in JSON string");
+        }
+        switch (raw[i]) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                uint32_t cp = parse_hex4(raw, i + 1);
+                i += 4;
+                // Combine UTF-16 surrogate pairs
+                if (cp >= 0xD800 && cp <= 0xDBFF && i + 6 < raw.size() &&
+                    raw[i + 1] == '\\' && raw[i + 2] == 'u') {
+                    uint32_t low = parse_hex4(raw, i + 3);
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        i += 6;
+                    }
+                }
+                append_utf8(out, cp);
+                break;
+            }
+            default:
+                throw std::runtime_error(std::format("Invalid escape '\\{}' in JSON string", raw[i]));
+        }
+    }
+}
+
+void unescape_csv(std::string_view raw, std::string& out) {
+    out.clear();
+    out.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        out += raw[i];
+        if (raw[i] == '"' && i + 1 < raw.size() && raw[i + 1] == '"') {
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief Minimal cursor over one JSON object.
+ */
+class JsonCursor {
+public:
+    explicit JsonCursor(std::string_view text) : text_(text) {}
+
+    void skip_ws() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\r' || text_[pos_] == '\n')) {
+            ++pos_;
+        }
+    }
+
+    bool consume(char c) {
+        skip_ws();
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            throw std::runtime_error(std::format(
+                "Malformed JSONL record: expected '{}' at offset {}", c, pos_));
+        }
+    }
+
+    /**
+     * @brief Read a string (cursor on the opening quote); returns its inner text.
+     */
+    FieldView read_string() {
+        expect('"');
+        size_t start = pos_;
+        bool escaped = false;
+        while (true) {
+            const void* hit = std::memchr(text_.data() + pos_, '"', text_.size() - pos_);
+            if (!hit) {
+                throw std::runtime_error("Malformed JSONL record: unterminated string");
+            }
+            size_t quote = static_cast<size_t>(static_cast<const char*>(hit) - text_.data());
+            // A quote preceded by an odd number of backslashes is escaped
+            size_t backslashes = 0;
+            while (quote - backslashes > start && text_[quote - backslashes - 1] == '\\') {
+                ++backslashes;
+            }
+            if (!escaped && std::memchr(text_.data() + pos_, '\\', quote - pos_)) {
+                escaped = true;
+            }
+            pos_ = quote + 1;
+            if (backslashes % 2 == 0) {
+                return {text_.substr(start, quote - start),
+                        escaped ? FieldView::Escape::JSON : FieldView::Escape::NONE};
+            }
+        }
+    }
+
+    /**
+     * @brief Read any value; non-strings are returned as raw JSON text.
+     */
+    FieldView read_value() {
+        skip_ws();
+        if (pos_ >= text_.size()) {
+            throw std::runtime_error("Malformed JSONL record: missing value");
+        }
+        char c = text_[pos_];
+        if (c == '"') {
+            return read_string();
+        }
+        size_t start = pos_;
+        if (c == '{' || c == '[') {
+            skip_nested();
+            return {text_.substr(start, pos_ - start), FieldView::Escape::NONE};
+        }
+        while (pos_ < text_.size() && text_[pos_] != ',' && text_[pos_] != '}' &&
+               text_[pos_] != ']' && text_[pos_] != ' ' && text_[pos_] != '\t' &&
+               text_[pos_] != '\r' && text_[pos_] != '\n') {
+            ++pos_;
+        }
+        std::string_view raw = text_.substr(start, pos_ - start);
+        if (raw.empty()) {
+            throw std::runtime_error(std::format(
+                "Malformed JSONL record: unexpected '{}' at offset {}", c, start));
+        }
+        if (raw == "null") {
+            raw = {};
+        }
+        return {raw, FieldView::Escape::NONE};
+    }
+
+private:
+    void skip_nested() {
+        size_t depth = 0;
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c == '"') {
+                read_string();
+                continue;
+            }
+            ++pos_;
+            if (c == '{' || c == '[') {
+                ++depth;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return;
+            }
+        }
+        throw std::runtime_error("Malformed JSONL record: unterminated object or array");
+    }
+
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+} // anonymous namespace
+
+namespace strgraph {
+
+std::string_view record_format_name(RecordFormat format) {
+    switch (format) {
+        case RecordFormat::LINES: return "lines";
+        case RecordFormat::CSV:   return "csv";
+        case RecordFormat::TSV:   return "tsv";
+        case RecordFormat::JSONL: return "jsonl";
+    }
+    return "unknown";
+}
+
+RecordFormat parse_record_format(std::string_view name) {
+    for (auto format : {RecordFormat::LINES, RecordFormat::CSV, RecordFormat::TSV, RecordFormat::JSONL}) {
+        if (record_format_name(format) == name) {
+            return format;
+        }
+    }
+    throw std::runtime_error(std::format("Unknown record format '{}'", name));
+}
+
+std::string_view FieldView::value(std::string& scratch) const {
+    switch (escape) {
+        case Escape::NONE:
+            return raw;
+        case Escape::CSV_QUOTES:
+            unescape_csv(raw, scratch);
+            return scratch;
+        case Escape::JSON:
+            unescape_json(raw, scratch);
+            return scratch;
+    }
+    return raw;
+}
+
+RecordReader::RecordReader(RecordFormat format, std::optional<char> delimiter, char record_delimiter)
+    : format_(format), delimiter_(delimiter), record_delimiter_(record_delimiter),
+      quoted_(format == RecordFormat::CSV) {
+    switch (format_) {
+        case RecordFormat::CSV:
+            delimiter_ = delimiter.value_or(',');
+            record_delimiter_ = '\n';
+            break;
+        case RecordFormat::TSV:
+            delimiter_ = delimiter.value_or('\t');
+            record_delimiter_ = '\n';
+            break;
+        case RecordFormat::JSONL:
+            delimiter_.reset();
+            record_delimiter_ = '\n';
+            break;
+        case RecordFormat::LINES:
+            break;
+    }
+    if (delimiter_ && (*delimiter_ == '"' || *delimiter_ == record_delimiter_)) {
+        throw std::runtime_error(std::format(
+            "Invalid column delimiter '{}' for format {}", *delimiter_, record_format_name(format_)));
+    }
+}
+
+size_t RecordReader::scan_records(std::string_view input, size_t pos, size_t max_records,
+                                  std::vector<std::string_view>& records,
+                                  bool final_segment) const {
+    records.clear();
+    if (max_records == 0 || pos >= input.size()) {
+        return std::min(pos, input.size());
+    }
+
+    auto emit = [&](size_t end) {
+        std::string_view record = input.substr(pos, end - pos);
+        if (record_delimiter_ == '\n' && !record.empty() && record.back() == '\r') {
+            record.remove_suffix(1);
+        }
+        records.push_back(record);
+        pos = end + 1;
+    };
+
+    size_t base = pos;
+    for_each_structural(input.substr(base), record_delimiter_, quoted_, [&](size_t offset) {
+        emit(base + offset);
+        return records.size() < max_records;
+    });
+
+    // Final record without a trailing delimiter
+    if (final_segment && records.size() < max_records && pos < input.size()) {
+        emit(input.size());
+    }
+    return std::min(pos, input.size());
+}
+
+void RecordReader::split_fields(std::string_view record, std::vector<FieldView>& fields) const {
+    if (format_ == RecordFormat::JSONL) {
+        throw std::runtime_error("split_fields is not applicable to JSONL records");
+    }
+    fields.clear();
+    if (!delimiter_) {
+        fields.push_back({record, FieldView::Escape::NONE});
+        return;
+    }
+
+    auto emit = [&](std::string_view field) {
+        if (quoted_ && field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+            std::string_view inner = field.substr(1, field.size() - 2);
+            bool escaped = inner.find('"') != std::string_view::npos;
+            fields.push_back({inner, escaped ? FieldView::Escape::CSV_QUOTES : FieldView::Escape::NONE});
+        } else {
+            fields.push_back({field, FieldView::Escape::NONE});
+        }
+    };
+
+    size_t start = 0;
+    for_each_structural(record, *delimiter_, quoted_, [&](size_t offset) {
+        emit(record.substr(start, offset - start));
+        start = offset + 1;
+        return true;
+    });
+    emit(record.substr(start));
+}
+
+void RecordReader::find_json_fields(std::string_view record, std::span<const std::string_view> names,
+                                    std::vector<std::optional<FieldView>>& fields) const {
+    fields.assign(names.size(), std::nullopt);
+
+    JsonCursor cursor(record);
+    cursor.expect('{');
+    if (cursor.consume('}')) {
+        return;
+    }
+    do {
+        cursor.skip_ws();
+        FieldView key = cursor.read_string();
+        cursor.expect(':');
+        FieldView value = cursor.read_value();
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == key.raw) {
+                fields[i] = value;
+            }
+        }
+    } while (cursor.consume(','));
+    cursor.expect('}');
+}
+
+std::vector<std::string> RecordReader::parse_header(std::string_view record) const {
+    std::vector<FieldView> fields;
+    split_fields(record, fields);
+    std::vector<std::string> names;
+    names.reserve(fields.size());
+    std::string scratch;
+    for (const auto& field : fields) {
+        names.emplace_back(field.value(scratch));
+    }
+    return names;
+}
+
+} // namespace strgraph
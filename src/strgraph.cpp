@@ -2,16 +2,28 @@
 #include "strgraph/graph.h"
 #include "strgraph/executor.h"
 #include <json.hpp>
+#include <chrono>
 
+namespace {
 
-namespace strgraph {
-
-std::string execute(std::string_view json_data) {
-    return execute(json_data, {});
-}
+/**
+ * @brief Parse, build and execute a graph with its target, timing each phase.
+ */
+std::string execute_json(std::string_view json_data,
+                         const std::unordered_map<std::string, std::string>& feed_dict,
+                         strgraph::ExecutionStrategy strategy,
+                         strgraph::ExecuteTimings* timings) {
+    using clock = std::chrono::steady_clock;
+    auto mark = clock::now();
+    auto lap = [&](uint64_t strgraph::ExecuteTimings::*phase) {
+        auto now = clock::now();
+        if (timings != nullptr) {
+            timings->*phase = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - mark).count());
+        }
+        mark = now;
+    };
 
-std::string execute(std::string_view json_data, 
-                   const std::unordered_map<std::string, std::string>& feed_dict) {
     auto json = nlohmann::json::parse(json_data);
 
     if (!json.contains("target_node")) {
@@ -19,27 +31,35 @@ std::string execute(std::string_view json_data,
     }
 
     std::string target_node_id = json["target_node"].get<std::string>();
+    lap(&strgraph::ExecuteTimings::parse_ns);
 
-    auto graph = Graph::from_json(json);
-    Executor executor(*graph);
+    auto graph = strgraph::Graph::from_json(json);
+    strgraph::Executor executor(*graph);
+    lap(&strgraph::ExecuteTimings::build_ns);
 
-    return executor.compute(target_node_id, feed_dict);
+    std::string result = executor.compute_with_strategy(strategy, target_node_id, feed_dict);
+    lap(&strgraph::ExecuteTimings::execute_ns);
+    return result;
 }
 
-std::string execute_auto(std::string_view json_data,
-                        const std::unordered_map<std::string, std::string>& feed_dict) {
-    auto json = nlohmann::json::parse(json_data);
+} // anonymous namespace
 
-    if (!json.contains("target_node")) {
-        throw std::runtime_error("JSON missing 'target_node' field.");
-    }
+namespace strgraph {
 
-    std::string target_node_id = json["target_node"].get<std::string>();
+std::string execute(std::string_view json_data) {
+    return execute(json_data, {});
+}
 
-    auto graph = Graph::from_json(json);
-    Executor executor(*graph);
+std::string execute(std::string_view json_data, 
+                   const std::unordered_map<std::string, std::string>& feed_dict,
+                   ExecuteTimings* timings) {
+    return execute_json(json_data, feed_dict, ExecutionStrategy::RECURSIVE, timings);
+}
 
-    return executor.compute_auto(target_node_id, feed_dict);
+std::string execute_auto(std::string_view json_data,
+                        const std::unordered_map<std::string, std::string>& feed_dict,
+                        ExecuteTimings* timings) {
+    return execute_json(json_data, feed_dict, ExecutionStrategy::AUTO, timings);
 }
 
-} // namespace strgraph
\ No newline at end of file
+} // namespace strgraph
@@ -0,0 +1,197 @@
+#include "strgraph/traffic_recorder.h"
+#include <cstring>
+#include <format>
+#include <sstream>
+#include <stdexcept>
+
+namespace strgraph {
+
+namespace {
+
+constexpr size_t FLUSH_BYTES = size_t{1} << 20;
+
+template <typename T>
+void append_pod(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void append_string(std::string& out, std::string_view s) {
+    append_pod(out, static_cast<uint32_t>(s.size()));
+    out.append(s);
+}
+
+/**
+ * @brief Reader over the bytes of a traffic log.
+ */
+class LogReader {
+public:
+    explicit LogReader(std::string_view data) : data_(data) {}
+
+    template <typename T>
+    T read_pod() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return value;
+    }
+
+    std::string_view read_view(size_t size) {
+        require(size);
+        std::string_view view = data_.substr(pos_, size);
+        pos_ += size;
+        return view;
+    }
+
+    std::string read_string() {
+        return std::string(read_view(read_pod<uint32_t>()));
+    }
+
+    bool at_end() const { return pos_ == data_.size(); }
+
+private:
+    void require(size_t size) const {
+        if (data_.size() - pos_ < size) {
+            throw std::runtime_error("Traffic log is truncated");
+        }
+    }
+
+    std::string_view data_;
+    size_t pos_ = 0;
+};
+
+} // anonymous namespace
+
+TrafficRecorder::TrafficRecorder(const std::string& path, RecorderOptions options)
+    : file_(path, std::ios::binary | std::ios::trunc),
+      options_(options),
+      rng_(options.seed != 0 ? options.seed : std::random_device{}()),
+      epoch_(std::chrono::steady_clock::now()) {
+    if (!file_) {
+        throw std::runtime_error(std::format("Cannot create traffic log '{}'", path));
+    }
+    buffer_.append(LOG_MAGIC);
+    append_pod(buffer_, LOG_VERSION);
+}
+
+TrafficRecorder::~TrafficRecorder() {
+    try {
+        flush();
+    } catch (const std::exception&) {
+        // Destructors must not throw; the log stays truncated
+    }
+}
+
+bool TrafficRecorder::sample() {
+    std::lock_guard lock(mutex_);
+    if (options_.max_records != 0 && records_ >= options_.max_records) {
+        return false;
+    }
+    if (options_.sample_rate >= 1.0) {
+        return true;
+    }
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < options_.sample_rate;
+}
+
+void TrafficRecorder::record(const TrafficRecord& record) {
+    // Encode outside the lock; only the append is serialized
+    std::string out;
+    append_pod(out, uint32_t{0});
+    append_pod(out, record.timestamp_ns);
+    append_pod(out, record.latency_ns);
+    append_pod(out, record.result_size);
+    append_pod(out, record.result_hash);
+    append_string(out, record.graph_id);
+    append_string(out, record.target);
+    append_string(out, record.strategy);
+    append_string(out, record.error);
+    append_pod(out, static_cast<uint32_t>(record.feeds.size()));
+    for (const auto& [name, value] : record.feeds) {
+        append_string(out, name);
+        append_string(out, value);
+    }
+    auto record_size = static_cast<uint32_t>(out.size() - sizeof(uint32_t));
+    std::memcpy(out.data(), &record_size, sizeof(record_size));
+
+    std::lock_guard lock(mutex_);
+    if (options_.max_records != 0 && records_ >= options_.max_records) {
+        return;
+    }
+    buffer_.append(out);
+    ++records_;
+    if (buffer_.size() >= FLUSH_BYTES) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+    }
+}
+
+void TrafficRecorder::flush() {
+    std::lock_guard lock(mutex_);
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    file_.flush();
+    if (!file_) {
+        throw std::runtime_error("Writing the traffic log failed");
+    }
+}
+
+uint64_t TrafficRecorder::now_ns() const noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch_).count());
+}
+
+uint64_t TrafficRecorder::records() const {
+    std::lock_guard lock(mutex_);
+    return records_;
+}
+
+uint64_t TrafficRecorder::hash(std::string_view data) noexcept {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::vector<TrafficRecord> TrafficRecorder::read(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error(std::format("Cannot open traffic log '{}'", path));
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string data = std::move(buffer).str();
+
+    if (!data.starts_with(LOG_MAGIC)) {
+        throw std::runtime_error(std::format("'{}' is not a traffic log", path));
+    }
+    LogReader reader(std::string_view(data).substr(LOG_MAGIC.size()));
+    uint32_t version = reader.read_pod<uint32_t>();
+    if (version != LOG_VERSION) {
+        throw std::runtime_error(std::format("Unsupported traffic log version {}", version));
+    }
+
+    std::vector<TrafficRecord> records;
+    while (!reader.at_end()) {
+        LogReader fields(reader.read_view(reader.read_pod<uint32_t>()));
+        TrafficRecord& record = records.emplace_back();
+        record.timestamp_ns = fields.read_pod<uint64_t>();
+        record.latency_ns = fields.read_pod<uint64_t>();
+        record.result_size = fields.read_pod<uint64_t>();
+        record.result_hash = fields.read_pod<uint64_t>();
+        record.graph_id = fields.read_string();
+        record.target = fields.read_string();
+        record.strategy = fields.read_string();
+        record.error = fields.read_string();
+        uint32_t feed_count = fields.read_pod<uint32_t>();
+        record.feeds.reserve(feed_count);
+        for (uint32_t i = 0; i < feed_count; ++i) {
+            std::string name = fields.read_string();
+            record.feeds.emplace_back(std::move(name), fields.read_string());
+        }
+    }
+    return records;
+}
+
+} // namespace strgraph
@@ -0,0 +1,730 @@
+#pragma once
+/**
+ * @file bench_util.h
+ * @brief Shared workload generators and measurement helpers of the
+ *        benchmark executables (strgraph_benchmark, strgraph_analysis).
+ *
+ * Graphs are built from a GraphSpec: a shape, an operation mix, the size
+ * of the strings flowing through it and a node count. All operations in
+ * a mix preserve the length of their input, and nodes with several
+ * inputs concat them and cut the result back to the value size, so the
+ * memory a run needs is predictable (about nodes x value size).
+ */
+
+#include "strgraph/alloc_tracking.h"
+#include "strgraph/executor.h"
+#include "strgraph/graph.h"
+#include "strgraph/graph_generator.h"
+#include "strgraph/profiler.h"
+#include <json.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+
+namespace strgraph::bench {
+
+/**
+ * @brief Topology of a generated graph.
+ */
+enum class Shape {
+    CHAIN,      ///< One long dependency chain
+    FANOUT,     ///< One input feeding many independent nodes, joined at the end
+    LATTICE,    ///< Layers where every node depends on two neighbours of the previous layer
+    RANDOM,     ///< Random DAG, 1-3 inputs per node chosen from recent nodes
+    MERGED,     ///< Many small independent graphs with their own inputs, joined at the end
+    LAYERED     ///< Diamond-shaped layers with split nodes, from generator::generate()
+};
+
+/**
+ * @brief Operations used by the unary nodes of a generated graph.
+ */
+enum class OpMix {
+    CASE,       ///< to_upper, to_lower, capitalize, title
+    COPY,       ///< identity, reverse
+    EDIT,       ///< replace, trim, substring
+    MIXED       ///< All of the above
+};
+
+inline constexpr std::array<Shape, 6> ALL_SHAPES = {
+    Shape::CHAIN, Shape::FANOUT, Shape::LATTICE, Shape::RANDOM, Shape::MERGED, Shape::LAYERED};
+inline constexpr std::array<OpMix, 4> ALL_MIXES = {
+    OpMix::CASE, OpMix::COPY, OpMix::EDIT, OpMix::MIXED};
+
+inline std::string_view shape_name(Shape shape) {
+    switch (shape) {
+        case Shape::CHAIN: return "chain";
+        case Shape::FANOUT: return "fanout";
+        case Shape::LATTICE: return "lattice";
+        case Shape::RANDOM: return "random";
+        case Shape::MERGED: return "merged";
+        case Shape::LAYERED: return "layered";
+    }
+    return "unknown";
+}
+
+inline std::string_view mix_name(OpMix mix) {
+    switch (mix) {
+        case OpMix::CASE: return "case";
+        case OpMix::COPY: return "copy";
+        case OpMix::EDIT: return "edit";
+        case OpMix::MIXED: return "mixed";
+    }
+    return "unknown";
+}
+
+inline Shape parse_shape(std::string_view name) {
+    for (Shape shape : ALL_SHAPES) {
+        if (shape_name(shape) == name) return shape;
+    }
+    throw std::runtime_error(std::format("Unknown shape '{}'", name));
+}
+
+inline OpMix parse_mix(std::string_view name) {
+    for (OpMix mix : ALL_MIXES) {
+        if (mix_name(mix) == name) return mix;
+    }
+    throw std::runtime_error(std::format("Unknown op mix '{}'", name));
+}
+
+/**
+ * @brief Parse a byte count with an optional K, M or G suffix (powers of 1024).
+ */
+inline size_t parse_bytes(std::string_view text) {
+    size_t multiplier = 1;
+    if (!text.empty()) {
+        switch (text.back()) {
+            case 'K': case 'k': multiplier = size_t{1} << 10; break;
+            case 'M': case 'm': multiplier = size_t{1} << 20; break;
+            case 'G': case 'g': multiplier = size_t{1} << 30; break;
+        }
+        if (multiplier != 1) text.remove_suffix(1);
+    }
+    size_t value = 0;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (text.empty() || ec != std::errc{} || ptr != text.data() + text.size()) {
+        throw std::runtime_error(std::format("Invalid byte count '{}'", text));
+    }
+    return value * multiplier;
+}
+
+/**
+ * @brief Format a byte count as parse_bytes() accepts it (e.g. "64K").
+ */
+inline std::string format_bytes(size_t bytes) {
+    if (bytes >= (size_t{1} << 30) && bytes % (size_t{1} << 30) == 0) return std::format("{}G", bytes >> 30);
+    if (bytes >= (size_t{1} << 20) && bytes % (size_t{1} << 20) == 0) return std::format("{}M", bytes >> 20);
+    if (bytes >= (size_t{1} << 10) && bytes % (size_t{1} << 10) == 0) return std::format("{}K", bytes >> 10);
+    return std::format("{}", bytes);
+}
+
+/**
+ * @brief Split a comma-separated list.
+ */
+inline std::vector<std::string> split_list(std::string_view text) {
+    std::vector<std::string> items;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        if (comma != 0) items.emplace_back(text.substr(0, comma));
+        if (comma == std::string_view::npos) break;
+        text.remove_prefix(comma + 1);
+    }
+    return items;
+}
+
+/**
+ * @brief Parameters of a generated graph.
+ */
+struct GraphSpec {
+    Shape shape = Shape::CHAIN;
+    OpMix mix = OpMix::MIXED;
+    size_t value_size = 64;           ///< Length of every placeholder value
+    size_t nodes = 256;               ///< Requested number of operation nodes
+    size_t memory_budget = size_t{512} << 20;  ///< Caps nodes x value_size
+    uint64_t seed = 42;
+
+    /**
+     * @brief Node count after applying the memory budget (at least 4).
+     */
+    [[nodiscard]] size_t effective_nodes() const {
+        size_t affordable = memory_budget / std::max<size_t>(value_size, 1);
+        return std::max<size_t>(4, std::min(nodes, affordable));
+    }
+
+    [[nodiscard]] std::string name() const {
+        return std::format("{}/{}/{}/n{}", shape_name(shape), mix_name(mix),
+                           format_bytes(value_size), effective_nodes());
+    }
+};
+
+/**
+ * @brief A generated graph with the values to feed it.
+ */
+struct BenchGraph {
+    std::unique_ptr<Graph> graph;
+    std::string target;
+    std::vector<std::string> placeholder_ids;
+    std::unique_ptr<const std::string> value;   ///< Heap-allocated so feeds survive moves
+    FeedViewDict feeds;               ///< Views of placeholder_ids and *value
+    size_t operation_nodes = 0;
+};
+
+/**
+ * @brief Deterministic text of the given length: lowercase words separated
+ *        by single spaces, never starting or ending with a space.
+ */
+inline std::string make_value(size_t size, uint64_t seed) {
+    return generator::make_value(size, seed);
+}
+
+namespace detail {
+
+/**
+ * @brief Accumulates the JSON nodes of a generated graph.
+ */
+class GraphBuilder {
+public:
+    GraphBuilder(const GraphSpec& spec) : spec_(spec), rng_(spec.seed) {}
+
+    std::string placeholder() {
+        std::string id = std::format("p{}", placeholders_.size());
+        nodes_.push_back({{"id", id}, {"type", "placeholder"}});
+        placeholders_.push_back(id);
+        return id;
+    }
+
+    /**
+     * @brief Add a length-preserving operation drawn from the op mix.
+     */
+    std::string unary(const std::string& input) {
+        static constexpr std::array<std::string_view, 4> CASE_OPS = {"to_upper", "to_lower", "capitalize", "title"};
+        static constexpr std::array<std::string_view, 2> COPY_OPS = {"identity", "reverse"};
+        static constexpr std::array<std::string_view, 3> EDIT_OPS = {"replace", "trim", "substring"};
+
+        std::string_view op;
+        switch (spec_.mix) {
+            case OpMix::CASE: op = CASE_OPS[rng_() % CASE_OPS.size()]; break;
+            case OpMix::COPY: op = COPY_OPS[rng_() % COPY_OPS.size()]; break;
+            case OpMix::EDIT: op = EDIT_OPS[rng_() % EDIT_OPS.size()]; break;
+            case OpMix::MIXED: {
+                size_t pick = rng_() % (CASE_OPS.size() + COPY_OPS.size() + EDIT_OPS.size());
+                if (pick < CASE_OPS.size()) op = CASE_OPS[pick];
+                else if ((pick -= CASE_OPS.size()) < COPY_OPS.size()) op = COPY_OPS[pick];
+                else op = EDIT_OPS[pick - COPY_OPS.size()];
+                break;
+            }
+        }
+
+        nlohmann::json constants = nlohmann::json::array();
+        if (op == "replace") constants = {"a", "e"};
+        if (op == "substring") constants = {"0", "-1"};
+        return add(op, {input}, std::move(constants));
+    }
+
+    /**
+     * @brief Concat the inputs and cut the result back to the value size.
+     */
+    std::string merge(const std::vector<std::string>& inputs) {
+        std::string joined = add("concat", inputs, nlohmann::json::array());
+        return add("substring", {joined}, {"0", std::to_string(spec_.value_size)});
+    }
+
+    /**
+     * @brief Concat the inputs (the output is their total size).
+     */
+    std::string join(const std::vector<std::string>& inputs) {
+        return add("concat", inputs, nlohmann::json::array());
+    }
+
+    [[nodiscard]] size_t operation_nodes() const noexcept { return operations_; }
+    [[nodiscard]] std::mt19937_64& rng() noexcept { return rng_; }
+
+    BenchGraph finish(const std::string& target) {
+        BenchGraph result;
+        result.graph = Graph::from_json({{"nodes", std::move(nodes_)}, {"target_node", target}});
+        result.target = target;
+        result.placeholder_ids = std::move(placeholders_);
+        result.value = std::make_unique<const std::string>(make_value(spec_.value_size, spec_.seed));
+        for (const auto& id : result.placeholder_ids) {
+            result.feeds[id] = *result.value;
+        }
+        result.operation_nodes = operations_;
+        return result;
+    }
+
+private:
+    std::string add(std::string_view op, const std::vector<std::string>& inputs, nlohmann::json constants) {
+        std::string id = std::format("n{}", operations_++);
+        nodes_.push_back({{"id", id}, {"op", op}, {"inputs", inputs}, {"constants", std::move(constants)}});
+        return id;
+    }
+
+    const GraphSpec& spec_;
+    std::mt19937_64 rng_;
+    nlohmann::json nodes_ = nlohmann::json::array();
+    std::vector<std::string> placeholders_;
+    size_t operations_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Generate a graph with generator::generate_graph(), fed values
+ *        of options.value_size bytes.
+ */
+inline BenchGraph build_generated(const generator::Options& options) {
+    generator::Summary summary;
+    BenchGraph result;
+    result.graph = generator::generate_graph(options, &summary);
+    result.target = generator::Summary::TARGET;
+    result.placeholder_ids = std::move(summary.placeholder_ids);
+    result.value = std::make_unique<const std::string>(make_value(options.value_size, options.seed));
+    for (const auto& id : result.placeholder_ids) {
+        result.feeds[id] = *result.value;
+    }
+    result.operation_nodes = summary.operation_nodes;
+    return result;
+}
+
+/**
+ * @brief Generate the graph described by spec.
+ */
+inline BenchGraph build_graph(const GraphSpec& spec) {
+    detail::GraphBuilder builder(spec);
+    const size_t n = spec.effective_nodes();
+    std::string target;
+
+    switch (spec.shape) {
+        case Shape::CHAIN: {
+            target = builder.placeholder();
+            for (size_t i = 0; i < n; ++i) {
+                target = builder.unary(target);
+            }
+            break;
+        }
+        case Shape::FANOUT: {
+            std::string input = builder.placeholder();
+            std::vector<std::string> leaves;
+            for (size_t i = 0; i + 1 < n; ++i) {
+                leaves.push_back(builder.unary(input));
+            }
+            target = builder.join(leaves);
+            break;
+        }
+        case Shape::LATTICE: {
+            // Every cell after the first layer is a concat and a substring
+            size_t width = std::max<size_t>(2, static_cast<size_t>(std::sqrt(static_cast<double>(n) / 2.0)));
+            size_t depth = std::max<size_t>(2, n / (2 * width));
+            std::string input = builder.placeholder();
+            std::vector<std::string> layer;
+            for (size_t i = 0; i < width; ++i) {
+                layer.push_back(builder.unary(input));
+            }
+            for (size_t d = 1; d < depth; ++d) {
+                std::vector<std::string> next;
+                for (size_t i = 0; i < width; ++i) {
+                    next.push_back(builder.merge({layer[i], layer[(i + 1) % width]}));
+                }
+                layer = std::move(next);
+            }
+            target = builder.merge(layer);
+            break;
+        }
+        case Shape::RANDOM: {
+            constexpr size_t WINDOW = 32;
+            std::vector<std::string> ids = {builder.placeholder()};
+            std::vector<bool> used = {false};
+            while (builder.operation_nodes() < n) {
+                size_t fan_in = 1 + builder.rng()() % 3;
+                size_t lo = ids.size() > WINDOW ? ids.size() - WINDOW : 0;
+                std::vector<std::string> inputs;
+                for (size_t k = 0; k < fan_in; ++k) {
+                    size_t pick = lo + builder.rng()() % (ids.size() - lo);
+                    inputs.push_back(ids[pick]);
+                    used[pick] = true;
+                }
+                ids.push_back(fan_in == 1 ? builder.unary(inputs[0]) : builder.merge(inputs));
+                used.push_back(false);
+            }
+            std::vector<std::string> sinks;
+            for (size_t i = 0; i < ids.size(); ++i) {
+                if (!used[i]) sinks.push_back(ids[i]);
+            }
+            target = sinks.size() == 1 ? sinks[0] : builder.merge(sinks);
+            break;
+        }
+        case Shape::MERGED: {
+            // Small diamonds of 6 operations, each with its own placeholder
+            std::vector<std::string> outputs;
+            for (size_t i = 0; i < std::max<size_t>(1, n / 6); ++i) {
+                std::string input = builder.placeholder();
+                std::string left = builder.unary(input);
+                std::string right = builder.unary(input);
+                std::string joined = builder.merge({left, right});
+                outputs.push_back(builder.unary(builder.unary(joined)));
+            }
+            target = builder.join(outputs);
+            break;
+        }
+        case Shape::LAYERED: {
+            generator::Options options;
+            options.nodes = n;
+            options.width = generator::WidthProfile::DIAMOND;
+            options.lookback = 2;
+            options.multi_output_ratio = 0.1;
+            options.mix = generator::parse_op_mix(mix_name(spec.mix));
+            options.value_size = spec.value_size;
+            options.seed = spec.seed;
+            options.name = spec.name();
+            return build_generated(options);
+        }
+    }
+    return builder.finish(target);
+}
+
+/**
+ * @brief Allocation counters summed over the calling thread and the
+ *        OpenMP worker threads (which persist between parallel regions).
+ */
+inline alloc_tracking::AllocCounters team_alloc_counters() {
+    alloc_tracking::AllocCounters total;
+#ifdef USE_OPENMP
+    #pragma omp parallel
+    {
+        auto counters = alloc_tracking::thread_counters();
+        #pragma omp critical
+        {
+            total.allocations += counters.allocations;
+            total.deallocations += counters.deallocations;
+            total.allocated_bytes += counters.allocated_bytes;
+        }
+    }
+#else
+    total = alloc_tracking::thread_counters();
+#endif
+    return total;
+}
+
+/**
+ * @brief Order statistics of a latency sample.
+ */
+struct LatencySummary {
+    uint64_t min_ns = 0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t max_ns = 0;
+    double mean_ns = 0.0;
+};
+
+/**
+ * @brief Nearest-rank percentile (q in [0, 1]) of a sorted sample.
+ */
+template <typename T>
+T percentile(const std::vector<T>& sorted, double q) {
+    if (sorted.empty()) return T{};
+    size_t rank = static_cast<size_t>(std::ceil(q * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+inline LatencySummary summarize(std::vector<uint64_t> samples) {
+    LatencySummary summary;
+    if (samples.empty()) return summary;
+    std::ranges::sort(samples);
+    summary.min_ns = samples.front();
+    summary.p50_ns = percentile(samples, 0.50);
+    summary.p90_ns = percentile(samples, 0.90);
+    summary.p99_ns = percentile(samples, 0.99);
+    summary.max_ns = samples.back();
+    double sum = 0.0;
+    for (uint64_t sample : samples) sum += static_cast<double>(sample);
+    summary.mean_ns = sum / static_cast<double>(samples.size());
+    return summary;
+}
+
+/**
+ * @brief Log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 2 x SUB_BUCKETS are counted exactly; above that every
+ * power of two is split into SUB_BUCKETS buckets, so a percentile is
+ * within 1/SUB_BUCKETS (under 1%) of the true value over the whole
+ * uint64 range, in fixed memory and with O(1) recording. Histograms of
+ * several threads are combined with merge().
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t{1} << (SUB_BUCKET_BITS - 1);
+
+    LatencyHistogram() : counts_(bucket_index(UINT64_MAX) + 1, 0) {}
+
+    void record(uint64_t value) noexcept {
+        ++counts_[bucket_index(value)];
+        ++count_;
+        sum_ += static_cast<double>(value);
+        max_ = std::max(max_, value);
+        min_ = std::min(min_, value);
+    }
+
+    void merge(const LatencyHistogram& other) noexcept {
+        for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+        min_ = std::min(min_, other.min_);
+    }
+
+    /**
+     * @brief Nearest-rank percentile (q in [0, 1]), reported as the
+     *        highest value of its bucket (never below the true value).
+     */
+    [[nodiscard]] uint64_t percentile(double q) const noexcept {
+        if (count_ == 0) return 0;
+        auto rank = std::clamp<uint64_t>(static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_))), 1, count_);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(bucket_high(i), max_);
+        }
+        return max_;
+    }
+
+    [[nodiscard]] uint64_t count() const noexcept { return count_; }
+    [[nodiscard]] uint64_t min() const noexcept { return count_ > 0 ? min_ : 0; }
+    [[nodiscard]] uint64_t max() const noexcept { return max_; }
+    [[nodiscard]] double mean() const noexcept { return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0; }
+
+private:
+    static size_t bucket_index(uint64_t value) noexcept {
+        if (value < 2 * SUB_BUCKETS) return static_cast<size_t>(value);
+        unsigned shift = static_cast<unsigned>(std::bit_width(value)) - SUB_BUCKET_BITS;
+        return static_cast<size_t>(SUB_BUCKETS * shift + (value >> shift));
+    }
+
+    static uint64_t bucket_high(size_t index) noexcept {
+        if (index < 2 * SUB_BUCKETS) return index;
+        uint64_t shift = index / SUB_BUCKETS - 1;
+        uint64_t mantissa = index - SUB_BUCKETS * shift;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t count_ = 0;
+    double sum_ = 0.0;
+    uint64_t max_ = 0;
+    uint64_t min_ = UINT64_MAX;
+};
+
+/**
+ * @brief How long a case is repeated.
+ */
+struct MeasureOptions {
+    double min_seconds = 0.2;
+    size_t min_iterations = 5;
+    size_t max_iterations = 100000;
+    bool hardware_counters = false;   ///< Sample PerfCounters around the timed runs
+    bool flight_recorder = false;     ///< Keep a FlightRecorder (never dumping) attached to the timed runs
+    size_t min_parallel_layer_size = Executor::MIN_PARALLEL_LAYER_SIZE;
+};
+
+/**
+ * @brief Restart the process's peak resident set size (VmHWM) from the
+ *        current resident set size.
+ *
+ * @return false where /proc/self/clear_refs is unavailable (not Linux,
+ *         or a kernel before 4.0), in which case the peak keeps growing
+ *         from process start
+ */
+inline bool reset_peak_rss() {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+}
+
+/**
+ * @brief Peak resident set size of the process in bytes, -1 if unknown.
+ */
+inline int64_t peak_rss_bytes() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.starts_with("VmHWM:")) {
+            return std::stoll(line.substr(6)) * 1024;   // Reported in kB
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Timings and memory use of repeated runs of one case.
+ */
+struct Measurement {
+    std::vector<uint64_t> samples_ns;     ///< One latency per run
+    double allocations_per_run = 0.0;     ///< Only meaningful if alloc_tracking::installed()
+    double allocated_bytes_per_run = 0.0;
+    size_t bytes_processed = 0;           ///< Input bytes read by all operations of one run
+    size_t bytes_produced = 0;            ///< Output bytes written by all operations of one run
+    size_t operations_run = 0;            ///< Operation nodes executed per run
+    int64_t peak_live_bytes = -1;         ///< Heap high-water mark of one run over the heap without node values, -1 untracked
+    int64_t peak_rss_bytes = -1;          ///< Process peak RSS during one run (not reset if unsupported), -1 unknown
+    PerfSample counters;                  ///< Sum over all timed runs and worker threads
+
+    [[nodiscard]] double allocations_per_node() const noexcept {
+        return operations_run > 0 ? allocations_per_run / static_cast<double>(operations_run) : 0.0;
+    }
+    [[nodiscard]] double bytes_produced_per_node() const noexcept {
+        return operations_run > 0 ? static_cast<double>(bytes_produced) / static_cast<double>(operations_run) : 0.0;
+    }
+    /**
+     * @brief Peak heap over the size of all values of a run: 1.0 means
+     *        every intermediate result was alive at the same time.
+     */
+    [[nodiscard]] double peak_ratio() const noexcept {
+        return peak_live_bytes >= 0 && bytes_produced > 0
+            ? static_cast<double>(peak_live_bytes) / static_cast<double>(bytes_produced) : 0.0;
+    }
+};
+
+/**
+ * @brief Run the target of a graph repeatedly with one strategy.
+ *
+ * One profiled warm-up run measures the work per run and one unprofiled
+ * run the peak memory; the timed runs are unprofiled.
+ */
+inline Measurement measure(BenchGraph& bench, ExecutionStrategy strategy,
+                           const MeasureOptions& options = {}) {
+    using clock = std::chrono::steady_clock;
+    Executor executor(*bench.graph);
+    executor.set_min_parallel_layer_size(options.min_parallel_layer_size);
+    Measurement result;
+
+    Profiler profiler;
+    executor.set_profiler(&profiler);
+    (void)executor.compute_with_strategy(strategy, bench.target, bench.feeds);
+    executor.set_profiler(nullptr);
+    for (const auto& event : profiler.events()) {
+        result.bytes_processed += event.input_bytes;
+        result.bytes_produced += event.output_bytes;
+        ++result.operations_run;
+    }
+
+    // Nodes keep their values until the next run resets them; drop them
+    // first so the peak covers everything a run holds, including its result
+    for (auto& [id, node] : bench.graph->get_nodes()) {
+        if (node.type != NodeType::VARIABLE) node.computed_result.reset();
+    }
+    reset_peak_rss();
+    alloc_tracking::reset_peak();
+    const int64_t live_before = alloc_tracking::live_bytes();
+    (void)executor.compute_with_strategy(strategy, bench.target, bench.feeds);
+    if (alloc_tracking::installed()) {
+        result.peak_live_bytes = alloc_tracking::peak_live_bytes() - live_before;
+    }
+    result.peak_rss_bytes = peak_rss_bytes();
+
+    FlightRecorder flight_recorder({.threshold_ns = std::numeric_limits<uint64_t>::max()});
+    if (options.flight_recorder) {
+        executor.set_flight_recorder(&flight_recorder);
+    }
+    PerfSample counters_before;
+    if (options.hardware_counters) {
+        counters_before = PerfCounters::read_team();
+    }
+    auto before = team_alloc_counters();
+    auto deadline = clock::now() + std::chrono::duration<double>(options.min_seconds);
+    while (result.samples_ns.size() < options.max_iterations &&
+           (result.samples_ns.size() < options.min_iterations || clock::now() < deadline)) {
+        auto start = clock::now();
+        (void)executor.compute_with_strategy(strategy, bench.target, bench.feeds);
+        auto elapsed = clock::now() - start;
+        result.samples_ns.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+    auto after = team_alloc_counters();
+    if (options.hardware_counters) {
+        result.counters = PerfCounters::read_team() - counters_before;
+    }
+
+    double runs = static_cast<double>(result.samples_ns.size());
+    result.allocations_per_run = static_cast<double>(after.allocations - before.allocations) / runs;
+    result.allocated_bytes_per_run = static_cast<double>(after.allocated_bytes - before.allocated_bytes) / runs;
+    return result;
+}
+
+/**
+ * @brief How the worker threads spent the last run of a profiler.
+ */
+struct ThreadUtilization {
+    double busy_share = 0.0;          ///< Node time over run time x threads
+    double barrier_share = 0.0;       ///< Thread time of parallel layers outside nodes
+    double serial_share = 0.0;        ///< Share of the run in layers run serially
+};
+
+inline ThreadUtilization utilization(const Profiler& profiler) {
+    ThreadUtilization result;
+    if (profiler.runs().empty()) return result;
+    const RunEvent& run = profiler.runs().back();
+    const auto events = profiler.events();
+
+    // Node time started within [start, end); nodes never span a barrier
+    auto busy_between = [&](uint64_t start, uint64_t end) {
+        auto first = std::ranges::lower_bound(events, start, {}, &NodeEvent::start_ns);
+        uint64_t busy = 0;
+        for (auto it = first; it != events.end() && it->start_ns < end; ++it) {
+            busy += it->duration_ns();
+        }
+        return busy;
+    };
+
+    size_t threads = 1;
+    uint64_t parallel_capacity = 0, parallel_busy = 0, serial_ns = 0;
+    for (const auto& layer : profiler.layers()) {
+        if (layer.start_ns < run.start_ns) continue;
+        if (layer.threads > 1) {
+            threads = std::max(threads, layer.threads);
+            parallel_capacity += layer.duration_ns() * layer.threads;
+            parallel_busy += busy_between(layer.start_ns, layer.end_ns);
+        } else {
+            serial_ns += layer.duration_ns();
+        }
+    }
+
+    const double run_ns = static_cast<double>(std::max<uint64_t>(run.duration_ns(), 1));
+    result.busy_share = static_cast<double>(busy_between(run.start_ns, run.end_ns)) /
+                        (run_ns * static_cast<double>(threads));
+    if (parallel_capacity > 0) {
+        result.barrier_share = 1.0 - static_cast<double>(parallel_busy) / static_cast<double>(parallel_capacity);
+    }
+    result.serial_share = static_cast<double>(serial_ns) / run_ns;
+    return result;
+}
+
+/**
+ * @brief Number of threads the parallel strategy can use.
+ */
+inline int worker_threads() {
+#ifdef USE_OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+} // namespace strgraph::bench
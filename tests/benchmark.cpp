@@ -0,0 +1,265 @@
+/**
+ * @file benchmark.cpp
+ * @brief strgraph_benchmark: throughput and latency of every execution
+ *        strategy over generated workloads.
+ *
+ * Sweeps graph shapes (chain, fan-out, diamond lattice, random DAG,
+ * merged small graphs, generated layers), string sizes, operation mixes
+ * and strategies.
+ * Every case reports latency percentiles, throughput (bytes read by the
+ * operations per second), heap allocations and bytes produced per node,
+ * and the peak heap and RSS of a run, as a table and optionally as JSON.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include <fstream>
+#include <iostream>
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --shapes LIST        chain,fanout,lattice,random,merged,layered (default: all)\n"
+        "  --mixes LIST         case,copy,edit,mixed (default: mixed)\n"
+        "  --sizes LIST         String sizes with K/M/G suffixes (default: 8,256,4K,64K,1M,64M)\n"
+        "  --strategies LIST    recursive,iterative,parallel,auto (default: all)\n"
+        "  --nodes N            Operation nodes per graph (default: 256)\n"
+        "  --memory-budget N    Cap on nodes x size; fewer nodes for large strings (default: 512M)\n"
+        "  --min-time SECONDS   Minimum measuring time per case (default: 0.2)\n"
+        "  --min-iterations N   Minimum runs per case (default: 5)\n"
+        "  --seed N             Seed of the random shapes (default: 42)\n"
+        "  --json FILE          Also write the results as JSON ('-' for stdout)\n"
+        "  --perf               Also sample hardware counters (cycles, IPC, cache and branch misses)\n"
+        "  --flight-recorder    Time the runs with a flight recorder attached, to measure its overhead\n"
+        "  --quick              Small sweep: sizes 64,64K, 64 nodes, 0.05s per case\n",
+        program);
+}
+
+struct Options {
+    std::vector<Shape> shapes{ALL_SHAPES.begin(), ALL_SHAPES.end()};
+    std::vector<OpMix> mixes{OpMix::MIXED};
+    std::vector<size_t> sizes{8, 256, 4 << 10, 64 << 10, 1 << 20, 64 << 20};
+    std::vector<ExecutionStrategy> strategies{
+        ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+        ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO};
+    size_t nodes = 256;
+    size_t memory_budget = size_t{512} << 20;
+    uint64_t seed = 42;
+    MeasureOptions measure;
+    std::string json_path;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--shapes") {
+            options.shapes.clear();
+            for (const auto& name : split_list(value())) options.shapes.push_back(parse_shape(name));
+        } else if (arg == "--mixes") {
+            options.mixes.clear();
+            for (const auto& name : split_list(value())) options.mixes.push_back(parse_mix(name));
+        } else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : split_list(value())) options.sizes.push_back(parse_bytes(size));
+        } else if (arg == "--strategies") {
+            options.strategies.clear();
+            for (const auto& name : split_list(value())) options.strategies.push_back(parse_strategy(name));
+        } else if (arg == "--nodes") {
+            options.nodes = parse_bytes(value());
+        } else if (arg == "--memory-budget") {
+            options.memory_budget = parse_bytes(value());
+        } else if (arg == "--min-time") {
+            options.measure.min_seconds = std::stod(std::string(value()));
+        } else if (arg == "--min-iterations") {
+            options.measure.min_iterations = parse_bytes(value());
+        } else if (arg == "--seed") {
+            options.seed = parse_bytes(value());
+        } else if (arg == "--json") {
+            options.json_path = value();
+        } else if (arg == "--perf") {
+            options.measure.hardware_counters = true;
+        } else if (arg == "--flight-recorder") {
+            options.measure.flight_recorder = true;
+        } else if (arg == "--quick") {
+            options.sizes = {64, 64 << 10};
+            options.nodes = 64;
+            options.measure.min_seconds = 0.05;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    return options;
+}
+
+double to_ms(double ns) {
+    return ns / 1e6;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_benchmark: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    core_ops::register_all();
+    const bool track_allocations = alloc_tracking::installed();
+    // Keep stdout clean when the JSON report goes there
+    std::ostream& table = options.json_path == "-" ? std::cerr : std::cout;
+
+    // Counters the kernel refuses degrade the run to timing only
+    bool hardware_counters = options.measure.hardware_counters;
+    if (hardware_counters && !PerfCounters::supported()) {
+        table << std::format("Hardware counters unavailable ({}); timing only\n",
+                             PerfCounters::for_this_thread().unavailable_reason());
+        hardware_counters = options.measure.hardware_counters = false;
+    }
+
+    table << std::format("StrGraphCPP benchmark: {} worker threads, allocation tracking {}\n\n",
+                         worker_threads(), track_allocations ? "on" : "off");
+    table << std::format("{:<32} {:<10} {:>7} {:>10} {:>10} {:>10} {:>10} {:>11} {:>11} {:>11} {:>9} {:>10} {:>7} {:>10}",
+                         "case", "strategy", "runs", "p50 ms", "p90 ms", "p99 ms",
+                         "MB/s", "nodes/s", "allocs/run", "allocs/node", "B/node",
+                         "peak MB", "peak/B", "RSS MB");
+    if (hardware_counters) {
+        table << std::format(" {:>11} {:>6} {:>12} {:>12}", "Mcycles/run", "IPC", "cache-miss", "branch-miss");
+    }
+    table << "\n";
+
+    nlohmann::json results = nlohmann::json::array();
+    for (Shape shape : options.shapes) {
+        for (OpMix mix : options.mixes) {
+            for (size_t size : options.sizes) {
+                GraphSpec spec;
+                spec.shape = shape;
+                spec.mix = mix;
+                spec.value_size = size;
+                spec.nodes = options.nodes;
+                spec.memory_budget = options.memory_budget;
+                spec.seed = options.seed;
+                BenchGraph bench = build_graph(spec);
+
+                for (ExecutionStrategy strategy : options.strategies) {
+                    Measurement m = measure(bench, strategy, options.measure);
+                    LatencySummary latency = summarize(m.samples_ns);
+                    double seconds = static_cast<double>(latency.p50_ns) / 1e9;
+                    double mb_per_second = seconds > 0 ? static_cast<double>(m.bytes_processed) / (1024.0 * 1024.0) / seconds : 0.0;
+                    double nodes_per_second = seconds > 0 ? static_cast<double>(m.operations_run) / seconds : 0.0;
+
+                    auto megabytes = [](int64_t bytes) {
+                        return bytes >= 0 ? std::format("{:.2f}", static_cast<double>(bytes) / (1024.0 * 1024.0)) : "-";
+                    };
+                    table << std::format("{:<32} {:<10} {:>7} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.1f} {:>11.0f} {:>11} {:>11} {:>9.0f} {:>10} {:>7} {:>10}",
+                                         spec.name(), strategy_name(strategy), m.samples_ns.size(),
+                                         to_ms(static_cast<double>(latency.p50_ns)),
+                                         to_ms(static_cast<double>(latency.p90_ns)),
+                                         to_ms(static_cast<double>(latency.p99_ns)),
+                                         mb_per_second, nodes_per_second,
+                                         track_allocations ? std::format("{:.1f}", m.allocations_per_run) : "-",
+                                         track_allocations ? std::format("{:.2f}", m.allocations_per_node()) : "-",
+                                         m.bytes_produced_per_node(),
+                                         megabytes(m.peak_live_bytes),
+                                         track_allocations ? std::format("{:.2f}", m.peak_ratio()) : "-",
+                                         megabytes(m.peak_rss_bytes));
+                    // Counter columns are per run
+                    const double runs = static_cast<double>(m.samples_ns.size());
+                    auto per_run = [runs](int64_t count) {
+                        return count >= 0 ? static_cast<double>(count) / runs : -1.0;
+                    };
+                    if (hardware_counters) {
+                        table << std::format(" {:>11.3f} {:>6.2f} {:>12.0f} {:>12.0f}",
+                                             per_run(m.counters.cycles) / 1e6, m.counters.ipc(),
+                                             per_run(m.counters.cache_misses),
+                                             per_run(m.counters.branch_misses));
+                    }
+                    table << "\n";
+
+                    nlohmann::json entry = {
+                        {"case", spec.name()},
+                        {"shape", shape_name(shape)},
+                        {"mix", mix_name(mix)},
+                        {"value_size", size},
+                        {"nodes", bench.operation_nodes},
+                        {"strategy", strategy_name(strategy)},
+                        {"runs", m.samples_ns.size()},
+                        {"latency_ns", {
+                            {"min", latency.min_ns}, {"p50", latency.p50_ns}, {"p90", latency.p90_ns},
+                            {"p99", latency.p99_ns}, {"max", latency.max_ns}, {"mean", latency.mean_ns}
+                        }},
+                        {"bytes_processed", m.bytes_processed},
+                        {"bytes_produced", m.bytes_produced},
+                        {"bytes_produced_per_node", m.bytes_produced_per_node()},
+                        {"operations_run", m.operations_run},
+                        {"megabytes_per_second", mb_per_second},
+                        {"nodes_per_second", nodes_per_second}
+                    };
+                    if (track_allocations) {
+                        entry["allocations_per_run"] = m.allocations_per_run;
+                        entry["allocated_bytes_per_run"] = m.allocated_bytes_per_run;
+                        entry["allocations_per_node"] = m.allocations_per_node();
+                        entry["peak_live_bytes"] = m.peak_live_bytes;
+                        entry["peak_ratio"] = m.peak_ratio();
+                    }
+                    if (m.peak_rss_bytes >= 0) {
+                        entry["peak_rss_bytes"] = m.peak_rss_bytes;
+                    }
+                    if (hardware_counters) {
+                        entry["hardware_counters_per_run"] = {
+                            {"cycles", per_run(m.counters.cycles)},
+                            {"instructions", per_run(m.counters.instructions)},
+                            {"cache_misses", per_run(m.counters.cache_misses)},
+                            {"branch_misses", per_run(m.counters.branch_misses)},
+                            {"ipc", m.counters.ipc()}
+                        };
+                    }
+                    results.push_back(std::move(entry));
+                }
+            }
+        }
+    }
+
+    if (!options.json_path.empty()) {
+        nlohmann::json report = {
+            {"benchmark", "strgraph_benchmark"},
+            {"threads", worker_threads()},
+            {"allocation_tracking", track_allocations},
+            {"hardware_counters", hardware_counters},
+            {"flight_recorder", options.measure.flight_recorder},
+            {"results", std::move(results)}
+        };
+        if (options.json_path == "-") {
+            std::cout << report.dump(2) << "\n";
+        } else {
+            std::ofstream file(options.json_path);
+            file << report.dump(2) << "\n";
+            if (!file) {
+                std::cerr << std::format("strgraph_benchmark: cannot write '{}'\n", options.json_path);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,386 @@
+/**
+ * @file benchmark_analysis.cpp
+ * @brief strgraph_analysis: performance regression check against a baseline.
+ *
+ * Runs a fixed set of scenarios (every strategy on every graph shape, for
+ * short and long strings) several times. Each repetition yields one
+ * median latency; the repetitions give a median and a distribution-free
+ * confidence interval per scenario. Compared with a stored baseline, a
+ * scenario regresses when it is slower by more than a threshold and a
+ * one-sided Mann-Whitney U test finds the slowdown significant.
+ *
+ * Memory is checked the same way: every repetition also yields the heap
+ * allocations and the peak live heap of a run, and a scenario regresses
+ * when the median of either grows by more than the memory threshold.
+ * Both are counted rather than timed, so no test is needed.
+ *
+ * Exit status: 0 no regression, 1 regression found, 2 usage or I/O error.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --baseline FILE      Compare with a baseline written by --save\n"
+        "  --save FILE          Write the results as a new baseline\n"
+        "  --repetitions N      Repetitions per scenario (default: 10)\n"
+        "  --min-time SECONDS   Measuring time per repetition (default: 0.05)\n"
+        "  --threshold FRACTION Smallest slowdown reported (default: 0.05)\n"
+        "  --alpha P            Significance level of the test (default: 0.01)\n"
+        "  --memory-threshold FRACTION\n"
+        "                       Smallest growth of allocations or peak heap reported (default: 0.10)\n"
+        "  --filter TEXT        Only run scenarios whose name contains TEXT\n"
+        "  --list               Print the scenario names and exit\n",
+        program);
+}
+
+struct Options {
+    std::string baseline_path;
+    std::string save_path;
+    size_t repetitions = 10;
+    double min_seconds = 0.05;
+    double threshold = 0.05;
+    double alpha = 0.01;
+    double memory_threshold = 0.10;
+    std::string filter;
+    bool list = false;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--baseline") {
+            options.baseline_path = value();
+        } else if (arg == "--save") {
+            options.save_path = value();
+        } else if (arg == "--repetitions") {
+            options.repetitions = parse_bytes(value());
+        } else if (arg == "--min-time") {
+            options.min_seconds = std::stod(value());
+        } else if (arg == "--threshold") {
+            options.threshold = std::stod(value());
+        } else if (arg == "--alpha") {
+            options.alpha = std::stod(value());
+        } else if (arg == "--memory-threshold") {
+            options.memory_threshold = std::stod(value());
+        } else if (arg == "--filter") {
+            options.filter = value();
+        } else if (arg == "--list") {
+            options.list = true;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    if (options.repetitions < 3) {
+        throw std::runtime_error("--repetitions must be at least 3");
+    }
+    return options;
+}
+
+/**
+ * @brief One benchmark case of the fixed regression set.
+ */
+struct Scenario {
+    GraphSpec spec;
+    ExecutionStrategy strategy;
+
+    [[nodiscard]] std::string name() const {
+        return std::format("{}/{}", spec.name(), strategy_name(strategy));
+    }
+};
+
+/**
+ * @brief The fixed scenario set. Changing it invalidates stored baselines
+ *        only for the scenarios that change (they are matched by name).
+ */
+std::vector<Scenario> scenarios() {
+    std::vector<Scenario> result;
+    for (Shape shape : ALL_SHAPES) {
+        for (size_t size : {size_t{256}, size_t{64} << 10}) {
+            for (ExecutionStrategy strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                                               ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+                GraphSpec spec;
+                spec.shape = shape;
+                spec.mix = OpMix::MIXED;
+                spec.value_size = size;
+                spec.nodes = size <= 256 ? 512 : 64;
+                result.push_back({spec, strategy});
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Median of a sample (average of the middle pair for even sizes).
+ */
+double median(std::vector<double> values) {
+    std::ranges::sort(values);
+    size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+/**
+ * @brief Distribution-free confidence interval of the median.
+ *
+ * Uses the order statistics x(l) and x(n-1-l) with the largest l such
+ * that Binomial(n, 1/2) puts at least `confidence` mass on [l, n-1-l].
+ */
+std::pair<double, double> median_interval(std::vector<double> values, double confidence = 0.95) {
+    std::ranges::sort(values);
+    const size_t n = values.size();
+    // P(X = k) for X ~ Binomial(n, 1/2)
+    std::vector<double> pmf(n + 1);
+    for (size_t k = 0; k <= n; ++k) {
+        pmf[k] = std::exp(std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0)
+                          - static_cast<double>(n) * std::log(2.0));
+    }
+    size_t lower = 0;
+    double tail = pmf[0];   // P(X <= lower)
+    while (lower + 1 < n / 2 && 2.0 * (tail + pmf[lower + 1]) <= 1.0 - confidence) {
+        tail += pmf[++lower];
+    }
+    return {values[lower], values[n - 1 - lower]};
+}
+
+/**
+ * @brief One-sided Mann-Whitney U test that `current` tends to be larger
+ *        than `baseline`.
+ *
+ * @return p-value from the normal approximation with tie correction
+ */
+double mann_whitney_greater(const std::vector<double>& current, const std::vector<double>& baseline) {
+    const double n1 = static_cast<double>(current.size());
+    const double n2 = static_cast<double>(baseline.size());
+    if (current.empty() || baseline.empty()) {
+        return 1.0;
+    }
+
+    // Rank the pooled sample, averaging the ranks of ties
+    std::vector<std::pair<double, bool>> pooled;
+    for (double value : current) pooled.emplace_back(value, true);
+    for (double value : baseline) pooled.emplace_back(value, false);
+    std::ranges::sort(pooled);
+
+    double rank_sum = 0.0;
+    double tie_term = 0.0;
+    for (size_t i = 0; i < pooled.size();) {
+        size_t j = i;
+        while (j < pooled.size() && pooled[j].first == pooled[i].first) ++j;
+        double average_rank = (static_cast<double>(i + j) + 1.0) / 2.0;
+        double ties = static_cast<double>(j - i);
+        tie_term += ties * ties * ties - ties;
+        for (size_t k = i; k < j; ++k) {
+            if (pooled[k].second) rank_sum += average_rank;
+        }
+        i = j;
+    }
+
+    double u = rank_sum - n1 * (n1 + 1.0) / 2.0;
+    double mean = n1 * n2 / 2.0;
+    double n = n1 + n2;
+    double variance = n1 * n2 / 12.0 * ((n + 1.0) - tie_term / (n * (n - 1.0)));
+    if (variance <= 0.0) {
+        return u > mean ? 0.0 : 1.0;
+    }
+    double z = (u - mean - 0.5) / std::sqrt(variance);   // Continuity correction
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/**
+ * @brief Repetition medians and their summary for one scenario.
+ */
+struct ScenarioResult {
+    std::vector<double> samples_ns;
+    double median_ns = 0.0;
+    double ci_low_ns = 0.0;
+    double ci_high_ns = 0.0;
+    double allocations_per_run = 0.0;     ///< Median over the repetitions
+    double peak_live_bytes = 0.0;         ///< Median over the repetitions
+};
+
+ScenarioResult run_scenario(const Scenario& scenario, const Options& options) {
+    BenchGraph bench = build_graph(scenario.spec);
+    MeasureOptions measure_options;
+    measure_options.min_seconds = options.min_seconds;
+    measure_options.min_iterations = 3;
+
+    ScenarioResult result;
+    std::vector<double> allocations, peaks;
+    for (size_t i = 0; i < options.repetitions; ++i) {
+        Measurement m = measure(bench, scenario.strategy, measure_options);
+        result.samples_ns.push_back(static_cast<double>(summarize(m.samples_ns).p50_ns));
+        allocations.push_back(m.allocations_per_run);
+        peaks.push_back(static_cast<double>(m.peak_live_bytes));
+    }
+    result.median_ns = median(result.samples_ns);
+    result.allocations_per_run = median(allocations);
+    result.peak_live_bytes = median(peaks);
+    std::tie(result.ci_low_ns, result.ci_high_ns) = median_interval(result.samples_ns);
+    return result;
+}
+
+nlohmann::json load_baseline(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error(std::format("Cannot open baseline '{}'", path));
+    }
+    auto baseline = nlohmann::json::parse(file);
+    if (!baseline.contains("scenarios") || !baseline["scenarios"].is_object()) {
+        throw std::runtime_error(std::format("'{}' is not a strgraph_analysis baseline", path));
+    }
+    return baseline;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    nlohmann::json baseline;
+    try {
+        options = parse_options(argc, argv);
+        if (!options.baseline_path.empty()) {
+            baseline = load_baseline(options.baseline_path);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_analysis: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<Scenario> selected;
+    for (const auto& scenario : scenarios()) {
+        if (scenario.name().find(options.filter) != std::string::npos) {
+            selected.push_back(scenario);
+        }
+    }
+    if (options.list) {
+        for (const auto& scenario : selected) std::cout << scenario.name() << "\n";
+        return 0;
+    }
+
+    core_ops::register_all();
+    if (!baseline.is_null() && baseline.value("threads", 0) != worker_threads()) {
+        std::cerr << std::format("strgraph_analysis: warning: baseline used {} threads, this run uses {}\n",
+                                 baseline.value("threads", 0), worker_threads());
+    }
+
+    const bool track_memory = alloc_tracking::installed();
+    std::cout << std::format("{:<44} {:>12} {:>12} {:>25} {:>8} {:>9} {:>11} {:>10} {:>9}  {}\n",
+                             "scenario", "base ms", "median ms", "95% CI ms", "ratio", "p",
+                             "allocs/run", "peak KB", "mem ratio", "verdict");
+
+    nlohmann::json saved;
+    size_t regressions = 0;
+    for (const auto& scenario : selected) {
+        const std::string name = scenario.name();
+        ScenarioResult current = run_scenario(scenario, options);
+        saved[name] = {
+            {"median_ns", current.median_ns},
+            {"ci_low_ns", current.ci_low_ns},
+            {"ci_high_ns", current.ci_high_ns},
+            {"samples_ns", current.samples_ns}
+        };
+        if (track_memory) {
+            saved[name]["allocations_per_run"] = current.allocations_per_run;
+            saved[name]["peak_live_bytes"] = current.peak_live_bytes;
+        }
+
+        std::string base_ms = "-";
+        std::string ratio = "-";
+        std::string p_value = "-";
+        std::string memory_ratio = "-";
+        std::string verdict = "new";
+        if (!baseline.is_null() && baseline["scenarios"].contains(name)) {
+            const auto& base = baseline["scenarios"][name];
+            auto base_samples = base["samples_ns"].get<std::vector<double>>();
+            double base_median = base["median_ns"].get<double>();
+            double change = current.median_ns / base_median;
+            double p = mann_whitney_greater(current.samples_ns, base_samples);
+            double p_faster = mann_whitney_greater(base_samples, current.samples_ns);
+
+            base_ms = std::format("{:.4f}", base_median / 1e6);
+            ratio = std::format("{:.3f}", change);
+            p_value = std::format("{:.4f}", std::min(p, p_faster));
+            if (change > 1.0 + options.threshold && p < options.alpha) {
+                verdict = "REGRESSION";
+                ++regressions;
+            } else if (change < 1.0 - options.threshold && p_faster < options.alpha) {
+                verdict = "faster";
+            } else {
+                verdict = "ok";
+            }
+
+            // Baselines saved without allocation tracking have no memory fields
+            if (track_memory && base.contains("allocations_per_run") && base.contains("peak_live_bytes")) {
+                auto growth = [](double now, double before) {
+                    return before > 0.0 ? now / before : (now > 0.0 ? std::numeric_limits<double>::infinity() : 1.0);
+                };
+                double memory_change = std::max(
+                    growth(current.allocations_per_run, base["allocations_per_run"].get<double>()),
+                    growth(current.peak_live_bytes, base["peak_live_bytes"].get<double>()));
+                memory_ratio = std::format("{:.3f}", memory_change);
+                if (memory_change > 1.0 + options.memory_threshold) {
+                    if (verdict != "REGRESSION") ++regressions;
+                    verdict = verdict == "REGRESSION" ? "REGRESSION+MEMORY" : "MEMORY REGRESSION";
+                }
+            }
+        }
+
+        std::cout << std::format("{:<44} {:>12} {:>12.4f} {:>25} {:>8} {:>9} {:>11} {:>10} {:>9}  {}\n",
+                                 name, base_ms, current.median_ns / 1e6,
+                                 std::format("[{:.4f}, {:.4f}]", current.ci_low_ns / 1e6, current.ci_high_ns / 1e6),
+                                 ratio, p_value,
+                                 track_memory ? std::format("{:.1f}", current.allocations_per_run) : "-",
+                                 track_memory ? std::format("{:.1f}", current.peak_live_bytes / 1024.0) : "-",
+                                 memory_ratio, verdict);
+    }
+
+    if (!options.save_path.empty()) {
+        nlohmann::json report = {
+            {"tool", "strgraph_analysis"},
+            {"threads", worker_threads()},
+            {"repetitions", options.repetitions},
+            {"scenarios", std::move(saved)}
+        };
+        std::ofstream file(options.save_path);
+        file << report.dump(2) << "\n";
+        if (!file) {
+            std::cerr << std::format("strgraph_analysis: cannot write '{}'\n", options.save_path);
+            return 2;
+        }
+    }
+
+    if (regressions > 0) {
+        std::cout << std::format("\n{} scenario(s) regressed (slower by more than {:.0f}% at p < {}, "
+                                 "or allocations or peak heap up by more than {:.0f}%)\n",
+                                 regressions, options.threshold * 100.0, options.alpha,
+                                 options.memory_threshold * 100.0);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file compile_benchmark.cpp
+ * @brief strgraph_compile: loading and planning time against graph size.
+ *
+ * Generates graphs of increasing node counts and times the cold start of
+ * a graph: loading its JSON text with Graph::from_json_text() (against
+ * the single-threaded from_json() of the parsed document) and loading
+ * only the nodes reachable from a node 1% into the document (a service
+ * using a few targets of a shared graph file), and the planning every
+ * parallel or auto run starts with:
+ * Executor::topological_layers() from the target, and topological_sort()
+ * over the whole graph. Each is timed with one thread and with every
+ * thread count of --threads, and reported as latency, nanoseconds per
+ * node and speedup over one thread. Frontiers below
+ * Executor::MIN_PARALLEL_PLAN_NODES are always planned serially, so small
+ * graphs show no planning speedup by design.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --nodes LIST         Operation nodes per graph with K/M suffixes (default: 10K,100K,1M)\n"
+        "  --threads LIST       Thread counts besides 1 (default: all CPUs)\n"
+        "  --fan-in N           Maximum inputs per node (default: 3)\n"
+        "  --lookback N         Layers inputs are drawn from (default: 4)\n"
+        "  --repeats N          Timed runs per case, the median is reported (default: 5)\n"
+        "  --seed N             Seed of the graphs (default: 42)\n"
+        "  --json FILE          Also write the results as JSON ('-' for stdout)\n"
+        "  --quick              Small sweep: 4K and 32K nodes, 3 repeats\n",
+        program);
+}
+
+struct Options {
+    std::vector<size_t> nodes{10'000, 100'000, 1'000'000};
+    std::vector<size_t> threads;
+    size_t fan_in = 3;
+    size_t lookback = 4;
+    size_t repeats = 5;
+    uint64_t seed = 42;
+    std::string json_path;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--nodes") {
+            options.nodes.clear();
+            for (const auto& count : split_list(value())) options.nodes.push_back(parse_bytes(count));
+        } else if (arg == "--threads") {
+            options.threads.clear();
+            for (const auto& count : split_list(value())) options.threads.push_back(parse_bytes(count));
+        } else if (arg == "--fan-in") {
+            options.fan_in = parse_bytes(value());
+        } else if (arg == "--lookback") {
+            options.lookback = parse_bytes(value());
+        } else if (arg == "--repeats") {
+            options.repeats = std::max<size_t>(1, parse_bytes(value()));
+        } else if (arg == "--seed") {
+            options.seed = parse_bytes(value());
+        } else if (arg == "--json") {
+            options.json_path = value();
+        } else if (arg == "--quick") {
+            options.nodes = {4'000, 32'000};
+            options.repeats = 3;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    return options;
+}
+
+void set_threads([[maybe_unused]] size_t threads) {
+#ifdef USE_OPENMP
+    omp_set_num_threads(static_cast<int>(threads));
+#endif
+}
+
+/**
+ * @brief Median wall time of `repeats` calls of `plan`, in nanoseconds.
+ */
+template <typename Plan>
+double median_ns(size_t repeats, Plan&& plan) {
+    std::vector<double> samples;
+    for (size_t r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        plan();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+    std::ranges::sort(samples);
+    return samples[samples.size() / 2];
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_compile: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    core_ops::register_all();
+    std::ostream& table = options.json_path == "-" ? std::cerr : std::cout;
+
+    const size_t logical = std::max<size_t>(1, std::thread::hardware_concurrency());
+    if (options.threads.empty()) {
+        options.threads = {logical};
+    }
+#ifndef USE_OPENMP
+    table << "OpenMP not available: loading and planning run serially\n";
+    options.threads = {};
+#endif
+    std::erase(options.threads, 1);
+    options.threads.insert(options.threads.begin(), 1);
+
+    table << std::format("StrGraphCPP compile benchmark: {} logical CPUs, parallel planning from {} nodes\n\n",
+                         logical, Executor::MIN_PARALLEL_PLAN_NODES);
+    table << std::format("{:>9} {:>9} {:>7} {:<7} {:>7} {:>10} {:>8} {:>8}\n",
+                         "nodes", "edges", "levels", "phase", "threads", "p50 ms", "ns/node", "speedup");
+
+    nlohmann::json results = nlohmann::json::array();
+    for (size_t count : options.nodes) {
+        generator::Options spec;
+        spec.nodes = count;
+        spec.max_fan_in = options.fan_in;
+        spec.lookback = options.lookback;
+        spec.hub_ratio = 0.01;
+        spec.multi_output_ratio = 0.05;
+        spec.seed = options.seed;
+        std::ostringstream json_text;
+        generator::write_json(spec, json_text);
+        const std::string text = std::move(json_text).str();
+        auto graph = Graph::from_json_text(text);
+        Executor executor(*graph);
+        const std::string target(generator::Summary::TARGET);
+
+        size_t nodes = graph->get_nodes().size();
+        size_t edges = 0;
+        for (const auto& [id, node] : graph->get_nodes()) {
+            edges += node.input_ids.size();
+        }
+        const size_t levels = executor.topological_layers(target).size();
+        const std::vector<std::string> reach_targets{std::format("n{}", count / 100)};
+        const size_t reached = Graph::from_json_text(text, reach_targets)->get_nodes().size();
+
+        for (std::string_view phase : {"parse", "load", "reach", "layers", "sort"}) {
+            double single_ns = 0.0;
+            for (size_t threads : options.threads) {
+                if (phase == "parse" && threads != 1) {
+                    continue; // The tree parser is single-threaded
+                }
+                set_threads(threads);
+                const double ns = median_ns(options.repeats, [&] {
+                    if (phase == "parse") {
+                        (void)Graph::from_json(nlohmann::json::parse(text));
+                    } else if (phase == "load") {
+                        (void)Graph::from_json_text(text);
+                    } else if (phase == "reach") {
+                        (void)Graph::from_json_text(text, reach_targets);
+                    } else if (phase == "layers") {
+                        (void)executor.topological_layers(target);
+                    } else {
+                        (void)executor.topological_sort();
+                    }
+                });
+                if (threads == 1) {
+                    single_ns = ns;
+                }
+                const double per_node = ns / static_cast<double>(nodes);
+                const double speedup = ns > 0 ? single_ns / ns : 0.0;
+                table << std::format("{:>9} {:>9} {:>7} {:<7} {:>7} {:>10.3f} {:>8.1f} {:>8.2f}\n",
+                                     nodes, edges, levels, phase, threads, ns / 1e6, per_node, speedup);
+                results.push_back({
+                    {"nodes", phase == "reach" ? reached : nodes},
+                    {"edges", edges},
+                    {"levels", levels},
+                    {"phase", phase},
+                    {"threads", threads},
+                    {"p50_ns", ns},
+                    {"ns_per_node", per_node},
+                    {"speedup", speedup}
+                });
+            }
+        }
+        table << std::format("{:>9} nodes reached from '{}'\n", reached, reach_targets[0]);
+        set_threads(logical);
+    }
+
+    if (!options.json_path.empty()) {
+        nlohmann::json report = {
+            {"benchmark", "strgraph_compile"},
+            {"logical_cpus", logical},
+            {"min_parallel_plan_nodes", Executor::MIN_PARALLEL_PLAN_NODES},
+            {"results", std::move(results)}
+        };
+        if (options.json_path == "-") {
+            std::cout << report.dump(2) << "\n";
+        } else {
+            std::ofstream file(options.json_path);
+            file << report.dump(2) << "\n";
+            if (!file) {
+                std::cerr << std::format("strgraph_compile: cannot write '{}'\n", options.json_path);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,737 @@
+/**
+ * @file differential_test.cpp
+ * @brief strgraph_difftest: differential testing of the execution strategies.
+ *
+ * Generates random graphs over every core operation (with valid and
+ * edge-case constants), multi-output split nodes read through "id:index"
+ * inputs, CONSTANT and VARIABLE nodes, and placeholders fed random text.
+ * The targets of each graph are computed by compute() on one thread as
+ * the reference, then by every strategy, on every thread count, with the
+ * parallel layers on the thread team from the first node and at the
+ * default threshold, directly and through compute_to_sink(); each
+ * executor runs its targets twice, so state kept between runs (VARIABLE
+ * nodes, reused buffers) is covered as well. Every configuration also
+ * runs on a verified executor (Executor::verify()) whenever the graph
+ * verifies. Every value must match the reference byte for byte, and a
+ * target that fails must fail everywhere.
+ *
+ * A mismatch is shrunk to a minimal graph that still shows it (nodes
+ * collapsed into constants or bypassed, inputs dropped, values cut) and
+ * written as a JSON reproducer that --check re-runs.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include "strgraph/output_sink.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --graphs N           Random graphs to test (default: 200)\n"
+        "  --nodes N            Operation nodes per graph, at most (default: 60)\n"
+        "  --threads LIST       Thread counts of the parallel strategies (default: 1,2,4,8)\n"
+        "  --seed N             Seed of the first graph; graph i uses seed + i (default: 1)\n"
+        "  --repro-dir DIR      Where reproducers of mismatches are written (default: .)\n"
+        "  --check FILE         Re-run a reproducer instead of generating graphs\n"
+        "  --quick              50 graphs of at most 30 nodes, threads 1,4\n",
+        program);
+}
+
+struct Options {
+    size_t graphs = 200;
+    size_t nodes = 60;
+    std::vector<size_t> threads{1, 2, 4, 8};
+    uint64_t seed = 1;
+    std::string repro_dir = ".";
+    std::string check_path;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--graphs") {
+            options.graphs = parse_bytes(value());
+        } else if (arg == "--nodes") {
+            options.nodes = std::max<size_t>(parse_bytes(value()), 1);
+        } else if (arg == "--threads") {
+            options.threads.clear();
+            for (const auto& count : split_list(value())) {
+                options.threads.push_back(std::max<size_t>(parse_bytes(count), 1));
+            }
+        } else if (arg == "--seed") {
+            options.seed = parse_bytes(value());
+        } else if (arg == "--repro-dir") {
+            options.repro_dir = value();
+        } else if (arg == "--check") {
+            options.check_path = value();
+        } else if (arg == "--quick") {
+            options.graphs = 50;
+            options.nodes = 30;
+            options.threads = {1, 4};
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    return options;
+}
+
+void set_threads([[maybe_unused]] size_t threads) {
+#ifdef USE_OPENMP
+    omp_set_num_threads(static_cast<int>(threads));
+#endif
+}
+
+// ============================================================================
+// Test cases
+// ============================================================================
+
+/**
+ * @brief One node of a test case, in the terms of the JSON format.
+ */
+struct CaseNode {
+    std::string id{};
+    std::string type{};               ///< "placeholder", "constant", "variable" or "operation"
+    std::string op{};
+    std::vector<std::string> inputs{};
+    std::vector<std::string> constants{};
+    std::string value{};              ///< Of constants and variables
+};
+
+/**
+ * @brief A graph, its feeds and the targets to compare.
+ */
+struct TestCase {
+    std::vector<CaseNode> nodes;      ///< In topological order
+    std::map<std::string, std::string> feeds;
+    std::vector<std::string> targets;
+    uint64_t seed = 0;
+};
+
+nlohmann::json graph_json(const TestCase& test) {
+    nlohmann::json nodes = nlohmann::json::array();
+    for (const auto& node : test.nodes) {
+        nlohmann::json item = {{"id", node.id}, {"type", node.type}};
+        if (node.type == "operation") {
+            item["op"] = node.op;
+            item["inputs"] = node.inputs;
+            item["constants"] = node.constants;
+        } else if (node.type != "placeholder") {
+            item["value"] = node.value;
+        }
+        nodes.push_back(std::move(item));
+    }
+    return {{"name", std::format("difftest-{}", test.seed)}, {"nodes", std::move(nodes)}};
+}
+
+TestCase case_from_json(const nlohmann::json& json) {
+    TestCase test;
+    test.seed = json.value("seed", uint64_t{0});
+    for (const auto& item : json.at("nodes")) {
+        CaseNode& node = test.nodes.emplace_back();
+        node.id = item.at("id").get<std::string>();
+        node.type = item.value("type", item.contains("op") ? "operation" : "constant");
+        node.op = item.value("op", "");
+        node.inputs = item.value("inputs", std::vector<std::string>{});
+        node.constants = item.value("constants", std::vector<std::string>{});
+        node.value = item.value("value", "");
+    }
+    test.feeds = json.value("feeds", std::map<std::string, std::string>{});
+    if (json.contains("targets")) {
+        test.targets = json.at("targets").get<std::vector<std::string>>();
+    } else {
+        test.targets = {json.at("target_node").get<std::string>()};
+    }
+    return test;
+}
+
+/**
+ * @brief Node id of an input reference ("id" or "id:index").
+ */
+std::string_view ref_node(std::string_view ref) {
+    size_t colon = ref.rfind(':');
+    return colon == std::string_view::npos ? ref : ref.substr(0, colon);
+}
+
+CaseNode* find_node(TestCase& test, std::string_view id) {
+    auto it = std::ranges::find(test.nodes, id, &CaseNode::id);
+    return it == test.nodes.end() ? nullptr : &*it;
+}
+
+/**
+ * @brief Drop the nodes none of the targets reaches.
+ */
+void prune(TestCase& test) {
+    std::set<std::string, std::less<>> reached;
+    for (const auto& target : test.targets) {
+        reached.emplace(ref_node(target));
+    }
+    for (auto it = test.nodes.rbegin(); it != test.nodes.rend(); ++it) {
+        if (reached.contains(it->id)) {
+            for (const auto& input : it->inputs) {
+                reached.emplace(ref_node(input));
+            }
+        }
+    }
+    std::erase_if(test.nodes, [&](const CaseNode& node) { return !reached.contains(node.id); });
+    std::erase_if(test.feeds, [&](const auto& feed) { return !reached.contains(feed.first); });
+}
+
+// ============================================================================
+// Random graphs
+// ============================================================================
+
+constexpr size_t MAX_VALUE_SIZE = 512;    ///< Larger values are cut by a substring node
+constexpr size_t SPLIT_INDEXES = 2;       ///< Inputs read split outputs 0..SPLIT_INDEXES-1
+
+class CaseGenerator {
+public:
+    explicit CaseGenerator(uint64_t seed) : rng_(seed) {}
+
+    TestCase generate(size_t max_nodes, uint64_t seed) {
+        TestCase test;
+        test.seed = seed;
+        refs_.clear();
+
+        for (size_t i = 0, n = 1 + pick(3); i < n; ++i) {
+            std::string id = std::format("p{}", i);
+            std::string value = random_text(pick(4) == 0 ? 0 : pick(48));
+            test.nodes.push_back({.id = id, .type = "placeholder"});
+            refs_.push_back({id, value.size()});
+            test.feeds[id] = std::move(value);
+        }
+        for (const char* type : {"constant", "variable"}) {
+            for (size_t i = 0, n = pick(3); i < n; ++i) {
+                std::string id = std::format("{}{}", type[0], i);
+                std::string value = random_text(pick(32));
+                refs_.push_back({id, value.size()});
+                test.nodes.push_back({.id = id, .type = type, .value = std::move(value)});
+            }
+        }
+
+        const size_t operations = max_nodes / 2 + pick(max_nodes / 2 + 1);
+        for (size_t i = 0; i < operations; ++i) {
+            add_operation(test, std::format("n{}", i));
+        }
+
+        // The last node reaches deep; the others can be anywhere, split outputs included
+        test.targets.push_back(test.nodes.back().id);
+        for (size_t i = 0; i < 3; ++i) {
+            const Ref& ref = refs_[refs_.size() - 1 - pick(std::min<size_t>(refs_.size(), 16))];
+            if (std::ranges::find(test.targets, ref.id) == test.targets.end()) {
+                test.targets.push_back(ref.id);
+            }
+        }
+        return test;
+    }
+
+private:
+    struct Ref {
+        std::string id;               ///< Input reference, possibly "id:index"
+        size_t max_size;              ///< Upper bound of its value's size
+    };
+
+    size_t pick(size_t n) {
+        return n == 0 ? 0 : std::uniform_int_distribution<size_t>(0, n - 1)(rng_);
+    }
+
+    template <typename T, size_t N>
+    const T& choose(const std::array<T, N>& items) {
+        return items[pick(N)];
+    }
+
+    std::string random_text(size_t size) {
+        static constexpr std::string_view ALPHABET = "abcdeABCDE    ,,--xy\t.";
+        std::string text(size, ' ');
+        for (char& c : text) {
+            c = ALPHABET[pick(ALPHABET.size())];
+        }
+        return text;
+    }
+
+    /**
+     * @brief An input, mostly from the last few nodes so graphs get deep.
+     */
+    const Ref& pick_input() {
+        size_t window = pick(4) == 0 ? refs_.size() : std::min<size_t>(refs_.size(), 8);
+        return refs_[refs_.size() - 1 - pick(window)];
+    }
+
+    void add_operation(TestCase& test, const std::string& id) {
+        static constexpr std::array<std::string_view, 15> OPS = {
+            "identity", "concat", "reverse", "to_upper", "to_lower", "split", "trim", "replace",
+            "substring", "repeat", "pad_left", "pad_right", "capitalize", "title", "concat"};
+        CaseNode node{.id = id, .type = "operation", .op = std::string(choose(OPS))};
+
+        const Ref& first = pick_input();
+        node.inputs.push_back(first.id);
+        size_t size = first.max_size;
+        if (node.op == "concat") {
+            for (size_t i = 0, n = pick(4); i < n; ++i) {
+                const Ref& input = pick_input();
+                node.inputs.push_back(input.id);
+                size += input.max_size;
+            }
+            if (pick(3) == 0) {
+                node.constants.push_back(random_text(1 + pick(4)));
+                size += node.constants.back().size();
+            }
+        } else if (node.op == "split") {
+            node.constants.push_back(std::string(choose(std::array<std::string_view, 5>{" ", ",", "a", "--", ""})));
+        } else if (node.op == "replace") {
+            node.constants.push_back(std::string(choose(std::array<std::string_view, 4>{"a", " ", "ab", "x"})));
+            node.constants.push_back(std::string(choose(std::array<std::string_view, 4>{"", "b", "xyz", "  "})));
+            size *= std::max<size_t>(node.constants[1].size(), 1);
+        } else if (node.op == "substring") {
+            node.constants.push_back(std::to_string(pick(10)));
+            node.constants.push_back(pick(3) == 0 ? choose(std::array<std::string, 2>{"", "-1"})
+                                                  : std::to_string(pick(24)));
+        } else if (node.op == "repeat") {
+            size_t count = pick(4);
+            node.constants.push_back(std::to_string(count));
+            size *= count;
+        } else if (node.op == "pad_left" || node.op == "pad_right") {
+            size_t width = pick(40);
+            node.constants.push_back(std::to_string(width));
+            node.constants.push_back(std::string(choose(std::array<std::string_view, 3>{"", "*", " "})));
+            size = std::max(size, width);
+        }
+        test.nodes.push_back(node);
+
+        if (node.op == "split") {
+            // Output 0 always exists; later ones only if the delimiter occurs,
+            // and a failing input fails everything above it
+            refs_.push_back({id + ":0", size});
+            if (pick(4) == 0) {
+                refs_.push_back({std::format("{}:{}", id, 1 + pick(2)), size});
+            }
+            return;
+        }
+        if (size > MAX_VALUE_SIZE) {
+            // Keep values bounded however deep the graph gets
+            test.nodes.push_back({.id = id + "_cut", .type = "operation", .op = "substring",
+                                  .inputs = {id}, .constants = {"0", std::to_string(MAX_VALUE_SIZE)}});
+            refs_.push_back({id + "_cut", MAX_VALUE_SIZE});
+        } else {
+            refs_.push_back({id, size});
+        }
+    }
+
+    std::mt19937_64 rng_;
+    std::vector<Ref> refs_;
+};
+
+// ============================================================================
+// Execution
+// ============================================================================
+
+/**
+ * @brief One way of executing a graph.
+ */
+struct Config {
+    ExecutionStrategy strategy = ExecutionStrategy::RECURSIVE;
+    size_t threads = 1;
+    size_t threshold = Executor::MIN_PARALLEL_LAYER_SIZE;
+    bool sink = false;                ///< Through compute_to_sink()
+    bool verified = false;            ///< Executor::verify() first (if the graph passes)
+
+    std::string name() const {
+        std::string name(strategy_name(strategy));
+        if (strategy == ExecutionStrategy::PARALLEL || strategy == ExecutionStrategy::AUTO) {
+            name += std::format(" threads={} threshold={}", threads, threshold);
+        }
+        if (sink) {
+            name += " sink";
+        }
+        return verified ? name + " verified" : name;
+    }
+};
+
+std::vector<Config> all_configs(const std::vector<size_t>& thread_counts) {
+    std::vector<Config> configs;
+    for (bool verified : {false, true}) {
+        for (bool sink : {false, true}) {
+            for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                                  ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+                if (strategy != ExecutionStrategy::PARALLEL && strategy != ExecutionStrategy::AUTO) {
+                    configs.push_back({strategy, 1, Executor::MIN_PARALLEL_LAYER_SIZE, sink, verified});
+                    continue;
+                }
+                for (size_t threads : thread_counts) {
+                    for (size_t threshold : {size_t{1}, Executor::MIN_PARALLEL_LAYER_SIZE}) {
+                        configs.push_back({strategy, threads, threshold, sink, verified});
+                    }
+                }
+            }
+        }
+    }
+    return configs;
+}
+
+/**
+ * @brief Value of a target, or the error it failed with.
+ */
+struct Outcome {
+    bool ok = false;
+    std::string value;
+
+    /**
+     * @brief Errors match any error: messages may name different nodes
+     *        depending on the order nodes are visited in.
+     */
+    bool operator==(const Outcome& other) const {
+        return ok == other.ok && (!ok || value == other.value);
+    }
+};
+
+constexpr size_t RUNS_PER_EXECUTOR = 2;
+
+/**
+ * @brief Outcomes of every target in every run: runs x targets.
+ */
+std::vector<Outcome> execute(const TestCase& test, const Config& config) {
+    set_threads(config.threads);
+    auto graph = Graph::from_json(graph_json(test));
+    Executor executor(*graph);
+    executor.set_min_parallel_layer_size(config.threshold);
+    if (config.verified) {
+        try {
+            executor.verify();
+        } catch (const std::exception&) {
+            // Graphs that do not verify run checked, as CompiledGraph runs them
+        }
+    }
+    FeedDict feeds(test.feeds.begin(), test.feeds.end());
+
+    std::vector<Outcome> outcomes;
+    for (size_t run = 0; run < RUNS_PER_EXECUTOR; ++run) {
+        for (const auto& target : test.targets) {
+            Outcome& outcome = outcomes.emplace_back();
+            try {
+                if (config.sink) {
+                    std::ostringstream stream;
+                    StreamSink sink(stream);
+                    executor.compute_to_sink(config.strategy, target, sink, feeds);
+                    outcome.value = std::move(stream).str();
+                } else {
+                    outcome.value = executor.compute_with_strategy(config.strategy, target, feeds);
+                }
+                outcome.ok = true;
+            } catch (const std::exception& e) {
+                outcome.value = e.what();
+            }
+        }
+    }
+    return outcomes;
+}
+
+/**
+ * @brief The first target whose outcomes differ, if any.
+ */
+std::optional<size_t> first_mismatch(const std::vector<Outcome>& reference, const std::vector<Outcome>& actual) {
+    for (size_t i = 0; i < reference.size(); ++i) {
+        // Every run is compared with the reference's first run
+        const size_t first_run = i % (reference.size() / RUNS_PER_EXECUTOR);
+        if (!(actual[i] == reference[first_run])) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+const Config REFERENCE{};
+
+bool shows_mismatch(const TestCase& test, const Config& config) {
+    return first_mismatch(execute(test, REFERENCE), execute(test, config)).has_value();
+}
+
+// ============================================================================
+// Shrinking
+// ============================================================================
+
+constexpr size_t MAX_SHRINK_ATTEMPTS = 5000;
+
+/**
+ * @brief Values of the single-output nodes after a reference run.
+ */
+std::map<std::string, std::string> node_values(const TestCase& test) {
+    set_threads(1);
+    auto graph = Graph::from_json(graph_json(test));
+    Executor executor(*graph);
+    FeedDict feeds(test.feeds.begin(), test.feeds.end());
+    for (const auto& target : test.targets) {
+        try {
+            (void)executor.compute(target, feeds);
+        } catch (const std::exception&) {
+            // Nodes computed before the failure still have values
+        }
+    }
+    std::map<std::string, std::string> values;
+    for (const auto& [id, node] : graph->get_nodes()) {
+        if (node.computed_result.has_value()) {
+            if (const auto* value = std::get_if<std::string>(&*node.computed_result)) {
+                values.emplace(id, *value);
+            }
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Greedily simplify a test case while `config` still disagrees
+ *        with the reference on it.
+ */
+TestCase shrink(TestCase test, const Config& config) {
+    size_t attempts = 0;
+    auto try_candidate = [&](TestCase candidate) {
+        if (attempts >= MAX_SHRINK_ATTEMPTS) return false;
+        ++attempts;
+        prune(candidate);
+        if (!shows_mismatch(candidate, config)) return false;
+        test = std::move(candidate);
+        return true;
+    };
+
+    // One target is enough
+    for (size_t i = 0; i < test.targets.size() && test.targets.size() > 1; ++i) {
+        TestCase candidate = test;
+        candidate.targets = {test.targets[i]};
+        if (try_candidate(std::move(candidate))) break;
+    }
+
+    bool progress = true;
+    while (progress && attempts < MAX_SHRINK_ATTEMPTS) {
+        progress = false;
+        auto values = node_values(test);
+
+        // Candidates drop nodes, so nodes are looked up by id in the current case
+        std::vector<std::string> ids;
+        for (const auto& node : test.nodes) ids.push_back(node.id);
+        for (auto id = ids.rbegin(); id != ids.rend(); ++id) {
+            const CaseNode* current = find_node(test, *id);
+            if (current == nullptr || current->type != "operation") continue;
+            const CaseNode node = *current;
+
+            // Replace the node and everything below it by its value
+            if (auto it = values.find(node.id); it != values.end()) {
+                TestCase candidate = test;
+                *find_node(candidate, node.id) = {.id = node.id, .type = "constant", .value = it->second};
+                if (try_candidate(std::move(candidate))) {
+                    progress = true;
+                    continue;
+                }
+            }
+            // Read its first input instead
+            if (!node.inputs.empty()) {
+                TestCase candidate = test;
+                for (auto& other : candidate.nodes) {
+                    for (auto& input : other.inputs) {
+                        if (ref_node(input) == node.id) input = node.inputs.front();
+                    }
+                }
+                for (auto& target : candidate.targets) {
+                    if (ref_node(target) == node.id) target = node.inputs.front();
+                }
+                if (try_candidate(std::move(candidate))) {
+                    progress = true;
+                    continue;
+                }
+            }
+            if (node.op != "concat") continue;
+            // Drop inputs and constants of concat
+            for (size_t k = node.inputs.size(); k-- > 1;) {
+                TestCase candidate = test;
+                CaseNode* concat = find_node(candidate, node.id);
+                if (concat == nullptr || k >= concat->inputs.size()) break;
+                concat->inputs.erase(concat->inputs.begin() + static_cast<std::ptrdiff_t>(k));
+                progress |= try_candidate(std::move(candidate));
+            }
+            if (!node.constants.empty()) {
+                TestCase candidate = test;
+                if (CaseNode* concat = find_node(candidate, node.id)) {
+                    concat->constants.clear();
+                    progress |= try_candidate(std::move(candidate));
+                }
+            }
+        }
+
+        // Shorter feeds and values
+        auto shorten = [&](auto&& access) {
+            TestCase candidate = test;
+            std::string* text = access(candidate);
+            if (text == nullptr || text->empty()) return;
+            text->resize(text->size() / 2);
+            progress |= try_candidate(std::move(candidate));
+        };
+        for (const auto& [id, value] : TestCase(test).feeds) {
+            shorten([&](TestCase& c) { return c.feeds.contains(id) ? &c.feeds[id] : nullptr; });
+        }
+        for (const auto& id : ids) {
+            shorten([&](TestCase& c) -> std::string* {
+                CaseNode* node = find_node(c, id);
+                return node != nullptr && (node->type == "constant" || node->type == "variable")
+                    ? &node->value : nullptr;
+            });
+        }
+    }
+    return test;
+}
+
+/**
+ * @brief The value as a JSON string, or {"error": message}.
+ */
+nlohmann::json outcome_json(const Outcome& outcome) {
+    if (!outcome.ok) {
+        return {{"error", outcome.value}};
+    }
+    return outcome.value;
+}
+
+std::string describe(const Outcome& outcome) {
+    return outcome_json(outcome).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+/**
+ * @brief Shrink a mismatch, write its reproducer and print it.
+ */
+void report(const TestCase& test, const Config& config, const std::string& repro_dir) {
+    TestCase minimal = shrink(test, config);
+    auto reference = execute(minimal, REFERENCE);
+    auto actual = execute(minimal, config);
+    size_t index = first_mismatch(reference, actual).value_or(0);
+    const size_t targets = minimal.targets.size();
+
+    nlohmann::json repro = graph_json(minimal);
+    repro["seed"] = minimal.seed;
+    repro["target_node"] = minimal.targets[index % targets];
+    repro["targets"] = minimal.targets;
+    repro["feeds"] = minimal.feeds;
+    repro["config"] = config.name();
+    repro["run"] = index / targets + 1;
+    repro["expected"] = outcome_json(reference[index % targets]);
+    repro["actual"] = outcome_json(actual[index]);
+
+    std::string file_name = std::format("difftest-{}-{}.json", minimal.seed, config.name());
+    std::ranges::replace(file_name, ' ', '_');
+    std::ranges::replace(file_name, '=', '-');
+    std::filesystem::path path = std::filesystem::path(repro_dir) / file_name;
+    std::ofstream file(path);
+    file << repro.dump(2, ' ', false, nlohmann::json::error_handler_t::replace) << "\n";
+
+    std::cout << std::format(
+        "MISMATCH seed={} config='{}' target={} run={}\n"
+        "  expected {}\n"
+        "  actual   {}\n"
+        "  shrunk from {} to {} nodes: {}\n",
+        minimal.seed, config.name(), minimal.targets[index % targets], index / targets + 1,
+        describe(reference[index % targets]), describe(actual[index]),
+        test.nodes.size(), minimal.nodes.size(), file ? path.string() : "(could not be written)");
+}
+
+/**
+ * @brief Run a test case in every configuration.
+ *
+ * @return Configurations that disagree with the reference
+ */
+std::vector<Config> failing_configs(const TestCase& test, const std::vector<Config>& configs) {
+    auto reference = execute(test, REFERENCE);
+    std::vector<Config> failing;
+    for (const auto& config : configs) {
+        if (first_mismatch(reference, execute(test, config))) {
+            failing.push_back(config);
+        }
+    }
+    return failing;
+}
+
+int run(const Options& options) {
+    const auto configs = all_configs(options.threads);
+
+    if (!options.check_path.empty()) {
+        std::ifstream file(options.check_path);
+        if (!file) {
+            throw std::runtime_error(std::format("Cannot open '{}'", options.check_path));
+        }
+        TestCase test = case_from_json(nlohmann::json::parse(file));
+        auto failing = failing_configs(test, configs);
+        for (const auto& config : failing) {
+            std::cout << std::format("MISMATCH config='{}'\n", config.name());
+        }
+        std::cout << std::format("{}: {} of {} configurations disagree with the reference\n",
+                                 options.check_path, failing.size(), configs.size());
+        return failing.empty() ? 0 : 1;
+    }
+
+    size_t mismatches = 0, targets = 0, failing_targets = 0, verified = 0;
+    for (size_t i = 0; i < options.graphs; ++i) {
+        const uint64_t seed = options.seed + i;
+        TestCase test = CaseGenerator(seed).generate(options.nodes, seed);
+        try {
+            auto graph = Graph::from_json(graph_json(test));
+            Executor(*graph).verify();
+            ++verified;
+        } catch (const std::exception&) {
+        }
+        for (const auto& outcome : execute(test, REFERENCE)) {
+            ++targets;
+            failing_targets += !outcome.ok;
+        }
+        auto failing = failing_configs(test, configs);
+        if (!failing.empty()) {
+            ++mismatches;
+            // One reproducer per graph; the configurations often share the bug
+            report(test, failing.front(), options.repro_dir);
+            if (failing.size() > 1) {
+                std::cout << std::format("  also disagreeing: {} more configurations\n", failing.size() - 1);
+            }
+        }
+    }
+    std::cout << std::format(
+        "strgraph_difftest: {} graphs ({} verified) x {} configurations, {} target runs "
+        "({} failing consistently), {} graphs with mismatches\n",
+        options.graphs, verified, configs.size(), targets, failing_targets, mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+        core_ops::register_all();
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_difftest: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+    try {
+        return run(options);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_difftest: " << e.what() << "\n";
+        return 2;
+    }
+}
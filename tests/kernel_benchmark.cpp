@@ -0,0 +1,479 @@
+/**
+ * @file kernel_benchmark.cpp
+ * @brief strgraph_kernels: GB/s, ns per call and cycles per byte of every
+ *        core operation, without the graph engine.
+ *
+ * Runs the matrix op x input size x character distribution x call path
+ * on one pinned thread. The call paths are the kernel itself, the
+ * std::function an executor holds, and a fresh OperationRegistry lookup
+ * per call, so the differences are the cost of the wrappers. The same
+ * source is built as strgraph_kernels_native with -march=native; running
+ * both compares the baseline ISA against the host's.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include "strgraph/operation_registry.h"
+#include "strgraph/perf_counters.h"
+#include <fstream>
+#include <iostream>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STRGRAPH_HAVE_TSC 1
+#endif
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+/**
+ * @brief Character distribution of the benchmark inputs.
+ */
+enum class Distribution {
+    ASCII,      ///< Lowercase words separated by spaces, no ','
+    UTF8,       ///< Mostly 2-4 byte UTF-8 sequences
+    SPARSE,     ///< ASCII words with a ',' about every 1024 bytes
+    DENSE       ///< ASCII words with a ',' about every 16 bytes
+};
+
+constexpr std::array<Distribution, 4> ALL_DISTRIBUTIONS = {
+    Distribution::ASCII, Distribution::UTF8, Distribution::SPARSE, Distribution::DENSE};
+
+std::string_view distribution_name(Distribution distribution) {
+    switch (distribution) {
+        case Distribution::ASCII: return "ascii";
+        case Distribution::UTF8: return "utf8";
+        case Distribution::SPARSE: return "sparse";
+        case Distribution::DENSE: return "dense";
+    }
+    return "unknown";
+}
+
+Distribution parse_distribution(std::string_view name) {
+    for (Distribution distribution : ALL_DISTRIBUTIONS) {
+        if (distribution_name(distribution) == name) return distribution;
+    }
+    throw std::runtime_error(std::format("Unknown distribution '{}'", name));
+}
+
+/**
+ * @brief How a kernel is called.
+ */
+enum class CallPath {
+    DIRECT,     ///< Function pointer from core_ops::kernels()
+    FUNCTION,   ///< StringOperation fetched once, as executors hold it
+    REGISTRY    ///< OperationRegistry::get_op() on every call
+};
+
+constexpr std::array<CallPath, 3> ALL_PATHS = {CallPath::DIRECT, CallPath::FUNCTION, CallPath::REGISTRY};
+
+std::string_view path_name(CallPath path) {
+    switch (path) {
+        case CallPath::DIRECT: return "direct";
+        case CallPath::FUNCTION: return "function";
+        case CallPath::REGISTRY: return "registry";
+    }
+    return "unknown";
+}
+
+CallPath parse_path(std::string_view name) {
+    for (CallPath path : ALL_PATHS) {
+        if (path_name(path) == name) return path;
+    }
+    throw std::runtime_error(std::format("Unknown call path '{}'", name));
+}
+
+/**
+ * @brief Widest instruction set the binary was compiled for.
+ */
+std::string_view compiled_isa() {
+#if defined(__AVX512BW__)
+    return "avx512bw";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE4_2__)
+    return "sse4.2";
+#elif defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "generic";
+#endif
+}
+
+/**
+ * @brief Deterministic input of exactly `size` bytes.
+ */
+std::string make_input(Distribution distribution, size_t size, uint64_t seed) {
+    static constexpr std::string_view WIDE_CHARS[] = {"\xC3\xA9", "\xD0\xB6", "\xE4\xB8\xAD", "\xE2\x82\xAC", "\xF0\x9F\x98\x80"};
+    std::mt19937_64 rng(seed);
+    std::string value;
+    value.reserve(size);
+    while (value.size() < size) {
+        uint64_t r = rng();
+        switch (distribution) {
+            case Distribution::UTF8:
+                if (r % 4 != 0) {
+                    std::string_view wide = WIDE_CHARS[(r >> 8) % std::size(WIDE_CHARS)];
+                    if (value.size() + wide.size() <= size) {
+                        value.append(wide);
+                        continue;
+                    }
+                }
+                break;
+            case Distribution::SPARSE:
+                if (r % 1024 == 0) {
+                    value += ',';
+                    continue;
+                }
+                break;
+            case Distribution::DENSE:
+                if (r % 16 == 0) {
+                    value += ',';
+                    continue;
+                }
+                break;
+            case Distribution::ASCII:
+                break;
+        }
+        value += (r >> 16) % 7 == 0 ? ' ' : static_cast<char>('a' + (r >> 24) % 26);
+    }
+    return value;
+}
+
+/**
+ * @brief Arguments of one op for an input of `size` bytes.
+ */
+struct OpArguments {
+    std::vector<std::string_view> inputs;
+    std::vector<std::string> constant_storage;
+    std::vector<std::string_view> constants;
+};
+
+OpArguments arguments_for(std::string_view op, const std::string& input) {
+    OpArguments args;
+    args.inputs = {input};
+    if (op == "concat") {
+        args.inputs = {input, input};
+    } else if (op == "split") {
+        args.constant_storage = {","};
+    } else if (op == "replace") {
+        args.constant_storage = {",", ";"};
+    } else if (op == "substring") {
+        args.constant_storage = {"1", "-1"};
+    } else if (op == "repeat") {
+        args.constant_storage = {"2"};
+    } else if (op == "pad_left" || op == "pad_right") {
+        args.constant_storage = {std::to_string(input.size() + 16), "*"};
+    }
+    for (const auto& constant : args.constant_storage) {
+        args.constants.push_back(constant);
+    }
+    return args;
+}
+
+size_t result_size(const OpResult& result) {
+    if (const auto* single = std::get_if<std::string>(&result)) {
+        return single->size();
+    }
+    return std::get<std::vector<std::string>>(result).size();
+}
+
+/**
+ * @brief Cycle source for cycles per byte: hardware counters when the
+ *        kernel allows them, the time-stamp counter otherwise.
+ */
+class CycleCounter {
+public:
+    CycleCounter() : perf_(PerfCounters::supported()) {}
+
+    [[nodiscard]] std::string_view source() const {
+        if (perf_) return "perf";
+#ifdef STRGRAPH_HAVE_TSC
+        return "tsc";
+#else
+        return "none";
+#endif
+    }
+
+    [[nodiscard]] int64_t now() const {
+        if (perf_) return PerfCounters::for_this_thread().read().cycles;
+#ifdef STRGRAPH_HAVE_TSC
+        return static_cast<int64_t>(__rdtsc());
+#else
+        return -1;
+#endif
+    }
+
+private:
+    bool perf_;
+};
+
+struct Options {
+    std::vector<std::string> ops;
+    std::vector<Distribution> distributions{ALL_DISTRIBUTIONS.begin(), ALL_DISTRIBUTIONS.end()};
+    std::vector<size_t> sizes{8, 64, 512, 4 << 10, 32 << 10, 256 << 10, 2 << 20, 16 << 20, 64 << 20};
+    std::vector<CallPath> paths{ALL_PATHS.begin(), ALL_PATHS.end()};
+    double min_seconds = 0.02;
+    size_t min_batches = 5;
+    size_t warmup = 3;
+    int cpu = -1;
+    uint64_t seed = 42;
+    std::string json_path;
+};
+
+/**
+ * @brief Timing of one case.
+ */
+struct KernelResult {
+    double ns_per_call = 0.0;         ///< Median over the batches
+    double gb_per_second = 0.0;       ///< Input bytes per second
+    double cycles_per_byte = -1.0;
+    size_t calls = 0;
+};
+
+/**
+ * @brief Call `call` in batches long enough to time until min_seconds
+ *        have passed; the caches are warm from the warm-up calls.
+ */
+template <typename Call>
+KernelResult run_case(Call&& call, size_t input_bytes, const Options& options, const CycleCounter& cycles) {
+    using clock = std::chrono::steady_clock;
+    volatile size_t sink = 0;
+    auto elapsed_ns = [](clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+    };
+
+    for (size_t i = 0; i < options.warmup; ++i) {
+        sink = sink + call();
+    }
+    // Batches of at least 20 us keep the clock overhead out of small cases
+    size_t batch = 1;
+    for (;;) {
+        auto start = clock::now();
+        for (size_t i = 0; i < batch; ++i) sink = sink + call();
+        if (elapsed_ns(start) >= 20'000 || batch >= (size_t{1} << 24)) break;
+        batch *= 2;
+    }
+
+    KernelResult result;
+    std::vector<uint64_t> per_call;
+    int64_t cycles_start = cycles.now();
+    auto deadline = clock::now() + std::chrono::duration<double>(options.min_seconds);
+    while (per_call.size() < options.min_batches || clock::now() < deadline) {
+        auto start = clock::now();
+        for (size_t i = 0; i < batch; ++i) sink = sink + call();
+        per_call.push_back(elapsed_ns(start) * 1000 / batch);   // picoseconds per call
+        result.calls += batch;
+    }
+    int64_t cycles_end = cycles.now();
+
+    std::ranges::sort(per_call);
+    result.ns_per_call = static_cast<double>(percentile(per_call, 0.5)) / 1000.0;
+    if (result.ns_per_call > 0.0) {
+        result.gb_per_second = static_cast<double>(input_bytes) / result.ns_per_call;
+    }
+    if (cycles_start >= 0 && cycles_end >= 0 && input_bytes > 0) {
+        result.cycles_per_byte = static_cast<double>(cycles_end - cycles_start) /
+                                 (static_cast<double>(result.calls) * static_cast<double>(input_bytes));
+    }
+    return result;
+}
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --ops LIST           Core operations (default: all)\n"
+        "  --dists LIST         ascii,utf8,sparse,dense (default: all)\n"
+        "  --sizes LIST         Input sizes with K/M/G suffixes (default: 8,64,512,4K,32K,256K,2M,16M,64M)\n"
+        "  --paths LIST         direct,function,registry (default: all)\n"
+        "  --min-time SECONDS   Minimum measuring time per case (default: 0.02)\n"
+        "  --warmup N           Calls before measuring (default: 3)\n"
+        "  --cpu N              Pin to this CPU (default: the current one)\n"
+        "  --seed N             Seed of the inputs (default: 42)\n"
+        "  --json FILE          Also write the results as JSON ('-' for stdout)\n"
+        "  --quick              Small sweep: sizes 64,4K,256K, ascii and utf8, 0.005s per case\n",
+        program);
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--ops") {
+            options.ops = split_list(value());
+        } else if (arg == "--dists") {
+            options.distributions.clear();
+            for (const auto& name : split_list(value())) options.distributions.push_back(parse_distribution(name));
+        } else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : split_list(value())) options.sizes.push_back(parse_bytes(size));
+        } else if (arg == "--paths") {
+            options.paths.clear();
+            for (const auto& name : split_list(value())) options.paths.push_back(parse_path(name));
+        } else if (arg == "--min-time") {
+            options.min_seconds = std::stod(std::string(value()));
+        } else if (arg == "--warmup") {
+            options.warmup = parse_bytes(value());
+        } else if (arg == "--cpu") {
+            options.cpu = static_cast<int>(parse_bytes(value()));
+        } else if (arg == "--seed") {
+            options.seed = parse_bytes(value());
+        } else if (arg == "--json") {
+            options.json_path = value();
+        } else if (arg == "--quick") {
+            options.sizes = {64, 4 << 10, 256 << 10};
+            options.distributions = {Distribution::ASCII, Distribution::UTF8};
+            options.min_seconds = 0.005;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Pin the calling thread to one CPU.
+ *
+ * @return The CPU, or -1 if pinning failed
+ */
+int pin_thread(int cpu) {
+    if (cpu < 0) {
+        cpu = sched_getcpu();
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0 ? cpu : -1;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_kernels: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    core_ops::register_all();
+    OperationRegistry& registry = OperationRegistry::get_instance();
+    std::vector<core_ops::KernelEntry> kernels;
+    for (const auto& entry : core_ops::kernels()) {
+        if (options.ops.empty() || std::ranges::find(options.ops, entry.name) != options.ops.end()) {
+            kernels.push_back(entry);
+        }
+    }
+    if (kernels.empty()) {
+        std::cerr << "strgraph_kernels: no matching operations\n";
+        return 2;
+    }
+
+    const int cpu = pin_thread(options.cpu);
+    const CycleCounter cycles;
+    std::ostream& table = options.json_path == "-" ? std::cerr : std::cout;
+    table << std::format("StrGraphCPP kernel benchmark: isa {}, {}, cycles from {}\n\n", compiled_isa(),
+                         cpu >= 0 ? std::format("pinned to cpu {}", cpu) : std::string("not pinned"),
+                         cycles.source());
+    table << std::format("{:<12} {:<7} {:>6} {:<9} {:>12} {:>9} {:>9} {:>12}\n",
+                         "op", "dist", "size", "path", "ns/call", "GB/s", "cyc/B", "dispatch ns");
+
+    nlohmann::json results = nlohmann::json::array();
+    for (Distribution distribution : options.distributions) {
+        for (size_t size : options.sizes) {
+            const std::string input = make_input(distribution, size, options.seed);
+            for (const auto& [name, kernel, signature] : kernels) {
+                OpArguments args = arguments_for(name, input);
+                size_t input_bytes = 0;
+                for (auto view : args.inputs) input_bytes += view.size();
+                const StringOperation held = registry.get_op(name);
+
+                double direct_ns = -1.0;
+                for (CallPath path : options.paths) {
+                    KernelResult r;
+                    switch (path) {
+                        case CallPath::DIRECT:
+                            r = run_case([&] { return result_size(kernel(args.inputs, args.constants)); },
+                                         input_bytes, options, cycles);
+                            direct_ns = r.ns_per_call;
+                            break;
+                        case CallPath::FUNCTION:
+                            r = run_case([&] { return result_size(held(args.inputs, args.constants)); },
+                                         input_bytes, options, cycles);
+                            break;
+                        case CallPath::REGISTRY:
+                            r = run_case([&] { return result_size(registry.get_op(name)(args.inputs, args.constants)); },
+                                         input_bytes, options, cycles);
+                            break;
+                    }
+
+                    std::string dispatch = path != CallPath::DIRECT && direct_ns >= 0.0
+                        ? std::format("{:.1f}", r.ns_per_call - direct_ns) : "-";
+                    table << std::format("{:<12} {:<7} {:>6} {:<9} {:>12.1f} {:>9.3f} {:>9} {:>12}\n",
+                                         name, distribution_name(distribution), format_bytes(size),
+                                         path_name(path), r.ns_per_call, r.gb_per_second,
+                                         r.cycles_per_byte >= 0.0 ? std::format("{:.3f}", r.cycles_per_byte) : "-",
+                                         dispatch);
+
+                    nlohmann::json entry = {
+                        {"op", name},
+                        {"distribution", distribution_name(distribution)},
+                        {"size", size},
+                        {"input_bytes", input_bytes},
+                        {"path", path_name(path)},
+                        {"calls", r.calls},
+                        {"ns_per_call", r.ns_per_call},
+                        {"gb_per_second", r.gb_per_second}
+                    };
+                    if (r.cycles_per_byte >= 0.0) {
+                        entry["cycles_per_byte"] = r.cycles_per_byte;
+                    }
+                    if (path != CallPath::DIRECT && direct_ns >= 0.0) {
+                        entry["dispatch_ns"] = r.ns_per_call - direct_ns;
+                    }
+                    results.push_back(std::move(entry));
+                }
+            }
+        }
+    }
+
+    if (!options.json_path.empty()) {
+        nlohmann::json report = {
+            {"benchmark", "strgraph_kernels"},
+            {"isa", compiled_isa()},
+            {"cpu", cpu},
+            {"cycle_source", cycles.source()},
+            {"results", std::move(results)}
+        };
+        if (options.json_path == "-") {
+            std::cout << report.dump(2) << "\n";
+        } else {
+            std::ofstream file(options.json_path);
+            file << report.dump(2) << "\n";
+            if (!file) {
+                std::cerr << std::format("strgraph_kernels: cannot write '{}'\n", options.json_path);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
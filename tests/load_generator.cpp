@@ -0,0 +1,498 @@
+/**
+ * @file load_generator.cpp
+ * @brief strgraph_loadgen: open-loop load test of the Executor with
+ *        tail latency against offered load.
+ *
+ * Requests arrive on a fixed schedule (Poisson or constant gaps) that
+ * does not wait for earlier requests to finish, and are served by a pool
+ * of workers with one Executor each. Latency is measured from the
+ * time a request was scheduled to arrive, so time spent queued behind
+ * slow requests is counted (coordinated-omission correction); the
+ * service time alone, which is what a closed loop would report, is kept
+ * as well. Both go into HDR-style histograms.
+ *
+ * Without --rates the capacity of the pool is measured in a closed-loop
+ * warm-up and the offered load is swept from 10% to 125% of it. The
+ * saturation knee is the highest load that is still served at its
+ * arrival rate with a p99 within --slo-factor of the p99 at the lowest
+ * load.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include "strgraph/executor.h"
+#include "strgraph/traffic_recorder.h"
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Workload (default: a generated graph):\n"
+        "  --graph FILE         Graph to load (JSON or binary)\n"
+        "  --target ID          Node to compute (default: JSON 'target_node')\n"
+        "  --feed ID=VALUE      Value of a placeholder (repeatable)\n"
+        "  --value-size N       Size of generated values for the other placeholders (default: 64)\n"
+        "  --traffic FILE       Cycle through the targets and feeds of a traffic log\n"
+        "  --shape NAME         Generated graph: chain,fanout,lattice,random,merged,layered (default: random)\n"
+        "  --mix NAME           Generated graph: case,copy,edit,mixed (default: mixed)\n"
+        "  --nodes N            Generated graph: operation nodes (default: 256)\n"
+        "\n"
+        "Load:\n"
+        "  --strategy NAME      recursive | iterative | parallel | auto (default: auto, or as recorded)\n"
+        "  --workers N          Concurrent workers, one Executor each (default: 1)\n"
+        "  --schedule NAME      poisson | constant arrivals (default: poisson)\n"
+        "  --rates LIST         Offered loads in requests/s (default: 10%-125% of the measured capacity)\n"
+        "  --duration SECONDS   Arrivals per offered load (default: 5)\n"
+        "  --warmup SECONDS     Closed-loop warm-up that measures the capacity (default: 1)\n"
+        "  --slo-factor X       p99 growth over the lowest load that counts as saturated (default: 5)\n"
+        "  --seed N             Seed of the schedule and generated workload (default: 42)\n"
+        "  --json FILE          Also write the results as JSON ('-' for stdout)\n"
+        "  --quick              Short sweep: 0.5s per load, 0.2s warm-up, 5 loads\n",
+        program);
+}
+
+enum class Schedule { POISSON, CONSTANT };
+
+struct Options {
+    std::string graph_path;
+    std::string target;
+    std::vector<std::pair<std::string, std::string>> feeds;
+    size_t value_size = 64;
+    std::string traffic_path;
+    GraphSpec spec{.shape = Shape::RANDOM, .mix = OpMix::MIXED, .value_size = 64, .nodes = 256};
+    std::optional<ExecutionStrategy> strategy;
+    size_t workers = 1;
+    Schedule schedule = Schedule::POISSON;
+    std::vector<double> rates;
+    std::vector<double> load_fractions{0.1, 0.25, 0.5, 0.7, 0.8, 0.9, 1.0, 1.1, 1.25};
+    double duration = 5.0;
+    double warmup = 1.0;
+    double slo_factor = 5.0;
+    uint64_t seed = 42;
+    std::string json_path;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--graph") {
+            options.graph_path = value();
+        } else if (arg == "--target") {
+            options.target = value();
+        } else if (arg == "--feed") {
+            std::string feed = value();
+            size_t equals = feed.find('=');
+            if (equals == std::string::npos) {
+                throw std::runtime_error(std::format("--feed expects ID=VALUE, got '{}'", feed));
+            }
+            options.feeds.emplace_back(feed.substr(0, equals), feed.substr(equals + 1));
+        } else if (arg == "--value-size") {
+            options.value_size = options.spec.value_size = parse_bytes(value());
+        } else if (arg == "--traffic") {
+            options.traffic_path = value();
+        } else if (arg == "--shape") {
+            options.spec.shape = parse_shape(value());
+        } else if (arg == "--mix") {
+            options.spec.mix = parse_mix(value());
+        } else if (arg == "--nodes") {
+            options.spec.nodes = parse_bytes(value());
+        } else if (arg == "--strategy") {
+            options.strategy = parse_strategy(value());
+        } else if (arg == "--workers") {
+            options.workers = parse_bytes(value());
+        } else if (arg == "--schedule") {
+            std::string name = value();
+            if (name == "poisson") options.schedule = Schedule::POISSON;
+            else if (name == "constant") options.schedule = Schedule::CONSTANT;
+            else throw std::runtime_error(std::format("Unknown schedule '{}' (poisson or constant)", name));
+        } else if (arg == "--rates") {
+            options.rates.clear();
+            for (const auto& rate : split_list(value())) options.rates.push_back(std::stod(rate));
+        } else if (arg == "--duration") {
+            options.duration = std::stod(value());
+        } else if (arg == "--warmup") {
+            options.warmup = std::stod(value());
+        } else if (arg == "--slo-factor") {
+            options.slo_factor = std::stod(value());
+        } else if (arg == "--seed") {
+            options.seed = options.spec.seed = parse_bytes(value());
+        } else if (arg == "--json") {
+            options.json_path = value();
+        } else if (arg == "--quick") {
+            options.duration = 0.5;
+            options.warmup = 0.2;
+            options.load_fractions = {0.25, 0.5, 0.8, 1.0, 1.25};
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    if (options.workers == 0) {
+        throw std::runtime_error("--workers must be at least 1");
+    }
+    if (options.duration <= 0.0) {
+        throw std::runtime_error("--duration must be positive");
+    }
+    for (double rate : options.rates) {
+        if (rate <= 0.0) throw std::runtime_error("--rates must be positive");
+    }
+    if (!options.traffic_path.empty() && options.graph_path.empty()) {
+        throw std::runtime_error("--traffic needs the --graph it was recorded on");
+    }
+    return options;
+}
+
+/**
+ * @brief One kind of request the workers cycle through.
+ */
+struct Request {
+    std::string target;
+    FeedDict feeds;
+    ExecutionStrategy strategy = ExecutionStrategy::AUTO;
+};
+
+/**
+ * @brief The graph and requests every worker serves.
+ */
+struct Workload {
+    std::string description;
+    std::function<std::unique_ptr<Graph>()> load_graph;   ///< Called once per worker
+    std::vector<Request> requests;
+};
+
+/**
+ * @brief target_node of a JSON graph file, empty for binary graphs.
+ */
+std::string default_target(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string data = std::move(buffer).str();
+    if (data.starts_with(Graph::BINARY_MAGIC)) return {};
+    auto json = nlohmann::json::parse(data);
+    return json.value("target_node", "");
+}
+
+Workload make_workload(const Options& options) {
+    Workload workload;
+    const ExecutionStrategy strategy = options.strategy.value_or(ExecutionStrategy::AUTO);
+
+    if (!options.traffic_path.empty()) {
+        for (auto& record : TrafficRecorder::read(options.traffic_path)) {
+            Request& request = workload.requests.emplace_back();
+            request.target = std::move(record.target);
+            request.feeds.insert(record.feeds.begin(), record.feeds.end());
+            request.strategy = options.strategy.value_or(parse_strategy(record.strategy));
+        }
+        if (workload.requests.empty()) {
+            throw std::runtime_error(std::format("'{}' holds no records", options.traffic_path));
+        }
+        workload.description = std::format("{} with {} recorded requests from {}",
+                                           options.graph_path, workload.requests.size(), options.traffic_path);
+        workload.load_graph = [path = options.graph_path] { return Graph::from_file(path); };
+        return workload;
+    }
+
+    Request& request = workload.requests.emplace_back();
+    request.strategy = strategy;
+    if (!options.graph_path.empty()) {
+        request.target = options.target.empty() ? default_target(options.graph_path) : options.target;
+        if (request.target.empty()) {
+            throw std::runtime_error("The graph names no target_node; pass --target");
+        }
+        request.feeds.insert(options.feeds.begin(), options.feeds.end());
+        // Placeholders without --feed get a generated value
+        auto graph = Graph::from_file(options.graph_path);
+        for (const auto& [id, node] : graph->get_nodes()) {
+            if (node.type == NodeType::PLACEHOLDER && !request.feeds.contains(id)) {
+                request.feeds.emplace(id, make_value(options.value_size, options.seed));
+            }
+        }
+        workload.description = std::format("{} -> '{}'", options.graph_path, request.target);
+        workload.load_graph = [path = options.graph_path] { return Graph::from_file(path); };
+        return workload;
+    }
+
+    BenchGraph bench = build_graph(options.spec);
+    request.target = bench.target;
+    for (const auto& [id, view] : bench.feeds) {
+        request.feeds.emplace(id, std::string(view));
+    }
+    workload.description = std::format("generated {}", options.spec.name());
+    workload.load_graph = [spec = options.spec] { return std::move(build_graph(spec).graph); };
+    return workload;
+}
+
+/**
+ * @brief A graph and Executor per worker, serving requests by strategy.
+ */
+class Worker {
+public:
+    explicit Worker(const Workload& workload) : graph_(workload.load_graph()), executor_(*graph_) {
+        try {
+            executor_.verify();
+        } catch (const std::exception&) {
+            // Still runnable on the checked path
+        }
+    }
+
+    void serve(const Request& request) {
+        (void)executor_.compute_with_strategy(request.strategy, request.target, request.feeds);
+    }
+
+private:
+    std::unique_ptr<Graph> graph_;
+    Executor executor_;
+};
+
+/**
+ * @brief Latencies of one offered load.
+ */
+struct LoadResult {
+    double offered = 0.0;             ///< Requests/s of the schedule
+    double achieved = 0.0;            ///< Requests/s completed, first arrival to last completion
+    uint64_t requests = 0;
+    uint64_t failures = 0;
+    LatencyHistogram latency;         ///< Completion - scheduled arrival (corrected)
+    LatencyHistogram service;         ///< Completion - start (uncorrected)
+    bool saturated = false;
+};
+
+/**
+ * @brief Arrival times (since the start of the run) of one offered load.
+ */
+std::vector<uint64_t> make_schedule(double rate, double duration, Schedule schedule, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::exponential_distribution<double> gap(rate);
+    std::vector<uint64_t> arrivals;
+    arrivals.reserve(static_cast<size_t>(rate * duration) + 16);
+    double t = 0.0;
+    for (size_t i = 0;; ++i) {
+        t = schedule == Schedule::CONSTANT ? static_cast<double>(i) / rate : t + gap(rng);
+        if (t >= duration) break;
+        arrivals.push_back(static_cast<uint64_t>(t * 1e9));
+    }
+    return arrivals;
+}
+
+/**
+ * @brief Serve a schedule with the worker pool (open loop).
+ */
+LoadResult run_load(std::vector<std::unique_ptr<Worker>>& workers, const Workload& workload,
+                    double rate, const Options& options, uint64_t seed) {
+    using clock = std::chrono::steady_clock;
+    const std::vector<uint64_t> arrivals = make_schedule(rate, options.duration, options.schedule, seed);
+    LoadResult result;
+    result.offered = rate;
+    result.requests = arrivals.size();
+
+    std::atomic<size_t> next{0};
+    std::vector<LoadResult> partial(workers.size());
+    std::vector<clock::time_point> finished(workers.size());
+    const auto start = clock::now() + std::chrono::milliseconds(1);
+    {
+        std::vector<std::jthread> threads;
+        for (size_t w = 0; w < workers.size(); ++w) {
+            threads.emplace_back([&, w] {
+                LoadResult& own = partial[w];
+                finished[w] = start;
+                for (size_t i = next.fetch_add(1); i < arrivals.size(); i = next.fetch_add(1)) {
+                    const auto scheduled = start + std::chrono::nanoseconds(arrivals[i]);
+                    std::this_thread::sleep_until(scheduled);
+                    const auto begin = clock::now();
+                    try {
+                        workers[w]->serve(workload.requests[i % workload.requests.size()]);
+                    } catch (const std::exception&) {
+                        ++own.failures;
+                    }
+                    const auto end = clock::now();
+                    own.latency.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(end - scheduled).count()));
+                    own.service.record(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()));
+                    finished[w] = end;
+                }
+            });
+        }
+    }
+
+    auto last = start;
+    for (size_t w = 0; w < workers.size(); ++w) {
+        result.latency.merge(partial[w].latency);
+        result.service.merge(partial[w].service);
+        result.failures += partial[w].failures;
+        last = std::max(last, finished[w]);
+    }
+    const double seconds = std::chrono::duration<double>(last - start).count();
+    result.achieved = seconds > 0.0 ? static_cast<double>(result.requests) / seconds : 0.0;
+    return result;
+}
+
+/**
+ * @brief Requests/s the pool completes back to back (closed loop).
+ */
+double measure_capacity(std::vector<std::unique_ptr<Worker>>& workers, const Workload& workload, double seconds) {
+    using clock = std::chrono::steady_clock;
+    std::atomic<uint64_t> completed{0};
+    const auto deadline = clock::now() + std::chrono::duration<double>(seconds);
+    const auto start = clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (size_t w = 0; w < workers.size(); ++w) {
+            threads.emplace_back([&, w] {
+                for (size_t i = w; clock::now() < deadline || i == w; i += workers.size()) {
+                    try {
+                        workers[w]->serve(workload.requests[i % workload.requests.size()]);
+                    } catch (const std::exception&) {
+                    }
+                    completed.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+    }
+    const double elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    return static_cast<double>(completed.load()) / elapsed;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    Workload workload;
+    try {
+        options = parse_options(argc, argv);
+        core_ops::register_all();
+        workload = make_workload(options);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_loadgen: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    std::ostream& table = options.json_path == "-" ? std::cerr : std::cout;
+    std::vector<std::unique_ptr<Worker>> workers;
+    try {
+        for (size_t w = 0; w < options.workers; ++w) {
+            workers.push_back(std::make_unique<Worker>(workload));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_loadgen: " << e.what() << "\n";
+        return 1;
+    }
+
+    // The warm-up also fills caches and the allocator before measuring
+    const double capacity = measure_capacity(workers, workload, options.warmup);
+    const bool sweep = options.rates.empty();
+    std::vector<double> rates = options.rates;
+    if (sweep) {
+        for (double fraction : options.load_fractions) rates.push_back(fraction * capacity);
+    }
+
+    table << std::format("StrGraphCPP load test: {}, {} workers, {} arrivals, {:.1f}s per load\n",
+                         workload.description, options.workers,
+                         options.schedule == Schedule::POISSON ? "Poisson" : "constant", options.duration);
+    table << std::format("Closed-loop capacity: {:.0f} requests/s\n\n", capacity);
+    table << std::format("{:>11} {:>11} {:>9} {:>10} {:>10} {:>10} {:>10} {:>11} {:>11}  {}\n",
+                         "offered/s", "achieved/s", "requests", "p50 ms", "p99 ms", "p99.9 ms", "max ms",
+                         "svc p50 ms", "svc p99 ms", "state");
+
+    auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+    std::vector<LoadResult> results;
+    size_t saturated_in_a_row = 0;
+    for (size_t r = 0; r < rates.size(); ++r) {
+        LoadResult result = run_load(workers, workload, rates[r], options, options.seed + r);
+        const uint64_t base_p99 = results.empty() ? result.latency.percentile(0.99)
+                                                  : results.front().latency.percentile(0.99);
+        result.saturated = result.achieved < 0.95 * result.offered ||
+                           static_cast<double>(result.latency.percentile(0.99)) >
+                               options.slo_factor * static_cast<double>(base_p99);
+        table << std::format("{:>11.0f} {:>11.0f} {:>9} {:>10.3f} {:>10.3f} {:>10.3f} {:>10.3f} {:>11.3f} {:>11.3f}  {}{}\n",
+                             result.offered, result.achieved, result.requests,
+                             ms(result.latency.percentile(0.50)), ms(result.latency.percentile(0.99)),
+                             ms(result.latency.percentile(0.999)), ms(result.latency.max()),
+                             ms(result.service.percentile(0.50)), ms(result.service.percentile(0.99)),
+                             result.saturated ? "saturated" : "ok",
+                             result.failures > 0 ? std::format(" ({} failed)", result.failures) : "");
+        saturated_in_a_row = result.saturated ? saturated_in_a_row + 1 : 0;
+        results.push_back(std::move(result));
+        // Past the knee every further load only grows the queue
+        if (sweep && saturated_in_a_row >= 2) break;
+    }
+
+    const LoadResult* knee = nullptr;
+    for (const auto& result : results) {
+        if (result.saturated) break;
+        knee = &result;
+    }
+    if (knee != nullptr) {
+        table << std::format("\nSaturation knee: about {:.0f} requests/s ({:.0f}% of capacity), p99 {:.3f} ms\n",
+                             knee->offered, 100.0 * knee->offered / capacity, ms(knee->latency.percentile(0.99)));
+    } else {
+        table << "\nSaturated at every offered load; try lower --rates\n";
+    }
+
+    if (!options.json_path.empty()) {
+        auto summary = [](const LatencyHistogram& histogram) {
+            return nlohmann::json{
+                {"min", histogram.min()}, {"p50", histogram.percentile(0.50)},
+                {"p90", histogram.percentile(0.90)}, {"p99", histogram.percentile(0.99)},
+                {"p999", histogram.percentile(0.999)}, {"max", histogram.max()}, {"mean", histogram.mean()}
+            };
+        };
+        nlohmann::json loads = nlohmann::json::array();
+        for (const auto& result : results) {
+            loads.push_back({
+                {"offered_per_second", result.offered},
+                {"achieved_per_second", result.achieved},
+                {"requests", result.requests},
+                {"failures", result.failures},
+                {"latency_ns", summary(result.latency)},
+                {"service_ns", summary(result.service)},
+                {"saturated", result.saturated}
+            });
+        }
+        nlohmann::json report = {
+            {"benchmark", "strgraph_loadgen"},
+            {"workload", workload.description},
+            {"workers", options.workers},
+            {"schedule", options.schedule == Schedule::POISSON ? "poisson" : "constant"},
+            {"duration_seconds", options.duration},
+            {"capacity_per_second", capacity},
+            {"knee_per_second", knee != nullptr ? nlohmann::json(knee->offered) : nlohmann::json()},
+            {"loads", std::move(loads)}
+        };
+        if (options.json_path == "-") {
+            std::cout << report.dump(2) << "\n";
+        } else {
+            std::ofstream file(options.json_path);
+            file << report.dump(2) << "\n";
+            if (!file) {
+                std::cerr << std::format("strgraph_loadgen: cannot write '{}'\n", options.json_path);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
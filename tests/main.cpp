@@ -4,10 +4,30 @@
 #include "strgraph/operation_registry.h"
 #include "strgraph/graph.h"
 #include "strgraph/executor.h"
+#include "strgraph/batch_runner.h"
+#include "strgraph/record_reader.h"
+#include "strgraph/async_io.h"
+#include "strgraph/compiled_graph.h"
+#include "strgraph/graph_template.h"
+#include "strgraph/alloc_tracking.h"
+#include "strgraph/metrics.h"
+#include "strgraph/graph_generator.h"
+#include "strgraph/traffic_recorder.h"
 #include <json.hpp>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
 #include <chrono>
 #include <random>
 #include <iomanip>
+#include <thread>
+#include <limits>
+#include <set>
+#include <unordered_map>
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
 
 using namespace strgraph;
 using json = nlohmann::json;
@@ -468,8 +488,8 @@ TEST_F(StrGraphTest, PerformanceDeepGraph) {
  * - Measure performance difference between approaches
  * Expected Results:
  * - Both strategies produce identical results
- * - Parallel execution should show performance improvement
  * - Large graph handles parallel processing correctly
+ * - Speedups are measured by strgraph_scaling, not asserted here
  */
 TEST_F(StrGraphTest, ParallelPerformance) {
     json nodes = json::array();
@@ -496,10 +516,15 @@ TEST_F(StrGraphTest, ParallelPerformance) {
         }
     }
     
+    // Join every chain so the whole lattice is reachable from the target
+    json last_layer = json::array();
+    for (int i = 0; i < 500; ++i) {
+        last_layer.push_back(std::format("node_9_{}", i));
+    }
     nodes.push_back({
         {"id", "output"},
-        {"op", "reverse"},
-        {"inputs", json::array({"node_9_0"})}
+        {"op", "concat"},
+        {"inputs", last_layer}
     });
     
     json graph = {{"nodes", nodes}, {"target_node", "output"}};
@@ -734,6 +759,1992 @@ TEST_F(ExecutionStrategyTest, AutoStrategyChoosesCorrectly) {
     EXPECT_FALSE(large_result.empty());
 }
 
+/**
+ * Test: Failures agree across strategies
+ * Test Content:
+ * - Read an output index a split node does not have, with the parallel
+ *   layers on the thread team
+ * - Write the value through compute_to_sink() where it is dropped by a
+ *   repeat count of 0
+ * Expected Results:
+ * - Every strategy throws the error compute() throws, instead of the
+ *   parallel strategy terminating the process or the sink skipping it
+ */
+TEST_F(ExecutionStrategyTest, FailuresAgreeAcrossStrategies) {
+    json graph_json = {
+        {"nodes", json::array({
+            {{"id", "text"}, {"type", "placeholder"}},
+            {{"id", "parts"}, {"op", "split"}, {"inputs", json::array({"text"})}, {"constants", json::array({","})}},
+            {{"id", "bad"}, {"op", "identity"}, {"inputs", json::array({"parts:2"})}},
+            {{"id", "good"}, {"op", "reverse"}, {"inputs", json::array({"parts:0"})}},
+            {{"id", "gone"}, {"op", "repeat"}, {"inputs", json::array({"parts:2"})}, {"constants", json::array({"0"})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"good", "gone"})}}
+        })}
+    };
+    auto graph = Graph::from_json(graph_json);
+    Executor executor(*graph);
+    executor.set_min_parallel_layer_size(1);
+    FeedDict feed = {{"text", "a,b"}};
+
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        EXPECT_THROW((void)executor.compute_with_strategy(strategy, "bad", feed), std::runtime_error);
+        EXPECT_THROW((void)executor.compute_with_strategy(strategy, "out", feed), std::runtime_error);
+        std::ostringstream stream;
+        StreamSink sink(stream);
+        EXPECT_THROW(executor.compute_to_sink(strategy, "out", sink, feed), std::runtime_error);
+    }
+    EXPECT_EQ(executor.compute_parallel("good", {{"text", "ab,c"}}), "ba");
+}
+
+// ============================================================================
+// BATCH PROCESSING TESTS
+// ============================================================================
+
+class BatchRunnerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Binary graph format round trip
+ * Test Content:
+ * - Serialize a graph with all node types to the binary format
+ * - Load it back and execute it
+ * - Feed truncated data to the loader
+ * - Feed node and input counts far larger than the data
+ * Expected Results:
+ * - The reloaded graph produces the same result
+ * - Truncated data and oversized counts throw runtime_error
+ */
+TEST_F(BatchRunnerTest, BinaryGraphRoundTrip) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "c"}, {"type", "constant"}, {"value", "x-"}},
+            {{"id", "p"}, {"type", "placeholder"}},
+            {{"id", "v"}, {"type", "variable"}, {"value", "-v"}},
+            {{"id", "parts"}, {"op", "split"}, {"inputs", json::array({"p"})}, {"constants", json::array({","})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"c", "parts:1", "v"})}, {"constants", json::array({"!"})}}
+        })}
+    };
+    
+    auto original = Graph::from_json(graph);
+    std::string binary = original->to_binary();
+    ASSERT_TRUE(binary.starts_with(Graph::BINARY_MAGIC));
+    
+    auto loaded = Graph::from_binary(binary);
+    EXPECT_EQ(loaded->get_nodes().size(), original->get_nodes().size());
+    
+    Executor executor(*loaded);
+    EXPECT_EQ(executor.compute("out", {{"p", "a,b"}}), "x-b-v!");
+    
+    EXPECT_THROW({
+        auto g = Graph::from_binary(std::string_view(binary).substr(0, binary.size() - 3));
+    }, std::runtime_error);
+
+    // Counts larger than the data are reported as truncation, not allocated
+    std::string huge_nodes;
+    Graph::append_binary_header(huge_nodes, uint64_t{1} << 31);
+    EXPECT_THROW({
+        auto g = Graph::from_binary(huge_nodes);
+    }, std::runtime_error);
+
+    std::string huge_inputs;
+    Graph::append_binary_header(huge_inputs, 1);
+    auto append_u32 = [&](uint32_t value) {
+        huge_inputs.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    append_u32(2 + 2 * sizeof(uint32_t) + 1 + sizeof(uint32_t));
+    huge_inputs += static_cast<char>(NodeType::OPERATION);
+    huge_inputs += '\0';
+    append_u32(1);
+    huge_inputs += 'n';
+    append_u32(0);
+    append_u32(0x7fffffff);
+    EXPECT_THROW({
+        auto g = Graph::from_binary(huge_inputs);
+    }, std::runtime_error);
+}
+
+/**
+ * Test: Batch execution over delimited records
+ * Test Content:
+ * - Bind two columns of comma-separated records to placeholders
+ * - Use a small chunk size so several chunks are scheduled
+ * - Run with every execution strategy
+ * Expected Results:
+ * - One output line per record, in input order
+ * - Statistics count records and bytes
+ */
+TEST_F(BatchRunnerTest, ColumnsBoundInOrder) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "first"}, {"type", "placeholder"}},
+            {{"id", "second"}, {"type", "placeholder"}},
+            {{"id", "upper"}, {"op", "to_upper"}, {"inputs", json::array({"second"})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"upper", "first"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    
+    std::string input;
+    std::string expected;
+    for (int i = 0; i < 1000; ++i) {
+        input += std::format("{},name{}\n", i, i);
+        expected += std::format("NAME{}{}\n", i, i);
+    }
+    
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        BatchOptions options;
+        options.target_node_id = "out";
+        options.column_delimiter = ',';
+        options.bindings = {{0, "first"}, {1, "second"}};
+        options.strategy = strategy;
+        options.chunk_records = 97;
+        
+        BatchRunner runner(*g, options);
+        std::ostringstream output;
+        BatchStats stats = runner.run(input, output);
+        
+        EXPECT_EQ(output.str(), expected) << strategy_name(strategy);
+        EXPECT_EQ(stats.records, 1000u);
+        EXPECT_EQ(stats.input_bytes, input.size());
+        EXPECT_EQ(stats.errors, 0u);
+    }
+}
+
+/**
+ * Test: Batch error handling
+ * Test Content:
+ * - Feed a record that lacks the bound column
+ * - Run once failing fast and once with skip_errors
+ * Expected Results:
+ * - Fail-fast run throws runtime_error
+ * - skip_errors emits an empty line and counts the error
+ */
+TEST_F(BatchRunnerTest, ErrorsFailOrSkip) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "a"}, {"type", "placeholder"}},
+            {{"id", "b"}, {"type", "placeholder"}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"a", "b"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    
+    BatchOptions options;
+    options.target_node_id = "out";
+    options.column_delimiter = '\t';
+    options.bindings = {{0, "a"}, {1, "b"}};
+    
+    std::string input = "x\ty\nmissing\nz\tw\n";
+    std::ostringstream output;
+    EXPECT_THROW({
+        BatchRunner runner(*g, options);
+        runner.run(input, output);
+    }, std::runtime_error);
+    
+    options.skip_errors = true;
+    BatchRunner runner(*g, options);
+    std::ostringstream skipped;
+    BatchStats stats = runner.run(input, skipped);
+    EXPECT_EQ(skipped.str(), "xy\n\nzw\n");
+    EXPECT_EQ(stats.errors, 1u);
+    
+    options.bindings = {{0, "out"}};
+    EXPECT_THROW({ BatchRunner invalid(*g, options); }, std::runtime_error);
+}
+
+// ============================================================================
+// RECORD INGESTION TESTS
+// ============================================================================
+
+/**
+ * Test: CSV record and field scanning
+ * Test Content:
+ * - Quoted fields containing delimiters, newlines and doubled quotes
+ * - Records long enough to cross several 64-byte scan blocks
+ * - CRLF line endings and a final record without newline
+ * Expected Results:
+ * - Newlines inside quotes do not split records
+ * - Fields are views into the input; escaped fields decode correctly
+ */
+TEST(RecordReaderTest, CsvQuotesAndBlockBoundaries) {
+    std::string long_field(150, 'x');
+    std::string input = "id,text\r\n"
+                        "1,\"a,b\"\r\n"
+                        "2,\"line1\nline2 \"\"quoted\"\"\"\n"
+                        "3," + long_field + ",\"" + long_field + ",\"\n"
+                        "4,last";
+    
+    RecordReader reader(RecordFormat::CSV);
+    std::vector<std::string_view> records;
+    size_t pos = reader.scan_records(input, 0, 100, records);
+    EXPECT_EQ(pos, input.size());
+    ASSERT_EQ(records.size(), 5u);
+    EXPECT_EQ(records[0], "id,text");
+    EXPECT_EQ(records[4], "4,last");
+    
+    std::vector<FieldView> fields;
+    std::string scratch;
+    reader.split_fields(records[1], fields);
+    ASSERT_EQ(fields.size(), 2u);
+    EXPECT_EQ(fields[1].value(scratch), "a,b");
+    EXPECT_EQ(fields[1].escape, FieldView::Escape::NONE);
+    
+    reader.split_fields(records[2], fields);
+    ASSERT_EQ(fields.size(), 2u);
+    EXPECT_EQ(fields[1].value(scratch), "line1\nline2 \"quoted\"");
+    
+    reader.split_fields(records[3], fields);
+    ASSERT_EQ(fields.size(), 3u);
+    EXPECT_EQ(fields[1].value(scratch), long_field);
+    EXPECT_EQ(fields[2].value(scratch), long_field + ",");
+    EXPECT_GE(fields[1].raw.data(), input.data());
+    EXPECT_LT(fields[1].raw.data(), input.data() + input.size());
+    
+    // Windowed scanning resumes at record boundaries
+    pos = reader.scan_records(input, 0, 2, records);
+    ASSERT_EQ(records.size(), 2u);
+    reader.scan_records(input, pos, 100, records);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_TRUE(records[0].starts_with("2,"));
+}
+
+/**
+ * Test: JSONL field lookup
+ * Test Content:
+ * - String values with escapes (including \\u surrogate pairs)
+ * - Numbers, null, nested objects and missing fields
+ * - Malformed records
+ * Expected Results:
+ * - Strings decode, other values are returned as raw JSON text
+ * - Missing fields are nullopt; malformed records throw runtime_error
+ */
+TEST(RecordReaderTest, JsonlFields) {
+    RecordReader reader(RecordFormat::JSONL);
+    std::string record = R"({"name": "A \"q\" \ud83d\ude00", "n": 42, "z": null, "obj": {"k": "}"}, "plain": "v"})";
+    std::vector<std::string_view> names = {"plain", "name", "n", "z", "obj", "missing"};
+    std::vector<std::optional<FieldView>> fields;
+    reader.find_json_fields(record, names, fields);
+    
+    std::string scratch;
+    ASSERT_TRUE(fields[0].has_value());
+    EXPECT_EQ(fields[0]->value(scratch), "v");
+    EXPECT_EQ(fields[0]->escape, FieldView::Escape::NONE);
+    ASSERT_TRUE(fields[1].has_value());
+    EXPECT_EQ(fields[1]->value(scratch), "A \"q\" \xF0\x9F\x98\x80");
+    EXPECT_EQ(fields[2]->value(scratch), "42");
+    EXPECT_EQ(fields[3]->value(scratch), "");
+    EXPECT_EQ(fields[4]->value(scratch), R"({"k": "}"})");
+    EXPECT_FALSE(fields[5].has_value());
+    
+    EXPECT_THROW(reader.find_json_fields("[1, 2]", names, fields), std::runtime_error);
+    EXPECT_THROW(reader.find_json_fields(R"({"a": "unterminated)", names, fields), std::runtime_error);
+}
+
+/**
+ * Test: Named column bindings in batch execution
+ * Test Content:
+ * - CSV input with a header, bound by column name
+ * - JSONL input bound by field name
+ * - Placeholder values passed as views (zero copy) through the executor
+ * Expected Results:
+ * - Results are correct and in input order
+ * - Unknown column names throw runtime_error
+ */
+TEST_F(BatchRunnerTest, CsvAndJsonlNamedBindings) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "first"}, {"type", "placeholder"}},
+            {{"id", "last"}, {"type", "placeholder"}},
+            {{"id", "upper"}, {"op", "to_upper"}, {"inputs", json::array({"last"})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"first", "upper"})}, {"constants", json::array({"!"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    
+    BatchOptions options;
+    options.target_node_id = "out";
+    options.format = RecordFormat::CSV;
+    options.bindings = {{ColumnBinding::WHOLE_RECORD, "first", "given"},
+                        {ColumnBinding::WHOLE_RECORD, "last", "family"}};
+    
+    std::string csv = "family,given\nsmith,\"Ann, B\"\n\"o\"\"neil\",Cy\n";
+    BatchRunner csv_runner(*g, options);
+    std::ostringstream csv_output;
+    BatchStats stats = csv_runner.run(csv, csv_output);
+    EXPECT_EQ(csv_output.str(), "Ann, BSMITH!\nCyO\"NEIL!\n");
+    EXPECT_EQ(stats.records, 2u);
+    
+    options.format = RecordFormat::JSONL;
+    std::string jsonl = "{\"given\": \"Dee\", \"family\": \"lee\"}\n{\"family\": \"x\\ty\", \"given\": \"E\"}\n";
+    BatchRunner jsonl_runner(*g, options);
+    std::ostringstream jsonl_output;
+    jsonl_runner.run(jsonl, jsonl_output);
+    EXPECT_EQ(jsonl_output.str(), "DeeLEE!\nEX\tY!\n");
+    
+    options.format = RecordFormat::CSV;
+    options.bindings[0].column_name = "nope";
+    BatchRunner bad_runner(*g, options);
+    std::ostringstream bad_output;
+    EXPECT_THROW(bad_runner.run(csv, bad_output), std::runtime_error);
+}
+
+// ============================================================================
+// ZERO-COPY FEED TESTS
+// ============================================================================
+
+class FeedTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: View-based feeds
+ * Test Content:
+ * - Compute with FeedViewDict values pointing into caller memory
+ * - Target a PLACEHOLDER node directly
+ * - Index into a placeholder (invalid)
+ * Expected Results:
+ * - All strategies give the same result
+ * - No view into the caller's memory is kept after a run
+ * - Placeholder targets return their value; indexing throws runtime_error
+ */
+TEST_F(FeedTest, FeedViewsAreReadInPlace) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "p"}, {"type", "placeholder"}},
+            {{"id", "r"}, {"op", "reverse"}, {"inputs", json::array({"p"})}},
+            {{"id", "bad"}, {"op", "reverse"}, {"inputs", json::array({"p:0"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    Executor executor(*g);
+    
+    std::string buffer = "abcdef";
+    FeedViewDict views = {{"p", std::string_view(buffer).substr(1, 3)}};
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        EXPECT_EQ(executor.compute_with_strategy(strategy, "r", views), "dcb");
+        EXPECT_EQ(executor.compute_with_strategy(strategy, "p", views), "bcd");
+        EXPECT_FALSE(g->get_node("p").bound_value.has_value());
+    }
+    EXPECT_THROW({
+        [[maybe_unused]] auto& r = executor.compute_with_strategy(ExecutionStrategy::RECURSIVE, "bad", views);
+    }, std::runtime_error);
+}
+
+/**
+ * Test: File-backed placeholder values
+ * Test Content:
+ * - Feed one placeholder from a byte range of a file and one from feed_dict
+ * - Target the file-backed placeholder directly
+ * - Feed a placeholder twice, or from a missing file
+ * - Fail a run, and a bind after the first file was mapped
+ * Expected Results:
+ * - Operations read the mapped range; every strategy agrees
+ * - No view into the released mapping is left in the graph, also
+ *   after a failure
+ * - Invalid feeds throw runtime_error
+ */
+TEST_F(FeedTest, FileFeedsAreMapped) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "doc"}, {"type", "placeholder"}},
+            {{"id", "sep"}, {"type", "placeholder"}},
+            {{"id", "r"}, {"op", "reverse"}, {"inputs", json::array({"doc"})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"doc", "sep", "r"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    Executor executor(*g);
+    
+    auto path = (std::filesystem::temp_directory_path() / "strgraph_file_feed_test.txt").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "hello world";
+    }
+    
+    FileFeedDict files = {{"doc", {path, 6, 5}}};
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        EXPECT_EQ(executor.compute_with_files(strategy, "out", files, {{"sep", "|"}}), "world|dlrow");
+        EXPECT_FALSE(g->get_node("doc").bound_value.has_value());
+    }
+    EXPECT_EQ(executor.compute_with_files(ExecutionStrategy::RECURSIVE, "doc", {{"doc", {path}}}),
+              "hello world");
+    
+    EXPECT_THROW({
+        [[maybe_unused]] auto& r = executor.compute_with_files(
+            ExecutionStrategy::RECURSIVE, "out", files, {{"sep", "|"}, {"doc", "x"}});
+    }, std::runtime_error);
+    EXPECT_THROW({
+        [[maybe_unused]] auto& r = executor.compute_with_files(
+            ExecutionStrategy::RECURSIVE, "out", {{"doc", {path + ".missing"}}}, {{"sep", "|"}});
+    }, std::runtime_error);
+
+    // Failed runs and partial binds release the mappings' views as well
+    EXPECT_THROW({
+        [[maybe_unused]] auto& r = executor.compute_with_files(ExecutionStrategy::RECURSIVE, "out", files);
+    }, std::runtime_error);
+    EXPECT_FALSE(g->get_node("doc").bound_value.has_value());
+    CallbackSink sink([](std::string_view) {});
+    EXPECT_THROW(executor.compute_to_sink(ExecutionStrategy::ITERATIVE, "out", sink, {}, files),
+                 std::runtime_error);
+    EXPECT_FALSE(g->get_node("doc").bound_value.has_value());
+    EXPECT_THROW({
+        [[maybe_unused]] auto& r = executor.compute_with_files(
+            ExecutionStrategy::RECURSIVE, "out", {{"doc", {path}}, {"sep", {path}}}, {{"sep", "|"}});
+    }, std::runtime_error);
+    EXPECT_EQ(executor.compute_with_files(ExecutionStrategy::RECURSIVE, "out", files, {{"sep", "|"}}),
+              "world|dlrow");
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// OUTPUT SINK TESTS
+// ============================================================================
+
+class OutputSinkTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Streaming a result to an output sink
+ * Test Content:
+ * - Target a concat of a repeat of a concat, plus a computed node
+ * - Write it to a callback sink and to a file with every strategy
+ * - Target a non-assembly node and a repeat too large to flatten
+ * - Target a repeat whose piece count overflows size_t
+ * Expected Results:
+ * - Sinks receive exactly the value compute() returns
+ * - Nested concat/repeat nodes are flattened and never computed
+ * - The file is written with a single writev() call
+ * - The overflowing repeat is computed as one piece instead of flattened
+ */
+TEST_F(OutputSinkTest, SinkWritesAssembledPieces) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "p"}, {"type", "placeholder"}},
+            {{"id", "r"}, {"op", "reverse"}, {"inputs", json::array({"p"})}},
+            {{"id", "c1"}, {"op", "concat"}, {"inputs", json::array({"p"})}, {"constants", json::array({"-"})}},
+            {{"id", "rep"}, {"op", "repeat"}, {"inputs", json::array({"c1"})}, {"constants", json::array({"3"})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"rep", "r"})}, {"constants", json::array({"!"})}},
+            {{"id", "huge"}, {"op", "repeat"}, {"inputs", json::array({"r"})}, {"constants", json::array({"100000"})}},
+            {{"id", "q"}, {"type", "placeholder"}},
+            {{"id", "c2"}, {"op", "concat"}, {"inputs", json::array({"q"})}, {"constants", json::array({"-"})}},
+            {{"id", "overflow"}, {"op", "repeat"}, {"inputs", json::array({"c2"})},
+             {"constants", json::array({"9223372036854775808"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    Executor executor(*g);
+    FeedDict feed = {{"p", "abc"}};
+    const std::string expected = "abc-abc-abc-cba!";
+    
+    auto path = (std::filesystem::temp_directory_path() / "strgraph_sink_test.txt").string();
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        std::vector<std::string> pieces;
+        CallbackSink callback([&](std::string_view piece) { pieces.emplace_back(piece); });
+        EXPECT_EQ(executor.compute_to_sink(strategy, "out", callback, feed), expected.size());
+        EXPECT_EQ(pieces.size(), 8u);
+        std::string joined;
+        for (const auto& piece : pieces) joined += piece;
+        EXPECT_EQ(joined, expected);
+        EXPECT_FALSE(g->get_node("c1").computed_result.has_value());
+        EXPECT_FALSE(g->get_node("rep").computed_result.has_value());
+        
+        {
+            FdSink file(path);
+            executor.compute_to_sink(strategy, "out", file, feed);
+            EXPECT_EQ(file.bytes_written(), expected.size());
+            EXPECT_EQ(file.write_calls(), 1u);
+        }
+        std::ifstream written(path, std::ios::binary);
+        EXPECT_EQ(std::string(std::istreambuf_iterator<char>(written), {}), expected);
+    }
+    std::filesystem::remove(path);
+    
+    std::ostringstream stream;
+    StreamSink stream_sink(stream);
+    executor.compute_to_sink(ExecutionStrategy::RECURSIVE, "r", stream_sink, feed);
+    EXPECT_EQ(stream.str(), "cba");
+    
+    size_t calls = 0;
+    CallbackSink counter([&](std::string_view) { ++calls; });
+    EXPECT_EQ(executor.compute_to_sink(ExecutionStrategy::RECURSIVE, "huge", counter, feed), 300000u);
+    EXPECT_EQ(calls, 1u);
+
+    // 2 pieces times 2^63 wraps to 0: still too large to flatten, so the
+    // repeat is computed as one piece and fails on the unfed placeholder
+    EXPECT_THROW(executor.compute_to_sink(ExecutionStrategy::RECURSIVE, "overflow", counter, feed),
+                 std::runtime_error);
+}
+
+// ============================================================================
+// ASYNC I/O TESTS
+// ============================================================================
+
+/**
+ * @brief Backends usable in this environment (io_uring may be disabled).
+ */
+static std::vector<IoBackend> available_io_backends() {
+    std::vector<IoBackend> backends = {IoBackend::THREAD};
+    if (io_uring_available()) {
+        backends.push_back(IoBackend::IO_URING);
+    }
+    return backends;
+}
+
+/**
+ * Test: Asynchronous writer and reader round trip
+ * Test Content:
+ * - Write 100 KB through an AsyncFileWriter with 4 KB blocks
+ * - Read the file back with an AsyncFileReader, several reads in flight
+ * - Read an empty file
+ * - Run with every available backend
+ * Expected Results:
+ * - Blocks arrive in order and reassemble the written data
+ * - Byte counters match the file size; the empty file has no blocks
+ */
+TEST(AsyncIoTest, ReaderAndWriterRoundTrip) {
+    auto path = (std::filesystem::temp_directory_path() / "strgraph_async_io_test.bin").string();
+    std::string data;
+    std::mt19937 rng(7);
+    for (int i = 0; i < 100000; ++i) {
+        data.push_back(static_cast<char>('a' + rng() % 26));
+    }
+    
+    for (IoBackend backend : available_io_backends()) {
+        AsyncIoOptions options{backend, 4096, 3, 4096};
+        {
+            AsyncFileWriter writer(path, options);
+            std::ostream output(&writer);
+            output.write(data.data(), static_cast<std::streamsize>(data.size()));
+            writer.close();
+            EXPECT_EQ(writer.stats().backend, backend);
+            EXPECT_EQ(writer.stats().bytes, data.size());
+        }
+        
+        AsyncFileReader reader(path, options);
+        EXPECT_EQ(reader.file_size(), data.size());
+        std::string read_back;
+        bool saw_last = false;
+        while (auto block = reader.next()) {
+            EXPECT_FALSE(saw_last);
+            saw_last = block->last;
+            read_back.append(block->data, block->size);
+            reader.release(*block);
+        }
+        EXPECT_TRUE(saw_last);
+        EXPECT_EQ(read_back, data);
+        EXPECT_EQ(reader.stats().bytes, data.size());
+        
+        { std::ofstream truncate(path, std::ios::trunc); }
+        AsyncFileReader empty(path, options);
+        EXPECT_FALSE(empty.next().has_value());
+    }
+    std::filesystem::remove(path);
+    
+    EXPECT_THROW(AsyncFileReader("/nonexistent/strgraph.txt"), std::runtime_error);
+    EXPECT_THROW({
+        [[maybe_unused]] auto backend = parse_io_backend("aio");
+    }, std::runtime_error);
+}
+
+/**
+ * Test: Streaming batch execution
+ * Test Content:
+ * - CSV input with quoted newlines and a record longer than a block
+ * - Process it block by block with small blocks and headroom
+ * - Compare with processing the whole buffer at once
+ * Expected Results:
+ * - Identical output and record counts for every backend
+ */
+TEST_F(BatchRunnerTest, StreamingMatchesMappedInput) {
+    json graph = {
+        {"nodes", json::array({
+            {{"id", "name"}, {"type", "placeholder"}},
+            {{"id", "note"}, {"type", "placeholder"}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"note", "name"})}, {"constants", json::array({";"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    
+    std::string csv = "name,note\n";
+    for (int i = 0; i < 2000; ++i) {
+        csv += std::format("n{},\"line {}\nstill, quoted\"\n", i, i);
+        if (i == 1000) {
+            csv += "long," + std::string(10000, 'x') + "\n";
+        }
+    }
+    csv += "tail,no newline";
+    
+    auto path = (std::filesystem::temp_directory_path() / "strgraph_streaming_test.csv").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << csv;
+    }
+    
+    BatchOptions options;
+    options.target_node_id = "out";
+    options.format = RecordFormat::CSV;
+    options.bindings = {{ColumnBinding::WHOLE_RECORD, "name", "name"},
+                        {ColumnBinding::WHOLE_RECORD, "note", "note"}};
+    options.chunk_records = 100;
+    BatchRunner runner(*g, options);
+    
+    std::ostringstream expected;
+    BatchStats mapped = runner.run(csv, expected);
+    
+    for (IoBackend backend : available_io_backends()) {
+        AsyncFileReader reader(path, {backend, 4096, 4, 4096});
+        std::ostringstream streamed;
+        BatchStats stats = runner.run(reader, streamed);
+        EXPECT_EQ(streamed.str(), expected.str());
+        EXPECT_EQ(stats.records, mapped.records);
+        EXPECT_EQ(stats.input_bytes, csv.size());
+    }
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// PROFILING TESTS
+// ============================================================================
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Per-node profiling and Chrome trace export
+ * Test Content:
+ * - Profile a wide graph (one layer of 300 nodes) with every strategy
+ * - Inspect the events and the exported trace
+ * - Disable profiling and run again
+ * Expected Results:
+ * - One event per operation node with its op name and byte counts
+ * - Allocations are counted (the test links the allocation hooks)
+ * - The trace holds one complete event per node event plus one per run
+ * - Nothing is recorded while profiling is disabled
+ */
+TEST_F(ProfilerTest, ProfilerRecordsNodes) {
+    const size_t width = 300;
+    json nodes = json::array({{{"id", "p"}, {"type", "placeholder"}}});
+    json parts = json::array();
+    for (size_t i = 0; i < width; ++i) {
+        std::string id = "u" + std::to_string(i);
+        nodes.push_back({{"id", id}, {"op", "to_upper"}, {"inputs", json::array({"p"})}});
+        parts.push_back(id);
+    }
+    nodes.push_back({{"id", "out"}, {"op", "concat"}, {"inputs", parts}});
+    
+    CompiledGraph compiled(Graph::from_json({{"nodes", nodes}}));
+    ASSERT_EQ(compiled.profiler(), nullptr);
+    compiled.enable_profiling();
+    Profiler& profiler = *compiled.profiler();
+    ASSERT_TRUE(alloc_tracking::installed());
+    
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL}) {
+        profiler.clear();
+        compiled.run_with_files("out", {}, {{"p", "abcd"}}, strategy);
+        
+        auto events = profiler.events();
+        ASSERT_EQ(events.size(), width + 1);
+        const NodeEvent& last = events.back();
+        EXPECT_EQ(last.node_id, "out");
+        EXPECT_EQ(last.op_name, "concat");
+        EXPECT_EQ(last.input_bytes, 4 * width);
+        EXPECT_EQ(last.output_bytes, 4 * width);
+        EXPECT_GT(last.allocations, 0);
+        for (const auto& event : events) {
+            EXPECT_LE(event.start_ns, event.end_ns);
+            if (event.op_name == "to_upper") {
+                EXPECT_EQ(event.input_bytes, 4u);
+                EXPECT_EQ(event.output_bytes, 4u);
+            }
+        }
+        
+        ASSERT_EQ(profiler.runs().size(), 1u);
+        EXPECT_EQ(profiler.runs()[0].strategy, strategy_name(strategy));
+        EXPECT_LE(profiler.runs()[0].start_ns, events.front().start_ns);
+        EXPECT_GE(profiler.runs()[0].end_ns, last.end_ns);
+        
+        auto trace = json::parse(profiler.to_chrome_trace());
+        size_t complete = 0;
+        size_t runs = 0;
+        for (const auto& event : trace["traceEvents"]) {
+            if (event["ph"] == "X" && event["cat"] == "run") {
+                ++runs;
+            } else if (event["ph"] == "X") {
+                ++complete;
+                EXPECT_TRUE(event["args"].contains("allocations"));
+            }
+        }
+        EXPECT_EQ(complete, width + 1);
+        EXPECT_EQ(runs, 1u);
+    }
+    
+    compiled.disable_profiling();
+    profiler.clear();
+    EXPECT_EQ(compiled.run("out", {{"p", "x"}}), std::string(width, 'X'));
+    EXPECT_TRUE(profiler.events().empty());
+}
+
+/**
+ * Test: Peak heap tracking
+ * Test Content:
+ * - Run a chain of 8 length-preserving nodes over a 64 KB value
+ * - Reset the peak before each strategy and read it after the run
+ * Expected Results:
+ * - The peak above the heap before the run covers all 8 retained values
+ * - The next run frees the old values first, so the peak does not grow
+ *   with the number of runs
+ */
+TEST_F(ProfilerTest, PeakLiveBytes) {
+    const size_t chain = 8;
+    const size_t size = 64 << 10;
+    json nodes = json::array({{{"id", "p"}, {"type", "placeholder"}}});
+    for (size_t i = 0; i < chain; ++i) {
+        nodes.push_back({{"id", "n" + std::to_string(i)}, {"op", i % 2 == 0 ? "to_upper" : "reverse"},
+                         {"inputs", json::array({i == 0 ? "p" : "n" + std::to_string(i - 1)})}});
+    }
+    auto g = Graph::from_json({{"nodes", nodes}});
+    Executor executor(*g);
+    const std::string value(size, 'a');
+    FeedViewDict feed = {{"p", value}};
+    ASSERT_TRUE(alloc_tracking::installed());
+
+    const std::string target = "n" + std::to_string(chain - 1);
+    const int64_t before = alloc_tracking::live_bytes();
+    alloc_tracking::reset_peak();
+    (void)executor.compute_with_strategy(ExecutionStrategy::ITERATIVE, target, feed);
+    const int64_t first_peak = alloc_tracking::peak_live_bytes() - before;
+    EXPECT_GE(first_peak, static_cast<int64_t>(chain * size));
+
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL}) {
+        alloc_tracking::reset_peak();
+        (void)executor.compute_with_strategy(strategy, target, feed);
+        EXPECT_LE(alloc_tracking::peak_live_bytes() - before, first_peak + static_cast<int64_t>(size))
+            << strategy_name(strategy);
+    }
+}
+
+/**
+ * Test: Hardware performance counters
+ * Test Content:
+ * - Enable profiling with counters around runs and nodes
+ * - Run a small graph with every strategy
+ * Expected Results:
+ * - If the kernel refuses the counters, enable_profiling() reports it
+ *   and the events still carry timings with invalid samples
+ * - Otherwise every run and node carries cycles and instructions, and
+ *   the trace exports them
+ */
+TEST_F(ProfilerTest, ProfilerHardwareCounters) {
+    CompiledGraph compiled(Graph::from_json({{"nodes", {
+        {{"id", "p"}, {"type", "placeholder"}},
+        {{"id", "u"}, {"op", "to_upper"}, {"inputs", {"p"}}},
+        {{"id", "r"}, {"op", "reverse"}, {"inputs", {"u"}}}
+    }}}));
+    const bool counting = compiled.enable_profiling(CounterLevel::NODES);
+    Profiler& profiler = *compiled.profiler();
+    EXPECT_EQ(counting, PerfCounters::supported());
+    EXPECT_EQ(profiler.counter_level(), counting ? CounterLevel::NODES : CounterLevel::OFF);
+    if (!counting) {
+        EXPECT_FALSE(PerfCounters::for_this_thread().unavailable_reason().empty());
+        EXPECT_FALSE(PerfCounters::for_this_thread().read().valid());
+    }
+    
+    const std::string input(4096, 'a');
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL}) {
+        profiler.clear();
+        EXPECT_EQ(compiled.run_with_files("r", {}, {{"p", input}}, strategy), std::string(4096, 'A'));
+        
+        auto events = profiler.events();
+        ASSERT_EQ(events.size(), 2u);
+        ASSERT_EQ(profiler.runs().size(), 1u);
+        const RunEvent& run = profiler.runs()[0];
+        EXPECT_EQ(run.counters.valid(), counting);
+        for (const auto& event : events) {
+            EXPECT_EQ(event.counters.valid(), counting);
+        }
+        if (counting) {
+            EXPECT_GT(run.counters.cycles, 0);
+            EXPECT_GT(run.counters.instructions, 0);
+            EXPECT_GT(run.counters.ipc(), 0.0);
+            for (const auto& event : events) {
+                EXPECT_GE(event.counters.instructions, 0);
+            }
+            auto trace = json::parse(profiler.to_chrome_trace());
+            for (const auto& event : trace["traceEvents"]) {
+                if (event["ph"] == "X" && event["cat"] != "layer") {
+                    EXPECT_TRUE(event["args"].contains("cycles"));
+                }
+            }
+        }
+    }
+    
+    // Per-run counting leaves the nodes unsampled
+    compiled.enable_profiling(CounterLevel::RUNS);
+    profiler.clear();
+    compiled.run("r", {{"p", "x"}});
+    ASSERT_EQ(profiler.events().size(), 2u);
+    EXPECT_FALSE(profiler.events()[0].counters.valid());
+    EXPECT_EQ(profiler.runs()[0].counters.valid(), counting);
+}
+
+/**
+ * Test: Parallel layer threshold and layer events
+ * Test Content:
+ * - Run a 3-layer graph with the parallel strategy, profiled, with the
+ *   default threshold, with every layer parallel and with none
+ * Expected Results:
+ * - The threshold defaults to MIN_PARALLEL_LAYER_SIZE and is settable
+ * - Every non-empty layer is recorded with its width, in order
+ * - Layers below the threshold run on one thread, others on the team
+ * - EXPLAIN reports the threshold in effect
+ * - Results do not depend on the threshold
+ */
+TEST_F(ProfilerTest, ParallelLayerThreshold) {
+    const size_t width = 32;
+    json nodes = json::array({{{"id", "p"}, {"type", "placeholder"}}});
+    json parts = json::array();
+    for (size_t i = 0; i < width; ++i) {
+        std::string id = "u" + std::to_string(i);
+        nodes.push_back({{"id", id}, {"op", "to_upper"}, {"inputs", json::array({"p"})}});
+        parts.push_back(id);
+    }
+    nodes.push_back({{"id", "out"}, {"op", "concat"}, {"inputs", parts}});
+    auto graph = Graph::from_json({{"nodes", nodes}});
+    Executor executor(*graph);
+    EXPECT_EQ(executor.min_parallel_layer_size(), Executor::MIN_PARALLEL_LAYER_SIZE);
+
+    Profiler profiler;
+    executor.set_profiler(&profiler);
+    const std::string expected(2 * width, 'A');
+    for (size_t threshold : {Executor::MIN_PARALLEL_LAYER_SIZE, size_t{1}, std::numeric_limits<size_t>::max()}) {
+        executor.set_min_parallel_layer_size(threshold);
+        profiler.clear();
+        EXPECT_EQ(executor.compute_parallel("out", {{"p", "aa"}}), expected);
+
+        const auto& layers = profiler.layers();
+        ASSERT_EQ(layers.size(), 3u);
+        EXPECT_EQ(layers[0].width, 1u);
+        EXPECT_EQ(layers[1].width, width);
+        EXPECT_EQ(layers[2].width, 1u);
+        for (const auto& layer : layers) {
+            EXPECT_LE(layer.start_ns, layer.end_ns);
+#ifdef USE_OPENMP
+            if (layer.width >= threshold) {
+                EXPECT_GE(layer.threads, 1u);
+                EXPECT_LE(layer.threads, static_cast<size_t>(omp_get_max_threads()));
+            } else {
+                EXPECT_EQ(layer.threads, 1u);
+            }
+#else
+            EXPECT_EQ(layer.threads, 1u);
+#endif
+        }
+        auto plan = executor.explain("out", ExecutionStrategy::PARALLEL);
+        EXPECT_NE(plan.optimizations.back().find(std::format("below {} nodes", threshold)), std::string::npos);
+    }
+}
+
+/**
+ * Test: Phase timings of execute()
+ * Test Content:
+ * - Execute a graph from JSON with a timings struct, recursively and auto
+ * Expected Results:
+ * - The result is unchanged
+ * - Parsing, building and executing are each timed
+ */
+TEST_F(ProfilerTest, ExecuteReportsPhaseTimings) {
+    json graph = {
+        {"nodes", {
+            {{"id", "p"}, {"type", "placeholder"}},
+            {{"id", "u"}, {"op", "to_upper"}, {"inputs", {"p"}}}
+        }},
+        {"target_node", "u"}
+    };
+    ExecuteTimings timings;
+    EXPECT_EQ(execute(graph.dump(), {{"p", "abc"}}, &timings), "ABC");
+    EXPECT_GT(timings.parse_ns, 0u);
+    EXPECT_GT(timings.build_ns, 0u);
+    EXPECT_GT(timings.execute_ns, 0u);
+
+    ExecuteTimings auto_timings;
+    EXPECT_EQ(execute_auto(graph.dump(), {{"p", "xyz"}}, &auto_timings), "XYZ");
+    EXPECT_GT(auto_timings.execute_ns, 0u);
+}
+
+// ============================================================================
+// EXPLAIN TESTS
+// ============================================================================
+
+class ExplainTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: EXPLAIN and EXPLAIN ANALYZE
+ * Test Content:
+ * - Explain a small chain and a wide fan-out with the automatic strategy
+ * - Explain with a forced strategy
+ * - Analyze the fan-out
+ * Expected Results:
+ * - The explained strategy is the one compute_auto() runs, with reasons
+ * - Nodes are in topological order and grouped into layers
+ * - Concat estimates add up the sizes of their inputs
+ * - Unreachable nodes are reported as pruned
+ * - ANALYZE annotates every operation with its time and bytes
+ * - Text and JSON renderings describe the same plan
+ */
+TEST_F(ExplainTest, ExplainPlans) {
+    CompiledGraph chain(Graph::from_json({{"nodes", {
+        {{"id", "p"}, {"type", "placeholder"}},
+        {{"id", "sep"}, {"type", "constant"}, {"value", "--"}},
+        {{"id", "u"}, {"op", "to_upper"}, {"inputs", {"p"}}},
+        {{"id", "c"}, {"op", "concat"}, {"inputs", {"u", "sep", "p"}}},
+        {{"id", "unused"}, {"op", "reverse"}, {"inputs", {"p"}}}
+    }}}));
+    Explanation plan = chain.explain("c", ExecutionStrategy::AUTO, {{"p", "abcdef"}});
+    EXPECT_EQ(plan.decision.strategy, ExecutionStrategy::RECURSIVE);
+    EXPECT_EQ(plan.decision.node_count, 4u);
+    EXPECT_FALSE(plan.decision.reasons.empty());
+    EXPECT_EQ(plan.graph_nodes, 5u);
+    ASSERT_EQ(plan.nodes.size(), 4u);
+    EXPECT_EQ(plan.nodes.back().id, "c");
+    EXPECT_EQ(plan.nodes.back().estimated_bytes, 6u + 2u + 6u);
+    ASSERT_EQ(plan.layers.size(), 3u);
+    EXPECT_EQ(plan.nodes[plan.layers[2][0]].id, "c");
+    EXPECT_NE(plan.to_text().find("pruning: 1 of 5"), std::string::npos);
+    EXPECT_FALSE(plan.analyzed);
+
+    auto forced = chain.explain("c", ExecutionStrategy::ITERATIVE);
+    EXPECT_EQ(forced.decision.requested, ExecutionStrategy::ITERATIVE);
+    EXPECT_EQ(forced.decision.strategy, ExecutionStrategy::ITERATIVE);
+    EXPECT_EQ(forced.nodes.back().estimated_bytes,
+              2 * Explanation::ESTIMATED_PLACEHOLDER_BYTES + 2);
+
+    const size_t width = 600;
+    json nodes = json::array({{{"id", "p"}, {"type", "placeholder"}}});
+    json parts = json::array();
+    for (size_t i = 0; i < width; ++i) {
+        std::string id = "u" + std::to_string(i);
+        nodes.push_back({{"id", id}, {"op", "to_upper"}, {"inputs", json::array({"p"})}});
+        parts.push_back(id);
+    }
+    nodes.push_back({{"id", "out"}, {"op", "concat"}, {"inputs", parts}});
+    auto wide_graph = Graph::from_json({{"nodes", nodes}});
+    Executor executor(*wide_graph);
+
+    Explanation wide = executor.explain_analyze("out", {{"p", "ab"}});
+    EXPECT_EQ(wide.decision.max_layer_width, width);
+#ifdef USE_OPENMP
+    EXPECT_EQ(wide.decision.strategy, ExecutionStrategy::PARALLEL);
+#else
+    EXPECT_EQ(wide.decision.strategy, ExecutionStrategy::ITERATIVE);
+#endif
+    EXPECT_TRUE(wide.analyzed);
+    EXPECT_GT(wide.total_ns, 0u);
+    for (const auto& node : wide.nodes) {
+        if (node.type == NodeType::OPERATION) {
+            ASSERT_TRUE(node.actual_ns.has_value()) << node.id;
+            EXPECT_EQ(node.output_bytes, node.id == "out" ? 2 * width : 2u);
+        } else {
+            EXPECT_FALSE(node.actual_ns.has_value());
+        }
+    }
+    EXPECT_EQ(executor.profiler(), nullptr);
+
+    auto report = json::parse(wide.to_json());
+    EXPECT_EQ(report["strategy"]["chosen"], strategy_name(wide.decision.strategy));
+    EXPECT_EQ(report["nodes"].size(), width + 2);
+    EXPECT_EQ(report["layers"].size(), 3u);
+    EXPECT_TRUE(report["analyzed"].get<bool>());
+    EXPECT_NE(wide.to_text().find("EXPLAIN ANALYZE out"), std::string::npos);
+}
+
+// ============================================================================
+// METRICS TESTS
+// ============================================================================
+
+class MetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Engine metrics and Prometheus export
+ * Test Content:
+ * - Update a counter and a histogram from several threads
+ * - Run a named graph with every strategy, then make an operation throw
+ * - Export the registry in the Prometheus text format
+ * Expected Results:
+ * - Sharded values sum up exactly; histogram buckets are powers of two
+ * - Runs are counted per graph and resolved strategy, with latencies,
+ *   nodes executed, bytes produced and the failing op
+ * - The exposition contains HELP/TYPE lines and cumulative buckets
+ */
+TEST_F(MetricsTest, MetricsRecordRuns) {
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    Counter& counter = registry.counter("strgraph_test_events_total", "Test counter", {{"kind", "a\"b"}});
+    Histogram& histogram = registry.histogram("strgraph_test_sizes", "Test histogram");
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (uint64_t i = 0; i < 1000; ++i) {
+                    counter.add();
+                    histogram.observe(i % 8);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+    }
+    EXPECT_EQ(counter.value(), 4000u);
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 4000u);
+    EXPECT_EQ(snapshot.counts[0], 500u);    // 0
+    EXPECT_EQ(snapshot.counts[1], 500u);    // 1
+    EXPECT_EQ(snapshot.counts[2], 1000u);   // 2-3
+    EXPECT_EQ(snapshot.counts[3], 2000u);   // 4-7
+    EXPECT_THROW(registry.histogram("strgraph_test_events_total", "Wrong type"), std::runtime_error);
+    
+    json graph = {
+        {"name", "metrics_test"},
+        {"nodes", json::array({
+            {{"id", "p"}, {"type", "placeholder"}},
+            {{"id", "u"}, {"op", "to_upper"}, {"inputs", json::array({"p"})}},
+            {{"id", "c"}, {"op", "concat"}, {"inputs", json::array({"u", "p"})}},
+            {{"id", "bad"}, {"op", "substring"}, {"inputs", json::array({"p"})}, {"constants", json::array({"x", "1"})}}
+        })}
+    };
+    auto g = Graph::from_json(graph);
+    EXPECT_EQ(g->name(), "metrics_test");
+    
+    Counter& parallel_runs = registry.counter(
+        "strgraph_runs_total", "", {{"graph", "metrics_test"}, {"strategy", "parallel"}});
+    Counter& failures = registry.counter("strgraph_run_failures_total", "", {{"graph", "metrics_test"}});
+    Counter& op_errors = registry.counter("strgraph_op_exceptions_total", "", {{"op", "substring"}});
+    Counter& nodes = registry.counter("strgraph_nodes_executed_total", "");
+    Counter& bytes = registry.counter("strgraph_bytes_produced_total", "");
+    const uint64_t runs_before = parallel_runs.value();
+    const uint64_t failures_before = failures.value();
+    const uint64_t op_errors_before = op_errors.value();
+    const uint64_t nodes_before = nodes.value();
+    const uint64_t bytes_before = bytes.value();
+    
+    Executor executor(*g);
+    EXPECT_EQ(executor.compute_parallel("c", {{"p", "ab"}}), "ABab");
+    EXPECT_EQ(executor.compute_auto("c", {{"p", "ab"}}), "ABab");
+    EXPECT_EQ(parallel_runs.value(), runs_before + 1);
+    EXPECT_EQ(nodes.value(), nodes_before + 4);
+    EXPECT_EQ(bytes.value(), bytes_before + 12);
+    EXPECT_THROW([[maybe_unused]] auto& r = executor.compute("bad", {{"p", "ab"}}), std::runtime_error);
+    EXPECT_EQ(failures.value(), failures_before + 1);
+    EXPECT_EQ(op_errors.value(), op_errors_before + 1);
+    
+    std::string text;
+    registry.export_prometheus([&](std::string_view exposition) { text = exposition; });
+    EXPECT_NE(text.find("# TYPE strgraph_runs_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find(std::format("strgraph_runs_total{{graph=\"metrics_test\",strategy=\"parallel\"}} {}\n",
+                                    parallel_runs.value())), std::string::npos);
+    EXPECT_NE(text.find("strgraph_test_events_total{kind=\"a\\\"b\"} 4000\n"), std::string::npos);
+    EXPECT_NE(text.find("strgraph_test_sizes_bucket{le=\"3\"} 2000\n"), std::string::npos);
+    EXPECT_NE(text.find("strgraph_test_sizes_bucket{le=\"+Inf\"} 4000\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE strgraph_run_duration_seconds histogram\n"), std::string::npos);
+    EXPECT_NE(text.find("strgraph_parallel_layer_width_count"), std::string::npos);
+}
+
+// ============================================================================
+// GRAPH GENERATOR TESTS
+// ============================================================================
+
+class GraphGeneratorTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Synthetic graph generation
+ * Test Content:
+ * - Generate a diamond-shaped graph with hubs and split nodes as JSON
+ *   and as binary, twice with the same seed and once with another
+ * - Run the target with every strategy
+ * - Pass inconsistent options
+ * Expected Results:
+ * - The same seed gives byte-identical output, another seed does not
+ * - JSON and binary describe the same nodes as generate_graph()
+ * - At least the requested operation nodes, all reachable from the target
+ * - Every strategy computes the same value of the value size
+ * - Inconsistent options throw
+ */
+TEST_F(GraphGeneratorTest, GeneratedGraphs) {
+    generator::Options options;
+    options.nodes = 400;
+    options.depth = 8;
+    options.width = generator::WidthProfile::DIAMOND;
+    options.placeholders = 2;
+    options.lookback = 2;
+    options.hub_ratio = 0.1;
+    options.multi_output_ratio = 0.2;
+    options.value_size = 32;
+    options.seed = 7;
+
+    std::ostringstream json_text, json_again, binary_data;
+    generator::Summary summary = generator::write_json(options, json_text);
+    generator::write_json(options, json_again);
+    generator::write_binary(options, binary_data);
+    EXPECT_EQ(json_text.str(), json_again.str());
+
+    generator::Options reseeded = options;
+    reseeded.seed = 8;
+    std::ostringstream other;
+    generator::write_json(reseeded, other);
+    EXPECT_NE(json_text.str(), other.str());
+
+    EXPECT_GE(summary.operation_nodes, options.nodes);
+    EXPECT_GT(summary.split_nodes, 0u);
+    EXPECT_EQ(summary.placeholder_ids, (std::vector<std::string>{"p0", "p1"}));
+
+    auto from_json = Graph::from_json(json::parse(json_text.str()));
+    auto from_binary = Graph::from_binary(binary_data.str());
+    auto in_memory = generator::generate_graph(options);
+    ASSERT_EQ(from_json->get_nodes().size(), summary.total_nodes);
+    ASSERT_EQ(from_binary->get_nodes().size(), summary.total_nodes);
+    ASSERT_EQ(in_memory->get_nodes().size(), summary.total_nodes);
+    for (const auto& [id, node] : in_memory->get_nodes()) {
+        for (Graph* other_graph : {from_json.get(), from_binary.get()}) {
+            const Node& copy = other_graph->get_node(id);
+            EXPECT_EQ(copy.type, node.type) << id;
+            EXPECT_EQ(copy.op_name, node.op_name) << id;
+            EXPECT_EQ(copy.input_ids, node.input_ids) << id;
+            EXPECT_EQ(copy.constants, node.constants) << id;
+        }
+    }
+
+    CompiledGraph compiled(std::move(from_binary));
+    std::string value = generator::make_value(options.value_size, 1);
+    FeedDict feed = {{"p0", value}, {"p1", value}};
+    Explanation plan = compiled.explain(std::string(generator::Summary::TARGET), ExecutionStrategy::AUTO, feed);
+    EXPECT_EQ(plan.decision.node_count, summary.total_nodes);
+
+    Executor executor(*in_memory);
+    std::string expected = executor.compute_with_strategy(
+        ExecutionStrategy::RECURSIVE, std::string(generator::Summary::TARGET), feed);
+    EXPECT_EQ(expected.size(), options.value_size);
+    for (auto strategy : {ExecutionStrategy::ITERATIVE, ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        EXPECT_EQ(executor.compute_with_strategy(strategy, std::string(generator::Summary::TARGET), feed), expected);
+    }
+
+    generator::Options invalid = options;
+    invalid.min_fan_in = 4;
+    EXPECT_THROW(generator::generate_graph(invalid), std::runtime_error);
+    invalid = options;
+    invalid.multi_output_ratio = 1.5;
+    EXPECT_THROW(generator::generate_graph(invalid), std::runtime_error);
+    EXPECT_THROW(generator::parse_width_profile("square"), std::runtime_error);
+}
+
+// ============================================================================
+// TRAFFIC RECORDING TESTS
+// ============================================================================
+
+class TrafficRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Traffic recording
+ * Test Content:
+ * - Record run() and run_auto() calls of a CompiledGraph, including a
+ *   call that fails, then read the log back
+ * - Record with a sample rate of 0 and with a record limit
+ * Expected Results:
+ * - One record per call with graph id, target, strategy, sorted feeds,
+ *   increasing timestamps and the size and hash of the result
+ * - The failing call is recorded with its error and still throws
+ * - Nothing is recorded at rate 0; no more than max_records otherwise
+ */
+TEST_F(TrafficRecorderTest, TrafficRecording) {
+    json graph = {
+        {"name", "greeting"},
+        {"nodes", json::array({
+            {{"id", "a"}, {"type", "placeholder"}},
+            {{"id", "b"}, {"type", "placeholder"}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"a", "b"})}}
+        })}
+    };
+    auto path = (std::filesystem::temp_directory_path() / "strgraph_traffic_test.log").string();
+    {
+        CompiledGraph compiled(graph.dump());
+        auto recorder = std::make_shared<TrafficRecorder>(path);
+        compiled.enable_recording(recorder);
+        EXPECT_EQ(compiled.run("out", {{"b", "world"}, {"a", "hello "}}), "hello world");
+        EXPECT_EQ(compiled.run_auto("out", {{"a", "x"}, {"b", "y"}}), "xy");
+        EXPECT_THROW((void)compiled.run("out", {{"a", "x"}}), std::runtime_error);
+        compiled.disable_recording();
+        EXPECT_EQ(compiled.run("out", {{"a", "not "}, {"b", "recorded"}}), "not recorded");
+        EXPECT_EQ(recorder->records(), 3u);
+    }
+
+    auto records = TrafficRecorder::read(path);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(records[0].graph_id, "greeting");
+    EXPECT_EQ(records[0].target, "out");
+    EXPECT_EQ(records[0].strategy, "recursive");
+    using Feeds = std::vector<std::pair<std::string, std::string>>;
+    EXPECT_EQ(records[0].feeds, (Feeds{{"a", "hello "}, {"b", "world"}}));
+    EXPECT_EQ(records[0].result_size, 11u);
+    EXPECT_EQ(records[0].result_hash, TrafficRecorder::hash("hello world"));
+    EXPECT_TRUE(records[0].error.empty());
+    EXPECT_EQ(records[1].strategy, "auto");
+    EXPECT_EQ(records[1].result_hash, TrafficRecorder::hash("xy"));
+    EXPECT_LE(records[0].timestamp_ns, records[1].timestamp_ns);
+    EXPECT_LE(records[1].timestamp_ns, records[2].timestamp_ns);
+    EXPECT_FALSE(records[2].error.empty());
+
+    {
+        CompiledGraph compiled(graph.dump());
+        auto never = std::make_shared<TrafficRecorder>(path, RecorderOptions{.sample_rate = 0.0});
+        compiled.enable_recording(never, "other");
+        (void)compiled.run("out", {{"a", "1"}, {"b", "2"}});
+    }
+    EXPECT_TRUE(TrafficRecorder::read(path).empty());
+
+    {
+        CompiledGraph compiled(graph.dump());
+        compiled.enable_recording(std::make_shared<TrafficRecorder>(path, RecorderOptions{.max_records = 2}), "other");
+        for (int i = 0; i < 5; ++i) {
+            (void)compiled.run("out", {{"a", "1"}, {"b", "2"}});
+        }
+    }
+    records = TrafficRecorder::read(path);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[1].graph_id, "other");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// FLIGHT RECORDER TESTS
+// ============================================================================
+
+class FlightRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Flight recorder
+ * Test Content:
+ * - Enable the flight recorder with a threshold of 0, so every run is
+ *   slow, and with a threshold no run reaches
+ * - Use a ring smaller than the run and a dump limit
+ * - Profile a run while the flight recorder is enabled
+ * Expected Results:
+ * - A slow run writes a Chrome trace with one event per operation, the
+ *   run's strategy, latency and feed sizes; fast runs write nothing
+ * - Operations that did not fit in the ring are counted as dropped
+ * - A profiled run is recorded by both
+ * - No more than max_dumps traces are written
+ */
+TEST_F(FlightRecorderTest, FlightRecorder) {
+    json graph = {
+        {"name", "slow graph"},
+        {"nodes", json::array({
+            {{"id", "a"}, {"type", "placeholder"}},
+            {{"id", "b"}, {"type", "placeholder"}},
+            {{"id", "ab"}, {"op", "concat"}, {"inputs", json::array({"a", "b"})}},
+            {{"id", "ba"}, {"op", "reverse"}, {"inputs", json::array({"ab"})}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", json::array({"ab", "ba"})}}
+        })}
+    };
+    auto dir = std::filesystem::temp_directory_path() / "strgraph_flight_test";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+
+    CompiledGraph compiled(graph.dump());
+    compiled.enable_flight_recorder({.threshold_ns = 0, .trace_dir = dir.string()});
+    EXPECT_EQ(compiled.run("out", {{"a", "xy"}, {"b", "z"}}), "xyzzyx");
+    ASSERT_EQ(compiled.flight_recorder()->dumps().size(), 1u);
+
+    std::ifstream file(compiled.flight_recorder()->dumps()[0]);
+    json trace = json::parse(file);
+    std::set<std::string> nodes;
+    json run;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] != "X") {
+            continue;
+        }
+        if (event["cat"] == "run") {
+            run = event;
+        } else {
+            nodes.insert(event["name"].get<std::string>());
+            EXPECT_GE(event["dur"].get<double>(), 0.0);
+        }
+    }
+    EXPECT_EQ(nodes, (std::set<std::string>{"ab", "ba", "out"}));
+    ASSERT_TRUE(run.is_object());
+    EXPECT_EQ(run["args"]["strategy"], "recursive");
+    EXPECT_EQ(run["args"]["graph"], "slow graph");
+    EXPECT_EQ(run["args"]["feed_bytes"]["a"], 2);
+    EXPECT_EQ(run["args"]["feed_bytes"]["b"], 1);
+    EXPECT_EQ(run["args"]["dropped_events"], 0);
+
+    compiled.flight_recorder()->set_threshold_ns(std::numeric_limits<uint64_t>::max());
+    (void)compiled.run_auto("out", {{"a", "1"}, {"b", "2"}});
+    EXPECT_EQ(compiled.flight_recorder()->dumps().size(), 1u);
+    EXPECT_EQ(compiled.flight_recorder()->runs(), 2u);
+
+    compiled.enable_flight_recorder({.threshold_ns = 0, .events_per_thread = 2,
+                                     .trace_dir = dir.string(), .max_dumps = 1});
+    for (int i = 0; i < 3; ++i) {
+        (void)compiled.run("out", {{"a", "1"}, {"b", "2"}});
+    }
+    ASSERT_EQ(compiled.flight_recorder()->dumps().size(), 1u);
+    std::ifstream small_file(compiled.flight_recorder()->dumps()[0]);
+    trace = json::parse(small_file);
+    size_t operations = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X" && event["cat"] == "run") {
+            EXPECT_EQ(event["args"]["dropped_events"], 1);
+        } else if (event["ph"] == "X") {
+            ++operations;
+        }
+    }
+    EXPECT_EQ(operations, 2u);
+
+    // Profiling does not keep operations out of the flight recorder
+    compiled.enable_flight_recorder({.threshold_ns = 0, .trace_dir = dir.string(), .max_dumps = 1});
+    compiled.enable_profiling();
+    (void)compiled.run("ba", {{"a", "1"}, {"b", "2"}});
+    compiled.disable_profiling();
+    ASSERT_EQ(compiled.flight_recorder()->dumps().size(), 1u);
+    std::ifstream profiled_file(compiled.flight_recorder()->dumps()[0]);
+    trace = json::parse(profiled_file);
+    operations = 0;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "X" && event["cat"] != "run") {
+            ++operations;
+        }
+    }
+    EXPECT_EQ(operations, 2u);
+    EXPECT_EQ(compiled.profiler()->events().size(), 2u);
+
+    compiled.disable_flight_recorder();
+    (void)compiled.run("out", {{"a", "1"}, {"b", "2"}});
+    EXPECT_EQ(compiled.flight_recorder()->runs(), 1u);
+
+    std::filesystem::remove_all(dir);
+}
+
+// ============================================================================
+// PLANNING TESTS
+// ============================================================================
+
+class PlanningTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Topological layers of large and deep graphs
+ * Test Content:
+ * - Plan a generated graph well above MIN_PARALLEL_PLAN_NODES with one
+ *   thread and with all threads
+ * - Plan and run a chain of 100,000 nodes
+ * - Close a cycle in the generated graph
+ * Expected Results:
+ * - Every node reachable from the target is in exactly one layer, one
+ *   layer below its deepest input, and the layers are the same for any
+ *   thread count
+ * - The chain has one node per layer and runs iteratively without
+ *   overflowing the stack
+ * - The cycle throws
+ */
+TEST_F(PlanningTest, TopologicalLayersAtScale) {
+    generator::Options options;
+    options.nodes = 4 * Executor::MIN_PARALLEL_PLAN_NODES;
+    options.depth = 16;
+    options.lookback = 3;
+    options.hub_ratio = 0.05;
+    options.multi_output_ratio = 0.1;
+    auto graph = generator::generate_graph(options);
+    Executor executor(*graph);
+    const std::string target(generator::Summary::TARGET);
+
+    auto layers = executor.topological_layers(target);
+    std::unordered_map<const Node*, size_t> level;
+    for (size_t l = 0; l < layers.size(); ++l) {
+        for (const Node* node : layers[l]) {
+            EXPECT_TRUE(level.emplace(node, l).second) << node->id;
+        }
+    }
+    EXPECT_EQ(level.size(), graph->get_nodes().size());
+    for (const auto& [node, l] : level) {
+        size_t expected = 0;
+        for (const auto& input_id : node->input_ids) {
+            const Node* input = &graph->get_node(input_id.substr(0, input_id.find(':')));
+            ASSERT_TRUE(level.contains(input)) << node->id;
+            expected = std::max(expected, level[input] + 1);
+        }
+        EXPECT_EQ(l, expected) << node->id;
+    }
+#ifdef USE_OPENMP
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    EXPECT_EQ(executor.topological_layers(target), layers);
+    omp_set_num_threads(threads);
+#endif
+
+    const size_t length = 100'000;
+    json nodes = json::array();
+    nodes.push_back({{"id", "n0"}, {"value", "chain"}});
+    for (size_t i = 1; i <= length; ++i) {
+        nodes.push_back({{"id", "n" + std::to_string(i)}, {"op", "identity"},
+                         {"inputs", json::array({"n" + std::to_string(i - 1)})}});
+    }
+    auto chain = Graph::from_json({{"nodes", nodes}});
+    Executor chain_executor(*chain);
+    auto chain_layers = chain_executor.topological_layers("n" + std::to_string(length));
+    ASSERT_EQ(chain_layers.size(), length + 1);
+    EXPECT_EQ(chain_layers.front(), std::vector<Node*>{&chain->get_node("n0")});
+    EXPECT_EQ(chain_executor.compute_iterative("n" + std::to_string(length)), "chain");
+
+    Node& first = *layers[1].front();
+    first.input_ids.push_back(target);
+    EXPECT_THROW((void)executor.topological_layers(target), std::runtime_error);
+    EXPECT_THROW((void)executor.topological_sort(), std::runtime_error);
+}
+
+// ============================================================================
+// GRAPH LOADING TESTS
+// ============================================================================
+
+class GraphLoadingTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Loading JSON graph text in parallel chunks
+ * Test Content:
+ * - Load a generated graph of many chunks with from_json_text(), with
+ *   one thread and with all threads
+ * - Load a small document with escaped quotes and brackets in strings,
+ *   a nested "nodes" key and "nodes" not the first field
+ * - Load documents with a duplicate id, an invalid node, malformed JSON
+ *   and a non-object top level
+ * Expected Results:
+ * - The graphs equal from_json() of the parsed document, node by node,
+ *   and the other top-level fields are returned
+ * - Duplicate ids throw in from_json_text() and from_json()
+ * - An invalid node reports the same error as from_json(); malformed
+ *   documents throw
+ */
+TEST_F(GraphLoadingTest, JsonTextLoading) {
+    auto expect_same = [](const Graph& actual, const Graph& expected) {
+        ASSERT_EQ(actual.get_nodes().size(), expected.get_nodes().size());
+        EXPECT_EQ(actual.name(), expected.name());
+        for (const auto& [id, node] : expected.get_nodes()) {
+            auto it = actual.get_nodes().find(id);
+            ASSERT_NE(it, actual.get_nodes().end()) << id;
+            EXPECT_EQ(it->second.type, node.type) << id;
+            EXPECT_EQ(it->second.op_name, node.op_name) << id;
+            EXPECT_EQ(it->second.initial_value, node.initial_value) << id;
+            EXPECT_EQ(it->second.input_ids, node.input_ids) << id;
+            EXPECT_EQ(it->second.constants, node.constants) << id;
+        }
+    };
+
+    generator::Options options;
+    options.nodes = 20 * Graph::MIN_LOAD_CHUNK_NODES;
+    options.placeholders = 2;
+    options.multi_output_ratio = 0.1;
+    options.name = "loaded";
+    std::ostringstream text;
+    generator::write_json(options, text);
+    auto expected = Graph::from_json(json::parse(text.str()));
+
+    json fields;
+    auto loaded = Graph::from_json_text(text.str(), &fields);
+    expect_same(*loaded, *expected);
+    EXPECT_EQ(fields, (json{{"name", "loaded"}, {"target_node", "out"}}));
+#ifdef USE_OPENMP
+    int threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    expect_same(*Graph::from_json_text(text.str()), *expected);
+    omp_set_num_threads(threads);
+#endif
+
+    std::string tricky = R"( { "meta": {"nodes": [1, 2]}, "nodes" : [
+        {"id": "a\"]", "value": "[{\"x\"}]"},
+        {"id": "b", "op": "replace", "inputs": ["a\"]"], "constants": ["]", "\\"]},
+        {"id": "p", "type": "placeholder", "extra": {"nodes": []}}
+    ], "target_node": "b" } )";
+    fields = json();
+    expect_same(*Graph::from_json_text(tricky, &fields), *Graph::from_json(json::parse(tricky)));
+    EXPECT_EQ(fields["target_node"], "b");
+    EXPECT_EQ(fields["meta"]["nodes"], json::array({1, 2}));
+    EXPECT_FALSE(fields.contains("nodes"));
+
+    std::string duplicate = R"({"nodes": [{"id": "a", "value": "1"}, {"id": "a", "value": "2"}]})";
+    EXPECT_THROW(Graph::from_json_text(duplicate), std::runtime_error);
+    EXPECT_THROW(Graph::from_json(json::parse(duplicate)), std::runtime_error);
+
+    json invalid = json::parse(text.str());
+    invalid["nodes"][3 * Graph::MIN_LOAD_CHUNK_NODES] = {{"id", "bad"}, {"type", "square"}};
+    invalid["nodes"][5 * Graph::MIN_LOAD_CHUNK_NODES] = {{"id", "worse"}};
+    std::string message;
+    try {
+        (void)Graph::from_json(invalid);
+    } catch (const std::runtime_error& e) {
+        message = e.what();
+    }
+    EXPECT_EQ(message, "Unknown node type 'square' for node 'bad'");
+    try {
+        (void)Graph::from_json_text(invalid.dump());
+        ADD_FAILURE() << "invalid node loaded";
+    } catch (const std::runtime_error& e) {
+        EXPECT_EQ(std::string(e.what()), message);
+    }
+
+    EXPECT_ANY_THROW(Graph::from_json_text(R"({"nodes": [{"id": "a", "value": "1"},]})"));
+    EXPECT_ANY_THROW(Graph::from_json_text(R"({"nodes": [{"id": "a", "value": "1"}])"));
+    EXPECT_ANY_THROW(Graph::from_json_text(R"({"nodes": [{"id": "a" "value": "1"}]})"));
+    EXPECT_ANY_THROW(Graph::from_json_text(R"([{"id": "a", "value": "1"}])"));
+    EXPECT_ANY_THROW(Graph::from_json_text(R"({"nodes": [], "name": })"));
+}
+
+/**
+ * Test: Loading only the subgraph reachable from some targets
+ * Test Content:
+ * - Load a generated graph from its JSON text and its binary form with a
+ *   few targets, one of them with an output index
+ * - Load small documents with an invalid or duplicate unreached node, an
+ *   escaped id, an unknown input, a missing target and an element the
+ *   index cannot use
+ * Expected Results:
+ * - Exactly the nodes reachable from the targets are loaded, equal to
+ *   the whole graph's, and the targets compute the same values
+ * - Unreached nodes are not validated but duplicate ids still throw;
+ *   escaped ids resolve; unknown inputs are kept for the run to report;
+ *   a missing target throws; unindexable documents load and are pruned
+ */
+TEST_F(GraphLoadingTest, ReachableLoading) {
+    generator::Options options;
+    options.nodes = 8 * Graph::MIN_LOAD_CHUNK_NODES;
+    options.placeholders = 1;
+    options.multi_output_ratio = 0.1;
+    std::ostringstream text;
+    generator::Summary summary = generator::write_json(options, text);
+    auto whole = Graph::from_json_text(text.str());
+
+    // Single-output targets in the middle of the graph, and a multi-output one by index
+    auto single_output = [&](size_t index) {
+        while (whole->get_node(std::format("n{}", index)).op_name == "split") {
+            ++index;
+        }
+        return std::format("n{}", index);
+    };
+    std::vector<std::string> targets{single_output(700), single_output(1200)};
+    for (const auto& [id, node] : whole->get_nodes()) {
+        if (node.op_name == "split") {
+            targets.push_back(id + ":0");
+            break;
+        }
+    }
+    std::set<std::string> expected;
+    std::vector<std::string> stack;
+    for (const auto& target : targets) {
+        stack.push_back(target.substr(0, target.find(':')));
+    }
+    while (!stack.empty()) {
+        std::string id = stack.back();
+        stack.pop_back();
+        if (expected.insert(id).second) {
+            for (const auto& input : whole->get_node(id).input_ids) {
+                stack.push_back(input.substr(0, input.find(':')));
+            }
+        }
+    }
+    ASSERT_LT(expected.size(), whole->get_nodes().size());
+
+    std::unordered_map<std::string, std::string> feeds;
+    for (const auto& id : summary.placeholder_ids) {
+        feeds[id] = "Hello, World";
+    }
+    Executor whole_executor(*whole);
+    json fields;
+    std::unique_ptr<Graph> loaded[] = {Graph::from_json_text(text.str(), targets, &fields),
+                                       Graph::from_binary(whole->to_binary(), targets)};
+    for (const auto& reached : loaded) {
+        ASSERT_EQ(reached->get_nodes().size(), expected.size());
+        for (const auto& id : expected) {
+            const Node& node = reached->get_node(id);
+            EXPECT_EQ(node.op_name, whole->get_node(id).op_name) << id;
+            EXPECT_EQ(node.input_ids, whole->get_node(id).input_ids) << id;
+        }
+        Executor executor(*reached);
+        for (const auto& target : {targets[0], targets[1]}) {
+            EXPECT_EQ(executor.compute(target, feeds), whole_executor.compute(target, feeds)) << target;
+        }
+    }
+    EXPECT_EQ(fields["target_node"], "out");
+
+    std::string document = R"({"name": "small", "nodes": [
+        {"id": "bad", "type": "square"},
+        {"id": "q\"d", "value": "x"},
+        {"id": "a", "op": "reverse", "inputs": ["q\"d"]},
+        {"id": "b", "op": "concat", "inputs": ["a", "nowhere"]}
+    ]})";
+    const std::vector<std::string> a{"a"};
+    auto small = Graph::from_json_text(document, a);
+    EXPECT_EQ(small->name(), "small");
+    EXPECT_EQ(small->get_nodes().size(), 2u);
+    EXPECT_EQ(Executor(*small).compute("a"), "x");
+    auto dangling = Graph::from_json_text(document, std::vector<std::string>{"b"});
+    EXPECT_EQ(dangling->get_nodes().size(), 3u);
+    EXPECT_THROW((void)Executor(*dangling).compute("b"), std::runtime_error);
+    EXPECT_THROW(Graph::from_json_text(document, std::vector<std::string>{"bad"}), std::runtime_error);
+    EXPECT_THROW(Graph::from_json_text(document, std::vector<std::string>{"missing"}), std::runtime_error);
+
+    std::string duplicate = R"({"nodes": [{"id": "a", "value": "1"}, {"id": "z", "value": "2"},
+                                          {"id": "z", "value": "3"}]})";
+    EXPECT_THROW(Graph::from_json_text(duplicate, a), std::runtime_error);
+
+    std::string unindexed = R"({"nodes": [{"id": "a", "value": "1"}, {"\u0069d": "b", "value": "2"}]})";
+    auto pruned = Graph::from_json_text(unindexed, a);
+    EXPECT_EQ(pruned->get_nodes().size(), 1u);
+    EXPECT_TRUE(pruned->get_nodes().contains(std::string_view("a")));
+}
+
+// ============================================================================
+// VERIFICATION TESTS
+// ============================================================================
+
+class VerificationTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Verifying a graph at compile time and running it unchecked
+ * Test Content:
+ * - Run a multi-output graph with every strategy before and after verify()
+ * - Verify graphs with a wrong input count, an output index on a
+ *   single-output operation, a user operation registered without a
+ *   signature, and a cycle
+ * - Run a verified graph with an output index past the outputs produced
+ *   and without feeding its placeholder
+ * - Compile graphs through CompiledGraph
+ * Expected Results:
+ * - Verified and unverified runs give the same results
+ * - Each invalid graph fails verify() and stays unverified
+ * - The data-dependent errors still throw on the verified path
+ * - CompiledGraph reports verified graphs, and the reason for others
+ */
+TEST_F(VerificationTest, GraphVerification) {
+    auto make_graph = [](json extra = json::array()) {
+        json nodes = {
+            {{"id", "text"}, {"type", "placeholder"}},
+            {{"id", "sep"}, {"type", "constant"}, {"value", ","}},
+            {{"id", "parts"}, {"op", "split"}, {"inputs", {"text"}}, {"constants", {","}}},
+            {{"id", "first"}, {"op", "to_upper"}, {"inputs", {"parts:0"}}},
+            {{"id", "last"}, {"op", "reverse"}, {"inputs", {"parts:2"}}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", {"first", "sep", "last"}}}
+        };
+        nodes.insert(nodes.end(), extra.begin(), extra.end());
+        return Graph::from_json({{"nodes", nodes}});
+    };
+    const std::unordered_map<std::string, std::string> feeds{{"text", "ab,cd,ef"}};
+
+    auto graph = make_graph();
+    Executor executor(*graph);
+    EXPECT_FALSE(executor.is_verified());
+    std::vector<std::string> expected;
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        expected.push_back(executor.compute_with_strategy(strategy, "out", feeds));
+    }
+    EXPECT_EQ(expected[0], "AB,fe");
+
+    executor.verify();
+    EXPECT_TRUE(executor.is_verified());
+    size_t i = 0;
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+        EXPECT_EQ(executor.compute_with_strategy(strategy, "out", feeds), expected[i++]);
+    }
+    EXPECT_EQ(executor.compute("last", feeds), "fe");
+
+    // Data-dependent errors are still reported
+    EXPECT_THROW((void)executor.compute("last", {{"text", "ab"}}), std::runtime_error);
+    EXPECT_THROW((void)executor.compute("out"), std::runtime_error);
+    executor.clear_verification();
+    EXPECT_FALSE(executor.is_verified());
+
+    auto expect_unverifiable = [](std::unique_ptr<Graph> bad) {
+        Executor bad_executor(*bad);
+        EXPECT_THROW(bad_executor.verify(), std::runtime_error);
+        EXPECT_FALSE(bad_executor.is_verified());
+    };
+
+    expect_unverifiable(make_graph({{{"id", "two"}, {"op", "reverse"}, {"inputs", {"first", "last"}}}}));
+
+    expect_unverifiable(make_graph({{{"id", "indexed"}, {"op", "reverse"}, {"inputs", {"first:0"}}}}));
+
+    OperationRegistry::get_instance().register_op("unsigned_op",
+        [](std::span<const std::string_view> inputs, std::span<const std::string_view>) -> OpResult {
+            return std::string(inputs.empty() ? "" : inputs[0]);
+        });
+    const json custom = {{{"id", "custom"}, {"op", "unsigned_op"}, {"inputs", {"out"}}}};
+    expect_unverifiable(make_graph(custom));
+    expect_unverifiable(make_graph({
+        {{"id", "a"}, {"op", "reverse"}, {"inputs", {"b"}}},
+        {{"id", "b"}, {"op", "reverse"}, {"inputs", {"a"}}}
+    }));
+
+    CompiledGraph compiled(make_graph());
+    EXPECT_TRUE(compiled.is_verified());
+    EXPECT_TRUE(compiled.verification_error().empty());
+    EXPECT_EQ(compiled.run("out", feeds), expected[0]);
+
+    CompiledGraph checked(make_graph(custom));
+    EXPECT_TRUE(checked.is_valid());
+    EXPECT_FALSE(checked.is_verified());
+    EXPECT_NE(checked.verification_error().find("unsigned_op"), std::string::npos);
+    EXPECT_EQ(checked.run("custom", feeds), expected[0]);
+}
+
+/**
+ * Test: Verified operations that run graphs themselves
+ * Test Content:
+ * - Run a verified graph whose operation computes another verified
+ *   graph on the same thread before reading its own inputs
+ * - Run a verified graph whose operation returns several outputs while
+ *   its signature declares one
+ * Expected Results:
+ * - The inner run does not change the outer operation's inputs
+ * - The wrong output kind throws and the node is not left computed
+ */
+TEST_F(VerificationTest, VerifiedOperationsReenter) {
+    auto inner_graph = Graph::from_json({{"nodes", {
+        {{"id", "p"}, {"type", "placeholder"}},
+        {{"id", "out"}, {"op", "concat"}, {"inputs", {"p", "p", "p"}}}
+    }}});
+    Executor inner(*inner_graph);
+    inner.verify();
+
+    auto& registry = OperationRegistry::get_instance();
+    registry.register_op("run_inner",
+        [&inner](std::span<const std::string_view> inputs, std::span<const std::string_view>) -> OpResult {
+            std::string nested = inner.compute("out", {{"p", "z"}});
+            return std::string(inputs[0]) + nested + std::string(inputs[1]);
+        },
+        OpSignature{.min_inputs = 2, .max_inputs = 2, .max_constants = 0});
+    registry.register_op("lying_op",
+        [](std::span<const std::string_view>, std::span<const std::string_view>) -> OpResult {
+            return std::vector<std::string>{"a", "b"};
+        },
+        OpSignature{.min_inputs = 1, .max_inputs = 1, .max_constants = 0});
+
+    auto graph = Graph::from_json({{"nodes", {
+        {{"id", "x"}, {"type", "placeholder"}},
+        {{"id", "y"}, {"type", "placeholder"}},
+        {{"id", "outer"}, {"op", "run_inner"}, {"inputs", {"x", "y"}}},
+        {{"id", "liar"}, {"op", "lying_op"}, {"inputs", {"x"}}}
+    }}});
+    Executor executor(*graph);
+    executor.verify();
+    const FeedDict feeds = {{"x", "<"}, {"y", ">"}};
+    for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                          ExecutionStrategy::PARALLEL}) {
+        EXPECT_EQ(executor.compute_with_strategy(strategy, "outer", feeds), "<zzz>");
+        EXPECT_THROW((void)executor.compute_with_strategy(strategy, "liar", feeds),
+                     std::runtime_error);
+        EXPECT_FALSE(graph->get_node("liar").computed_result.has_value());
+        EXPECT_NE(graph->get_node("liar").state, NodeState::COMPUTED);
+    }
+}
+
+/**
+ * Test: EXPLAIN of a verified graph agrees with compute_auto()
+ * Test Content:
+ * - Feed 300 constants into one concat
+ * - Explain the target with AUTO before and after verifying the graph,
+ *   and run it with compute_auto()
+ * Expected Results:
+ * - The depth is exact (2) on both paths, not capped by the node count
+ * - The explained strategy is the one compute_auto() runs (recursive),
+ *   verified or not
+ */
+TEST_F(VerificationTest, VerifiedExplainMatchesAuto) {
+    json nodes = json::array();
+    json inputs = json::array();
+    for (int i = 0; i < 300; ++i) {
+        std::string id = "c" + std::to_string(i);
+        nodes.push_back({{"id", id}, {"type", "constant"}, {"value", "x"}});
+        inputs.push_back(id);
+    }
+    nodes.push_back({{"id", "out"}, {"op", "concat"}, {"inputs", inputs}});
+    auto graph = Graph::from_json({{"nodes", nodes}});
+    Executor executor(*graph);
+    Explanation unverified = executor.explain("out");
+    executor.verify();
+
+    Profiler profiler;
+    executor.set_profiler(&profiler);
+    Explanation plan = executor.explain("out");
+    EXPECT_EQ(plan.decision.estimated_depth, 2u);
+    EXPECT_EQ(plan.decision.node_count, 301u);
+    EXPECT_EQ(executor.compute_auto("out"), std::string(300, 'x'));
+    ASSERT_EQ(profiler.runs().size(), 1u);
+    EXPECT_EQ(profiler.runs()[0].strategy, strategy_name(plan.decision.strategy));
+    EXPECT_EQ(plan.decision.strategy, ExecutionStrategy::RECURSIVE);
+    EXPECT_EQ(unverified.decision.estimated_depth, plan.decision.estimated_depth);
+    EXPECT_EQ(unverified.decision.strategy, plan.decision.strategy);
+}
+
+// ============================================================================
+// GRAPH TEMPLATE TESTS
+// ============================================================================
+
+class GraphTemplateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        core_ops::register_all();
+    }
+};
+
+/**
+ * Test: Running tenants' parameter sets on one graph template
+ * Test Content:
+ * - Make two CONSTANT nodes of a graph parameters and bind tenants with
+ *   different values, one of them with none
+ * - Run them with every strategy, and from several threads at once
+ * - Bind an unknown parameter, feed a parameter, run a parameter set of
+ *   another template, and make a non-constant or repeated ID a parameter
+ * Expected Results:
+ * - Each tenant computes what a copy of the graph with its values
+ *   computes, and unbound parameters keep the graph's values
+ * - Concurrent runs create at most one context per thread
+ * - The invalid uses throw, and the template keeps working after them
+ */
+TEST_F(GraphTemplateTest, GraphTemplates) {
+    auto make_graph = [](const std::string& prefix, const std::string& sep) {
+        return Graph::from_json({{"nodes", {
+            {{"id", "name"}, {"type", "placeholder"}},
+            {{"id", "prefix"}, {"type", "constant"}, {"value", prefix}},
+            {{"id", "sep"}, {"type", "constant"}, {"value", sep}},
+            {{"id", "suffix"}, {"type", "constant"}, {"value", "!"}},
+            {{"id", "parts"}, {"op", "split"}, {"inputs", {"name"}}, {"constants", {" "}}},
+            {{"id", "first"}, {"op", "capitalize"}, {"inputs", {"parts:0"}}},
+            {{"id", "out"}, {"op", "concat"}, {"inputs", {"prefix", "sep", "first", "suffix"}}}
+        }}});
+    };
+    GraphTemplate graph_template(make_graph("Hello", ", "), {"prefix", "sep"});
+    EXPECT_EQ(graph_template.parameters(), (std::vector<std::string>{"prefix", "sep"}));
+    EXPECT_TRUE(graph_template.is_verified());
+
+    struct Tenant {
+        std::string prefix;
+        std::string sep;
+        ParameterSet parameters;
+    };
+    std::vector<Tenant> tenants;
+    for (int i = 0; i < 16; ++i) {
+        Tenant tenant{std::format("Hi #{}", i), i % 2 ? " - " : ": ", {}};
+        tenant.parameters = graph_template.bind({{"prefix", tenant.prefix}, {"sep", tenant.sep}});
+        tenants.push_back(std::move(tenant));
+    }
+    tenants.push_back({"Hello", "; ", graph_template.bind({{"sep", "; "}})});
+    tenants.push_back({"Hello", ", ", graph_template.defaults()});
+
+    const FeedDict feeds{{"name", "ada lovelace"}};
+    for (auto& tenant : tenants) {
+        auto copy = make_graph(tenant.prefix, tenant.sep);
+        const std::string expected = Executor(*copy).compute("out", feeds);
+        EXPECT_EQ(expected, tenant.prefix + tenant.sep + "Ada!");
+        for (auto strategy : {ExecutionStrategy::RECURSIVE, ExecutionStrategy::ITERATIVE,
+                              ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO}) {
+            EXPECT_EQ(graph_template.run(tenant.parameters, "out", feeds, strategy), expected);
+        }
+    }
+    EXPECT_EQ(graph_template.run(tenants[3].parameters, "prefix", feeds), tenants[3].prefix);
+    EXPECT_EQ(graph_template.contexts(), 1u);
+
+    constexpr size_t THREADS = 4;
+    std::atomic<size_t> mismatches{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < 200; ++i) {
+                const Tenant& tenant = tenants[(i + t) % tenants.size()];
+                std::string name = std::format("user{} x", i);
+                std::string result = graph_template.run(tenant.parameters, "out", {{"name", name}});
+                if (result != std::format("{}{}User{}!", tenant.prefix, tenant.sep, i)) {
+                    ++mismatches;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0u);
+    EXPECT_LE(graph_template.contexts(), THREADS);
+
+    EXPECT_THROW((void)graph_template.bind({{"suffix", "?"}}), std::runtime_error);
+    EXPECT_THROW(graph_template.run(tenants[0].parameters, "out", {{"name", "x"}, {"sep", "x"}}),
+                 std::runtime_error);
+    GraphTemplate other(make_graph("Hello", ", "), {"sep"});
+    EXPECT_THROW(other.run(tenants[0].parameters, "out", feeds), std::runtime_error);
+    EXPECT_THROW(graph_template.run(tenants[0].parameters, "out"), std::runtime_error);
+    EXPECT_EQ(graph_template.run(tenants[0].parameters, "out", feeds), tenants[0].prefix + tenants[0].sep + "Ada!");
+
+    EXPECT_THROW(GraphTemplate(make_graph("a", "b"), {"first"}), std::runtime_error);
+    EXPECT_THROW(GraphTemplate(make_graph("a", "b"), {"sep", "sep"}), std::runtime_error);
+    EXPECT_THROW(GraphTemplate(make_graph("a", "b"), {"missing"}), std::runtime_error);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     
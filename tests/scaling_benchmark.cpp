@@ -0,0 +1,309 @@
+/**
+ * @file scaling_benchmark.cpp
+ * @brief strgraph_scaling: thread scaling of the parallel strategies.
+ *
+ * Sweeps thread counts from 1 to every logical CPU (SMT siblings
+ * included) over layered graphs of increasing width, operation mixes
+ * and string sizes. Every case reports latency, speedup and efficiency
+ * against one thread, the speedup over the iterative strategy, and how
+ * the threads spent a profiled run: in nodes, at the barriers of
+ * parallel layers, or in layers run serially.
+ *
+ * The parallel strategy runs with every layer on the thread team (or
+ * --threshold), so the widths where it starts beating the iterative
+ * strategy are the crossover points MIN_PARALLEL_LAYER_SIZE should sit
+ * at; they are summarized at the end.
+ */
+
+#include "bench_util.h"
+#include "strgraph/core_ops.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <set>
+#include <thread>
+#include <tuple>
+
+using namespace strgraph;
+using namespace strgraph::bench;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --threads LIST       Thread counts (default: powers of two, the core count and all CPUs)\n"
+        "  --widths LIST        Nodes per layer (default: 8,32,128,512,2048)\n"
+        "  --depth N            Layers per graph (default: 8)\n"
+        "  --mixes LIST         case,copy,edit,mixed (default: copy,case,edit)\n"
+        "  --sizes LIST         String sizes with K/M/G suffixes (default: 64,1K,16K)\n"
+        "  --strategies LIST    parallel,auto (default: both)\n"
+        "  --threshold N        Layer size from which the parallel strategy uses threads (default: 1)\n"
+        "  --min-time SECONDS   Minimum measuring time per case (default: 0.05)\n"
+        "  --seed N             Seed of the graphs (default: 42)\n"
+        "  --json FILE          Also write the results as JSON ('-' for stdout)\n"
+        "  --quick              Small sweep: widths 16,256, sizes 64,4K, copy and case, 0.02s per case\n",
+        program);
+}
+
+struct Options {
+    std::vector<size_t> threads;
+    std::vector<size_t> widths{8, 32, 128, 512, 2048};
+    size_t depth = 8;
+    std::vector<OpMix> mixes{OpMix::COPY, OpMix::CASE, OpMix::EDIT};
+    std::vector<size_t> sizes{64, 1 << 10, 16 << 10};
+    std::vector<ExecutionStrategy> strategies{ExecutionStrategy::PARALLEL, ExecutionStrategy::AUTO};
+    size_t threshold = 1;
+    MeasureOptions measure{.min_seconds = 0.05, .min_iterations = 5};
+    uint64_t seed = 42;
+    std::string json_path;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string_view {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--threads") {
+            options.threads.clear();
+            for (const auto& count : split_list(value())) options.threads.push_back(parse_bytes(count));
+        } else if (arg == "--widths") {
+            options.widths.clear();
+            for (const auto& width : split_list(value())) options.widths.push_back(parse_bytes(width));
+        } else if (arg == "--depth") {
+            options.depth = parse_bytes(value());
+        } else if (arg == "--mixes") {
+            options.mixes.clear();
+            for (const auto& name : split_list(value())) options.mixes.push_back(parse_mix(name));
+        } else if (arg == "--sizes") {
+            options.sizes.clear();
+            for (const auto& size : split_list(value())) options.sizes.push_back(parse_bytes(size));
+        } else if (arg == "--strategies") {
+            options.strategies.clear();
+            for (const auto& name : split_list(value())) {
+                ExecutionStrategy strategy = parse_strategy(name);
+                if (strategy != ExecutionStrategy::PARALLEL && strategy != ExecutionStrategy::AUTO) {
+                    throw std::runtime_error(std::format("'{}' is not a parallel strategy", name));
+                }
+                options.strategies.push_back(strategy);
+            }
+        } else if (arg == "--threshold") {
+            options.threshold = parse_bytes(value());
+        } else if (arg == "--min-time") {
+            options.measure.min_seconds = std::stod(std::string(value()));
+        } else if (arg == "--seed") {
+            options.seed = parse_bytes(value());
+        } else if (arg == "--json") {
+            options.json_path = value();
+        } else if (arg == "--quick") {
+            options.widths = {16, 256};
+            options.sizes = {64, 4 << 10};
+            options.mixes = {OpMix::COPY, OpMix::CASE};
+            options.measure.min_seconds = 0.02;
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Physical cores, from the sysfs CPU topology (logical CPUs if unknown).
+ */
+size_t physical_cores(size_t logical) {
+    std::set<std::pair<std::string, std::string>> cores;
+    for (size_t cpu = 0; cpu < logical; ++cpu) {
+        std::filesystem::path topology = std::format("/sys/devices/system/cpu/cpu{}/topology", cpu);
+        std::ifstream package_file(topology / "physical_package_id");
+        std::ifstream core_file(topology / "core_id");
+        std::string package, core;
+        if (!(package_file >> package) || !(core_file >> core)) {
+            return logical;
+        }
+        cores.emplace(package, core);
+    }
+    return cores.empty() ? logical : cores.size();
+}
+
+/**
+ * @brief 1, 2, 4, ... up to the core count, then the core count and all
+ *        logical CPUs.
+ */
+std::vector<size_t> default_threads(size_t cores, size_t logical) {
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < cores; n *= 2) counts.push_back(n);
+    counts.push_back(cores);
+    if (logical > cores) counts.push_back(logical);
+    return counts;
+}
+
+void set_threads([[maybe_unused]] size_t threads) {
+#ifdef USE_OPENMP
+    omp_set_num_threads(static_cast<int>(threads));
+#endif
+}
+
+double to_ms(double ns) {
+    return ns / 1e6;
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph_scaling: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    core_ops::register_all();
+    std::ostream& table = options.json_path == "-" ? std::cerr : std::cout;
+
+    const size_t logical = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t cores = physical_cores(logical);
+    if (options.threads.empty()) {
+        options.threads = default_threads(cores, logical);
+    }
+#ifndef USE_OPENMP
+    table << "OpenMP not available: the parallel strategies run serially\n";
+    options.threads = {1};
+#endif
+    options.measure.min_parallel_layer_size = options.threshold;
+
+    table << std::format("StrGraphCPP scaling benchmark: {} logical CPUs, {} cores, parallel threshold {}\n\n",
+                         logical, cores, options.threshold);
+    table << std::format("{:<28} {:<9} {:>7} {:>10} {:>8} {:>8} {:>9} {:>7} {:>9} {:>8}\n",
+                         "case", "strategy", "threads", "p50 ms", "speedup", "effic.", "vs iter.",
+                         "busy", "barrier", "serial");
+
+    nlohmann::json results = nlohmann::json::array();
+    // (mix, size, threads) -> width -> parallel p50 / iterative p50
+    std::map<std::tuple<std::string, size_t, size_t>, std::map<size_t, double>> ratios;
+
+    for (OpMix mix : options.mixes) {
+        for (size_t size : options.sizes) {
+            for (size_t width : options.widths) {
+                generator::Options spec;
+                spec.nodes = width * options.depth;
+                spec.depth = options.depth;
+                spec.min_fan_in = spec.max_fan_in = 1;
+                spec.mix = generator::parse_op_mix(mix_name(mix));
+                spec.value_size = size;
+                spec.seed = options.seed;
+                BenchGraph bench = build_generated(spec);
+                const std::string name = std::format("w{}x{}/{}/{}", width, options.depth,
+                                                     mix_name(mix), format_bytes(size));
+
+                set_threads(logical);
+                Measurement serial = measure(bench, ExecutionStrategy::ITERATIVE, options.measure);
+                const double serial_p50 = static_cast<double>(summarize(serial.samples_ns).p50_ns);
+                table << std::format("{:<28} {:<9} {:>7} {:>10.3f}\n", name, "iterative", 1, to_ms(serial_p50));
+
+                for (ExecutionStrategy strategy : options.strategies) {
+                    double single_p50 = 0.0;
+                    for (size_t threads : options.threads) {
+                        set_threads(threads);
+                        Measurement m = measure(bench, strategy, options.measure);
+                        const double p50 = static_cast<double>(summarize(m.samples_ns).p50_ns);
+                        if (threads == options.threads.front()) {
+                            single_p50 = p50 * static_cast<double>(threads);
+                        }
+
+                        // One more run, profiled, for where the thread time goes
+                        Executor executor(*bench.graph);
+                        executor.set_min_parallel_layer_size(options.threshold);
+                        Profiler profiler;
+                        executor.set_profiler(&profiler);
+                        (void)executor.compute_with_strategy(strategy, bench.target, bench.feeds);
+                        ThreadUtilization use = utilization(profiler);
+
+                        const double speedup = p50 > 0 ? single_p50 / p50 : 0.0;
+                        const double efficiency = speedup / static_cast<double>(threads);
+                        const double vs_serial = p50 > 0 ? serial_p50 / p50 : 0.0;
+                        table << std::format("{:<28} {:<9} {:>7} {:>10.3f} {:>8.2f} {:>7.0f}% {:>9.2f} {:>6.0f}% {:>8.0f}% {:>7.0f}%{}\n",
+                                             name, strategy_name(strategy), threads, to_ms(p50), speedup,
+                                             100.0 * efficiency, vs_serial, 100.0 * use.busy_share,
+                                             100.0 * use.barrier_share, 100.0 * use.serial_share,
+                                             threads > cores ? "  (SMT)" : "");
+
+                        if (strategy == ExecutionStrategy::PARALLEL) {
+                            ratios[{std::string(mix_name(mix)), size, threads}][width] = p50 / std::max(serial_p50, 1.0);
+                        }
+                        results.push_back({
+                            {"case", name},
+                            {"width", width},
+                            {"depth", options.depth},
+                            {"mix", mix_name(mix)},
+                            {"value_size", size},
+                            {"strategy", strategy_name(strategy)},
+                            {"threads", threads},
+                            {"smt", threads > cores},
+                            {"p50_ns", p50},
+                            {"iterative_p50_ns", serial_p50},
+                            {"speedup", speedup},
+                            {"efficiency", efficiency},
+                            {"speedup_vs_iterative", vs_serial},
+                            {"busy_share", use.busy_share},
+                            {"barrier_share", use.barrier_share},
+                            {"serial_share", use.serial_share}
+                        });
+                    }
+                }
+            }
+        }
+    }
+
+    // Smallest width from which the parallel strategy stays faster than iterative
+    table << std::format("\nCrossover layer widths (current MIN_PARALLEL_LAYER_SIZE: {})\n",
+                         Executor::MIN_PARALLEL_LAYER_SIZE);
+    nlohmann::json crossovers = nlohmann::json::array();
+    for (const auto& [key, by_width] : ratios) {
+        const auto& [mix, size, threads] = key;
+        std::optional<size_t> crossover;
+        for (auto it = by_width.rbegin(); it != by_width.rend() && it->second < 1.0; ++it) {
+            crossover = it->first;
+        }
+        table << std::format("  {:<6} {:>6} {:>3} threads: {}\n", mix, format_bytes(size), threads,
+                             crossover ? std::format("width >= {}", *crossover) : std::string("never faster"));
+        crossovers.push_back({{"mix", mix}, {"value_size", size}, {"threads", threads},
+                              {"crossover_width", crossover ? nlohmann::json(*crossover) : nlohmann::json()}});
+    }
+
+    if (!options.json_path.empty()) {
+        nlohmann::json report = {
+            {"benchmark", "strgraph_scaling"},
+            {"logical_cpus", logical},
+            {"cores", cores},
+            {"threshold", options.threshold},
+            {"results", std::move(results)},
+            {"crossovers", std::move(crossovers)}
+        };
+        if (options.json_path == "-") {
+            std::cout << report.dump(2) << "\n";
+        } else {
+            std::ofstream file(options.json_path);
+            file << report.dump(2) << "\n";
+            if (!file) {
+                std::cerr << std::format("strgraph_scaling: cannot write '{}'\n", options.json_path);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
@@ -542,6 +542,51 @@ def test_graph_modification_after_optimization():
     assert result3 == "HELLO"
 
 
+def test_call_timing_breakdown():
+    """
+    Test: Latency breakdown of Python calls into the engine
+    
+    Test Content:
+    - Run a small graph through Graph.run and CompiledGraph.run with
+      timing collected
+    - Run again with timing disabled
+    
+    Expected Results:
+    - Results are unchanged while timing
+    - Each entry point reports its call count and the phases it passes
+      through; the shares add up to the whole call
+    - Nothing is recorded while timing is disabled
+    """
+    from strgraph import timing
+    
+    with sg.Graph() as g:
+        text = g.placeholder(name="text")
+        upper = sg.to_upper(text, name="upper")
+    compiled = g.compile()
+    
+    with timing.collect():
+        for _ in range(20):
+            assert g.run(upper, {"text": "abc"}) == "ABC"
+            assert compiled.run(upper, {"text": "abc"}) == "ABC"
+    
+    report = timing.report()
+    assert report["Graph.run"]["calls"] == 20
+    assert report["CompiledGraph.run"]["calls"] == 20
+    graph_phases = report["Graph.run"]["phases"]
+    for phase in ("graph_to_json", "json_dumps", "json_parse", "graph_build", "execute", "gil_handoff"):
+        assert phase in graph_phases, f"Graph.run is missing {phase}"
+    compiled_phases = report["CompiledGraph.run"]["phases"]
+    assert "execute" in compiled_phases and "json_parse" not in compiled_phases
+    for entry in report.values():
+        total_share = sum(stats["share"] for stats in entry["phases"].values())
+        assert abs(total_share - 1.0) < 0.05, f"Shares add up to {total_share}"
+    assert "CompiledGraph.run" in timing.summary()
+    
+    timing.reset()
+    compiled.run(upper, {"text": "abc"})
+    assert timing.report() == {}
+
+
 def main():
     """Run all tests."""
     tests = [
@@ -557,6 +602,7 @@ def main():
         ("test_single_execution_optimization", test_single_execution_optimization),
         ("test_graph_modification_after_optimization", test_graph_modification_after_optimization),
         ("test_cpp_operations", test_cpp_operations),
+        ("test_call_timing_breakdown", test_call_timing_breakdown),
     ]
     
     passed = 0
@@ -0,0 +1,152 @@
+/**
+ * @file strgraph_gen.cpp
+ * @brief strgraph-gen: write a seeded synthetic graph for scale and
+ *        stress testing.
+ *
+ * Graphs are layered DAGs with a controlled node count, depth, width
+ * profile, fan-in, operation mix and share of multi-output nodes (see
+ * generator::Options). Nodes are streamed to the output as they are
+ * generated, so graphs of tens of millions of nodes can be written
+ * without holding them in memory. Feed every placeholder a value of
+ * --value-size bytes, e.g. generator::make_value().
+ */
+
+#include "strgraph/graph_generator.h"
+#include "tool_args.h"
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace strgraph;
+using tools::parse_count;
+using tools::parse_size;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} [options]\n"
+        "\n"
+        "Options:\n"
+        "  --nodes N              Operation nodes, K/M/G suffixes are powers of 1000 (default: 1000)\n"
+        "  --depth N              Layers (default: about sqrt(nodes))\n"
+        "  --width NAME           uniform | diamond | funnel | random (default: uniform)\n"
+        "  --placeholders N       Input placeholders (default: 1)\n"
+        "  --fan-in MIN[-MAX]     Inputs per node (default: 1-3)\n"
+        "  --lookback N           Layers inputs are drawn from (default: 1)\n"
+        "  --hub-ratio R          Probability that an input is a placeholder (default: 0)\n"
+        "  --mix NAME             case | copy | edit | mixed (default: mixed)\n"
+        "  --value-size N         Length merges cut their result to (default: 64)\n"
+        "  --multi-output R       Share of split nodes (default: 0)\n"
+        "  --split-outputs N      Outputs per split node (default: 4)\n"
+        "  --seed N               Random seed (default: 42)\n"
+        "  --name NAME            Graph name (default: generated)\n"
+        "  --format NAME          json | binary (default: json)\n"
+        "  --output FILE          Output file (default: stdout)\n"
+        "  --quiet                Do not print the summary\n",
+        program);
+}
+
+double parse_ratio(std::string_view value, std::string_view option) {
+    try {
+        size_t used = 0;
+        double result = std::stod(std::string(value), &used);
+        if (used == value.size()) return result;
+    } catch (const std::exception&) {
+    }
+    throw std::runtime_error(std::format("Invalid value '{}' for {}", value, option));
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    generator::Options options;
+    std::string format = "json";
+    std::string output_path;
+    bool quiet = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto next = [&]() -> std::string_view {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error(std::format("Missing value for {}", arg));
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--nodes") options.nodes = parse_count(next(), arg);
+            else if (arg == "--depth") options.depth = parse_count(next(), arg);
+            else if (arg == "--width") options.width = generator::parse_width_profile(next());
+            else if (arg == "--placeholders") options.placeholders = parse_count(next(), arg);
+            else if (arg == "--fan-in") {
+                std::string_view range = next();
+                size_t dash = range.find('-');
+                options.min_fan_in = parse_size(range.substr(0, dash), arg);
+                options.max_fan_in = dash == std::string_view::npos
+                    ? options.min_fan_in : parse_size(range.substr(dash + 1), arg);
+            }
+            else if (arg == "--lookback") options.lookback = parse_size(next(), arg);
+            else if (arg == "--hub-ratio") options.hub_ratio = parse_ratio(next(), arg);
+            else if (arg == "--mix") options.mix = generator::parse_op_mix(next());
+            else if (arg == "--value-size") options.value_size = parse_size(next(), arg);
+            else if (arg == "--multi-output") options.multi_output_ratio = parse_ratio(next(), arg);
+            else if (arg == "--split-outputs") options.split_outputs = parse_size(next(), arg);
+            else if (arg == "--seed") options.seed = parse_size(next(), arg);
+            else if (arg == "--name") options.name = next();
+            else if (arg == "--format") format = next();
+            else if (arg == "--output") output_path = next();
+            else if (arg == "--quiet") quiet = true;
+            else if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            } else {
+                throw std::runtime_error(std::format("Unknown option '{}'", arg));
+            }
+        }
+        if (format != "json" && format != "binary") {
+            throw std::runtime_error(std::format("Unknown format '{}' (json or binary)", format));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph-gen: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        std::ofstream file;
+        if (!output_path.empty()) {
+            file.open(output_path, std::ios::binary | std::ios::trunc);
+            if (!file) {
+                throw std::runtime_error(std::format("Cannot open output file '{}'", output_path));
+            }
+        } else {
+            std::ios::sync_with_stdio(false);
+        }
+        std::ostream& out = output_path.empty() ? std::cout : file;
+
+        auto start = std::chrono::steady_clock::now();
+        generator::Summary summary = format == "binary" ? generator::write_binary(options, out)
+                                                        : generator::write_json(options, out);
+        out.flush();
+        if (!out) {
+            throw std::runtime_error("Writing the graph failed");
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!quiet) {
+            std::cerr << std::format(
+                "strgraph-gen: {} nodes ({} operations, {} split, {} edges) in {} layers, "
+                "widest {}, {} placeholders, target '{}', {:.3f}s\n",
+                summary.total_nodes, summary.operation_nodes, summary.split_nodes, summary.edges,
+                summary.layers, summary.max_layer_nodes, summary.placeholder_ids.size(),
+                generator::Summary::TARGET, seconds);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph-gen: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,413 @@
+/**
+ * @file strgraph_replay.cpp
+ * @brief strgraph-replay: re-execute a recorded traffic log against this
+ *        build.
+ *
+ * Reads a log written by a TrafficRecorder (CompiledGraph::enable_recording),
+ * runs every record on the graph registered for its graph id, compares
+ * the result with the recorded hash (or the recorded error) and reports
+ * the latency distribution. Records are replayed by --concurrency
+ * threads, each with its own executors, either as fast as possible or
+ * paced at --speed times the recorded arrival rate.
+ *
+ * Exit status: 0 all results verified, 1 mismatch or unexpected error,
+ * 2 usage or I/O error.
+ */
+
+#include "strgraph/core_ops.h"
+#include "strgraph/executor.h"
+#include "strgraph/graph.h"
+#include "strgraph/traffic_recorder.h"
+#include "bench_util.h"
+#include <json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace strgraph;
+using bench::percentile;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} --log FILE --graph [ID=]FILE [options]\n"
+        "\n"
+        "Options:\n"
+        "  --log FILE             Traffic log written by a TrafficRecorder\n"
+        "  --graph [ID=]FILE      Graph (JSON or binary) for the records of graph ID;\n"
+        "                         without ID, for every record without its own --graph\n"
+        "  --concurrency N        Replay threads (default: 1)\n"
+        "  --speed X              Pace at X times the recorded arrival rate;\n"
+        "                         0 replays as fast as possible (default: 0)\n"
+        "  --strategy NAME        recursive | iterative | parallel | auto\n"
+        "                         (default: the recorded strategy)\n"
+        "  --repeat N             Replay the log N times (default: 1)\n"
+        "  --no-verify            Do not compare results with the recording\n"
+        "  --json FILE            Also write the report as JSON ('-' for stdout)\n",
+        program);
+}
+
+struct Options {
+    std::string log_path;
+    std::map<std::string, std::string> graph_paths;    ///< Graph id -> file
+    std::string default_graph_path;
+    size_t concurrency = 1;
+    double speed = 0.0;
+    std::optional<ExecutionStrategy> strategy;
+    size_t repeat = 1;
+    bool verify = true;
+    std::string json_path;
+};
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error(std::format("Missing value for {}", arg));
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--log") {
+            options.log_path = value();
+        } else if (arg == "--graph") {
+            std::string spec = value();
+            size_t equals = spec.find('=');
+            if (equals == std::string::npos) {
+                options.default_graph_path = spec;
+            } else {
+                options.graph_paths[spec.substr(0, equals)] = spec.substr(equals + 1);
+            }
+        } else if (arg == "--concurrency") {
+            options.concurrency = std::stoul(value());
+        } else if (arg == "--speed") {
+            options.speed = std::stod(value());
+        } else if (arg == "--strategy") {
+            options.strategy = parse_strategy(value());
+        } else if (arg == "--repeat") {
+            options.repeat = std::stoul(value());
+        } else if (arg == "--no-verify") {
+            options.verify = false;
+        } else if (arg == "--json") {
+            options.json_path = value();
+        } else if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            std::exit(0);
+        } else {
+            throw std::runtime_error(std::format("Unknown option '{}'", arg));
+        }
+    }
+    if (options.log_path.empty()) {
+        throw std::runtime_error("--log is required");
+    }
+    if (options.graph_paths.empty() && options.default_graph_path.empty()) {
+        throw std::runtime_error("--graph is required");
+    }
+    if (options.concurrency == 0 || options.repeat == 0) {
+        throw std::runtime_error("--concurrency and --repeat must be at least 1");
+    }
+    if (options.speed < 0.0) {
+        throw std::runtime_error("--speed must not be negative");
+    }
+    return options;
+}
+
+/**
+ * @brief Outcome of one replayed record.
+ */
+enum class Outcome {
+    MATCHED,        ///< Same result (or same failure) as recorded, or not verified
+    MISMATCHED,     ///< Different result, or failed/succeeded unlike the recording
+    SKIPPED         ///< No graph for the record's graph id
+};
+
+/**
+ * @brief What one replay thread measured.
+ */
+struct WorkerResult {
+    std::vector<uint64_t> latencies_ns;
+    std::vector<uint64_t> lags_ns;          ///< Start after the scheduled time (paced replays)
+    std::vector<double> ratios;             ///< Replayed over recorded latency
+    size_t matched = 0;
+    size_t mismatched = 0;
+    size_t skipped = 0;
+    size_t failed = 0;                      ///< Calls that threw, expected or not
+};
+
+/**
+ * @brief A graph and its executor, owned by one replay thread.
+ */
+struct Session {
+    std::unique_ptr<Graph> graph;
+    std::unique_ptr<Executor> executor;
+};
+
+class Replayer {
+public:
+    Replayer(const Options& options, const std::vector<TrafficRecord>& records)
+        : options_(options), records_(records) {}
+
+    WorkerResult run_worker(std::chrono::steady_clock::time_point start, uint64_t first_ns, uint64_t span_ns) {
+        using clock = std::chrono::steady_clock;
+        WorkerResult result;
+        std::unordered_map<std::string, Session> sessions;
+        const size_t total = records_.size() * options_.repeat;
+
+        for (size_t job = next_.fetch_add(1); job < total; job = next_.fetch_add(1)) {
+            const size_t pass = job / records_.size();
+            const TrafficRecord& record = records_[job % records_.size()];
+
+            Executor* executor = session(sessions, record.graph_id);
+            if (executor == nullptr) {
+                ++result.skipped;
+                continue;
+            }
+
+            if (options_.speed > 0.0) {
+                auto offset_ns = static_cast<double>(record.timestamp_ns - first_ns + pass * span_ns) / options_.speed;
+                auto scheduled = start + std::chrono::nanoseconds(static_cast<int64_t>(offset_ns));
+                std::this_thread::sleep_until(scheduled);
+                result.lags_ns.push_back(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - scheduled).count()));
+            }
+
+            FeedViewDict feeds;
+            for (const auto& [name, value] : record.feeds) {
+                feeds.emplace(name, value);
+            }
+            ExecutionStrategy strategy = options_.strategy.value_or(parse_strategy(record.strategy));
+
+            std::optional<std::string> error;
+            uint64_t size = 0, hash = 0;
+            auto call_start = clock::now();
+            try {
+                const std::string& value = executor->compute_with_strategy(strategy, record.target, feeds);
+                size = value.size();
+                hash = options_.verify ? TrafficRecorder::hash(value) : 0;
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+            auto latency = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - call_start).count());
+            result.latencies_ns.push_back(latency);
+            if (record.latency_ns > 0) {
+                result.ratios.push_back(static_cast<double>(latency) / static_cast<double>(record.latency_ns));
+            }
+            if (error) ++result.failed;
+
+            std::string reason;
+            if (options_.verify) {
+                if (error && record.error.empty()) {
+                    reason = std::format("failed: {}", *error);
+                } else if (!error && !record.error.empty()) {
+                    reason = std::format("succeeded, recorded error: {}", record.error);
+                } else if (!error && (size != record.result_size || hash != record.result_hash)) {
+                    reason = std::format("result differs ({} bytes, recorded {})", size, record.result_size);
+                }
+            }
+            if (reason.empty()) {
+                ++result.matched;
+            } else {
+                ++result.mismatched;
+                report_mismatch(job % records_.size(), record, reason);
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t MAX_REPORTED_MISMATCHES = 10;
+
+    Executor* session(std::unordered_map<std::string, Session>& sessions, const std::string& graph_id) {
+        if (auto it = sessions.find(graph_id); it != sessions.end()) {
+            return it->second.executor.get();
+        }
+        auto path = options_.graph_paths.find(graph_id);
+        const std::string& file = path != options_.graph_paths.end() ? path->second : options_.default_graph_path;
+        Session& session = sessions[graph_id];
+        if (!file.empty()) {
+            session.graph = Graph::from_file(file);
+            session.executor = std::make_unique<Executor>(*session.graph);
+            // Recorded traffic ran on CompiledGraph, which verifies its graph:
+            // replay on the same path. A graph that fails runs checked.
+            try {
+                session.executor->verify();
+            } catch (const std::exception&) {
+            }
+        }
+        return session.executor.get();
+    }
+
+    void report_mismatch(size_t index, const TrafficRecord& record, const std::string& reason) {
+        std::lock_guard lock(report_mutex_);
+        if (++reported_ <= MAX_REPORTED_MISMATCHES) {
+            std::cerr << std::format("strgraph-replay: record {} ({} -> '{}'): {}\n",
+                                     index, record.graph_id, record.target, reason);
+        }
+    }
+
+    const Options& options_;
+    const std::vector<TrafficRecord>& records_;
+    std::atomic<size_t> next_{0};
+    std::mutex report_mutex_;
+    size_t reported_ = 0;
+};
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<TrafficRecord> records;
+    try {
+        options = parse_options(argc, argv);
+        records = TrafficRecorder::read(options.log_path);
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph-replay: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 2;
+    }
+    if (records.empty()) {
+        std::cerr << std::format("strgraph-replay: '{}' holds no records\n", options.log_path);
+        return 2;
+    }
+
+    core_ops::register_all();
+    std::ranges::stable_sort(records, {}, &TrafficRecord::timestamp_ns);
+    const uint64_t first_ns = records.front().timestamp_ns;
+    const uint64_t span_ns = records.back().timestamp_ns + records.back().latency_ns - first_ns;
+
+    Replayer replayer(options, records);
+    std::vector<WorkerResult> results(options.concurrency);
+    auto start = std::chrono::steady_clock::now();
+    try {
+        std::vector<std::jthread> threads;
+        std::vector<std::exception_ptr> errors(options.concurrency);
+        for (size_t t = 0; t < options.concurrency; ++t) {
+            threads.emplace_back([&, t] {
+                try {
+                    results[t] = replayer.run_worker(start, first_ns, span_ns);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            });
+        }
+        threads.clear();
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph-replay: " << e.what() << "\n";
+        return 2;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    WorkerResult total;
+    for (auto& result : results) {
+        total.latencies_ns.insert(total.latencies_ns.end(), result.latencies_ns.begin(), result.latencies_ns.end());
+        total.lags_ns.insert(total.lags_ns.end(), result.lags_ns.begin(), result.lags_ns.end());
+        total.ratios.insert(total.ratios.end(), result.ratios.begin(), result.ratios.end());
+        total.matched += result.matched;
+        total.mismatched += result.mismatched;
+        total.skipped += result.skipped;
+        total.failed += result.failed;
+    }
+    std::ranges::sort(total.latencies_ns);
+    std::ranges::sort(total.lags_ns);
+    std::ranges::sort(total.ratios);
+    std::vector<uint64_t> recorded_ns;
+    for (const auto& record : records) recorded_ns.push_back(record.latency_ns);
+    std::ranges::sort(recorded_ns);
+
+    const size_t replayed = total.latencies_ns.size();
+    const double calls_per_second = seconds > 0.0 ? static_cast<double>(replayed) / seconds : 0.0;
+    double mean_ns = 0.0;
+    for (uint64_t latency : total.latencies_ns) mean_ns += static_cast<double>(latency);
+    if (replayed > 0) mean_ns /= static_cast<double>(replayed);
+
+    std::ostream& out = options.json_path == "-" ? std::cerr : std::cout;
+    out << std::format("strgraph-replay: {} records x {} from '{}', {} threads, {}\n",
+                       records.size(), options.repeat, options.log_path, options.concurrency,
+                       options.speed > 0.0 ? std::format("{}x recorded speed", options.speed) : "as fast as possible");
+    out << std::format("replayed {} in {:.3f}s ({:.0f} calls/s): {} matched, {} mismatched, {} failed, {} skipped{}\n",
+                       replayed, seconds, calls_per_second, total.matched, total.mismatched, total.failed,
+                       total.skipped, options.verify ? "" : " (not verified)");
+    out << std::format("{:<10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+                       "latency us", "min", "p50", "p90", "p99", "p99.9", "max", "mean");
+    auto row = [&](std::string_view name, const std::vector<uint64_t>& sorted, double mean) {
+        if (sorted.empty()) return;
+        out << std::format("{:<10} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+                           name, sorted.front() / 1e3, percentile(sorted, 0.5) / 1e3,
+                           percentile(sorted, 0.9) / 1e3, percentile(sorted, 0.99) / 1e3,
+                           percentile(sorted, 0.999) / 1e3, sorted.back() / 1e3, mean / 1e3);
+    };
+    double recorded_mean = 0.0;
+    for (uint64_t latency : recorded_ns) recorded_mean += static_cast<double>(latency);
+    recorded_mean /= static_cast<double>(recorded_ns.size());
+    row("replay", total.latencies_ns, mean_ns);
+    row("recorded", recorded_ns, recorded_mean);
+    if (!total.ratios.empty()) {
+        out << std::format("replay / recorded latency per record: p10 {:.3f}, p50 {:.3f}, p90 {:.3f}\n",
+                           percentile(total.ratios, 0.1), percentile(total.ratios, 0.5),
+                           percentile(total.ratios, 0.9));
+    }
+    if (!total.lags_ns.empty()) {
+        out << std::format("start lag behind schedule: p50 {:.1f} us, p99 {:.1f} us, max {:.1f} us\n",
+                           percentile(total.lags_ns, 0.5) / 1e3, percentile(total.lags_ns, 0.99) / 1e3,
+                           total.lags_ns.back() / 1e3);
+    }
+
+    if (!options.json_path.empty()) {
+        auto summary = [](const std::vector<uint64_t>& sorted) {
+            if (sorted.empty()) return nlohmann::json::object();
+            return nlohmann::json{
+                {"min", sorted.front()}, {"p50", percentile(sorted, 0.5)}, {"p90", percentile(sorted, 0.9)},
+                {"p99", percentile(sorted, 0.99)}, {"p999", percentile(sorted, 0.999)}, {"max", sorted.back()}
+            };
+        };
+        nlohmann::json report = {
+            {"tool", "strgraph-replay"},
+            {"log", options.log_path},
+            {"records", records.size()},
+            {"repeat", options.repeat},
+            {"concurrency", options.concurrency},
+            {"speed", options.speed},
+            {"verified", options.verify},
+            {"replayed", replayed},
+            {"matched", total.matched},
+            {"mismatched", total.mismatched},
+            {"failed", total.failed},
+            {"skipped", total.skipped},
+            {"seconds", seconds},
+            {"calls_per_second", calls_per_second},
+            {"latency_ns", summary(total.latencies_ns)},
+            {"recorded_latency_ns", summary(recorded_ns)},
+            {"lag_ns", summary(total.lags_ns)},
+            {"latency_ratio_p50", percentile(total.ratios, 0.5)}
+        };
+        if (options.json_path == "-") {
+            std::cout << report.dump(2) << "\n";
+        } else {
+            std::ofstream file(options.json_path);
+            file << report.dump(2) << "\n";
+            if (!file) {
+                std::cerr << std::format("strgraph-replay: cannot write '{}'\n", options.json_path);
+                return 2;
+            }
+        }
+    }
+    return total.mismatched > 0 ? 1 : 0;
+}
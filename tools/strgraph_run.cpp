@@ -0,0 +1,281 @@
+/**
+ * @file strgraph_run.cpp
+ * @brief strgraph-run: stream the records of a file through a graph.
+ * 
+ * Loads a graph (JSON or binary), memory-maps the input file, splits it
+ * into records (lines, CSV, TSV or JSONL), binds each record or its
+ * columns/fields to PLACEHOLDER nodes, runs the graph over parallel chunks
+ * and writes the results in input order.
+ * 
+ * With --io the input is streamed instead of mapped: blocks are read
+ * asynchronously (io_uring or a read-ahead thread) while earlier blocks
+ * are being processed, and results are written back asynchronously.
+ */
+
+#include "strgraph/async_io.h"
+#include "strgraph/batch_runner.h"
+#include "strgraph/core_ops.h"
+#include "strgraph/graph.h"
+#include "strgraph/mapped_file.h"
+#include "tool_args.h"
+#include <json.hpp>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace strgraph;
+using tools::parse_size;
+
+namespace {
+
+void print_usage(const char* program) {
+    std::cerr << std::format(
+        "Usage: {} --graph FILE --input FILE [options]\n"
+        "\n"
+        "Options:\n"
+        "  --graph FILE             Graph definition (JSON or binary)\n"
+        "  --input FILE             Input file\n"
+        "  --format NAME            lines | csv | tsv | jsonl (default: lines)\n"
+        "  --no-header              CSV/TSV input has no header row\n"
+        "  --output FILE            Output file (default: stdout)\n"
+        "  --target ID              Node to compute; only the nodes it reaches are loaded\n"
+        "                           (default: JSON 'target_node', with the whole graph)\n"
+        "  --bind [COL=]ID          Bind column COL (index, header name or JSON field)\n"
+        "                           or the whole record to placeholder ID\n"
+        "  --delimiter CHAR         Column delimiter (use 'tab' for tabs)\n"
+        "  --record-delimiter CHAR  Record delimiter (default: newline)\n"
+        "  --strategy NAME          recursive | iterative | parallel | auto\n"
+        "  --threads N              Worker threads (default: all cores)\n"
+        "  --chunk N                Records per scheduling chunk\n"
+        "  --skip-errors            Write an empty line for failing records\n"
+        "  --io NAME                mmap | auto | io_uring | thread (default: mmap)\n"
+        "  --block-size N           Streaming I/O block size in bytes (default: 1 MiB)\n"
+        "  --queue-depth N          Streaming I/O requests in flight (default: 4)\n"
+        "  --quiet                  Do not print throughput statistics\n",
+        program);
+}
+
+char parse_char(std::string_view value) {
+    if (value == "tab" || value == "\\t") return '\t';
+    if (value == "newline" || value == "\\n") return '\n';
+    if (value == "nul" || value == "\\0") return '\0';
+    if (value.size() != 1) {
+        throw std::runtime_error(std::format("Delimiter '{}' must be a single character", value));
+    }
+    return value[0];
+}
+
+ColumnBinding parse_binding(std::string_view value) {
+    ColumnBinding binding;
+    size_t eq = value.rfind('=');
+    if (eq == std::string_view::npos) {
+        binding.placeholder_id = std::string(value);
+        return binding;
+    }
+    std::string_view column = value.substr(0, eq);
+    binding.placeholder_id = std::string(value.substr(eq + 1));
+    bool numeric = !column.empty() &&
+        column.find_first_not_of("0123456789") == std::string_view::npos;
+    if (numeric) {
+        binding.column = parse_size(column, "--bind");
+    } else {
+        binding.column_name = std::string(column);
+    }
+    return binding;
+}
+
+/**
+ * @brief Load the graph and, for JSON graphs, its default target node.
+ *
+ * With a --target, only the nodes it reaches are loaded.
+ */
+std::unique_ptr<Graph> load_graph(const std::string& path, const std::string& target,
+                                  std::string& default_target) {
+    nlohmann::json fields;
+    auto graph = target.empty() ? Graph::from_file(path, &fields)
+                                : Graph::from_file(path, std::span(&target, 1), &fields);
+    if (fields.contains("target_node")) {
+        default_target = fields["target_node"].get<std::string>();
+    }
+    return graph;
+}
+
+void print_stats(const BatchStats& stats) {
+    std::cerr << std::format(
+        "strgraph-run: {} records ({} errors), {:.1f} MB in {:.3f}s: "
+        "{:.0f} records/sec, {:.1f} MB/s\n",
+        stats.records, stats.errors,
+        static_cast<double>(stats.input_bytes) / (1024.0 * 1024.0),
+        stats.elapsed_seconds, stats.records_per_second(),
+        stats.megabytes_per_second());
+}
+
+void print_io_stats(std::string_view direction, const IoStats& io) {
+    std::cerr << std::format(
+        "strgraph-run: {} {:.1f} MB in {} requests via {}, blocked {:.3f}s\n",
+        direction, static_cast<double>(io.bytes) / (1024.0 * 1024.0), io.requests,
+        io_backend_name(io.backend), io.wait_seconds);
+}
+
+/**
+ * @brief Run with asynchronous block input and output instead of mmap.
+ */
+void run_streaming(BatchRunner& runner, const std::string& input_path,
+                   const std::string& output_path, const AsyncIoOptions& io_options, bool quiet) {
+    AsyncFileReader input(input_path, io_options);
+    auto writer = output_path.empty()
+        ? std::make_unique<AsyncFileWriter>(STDOUT_FILENO, io_options)
+        : std::make_unique<AsyncFileWriter>(output_path, io_options);
+    std::ostream output(writer.get());
+
+    BatchStats stats = runner.run(input, output);
+    writer->close();
+    if (!output) {
+        throw std::runtime_error(output_path.empty() ? std::string("Cannot write to standard output")
+                                                     : std::format("Cannot write output file '{}'", output_path));
+    }
+
+    if (!quiet) {
+        print_stats(stats);
+        print_io_stats("read", input.stats());
+        print_io_stats("wrote", writer->stats());
+        double blocked = input.stats().wait_seconds + writer->stats().wait_seconds;
+        auto share = [&](double seconds) {
+            return stats.elapsed_seconds > 0.0 ? 100.0 * seconds / stats.elapsed_seconds : 0.0;
+        };
+        std::cerr << std::format(
+            "strgraph-run: compute {:.3f}s ({:.0f}% of elapsed), blocked on I/O {:.3f}s ({:.0f}%)\n",
+            stats.compute_seconds, share(stats.compute_seconds), blocked, share(blocked));
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string graph_path;
+    std::string input_path;
+    std::string output_path;
+    std::string target;
+    bool quiet = false;
+    bool streaming = false;
+    BatchOptions options;
+    AsyncIoOptions io_options;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto next = [&]() -> std::string_view {
+                if (i + 1 >= argc) {
+                    throw std::runtime_error(std::format("Missing value for {}", arg));
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--graph") graph_path = next();
+            else if (arg == "--input") input_path = next();
+            else if (arg == "--output") output_path = next();
+            else if (arg == "--format") options.format = parse_record_format(next());
+            else if (arg == "--no-header") options.has_header = false;
+            else if (arg == "--target") target = next();
+            else if (arg == "--bind") options.bindings.push_back(parse_binding(next()));
+            else if (arg == "--delimiter") options.column_delimiter = parse_char(next());
+            else if (arg == "--record-delimiter") options.record_delimiter = parse_char(next());
+            else if (arg == "--strategy") options.strategy = parse_strategy(next());
+            else if (arg == "--threads") options.num_threads = parse_size(next(), arg);
+            else if (arg == "--chunk") options.chunk_records = parse_size(next(), arg);
+            else if (arg == "--skip-errors") options.skip_errors = true;
+            else if (arg == "--io") {
+                std::string_view name = next();
+                streaming = name != "mmap";
+                if (streaming) io_options.backend = parse_io_backend(name);
+            }
+            else if (arg == "--block-size") io_options.block_size = parse_size(next(), arg);
+            else if (arg == "--queue-depth") io_options.queue_depth = parse_size(next(), arg);
+            else if (arg == "--quiet") quiet = true;
+            else if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                return 0;
+            } else {
+                throw std::runtime_error(std::format("Unknown option '{}'", arg));
+            }
+        }
+
+        if (graph_path.empty() || input_path.empty()) {
+            print_usage(argv[0]);
+            return 2;
+        }
+
+        core_ops::register_all();
+
+        std::string default_target;
+        auto graph = load_graph(graph_path, target, default_target);
+        options.target_node_id = target.empty() ? default_target : target;
+        if (options.target_node_id.empty()) {
+            throw std::runtime_error("No --target given and the graph has no 'target_node'");
+        }
+
+        // Without explicit bindings, placeholders take the column or field of the
+        // same name; for plain lines a single placeholder takes whole records
+        if (options.bindings.empty()) {
+            std::vector<std::string> placeholders;
+            for (const auto& [id, node] : graph->get_nodes()) {
+                if (node.type == NodeType::PLACEHOLDER) {
+                    placeholders.push_back(id);
+                }
+            }
+            bool named = options.format == RecordFormat::JSONL ||
+                (options.format != RecordFormat::LINES && options.has_header);
+            if (named) {
+                for (const auto& id : placeholders) {
+                    options.bindings.push_back({ColumnBinding::WHOLE_RECORD, id, id});
+                }
+            } else if (placeholders.size() != 1) {
+                throw std::runtime_error(std::format(
+                    "Graph has {} placeholders; use --bind to map record columns",
+                    placeholders.size()));
+            } else {
+                options.bindings.push_back({ColumnBinding::WHOLE_RECORD, placeholders[0]});
+            }
+        }
+
+        BatchRunner runner(*graph, options);
+        BatchStats stats;
+        if (streaming) {
+            run_streaming(runner, input_path, output_path, io_options, quiet);
+            return 0;
+        }
+
+        MappedFile input(input_path);
+        input.advise_sequential();
+        if (output_path.empty()) {
+            std::ios::sync_with_stdio(false);
+            stats = runner.run(input.view(), std::cout);
+            if (!std::cout.flush()) {
+                throw std::runtime_error("Cannot write to standard output");
+            }
+        } else {
+            std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+            if (!output) {
+                throw std::runtime_error(std::format("Cannot open output file '{}'", output_path));
+            }
+            stats = runner.run(input.view(), output);
+            output.close();
+            if (!output) {
+                throw std::runtime_error(std::format("Cannot write output file '{}'", output_path));
+            }
+        }
+
+        if (!quiet) {
+            print_stats(stats);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "strgraph-run: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+/**
+ * @file tool_args.h
+ * @brief Command-line value parsers shared by the strgraph tools.
+ *
+ * Invalid values throw std::runtime_error naming the option, which the
+ * tools report before exiting.
+ */
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string_view>
+
+namespace strgraph::tools {
+
+/**
+ * @brief Non-negative decimal integer.
+ */
+inline size_t parse_size(std::string_view value, std::string_view option) {
+    size_t result = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (value.empty() || ec != std::errc{} || ptr != value.data() + value.size()) {
+        throw std::runtime_error(std::format("Invalid value '{}' for {}", value, option));
+    }
+    return result;
+}
+
+/**
+ * @brief Count with an optional K, M or G suffix (powers of 1000).
+ */
+inline size_t parse_count(std::string_view value, std::string_view option) {
+    size_t multiplier = 1;
+    std::string_view digits = value;
+    if (!digits.empty()) {
+        switch (digits.back()) {
+            case 'K': case 'k': multiplier = 1'000; break;
+            case 'M': case 'm': multiplier = 1'000'000; break;
+            case 'G': case 'g': multiplier = 1'000'000'000; break;
+        }
+        if (multiplier != 1) digits.remove_suffix(1);
+    }
+    size_t count = parse_size(digits, option);
+    if (count > SIZE_MAX / multiplier) {
+        throw std::runtime_error(std::format("Value '{}' for {} is too large", value, option));
+    }
+    return count * multiplier;
+}
+
+} // namespace strgraph::tools